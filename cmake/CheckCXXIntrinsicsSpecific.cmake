@@ -74,5 +74,91 @@ if(SEAL_USE_INTRIN)
         SEAL__SUBBORROW_U64_FOUND
     )
 
+    # Check for AVX2, AVX-512 (F and DQ), and AVX-512 IFMA intrinsics; the kernels are selected at runtime so we only
+    # check that they compile and never run them here
+    if(MSVC)
+        check_cxx_source_compiles("
+            #include <immintrin.h>
+            int main() {
+                __m256i a = _mm256_set1_epi64x(1);
+                volatile int res = _mm256_movemask_epi8(_mm256_mul_epu32(a, a));
+                return 0;
+            }"
+            SEAL_AVX2_FOUND
+        )
+        check_cxx_source_compiles("
+            #include <immintrin.h>
+            int main() {
+                __m512i a = _mm512_set1_epi64(1);
+                volatile auto res = _mm512_cmpge_epu64_mask(_mm512_mullo_epi64(a, a), a);
+                return 0;
+            }"
+            SEAL_AVX512_FOUND
+        )
+        check_cxx_source_compiles("
+            #include <immintrin.h>
+            int main() {
+                __m512i a = _mm512_set1_epi64(1);
+                volatile auto res = _mm512_cmpge_epu64_mask(_mm512_madd52hi_epu64(a, a, a), a);
+                return 0;
+            }"
+            SEAL_AVX512IFMA_FOUND
+        )
+        check_cxx_source_compiles("
+            #include <wmmintrin.h>
+            int main() {
+                __m128i a = _mm_set1_epi32(1);
+                volatile int res = _mm_cvtsi128_si32(_mm_aesenclast_si128(_mm_aesenc_si128(a, a), a));
+                return 0;
+            }"
+            SEAL_AESNI_FOUND
+        )
+    else()
+        check_cxx_source_compiles("
+            #include <immintrin.h>
+            __attribute__((target(\"avx2\"))) int f() {
+                __m256i a = _mm256_set1_epi64x(1);
+                return _mm256_movemask_epi8(_mm256_mul_epu32(a, a));
+            }
+            int main() {
+                return __builtin_cpu_supports(\"avx2\") ? f() : 0;
+            }"
+            SEAL_AVX2_FOUND
+        )
+        check_cxx_source_compiles("
+            #include <immintrin.h>
+            __attribute__((target(\"avx2,avx512f,avx512dq\"))) int f() {
+                __m512i a = _mm512_set1_epi64(1);
+                return static_cast<int>(_mm512_cmpge_epu64_mask(_mm512_mullo_epi64(a, a), a));
+            }
+            int main() {
+                return __builtin_cpu_supports(\"avx512dq\") ? f() : 0;
+            }"
+            SEAL_AVX512_FOUND
+        )
+        check_cxx_source_compiles("
+            #include <immintrin.h>
+            __attribute__((target(\"avx2,avx512f,avx512dq,avx512ifma\"))) int f() {
+                __m512i a = _mm512_set1_epi64(1);
+                return static_cast<int>(_mm512_cmpge_epu64_mask(_mm512_madd52hi_epu64(a, a, a), a));
+            }
+            int main() {
+                return __builtin_cpu_supports(\"avx512ifma\") ? f() : 0;
+            }"
+            SEAL_AVX512IFMA_FOUND
+        )
+        check_cxx_source_compiles("
+            #include <wmmintrin.h>
+            __attribute__((target(\"aes\"))) int f() {
+                __m128i a = _mm_set1_epi32(1);
+                return _mm_cvtsi128_si32(_mm_aesenclast_si128(_mm_aesenc_si128(a, a), a));
+            }
+            int main() {
+                return __builtin_cpu_supports(\"aes\") ? f() : 0;
+            }"
+            SEAL_AESNI_FOUND
+        )
+    endif()
+
     cmake_pop_check_state()
 endif()
@@ -3,6 +3,8 @@
 
 using Microsoft.Research.SEAL.Tools;
 using System;
+using System.Collections.Generic;
+using System.Linq;
 using System.Runtime.InteropServices;
 
 namespace Microsoft.Research.SEAL
@@ -126,6 +128,28 @@ namespace Microsoft.Research.SEAL
             NativeMethods.Encryptor_SetSecretKey(NativePtr, secretKey.NativePtr);
         }
 
+        /// <summary>
+        /// Gets or sets the number of threads used by EncryptBatch, including the calling thread.
+        /// </summary>
+        /// <remarks>
+        /// With more than one thread, the batch is split into contiguous chunks that are encrypted in parallel by a
+        /// pool of threads owned by this Encryptor. By default only the calling thread is used.
+        /// </remarks>
+        /// <exception cref="ArgumentException">if the value is zero</exception>
+        public ulong ThreadCount
+        {
+            get
+            {
+                NativeMethods.Encryptor_GetThreadCount(NativePtr, out ulong threadCount);
+                return threadCount;
+            }
+
+            set
+            {
+                NativeMethods.Encryptor_SetThreadCount(NativePtr, value);
+            }
+        }
+
         /// <summary>
         /// Encrypts a plaintext with the public key and stores the result in destination.
         /// </summary>
@@ -168,6 +192,50 @@ namespace Microsoft.Research.SEAL
                 NativePtr, plain.NativePtr, destination.NativePtr, poolHandle);
         }
 
+        /// <summary>
+        /// Encrypts a batch of plaintexts with the public key and stores the results in destinations.
+        /// </summary>
+        /// <remarks>
+        /// <para>
+        /// The result is the same as calling Encrypt on every plaintext, but the whole batch is encrypted in one
+        /// native call: all plaintexts are validated up front, every chunk of the batch draws its randomness from a
+        /// single PRNG and reuses one scratch memory pool, and the chunks are encrypted in parallel if ThreadCount is
+        /// greater than one.
+        /// </para>
+        /// <para>
+        /// The encryption parameters for the resulting ciphertexts correspond to:
+        /// 1) in BFV, the highest (data) level in the modulus switching chain,
+        /// 2) in CKKS, the encryption parameters of the plaintexts.
+        /// New ciphertext data is allocated from the memory pool of each destination.
+        /// </para>
+        /// </remarks>
+        /// <param name="plains">The plaintexts to encrypt</param>
+        /// <param name="destinations">The ciphertexts to overwrite with the encrypted plaintexts, one for each
+        /// plaintext</param>
+        /// <exception cref="ArgumentNullException">if either plains or destinations or any of their elements are
+        /// null</exception>
+        /// <exception cref="ArgumentException">if plains and destinations have different sizes</exception>
+        /// <exception cref="InvalidOperationException">if a public key is not set</exception>
+        /// <exception cref="ArgumentException">if any of plains is not valid for the encryption
+        /// parameters</exception>
+        /// <exception cref="ArgumentException">if any of plains is not in default NTT form</exception>
+        public void EncryptBatch(IEnumerable<Plaintext> plains, IEnumerable<Ciphertext> destinations)
+        {
+            if (null == plains)
+                throw new ArgumentNullException(nameof(plains));
+            if (null == destinations)
+                throw new ArgumentNullException(nameof(destinations));
+
+            IntPtr[] plainArray = plains.Select(p => p?.NativePtr ??
+                throw new ArgumentNullException(nameof(plains))).ToArray();
+            IntPtr[] destinationArray = destinations.Select(c => c?.NativePtr ??
+                throw new ArgumentNullException(nameof(destinations))).ToArray();
+            if (plainArray.Length != destinationArray.Length)
+                throw new ArgumentException("plains and destinations must have the same size");
+
+            NativeMethods.Encryptor_EncryptBatch(NativePtr, (ulong)plainArray.Length, plainArray, destinationArray);
+        }
+
         /// <summary>
         /// Encrypts a plaintext with the public key and returns the ciphertext as
         /// a serializable object.
@@ -871,6 +871,15 @@ namespace Microsoft.Research.SEAL
         [DllImport(sealc, PreserveSig = false)]
         internal static extern void Encryptor_Encrypt(IntPtr thisptr, IntPtr plaintext, IntPtr destination, IntPtr poolHandle);
 
+        [DllImport(sealc, PreserveSig = false)]
+        internal static extern void Encryptor_EncryptBatch(IntPtr thisptr, ulong count, IntPtr[] plaintexts, IntPtr[] destinations);
+
+        [DllImport(sealc, PreserveSig = false)]
+        internal static extern void Encryptor_SetThreadCount(IntPtr thisptr, ulong threadCount);
+
+        [DllImport(sealc, PreserveSig = false)]
+        internal static extern void Encryptor_GetThreadCount(IntPtr thisptr, out ulong threadCount);
+
         [DllImport(sealc, PreserveSig = false)]
         internal static extern void Encryptor_EncryptZero1(IntPtr thisptr, ulong[] parmsId, IntPtr destination, IntPtr poolHandle);
 
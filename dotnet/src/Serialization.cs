@@ -25,7 +25,15 @@ namespace Microsoft.Research.SEAL
         ZLIB = 1,
 
         /// <summary>Use Zstandard compression.</summary>
-        ZSTD = 2
+        ZSTD = 2,
+
+        /// <summary>
+        /// Store the coefficients of Ciphertext, Plaintext, SecretKey, PublicKey,
+        /// RelinKeys, and GaloisKeys data with only as many bits as the largest
+        /// coefficient in each RNS component needs. Other objects are saved without
+        /// compression in this mode.
+        /// </summary>
+        Bitpack = 3
     }
 
     /// <summary>Class to provide functionality for serialization.</summary>
@@ -360,6 +360,42 @@ namespace SEALNetTest
             }
         }
 
+        [TestMethod]
+        public void EncryptBatchTest()
+        {
+            SEALContext context = GlobalContext.BFVContext;
+            KeyGenerator keygen = new KeyGenerator(context);
+            keygen.CreatePublicKey(out PublicKey publicKey);
+            Encryptor encryptor = new Encryptor(context, publicKey);
+            Decryptor decryptor = new Decryptor(context, keygen.SecretKey);
+
+            Assert.AreEqual(1ul, encryptor.ThreadCount);
+            encryptor.ThreadCount = 3;
+            Assert.AreEqual(3ul, encryptor.ThreadCount);
+
+            List<Plaintext> plains = new List<Plaintext>();
+            List<Ciphertext> ciphers = new List<Ciphertext>();
+            for (int i = 1; i <= 5; i++)
+            {
+                plains.Add(new Plaintext($"{i}x^{i} + {i}"));
+                ciphers.Add(new Ciphertext());
+            }
+
+            encryptor.EncryptBatch(plains, ciphers);
+            for (int i = 0; i < plains.Count; i++)
+            {
+                Assert.AreEqual(2ul, ciphers[i].Size);
+                Plaintext plain = new Plaintext();
+                decryptor.Decrypt(ciphers[i], plain);
+                Assert.AreEqual(plains[i].ToString(), plain.ToString());
+            }
+
+            Utilities.AssertThrows<ArgumentNullException>(() => encryptor.EncryptBatch(null, ciphers));
+            Utilities.AssertThrows<ArgumentNullException>(() => encryptor.EncryptBatch(plains, null));
+            Utilities.AssertThrows<ArgumentException>(() => encryptor.EncryptBatch(plains, ciphers.GetRange(0, 4)));
+            Utilities.AssertThrows<ArgumentException>(() => { encryptor.ThreadCount = 0; });
+        }
+
         [TestMethod]
         public void ExceptionsTest()
         {
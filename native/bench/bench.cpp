@@ -2,8 +2,11 @@
 // Licensed under the MIT license.
 
 #include "seal/seal.h"
+#include "seal/util/cpufeatures.h"
 #include "bench.h"
+#include <algorithm>
 #include <iomanip>
+#include <thread>
 
 using namespace benchmark;
 using namespace seal;
@@ -25,6 +28,18 @@ namespace sealbench
         ->Unit(benchmark::kMicrosecond)                                                                               \
         ->Iterations(10);
 
+    /**
+    Same as SEAL_BENCHMARK_REGISTER but appends a std::string suffix to the name.
+    */
+#define SEAL_BENCHMARK_REGISTER_SUFFIX(category, n, log_q, name, suffix, func, ...)                                   \
+    RegisterBenchmark(                                                                                                \
+        (string("n=") + to_string(n) + string(" / log(q)=") + to_string(log_q) +                                      \
+         string(" / " #category " / " #name) + suffix)                                                                \
+            .c_str(),                                                                                                 \
+        [=](State &st) { func(st, __VA_ARGS__); })                                                                    \
+        ->Unit(benchmark::kMicrosecond)                                                                               \
+        ->Iterations(10);
+
     void register_bm_family(
         const pair<size_t, vector<Modulus>> &parms, unordered_map<EncryptionParameters, shared_ptr<BMEnv>> &bm_env_map)
     {
@@ -69,6 +84,19 @@ namespace sealbench
         SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateMulCt, bm_bfv_mul_ct, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateMulPt, bm_bfv_mul_pt, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateSquare, bm_bfv_square, bm_env_bfv);
+
+        // BEHZ and HPS multiplication side by side
+        if (bm_env_bfv->context().first_context_data()->rns_tool()->hps_supported())
+        {
+            SEAL_BENCHMARK_REGISTER_SUFFIX(
+                BFV, n, log_q, EvaluateMulCt, " / BEHZ", bm_bfv_mul_ct_method, bm_env_bfv, bfv_mul_type::behz);
+            SEAL_BENCHMARK_REGISTER_SUFFIX(
+                BFV, n, log_q, EvaluateMulCt, " / HPS", bm_bfv_mul_ct_method, bm_env_bfv, bfv_mul_type::hps);
+            SEAL_BENCHMARK_REGISTER_SUFFIX(
+                BFV, n, log_q, EvaluateSquare, " / BEHZ", bm_bfv_square_method, bm_env_bfv, bfv_mul_type::behz);
+            SEAL_BENCHMARK_REGISTER_SUFFIX(
+                BFV, n, log_q, EvaluateSquare, " / HPS", bm_bfv_square_method, bm_env_bfv, bfv_mul_type::hps);
+        }
         if (bm_env_bfv->context().first_context_data()->parms().coeff_modulus().size() > 1)
         {
             SEAL_BENCHMARK_REGISTER(BFV, n, log_q, EvaluateModSwitchInplace, bm_bfv_modswitch_inplace, bm_env_bfv);
@@ -85,6 +113,8 @@ namespace sealbench
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, Decrypt, bm_ckks_decrypt, bm_env_ckks);
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EncodeDouble, bm_ckks_encode_double, bm_env_ckks);
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, DecodeDouble, bm_ckks_decode_double, bm_env_ckks);
+        SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EncodeComplex, bm_ckks_encode_complex, bm_env_ckks);
+        SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, DecodeComplex, bm_ckks_decode_complex, bm_env_ckks);
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EvaluateAddCt, bm_ckks_add_ct, bm_env_ckks);
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EvaluateAddPt, bm_ckks_add_pt, bm_env_ckks);
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EvaluateNegate, bm_ckks_negate, bm_env_ckks);
@@ -92,6 +122,10 @@ namespace sealbench
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EvaluateSubPt, bm_ckks_sub_pt, bm_env_ckks);
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EvaluateMulCt, bm_ckks_mul_ct, bm_env_ckks);
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EvaluateMulPt, bm_ckks_mul_pt, bm_env_ckks);
+        SEAL_BENCHMARK_REGISTER_SUFFIX(
+            CKKS, n, log_q, EvaluateMulConst, " / encode", bm_ckks_mul_const, bm_env_ckks, true);
+        SEAL_BENCHMARK_REGISTER_SUFFIX(
+            CKKS, n, log_q, EvaluateMulConst, " / scalar", bm_ckks_mul_const, bm_env_ckks, false);
         SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EvaluateSquare, bm_ckks_square, bm_env_ckks);
         if (bm_env_bfv->context().first_context_data()->parms().coeff_modulus().size() > 1)
         {
@@ -101,6 +135,35 @@ namespace sealbench
         {
             SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EvaluateRelinInplace, bm_ckks_relin_inplace, bm_env_ckks);
             SEAL_BENCHMARK_REGISTER(CKKS, n, log_q, EvaluateRotate, bm_ckks_rotate, bm_env_ckks);
+            if (bm_env_ckks->context().first_context_data()->parms().coeff_modulus().size() > 1)
+            {
+                SEAL_BENCHMARK_REGISTER_SUFFIX(
+                    CKKS, n, log_q, EvaluateMulRelinRescale, " / sequential", bm_ckks_mul_relin_rescale, bm_env_ckks,
+                    false);
+                SEAL_BENCHMARK_REGISTER_SUFFIX(
+                    CKKS, n, log_q, EvaluateMulRelinRescale, " / fused", bm_ckks_mul_relin_rescale, bm_env_ckks, true);
+                SEAL_BENCHMARK_REGISTER_SUFFIX(
+                    CKKS, n, log_q, EvaluateInnerProduct, " / terms=8 / relin each", bm_ckks_inner_product, bm_env_ckks,
+                    false);
+                SEAL_BENCHMARK_REGISTER_SUFFIX(
+                    CKKS, n, log_q, EvaluateInnerProduct, " / terms=8 / lazy relin", bm_ckks_inner_product, bm_env_ckks,
+                    true);
+            }
+
+            // Scaling of multithreaded key switching with 1, 2, 4, ... threads
+            size_t max_thread_count = max(size_t(thread::hardware_concurrency()), size_t(1));
+            for (size_t thread_count = 1; thread_count <= max_thread_count; thread_count <<= 1)
+            {
+                string threads = string(" / threads=") + to_string(thread_count);
+                SEAL_BENCHMARK_REGISTER_SUFFIX(
+                    CKKS, n, log_q, EvaluateRelinInplace, threads, bm_ckks_relin_inplace_threads, bm_env_ckks,
+                    thread_count);
+                SEAL_BENCHMARK_REGISTER_SUFFIX(
+                    CKKS, n, log_q, EvaluateRotate, threads, bm_ckks_rotate_threads, bm_env_ckks, thread_count);
+                SEAL_BENCHMARK_REGISTER_SUFFIX(
+                    CKKS, n, log_q, EncryptPublicBatch, threads + " / batch=16", bm_ckks_encrypt_public_batch,
+                    bm_env_ckks, thread_count);
+            }
         }
         SEAL_BENCHMARK_REGISTER(UTIL, n, log_q, NTTForward, bm_util_ntt_forward, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(UTIL, n, log_q, NTTInverse, bm_util_ntt_inverse, bm_env_bfv);
@@ -108,6 +171,64 @@ namespace sealbench
         SEAL_BENCHMARK_REGISTER(UTIL, n, 0, NTTInverseLowLevel, bm_util_ntt_inverse_low_level, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(UTIL, n, 0, NTTForwardLowLevelLazy, bm_util_ntt_forward_low_level_lazy, bm_env_bfv);
         SEAL_BENCHMARK_REGISTER(UTIL, n, 0, NTTInverseLowLevelLazy, bm_util_ntt_inverse_low_level_lazy, bm_env_bfv);
+        SEAL_BENCHMARK_REGISTER(
+            UTIL, n, 0, NTTForwardLowLevelLazyScalar, bm_util_ntt_forward_low_level_lazy_backend, bm_env_bfv,
+            NTTBackend::scalar);
+        SEAL_BENCHMARK_REGISTER(
+            UTIL, n, 0, NTTInverseLowLevelLazyScalar, bm_util_ntt_inverse_low_level_lazy_backend, bm_env_bfv,
+            NTTBackend::scalar);
+        if (seal::util::cpu_has_avx2())
+        {
+            SEAL_BENCHMARK_REGISTER(
+                UTIL, n, 0, NTTForwardLowLevelLazyAVX2, bm_util_ntt_forward_low_level_lazy_backend, bm_env_bfv,
+                NTTBackend::avx2);
+            SEAL_BENCHMARK_REGISTER(
+                UTIL, n, 0, NTTInverseLowLevelLazyAVX2, bm_util_ntt_inverse_low_level_lazy_backend, bm_env_bfv,
+                NTTBackend::avx2);
+        }
+        if (seal::util::cpu_has_avx512())
+        {
+            SEAL_BENCHMARK_REGISTER(
+                UTIL, n, 0, NTTForwardLowLevelLazyAVX512, bm_util_ntt_forward_low_level_lazy_backend, bm_env_bfv,
+                NTTBackend::avx512);
+            SEAL_BENCHMARK_REGISTER(
+                UTIL, n, 0, NTTInverseLowLevelLazyAVX512, bm_util_ntt_inverse_low_level_lazy_backend, bm_env_bfv,
+                NTTBackend::avx512);
+        }
+
+        // Base conversion with 61-bit moduli (AVX-512F/DQ kernel) and with moduli small enough for the IFMA kernel
+        SEAL_BENCHMARK_REGISTER(UTIL, n, 0, FastConvertArray60To61Bit, bm_util_fast_convert_array, bm_env_bfv, 60, 61);
+        SEAL_BENCHMARK_REGISTER(UTIL, n, 0, FastConvertArray45To50Bit, bm_util_fast_convert_array, bm_env_bfv, 45, 50);
+
+        // Throughput of memory pool allocations with 1, 2, 4, ... threads
+        size_t max_thread_count = max(size_t(thread::hardware_concurrency()), size_t(1));
+        for (size_t thread_count = 1; thread_count <= max_thread_count; thread_count <<= 1)
+        {
+            string threads = string(" / threads=") + to_string(thread_count);
+            SEAL_BENCHMARK_REGISTER_SUFFIX(
+                UTIL, n, 0, MemoryPoolAllocFreeMT, threads, bm_util_mempool_alloc_free, bm_env_bfv, MemoryPoolKind::mt,
+                thread_count);
+            SEAL_BENCHMARK_REGISTER_SUFFIX(
+                UTIL, n, 0, MemoryPoolAllocFreeThreadCaching, threads, bm_util_mempool_alloc_free, bm_env_bfv,
+                MemoryPoolKind::thread_caching, thread_count);
+        }
+
+        // Throughput of the PRNGs, directly and through uniform sampling modulo the coefficient modulus
+        vector<pair<string, shared_ptr<UniformRandomGeneratorFactory>>> prng_factories = {
+            { " / Blake2xb", make_shared<Blake2xbPRNGFactory>() },
+            { " / Shake256", make_shared<Shake256PRNGFactory>() },
+            { " / AES256CTR", make_shared<AES256CTRPRNGFactory>() }
+        };
+        for (auto &prng_factory : prng_factories)
+        {
+            SEAL_BENCHMARK_REGISTER_SUFFIX(
+                UTIL, n, log_q, PRNGGenerate, prng_factory.first, bm_util_prng_generate, bm_env_bfv,
+                prng_factory.second);
+            SEAL_BENCHMARK_REGISTER_SUFFIX(
+                UTIL, n, log_q, SampleUniform, prng_factory.first, bm_util_sample_uniform, bm_env_bfv,
+                prng_factory.second);
+        }
+        SEAL_BENCHMARK_REGISTER(UTIL, n, log_q, AES256CTRPortable, bm_util_aes256_ctr_portable, bm_env_bfv);
     }
 
 } // namespace sealbench
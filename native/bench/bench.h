@@ -331,6 +331,40 @@ namespace sealbench
     void bm_util_ntt_forward_low_level_lazy(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_util_ntt_inverse_low_level_lazy(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
 
+    // Backends of the lazy NTT that can be benchmarked against each other
+    enum class NTTBackend
+    {
+        scalar,
+        avx2,
+        avx512
+    };
+    void bm_util_ntt_forward_low_level_lazy_backend(
+        benchmark::State &state, std::shared_ptr<BMEnv> bm_env, NTTBackend backend);
+    void bm_util_ntt_inverse_low_level_lazy_backend(
+        benchmark::State &state, std::shared_ptr<BMEnv> bm_env, NTTBackend backend);
+
+    // RNS benchmark cases
+    void bm_util_fast_convert_array(
+        benchmark::State &state, std::shared_ptr<BMEnv> bm_env, int ibase_bit_count, int obase_bit_count);
+
+    // Memory pool benchmark cases
+    enum class MemoryPoolKind
+    {
+        mt,
+        thread_caching
+    };
+    void bm_util_mempool_alloc_free(
+        benchmark::State &state, std::shared_ptr<BMEnv> bm_env, MemoryPoolKind kind, std::size_t thread_count);
+
+    // PRNG benchmark cases
+    void bm_util_prng_generate(
+        benchmark::State &state, std::shared_ptr<BMEnv> bm_env,
+        std::shared_ptr<seal::UniformRandomGeneratorFactory> factory);
+    void bm_util_aes256_ctr_portable(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_util_sample_uniform(
+        benchmark::State &state, std::shared_ptr<BMEnv> bm_env,
+        std::shared_ptr<seal::UniformRandomGeneratorFactory> factory);
+
     // KeyGen benchmark cases
     void bm_keygen_secret(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_keygen_public(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
@@ -349,8 +383,10 @@ namespace sealbench
     void bm_bfv_sub_ct(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_sub_pt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_mul_ct(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_bfv_mul_ct_method(benchmark::State &state, std::shared_ptr<BMEnv> bm_env, seal::bfv_mul_type mul_type);
     void bm_bfv_mul_pt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_square(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_bfv_square_method(benchmark::State &state, std::shared_ptr<BMEnv> bm_env, seal::bfv_mul_type mul_type);
     void bm_bfv_modswitch_inplace(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_relin_inplace(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_bfv_rotate_rows(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
@@ -359,9 +395,13 @@ namespace sealbench
     // CKKS-specific benchmark cases
     void bm_ckks_encrypt_secret(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_encrypt_public(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_ckks_encrypt_public_batch(
+        benchmark::State &state, std::shared_ptr<BMEnv> bm_env, std::size_t thread_count);
     void bm_ckks_decrypt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_encode_double(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_decode_double(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_ckks_encode_complex(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_ckks_decode_complex(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_add_ct(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_add_pt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_negate(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
@@ -369,8 +409,14 @@ namespace sealbench
     void bm_ckks_sub_pt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_mul_ct(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_mul_pt(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_ckks_mul_const(benchmark::State &state, std::shared_ptr<BMEnv> bm_env, bool encode);
     void bm_ckks_square(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_rescale_inplace(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
     void bm_ckks_relin_inplace(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_ckks_mul_relin_rescale(benchmark::State &state, std::shared_ptr<BMEnv> bm_env, bool fused);
+    void bm_ckks_inner_product(benchmark::State &state, std::shared_ptr<BMEnv> bm_env, bool lazy);
+    void bm_ckks_relin_inplace_threads(
+        benchmark::State &state, std::shared_ptr<BMEnv> bm_env, std::size_t thread_count);
     void bm_ckks_rotate(benchmark::State &state, std::shared_ptr<BMEnv> bm_env);
+    void bm_ckks_rotate_threads(benchmark::State &state, std::shared_ptr<BMEnv> bm_env, std::size_t thread_count);
 } // namespace sealbench
@@ -171,6 +171,22 @@ namespace sealbench
         }
     }
 
+    void bm_bfv_mul_ct_method(State &state, shared_ptr<BMEnv> bm_env, bfv_mul_type mul_type)
+    {
+        Evaluator evaluator(bm_env->context());
+        evaluator.set_bfv_mul(mul_type);
+        vector<Ciphertext> &ct = bm_env->ct();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_bfv(ct[0]);
+            bm_env->randomize_ct_bfv(ct[1]);
+
+            state.ResumeTiming();
+            evaluator.multiply(ct[0], ct[1], ct[2]);
+        }
+    }
+
     void bm_bfv_mul_pt(State &state, shared_ptr<BMEnv> bm_env)
     {
         vector<Ciphertext> &ct = bm_env->ct();
@@ -200,6 +216,21 @@ namespace sealbench
         }
     }
 
+    void bm_bfv_square_method(State &state, shared_ptr<BMEnv> bm_env, bfv_mul_type mul_type)
+    {
+        Evaluator evaluator(bm_env->context());
+        evaluator.set_bfv_mul(mul_type);
+        vector<Ciphertext> &ct = bm_env->ct();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_bfv(ct[0]);
+
+            state.ResumeTiming();
+            evaluator.square(ct[0], ct[2]);
+        }
+    }
+
     void bm_bfv_modswitch_inplace(State &state, shared_ptr<BMEnv> bm_env)
     {
         vector<Ciphertext> &ct = bm_env->ct();
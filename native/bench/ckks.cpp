@@ -44,6 +44,25 @@ namespace sealbench
         }
     }
 
+    void bm_ckks_encrypt_public_batch(State &state, shared_ptr<BMEnv> bm_env, size_t thread_count)
+    {
+        Encryptor encryptor(bm_env->context(), bm_env->pk());
+        encryptor.set_thread_count(thread_count);
+        vector<Plaintext> pt(16);
+        vector<Ciphertext> ct;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            for (auto &p : pt)
+            {
+                bm_env->randomize_pt_ckks(p);
+            }
+
+            state.ResumeTiming();
+            encryptor.encrypt_batch(pt, ct);
+        }
+    }
+
     void bm_ckks_decrypt(State &state, shared_ptr<BMEnv> bm_env)
     {
         vector<Ciphertext> &ct = bm_env->ct();
@@ -88,6 +107,38 @@ namespace sealbench
         }
     }
 
+    void bm_ckks_encode_complex(State &state, shared_ptr<BMEnv> bm_env)
+    {
+        vector<double> &msg_double = bm_env->msg_double();
+        vector<complex<double>> msg;
+        Plaintext &pt = bm_env->pt()[0];
+        parms_id_type parms_id = bm_env->context().first_parms_id();
+        double scale = bm_env->safe_scale();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_message_double(msg_double);
+            msg.assign(msg_double.begin(), msg_double.end());
+
+            state.ResumeTiming();
+            bm_env->ckks_encoder()->encode(msg, parms_id, scale, pt);
+        }
+    }
+
+    void bm_ckks_decode_complex(State &state, shared_ptr<BMEnv> bm_env)
+    {
+        vector<complex<double>> msg;
+        Plaintext &pt = bm_env->pt()[0];
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_pt_ckks(pt);
+
+            state.ResumeTiming();
+            bm_env->ckks_encoder()->decode(pt, msg);
+        }
+    }
+
     void bm_ckks_add_ct(State &state, shared_ptr<BMEnv> bm_env)
     {
         vector<Ciphertext> &ct = bm_env->ct();
@@ -208,6 +259,30 @@ namespace sealbench
         }
     }
 
+    void bm_ckks_mul_const(State &state, shared_ptr<BMEnv> bm_env, bool encode)
+    {
+        vector<Ciphertext> &ct = bm_env->ct();
+        Plaintext &pt = bm_env->pt()[0];
+        double scale = bm_env->safe_scale();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_ckks(ct[0]);
+            ct[0].scale() = scale;
+
+            state.ResumeTiming();
+            if (encode)
+            {
+                bm_env->ckks_encoder()->encode(1.5, ct[0].parms_id(), scale, pt);
+                bm_env->evaluator()->multiply_plain(ct[0], pt, ct[2]);
+            }
+            else
+            {
+                bm_env->evaluator()->multiply_const(ct[0], 1.5, scale, ct[2]);
+            }
+        }
+    }
+
     void bm_ckks_square(State &state, shared_ptr<BMEnv> bm_env)
     {
         vector<Ciphertext> &ct = bm_env->ct();
@@ -240,6 +315,67 @@ namespace sealbench
         }
     }
 
+    void bm_ckks_mul_relin_rescale(State &state, shared_ptr<BMEnv> bm_env, bool fused)
+    {
+        vector<Ciphertext> &ct = bm_env->ct();
+        double scale = bm_env->safe_scale();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_ckks(ct[0]);
+            ct[0].scale() = scale;
+            bm_env->randomize_ct_ckks(ct[1]);
+            ct[1].scale() = scale;
+
+            state.ResumeTiming();
+            if (fused)
+            {
+                bm_env->evaluator()->multiply_relin_rescale(ct[0], ct[1], bm_env->rlk(), ct[2]);
+            }
+            else
+            {
+                bm_env->evaluator()->multiply(ct[0], ct[1], ct[2]);
+                bm_env->evaluator()->relinearize_inplace(ct[2], bm_env->rlk());
+                bm_env->evaluator()->rescale_to_next_inplace(ct[2]);
+            }
+        }
+    }
+
+    void bm_ckks_inner_product(State &state, shared_ptr<BMEnv> bm_env, bool lazy)
+    {
+        vector<Ciphertext> &ct = bm_env->ct();
+        double scale = bm_env->safe_scale();
+        vector<Ciphertext> ct1(8, ct[0]);
+        vector<Ciphertext> ct2(8, ct[1]);
+        Ciphertext product;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            for (size_t i = 0; i < ct1.size(); i++)
+            {
+                bm_env->randomize_ct_ckks(ct1[i]);
+                ct1[i].scale() = scale;
+                bm_env->randomize_ct_ckks(ct2[i]);
+                ct2[i].scale() = scale;
+            }
+
+            state.ResumeTiming();
+            if (lazy)
+            {
+                bm_env->evaluator()->inner_product(ct1, ct2, bm_env->rlk(), ct[2]);
+            }
+            else
+            {
+                bm_env->evaluator()->multiply_relin_rescale(ct1[0], ct2[0], bm_env->rlk(), ct[2]);
+                for (size_t i = 1; i < ct1.size(); i++)
+                {
+                    bm_env->evaluator()->multiply_relin_rescale(ct1[i], ct2[i], bm_env->rlk(), product);
+                    bm_env->evaluator()->add_inplace(ct[2], product);
+                }
+            }
+        }
+    }
+
     void bm_ckks_relin_inplace(State &state, shared_ptr<BMEnv> bm_env)
     {
         Ciphertext ct;
@@ -254,6 +390,22 @@ namespace sealbench
         }
     }
 
+    void bm_ckks_relin_inplace_threads(State &state, shared_ptr<BMEnv> bm_env, size_t thread_count)
+    {
+        Evaluator evaluator(bm_env->context());
+        evaluator.set_thread_count(thread_count);
+        Ciphertext ct;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            ct.resize(bm_env->context(), size_t(3));
+            bm_env->randomize_ct_ckks(ct);
+
+            state.ResumeTiming();
+            evaluator.relinearize_inplace(ct, bm_env->rlk());
+        }
+    }
+
     void bm_ckks_rotate(State &state, shared_ptr<BMEnv> bm_env)
     {
         vector<Ciphertext> &ct = bm_env->ct();
@@ -266,4 +418,19 @@ namespace sealbench
             bm_env->evaluator()->rotate_vector(ct[0], 1, bm_env->glk(), ct[2]);
         }
     }
+
+    void bm_ckks_rotate_threads(State &state, shared_ptr<BMEnv> bm_env, size_t thread_count)
+    {
+        Evaluator evaluator(bm_env->context());
+        evaluator.set_thread_count(thread_count);
+        vector<Ciphertext> &ct = bm_env->ct();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_ckks(ct[0]);
+
+            state.ResumeTiming();
+            evaluator.rotate_vector(ct[0], 1, bm_env->glk(), ct[2]);
+        }
+    }
 } // namespace sealbench
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/seal.h"
+#include "seal/util/pointer.h"
+#include "bench.h"
+#include <thread>
+
+using namespace benchmark;
+using namespace sealbench;
+using namespace seal;
+using namespace std;
+
+/**
+This file defines benchmarks for the memory pools.
+*/
+
+namespace sealbench
+{
+    void bm_util_mempool_alloc_free(State &state, shared_ptr<BMEnv> bm_env, MemoryPoolKind kind, size_t thread_count)
+    {
+        // Allocations of one and two RNS components, as in the temporaries of most evaluator functions
+        size_t coeff_count = bm_env->parms().poly_modulus_degree();
+        size_t pair_count = 4096;
+        MemoryPoolHandle pool =
+            (kind == MemoryPoolKind::thread_caching) ? MemoryPoolHandle::NewThreadCaching() : MemoryPoolHandle::New();
+
+        auto alloc_free = [&]() {
+            for (size_t i = 0; i < pair_count; i++)
+            {
+                auto small = util::allocate_uint(coeff_count, pool);
+                auto large = util::allocate_uint(coeff_count * 2, pool);
+                DoNotOptimize(small.get());
+                DoNotOptimize(large.get());
+            }
+        };
+
+        vector<thread> threads;
+        for (auto _ : state)
+        {
+            threads.clear();
+            for (size_t t = 0; t < thread_count; t++)
+            {
+                threads.emplace_back(alloc_free);
+            }
+            for (auto &th : threads)
+            {
+                th.join();
+            }
+        }
+        state.SetItemsProcessed(
+            static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(pair_count * 2 * thread_count));
+    }
+} // namespace sealbench
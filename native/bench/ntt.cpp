@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 #include "seal/seal.h"
+#include "seal/util/nttavx.h"
 #include "seal/util/rlwe.h"
 #include "bench.h"
 
@@ -106,4 +107,82 @@ namespace sealbench
             inverse_ntt_negacyclic_harvey_lazy(ct[0].data(), small_ntt_tables[0]);
         }
     }
+
+    namespace
+    {
+        void ntt_forward_lazy_backend(util::CoeffIter operand, const util::NTTTables &tables, NTTBackend backend)
+        {
+            switch (backend)
+            {
+#ifdef SEAL_USE_AVX2
+            case NTTBackend::avx2:
+                util::ntt_negacyclic_harvey_lazy_avx2(operand, tables);
+                break;
+#endif
+#ifdef SEAL_USE_AVX512
+            case NTTBackend::avx512:
+                util::ntt_negacyclic_harvey_lazy_avx512(operand, tables);
+                break;
+#endif
+            default:
+                tables.ntt_handler().transform_to_rev(
+                    operand.ptr(), tables.coeff_count_power(), tables.get_from_root_powers());
+                break;
+            }
+        }
+
+        void ntt_inverse_lazy_backend(util::CoeffIter operand, const util::NTTTables &tables, NTTBackend backend)
+        {
+            switch (backend)
+            {
+#ifdef SEAL_USE_AVX2
+            case NTTBackend::avx2:
+                util::inverse_ntt_negacyclic_harvey_lazy_avx2(operand, tables);
+                break;
+#endif
+#ifdef SEAL_USE_AVX512
+            case NTTBackend::avx512:
+                util::inverse_ntt_negacyclic_harvey_lazy_avx512(operand, tables);
+                break;
+#endif
+            default:
+                util::MultiplyUIntModOperand inv_degree_modulo = tables.inv_degree_modulo();
+                tables.ntt_handler().transform_from_rev(
+                    operand.ptr(), tables.coeff_count_power(), tables.get_from_inv_root_powers(), &inv_degree_modulo);
+                break;
+            }
+        }
+    } // namespace
+
+    void bm_util_ntt_forward_low_level_lazy_backend(State &state, shared_ptr<BMEnv> bm_env, NTTBackend backend)
+    {
+        parms_id_type parms_id = bm_env->context().first_parms_id();
+        auto context_data = bm_env->context().get_context_data(parms_id);
+        const auto &small_ntt_tables = context_data->small_ntt_tables();
+        vector<Ciphertext> &ct = bm_env->ct();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_bfv(ct[0]);
+
+            state.ResumeTiming();
+            ntt_forward_lazy_backend(ct[0].data(), small_ntt_tables[0], backend);
+        }
+    }
+
+    void bm_util_ntt_inverse_low_level_lazy_backend(State &state, shared_ptr<BMEnv> bm_env, NTTBackend backend)
+    {
+        parms_id_type parms_id = bm_env->context().first_parms_id();
+        auto context_data = bm_env->context().get_context_data(parms_id);
+        const auto &small_ntt_tables = context_data->small_ntt_tables();
+        vector<Ciphertext> &ct = bm_env->ct();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            bm_env->randomize_ct_bfv(ct[0]);
+
+            state.ResumeTiming();
+            ntt_inverse_lazy_backend(ct[0].data(), small_ntt_tables[0], backend);
+        }
+    }
 } // namespace sealbench
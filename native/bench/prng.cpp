@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/seal.h"
+#include "seal/util/aes.h"
+#include "seal/util/rlwe.h"
+#include "bench.h"
+#include <array>
+#include <vector>
+
+using namespace benchmark;
+using namespace sealbench;
+using namespace seal;
+using namespace std;
+
+/**
+This file defines benchmarks for the pseudo-random number generators.
+*/
+
+namespace sealbench
+{
+    void bm_util_prng_generate(
+        State &state, shared_ptr<BMEnv> bm_env, shared_ptr<UniformRandomGeneratorFactory> factory)
+    {
+        // As much randomness as a uniformly random polynomial in the first encryption level takes
+        auto &parms = bm_env->parms();
+        size_t byte_count = parms.poly_modulus_degree() * parms.coeff_modulus().size() * sizeof(uint64_t);
+        vector<seal_byte> buffer(byte_count);
+        auto prng = factory->create();
+        for (auto _ : state)
+        {
+            prng->generate(byte_count, buffer.data());
+            DoNotOptimize(buffer.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * byte_count));
+    }
+
+    void bm_util_aes256_ctr_portable(State &state, shared_ptr<BMEnv> bm_env)
+    {
+        auto &parms = bm_env->parms();
+        size_t block_count =
+            parms.poly_modulus_degree() * parms.coeff_modulus().size() * sizeof(uint64_t) / util::aes_block_byte_count;
+        vector<seal_byte> buffer(block_count * util::aes_block_byte_count);
+        array<uint8_t, util::aes256_key_byte_count> key{};
+        array<uint8_t, util::aes256_round_key_byte_count> round_keys;
+        util::aes256_expand_key(key.data(), round_keys.data());
+        uint64_t counter = 0;
+        for (auto _ : state)
+        {
+            util::aes256_ctr_keystream_portable(round_keys.data(), 0, counter, block_count, buffer.data());
+            counter += block_count;
+            DoNotOptimize(buffer.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+    }
+
+    void bm_util_sample_uniform(
+        State &state, shared_ptr<BMEnv> bm_env, shared_ptr<UniformRandomGeneratorFactory> factory)
+    {
+        auto &parms = bm_env->parms();
+        vector<uint64_t> poly(parms.poly_modulus_degree() * parms.coeff_modulus().size());
+        auto prng = factory->create();
+        for (auto _ : state)
+        {
+            util::sample_poly_uniform(prng, parms, poly.data());
+            DoNotOptimize(poly.data());
+        }
+    }
+} // namespace sealbench
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/seal.h"
+#include "seal/util/numth.h"
+#include "seal/util/rns.h"
+#include "bench.h"
+
+using namespace benchmark;
+using namespace sealbench;
+using namespace seal;
+using namespace std;
+
+/**
+This file defines benchmarks for RNS base conversion.
+*/
+
+namespace sealbench
+{
+    void bm_util_fast_convert_array(State &state, shared_ptr<BMEnv> bm_env, int ibase_bit_count, int obase_bit_count)
+    {
+        // Convert from a base as large as the coefficient modulus to a base with one more prime, as is done when
+        // extending to the auxiliary base in BFV multiplication; the bit counts must differ so the bases are coprime
+        size_t n = bm_env->parms().poly_modulus_degree();
+        size_t ibase_size = bm_env->parms().coeff_modulus().size();
+        auto pool = seal::MemoryManager::GetPool();
+        vector<Modulus> ibase = util::get_primes(n, ibase_bit_count, ibase_size);
+        vector<Modulus> obase = util::get_primes(n, obase_bit_count, ibase_size + 1);
+        util::BaseConverter conv(util::RNSBase(ibase, pool), util::RNSBase(obase, pool), pool);
+
+        vector<uint64_t> in(ibase_size * n);
+        vector<uint64_t> out(obase.size() * n);
+        for (size_t i = 0; i < ibase_size; i++)
+        {
+            bm_env->randomize_array_mod(in.data() + i * n, n, ibase[i]);
+        }
+
+        for (auto _ : state)
+        {
+            conv.fast_convert_array(util::ConstRNSIter(in.data(), n), util::RNSIter(out.data(), n), pool);
+        }
+    }
+} // namespace sealbench
@@ -32,6 +32,12 @@ using ph = struct seal::Encryptor::EncryptorPrivateHelper
     {
         encryptor->encrypt_zero_internal(encryptor->context_.first_parms_id(), false, save_seed, destination, pool);
     }
+
+    static void encrypt_batch_internal(
+        Encryptor *encryptor, const Plaintext *const *plains, Ciphertext *const *destinations, size_t count)
+    {
+        encryptor->encrypt_batch_internal(plains, destinations, count);
+    }
 };
 
 SEAL_C_FUNC Encryptor_Create(void *context, void *public_key, void *secret_key, void **encryptor)
@@ -131,6 +137,63 @@ SEAL_C_FUNC Encryptor_Encrypt(void *thisptr, void *plaintext, void *destination,
     }
 }
 
+SEAL_C_FUNC Encryptor_EncryptBatch(void *thisptr, uint64_t count, void **plaintexts, void **destinations)
+{
+    Encryptor *encryptor = FromVoid<Encryptor>(thisptr);
+    IfNullRet(encryptor, E_POINTER);
+    IfNullRet(plaintexts, E_POINTER);
+    IfNullRet(destinations, E_POINTER);
+
+    // The ciphertexts are encrypted in place without copying the batch
+    Plaintext **plains = reinterpret_cast<Plaintext **>(plaintexts);
+    Ciphertext **ciphers = reinterpret_cast<Ciphertext **>(destinations);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        IfNullRet(plains[i], E_POINTER);
+        IfNullRet(ciphers[i], E_POINTER);
+    }
+
+    try
+    {
+        ph::encrypt_batch_internal(encryptor, plains, ciphers, static_cast<size_t>(count));
+        return S_OK;
+    }
+    catch (const invalid_argument &)
+    {
+        return E_INVALIDARG;
+    }
+    catch (const logic_error &)
+    {
+        return COR_E_INVALIDOPERATION;
+    }
+}
+
+SEAL_C_FUNC Encryptor_SetThreadCount(void *thisptr, uint64_t thread_count)
+{
+    Encryptor *encryptor = FromVoid<Encryptor>(thisptr);
+    IfNullRet(encryptor, E_POINTER);
+
+    try
+    {
+        encryptor->set_thread_count(static_cast<size_t>(thread_count));
+        return S_OK;
+    }
+    catch (const invalid_argument &)
+    {
+        return E_INVALIDARG;
+    }
+}
+
+SEAL_C_FUNC Encryptor_GetThreadCount(void *thisptr, uint64_t *thread_count)
+{
+    Encryptor *encryptor = FromVoid<Encryptor>(thisptr);
+    IfNullRet(encryptor, E_POINTER);
+    IfNullRet(thread_count, E_POINTER);
+
+    *thread_count = static_cast<uint64_t>(encryptor->thread_count());
+    return S_OK;
+}
+
 SEAL_C_FUNC Encryptor_EncryptZero1(void *thisptr, uint64_t *parms_id, void *destination, void *pool_handle)
 {
     Encryptor *encryptor = FromVoid<Encryptor>(thisptr);
@@ -21,6 +21,12 @@ SEAL_C_FUNC Encryptor_SetSecretKey(void *thisptr, void *secret_key);
 
 SEAL_C_FUNC Encryptor_Encrypt(void *thisptr, void *plaintext, void *destination, void *pool_handle);
 
+SEAL_C_FUNC Encryptor_EncryptBatch(void *thisptr, uint64_t count, void **plaintexts, void **destinations);
+
+SEAL_C_FUNC Encryptor_SetThreadCount(void *thisptr, uint64_t thread_count);
+
+SEAL_C_FUNC Encryptor_GetThreadCount(void *thisptr, uint64_t *thread_count);
+
 SEAL_C_FUNC Encryptor_EncryptZero1(void *thisptr, uint64_t *parms_id, void *destination, void *pool_handle);
 
 SEAL_C_FUNC Encryptor_EncryptZero2(void *thisptr, void *destination, void *pool_handle);
@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 #include "seal/ciphertext.h"
+#include "seal/util/bitpack.h"
 #include "seal/util/defines.h"
 #include "seal/util/pointer.h"
 #include "seal/util/polyarithsmallmod.h"
@@ -117,9 +118,14 @@ namespace seal
     void Ciphertext::expand_seed(
         const SEALContext &context, const UniformRandomGeneratorInfo &prng_info, SEALVersion version)
     {
-        auto context_data_ptr = context.get_context_data(parms_id_);
+        expand_seed(context.get_context_data(parms_id_)->parms(), prng_info, version, data(1));
+    }
 
-        // Set up a PRNG from the given info and sample the second polynomial
+    void Ciphertext::expand_seed(
+        const EncryptionParameters &parms, const UniformRandomGeneratorInfo &prng_info, SEALVersion version,
+        ct_coeff_type *destination)
+    {
+        // Set up a PRNG from the given info and sample the polynomial
         auto prng = prng_info.make_prng();
         if (!prng)
         {
@@ -128,15 +134,15 @@ namespace seal
 
         if (version.major == 3 && version.minor >= 6)
         {
-            sample_poly_uniform(prng, context_data_ptr->parms(), data(1));
+            sample_poly_uniform(prng, parms, destination);
         }
         else if (version.major == 3 && version.minor == 4)
         {
-            sample_poly_uniform_seal_3_4(prng, context_data_ptr->parms(), data(1));
+            sample_poly_uniform_seal_3_4(prng, parms, destination);
         }
         else if (version.major == 3 && version.minor == 5)
         {
-            sample_poly_uniform_seal_3_5(prng, context_data_ptr->parms(), data(1));
+            sample_poly_uniform_seal_3_5(prng, parms, destination);
         }
         else
         {
@@ -149,9 +155,21 @@ namespace seal
     {
         // We need to consider two cases: seeded and unseeded; these have very
         // different size characteristics and we need the exact size when
-        // compr_mode is compr_mode_type::none.
+        // compr_mode is compr_mode_type::none or compr_mode_type::bitpack.
         size_t data_size;
-        if (has_seed_marker())
+        if (compr_mode == compr_mode_type::bitpack)
+        {
+            // Seeded ciphertexts pack only data_(0) and append the seed
+            bool is_seeded = has_seed_marker();
+            data_size = bitpacked_array_save_size(
+                data_.cbegin(), is_seeded ? data_.size() / 2 : data_.size(), poly_modulus_degree_);
+            if (is_seeded)
+            {
+                data_size = add_safe(
+                    data_size, static_cast<size_t>(UniformRandomGeneratorInfo::SaveSize(compr_mode_type::none)));
+            }
+        }
+        else if (has_seed_marker())
         {
             // Create a temporary aliased DynArray of smaller size
             DynArray<ct_coeff_type> alias_data(
@@ -180,7 +198,7 @@ namespace seal
         return safe_cast<streamoff>(add_safe(sizeof(Serialization::SEALHeader), members_size));
     }
 
-    void Ciphertext::save_members(ostream &stream) const
+    void Ciphertext::save_members(ostream &stream, compr_mode_type compr_mode) const
     {
         auto old_except_mask = stream.exceptions();
         try
@@ -207,18 +225,31 @@ namespace seal
 
                 size_t data_size = data_.size();
                 size_t half_size = data_size / 2;
-                // Save_members must be a const method.
-                // Create an alias of data_; must be handled with care.
-                DynArray<ct_coeff_type> alias_data(data_.pool_);
-                alias_data.size_ = half_size;
-                alias_data.capacity_ = half_size;
-                auto alias_ptr = util::Pointer<ct_coeff_type>::Aliasing(const_cast<ct_coeff_type *>(data_.cbegin()));
-                swap(alias_data.data_, alias_ptr);
-                alias_data.save(stream, compr_mode_type::none);
+                if (compr_mode == compr_mode_type::bitpack)
+                {
+                    save_bitpacked_array(data_.cbegin(), half_size, poly_modulus_degree_, stream);
+                }
+                else
+                {
+                    // Save_members must be a const method.
+                    // Create an alias of data_; must be handled with care.
+                    DynArray<ct_coeff_type> alias_data(data_.pool_);
+                    alias_data.size_ = half_size;
+                    alias_data.capacity_ = half_size;
+                    auto alias_ptr =
+                        util::Pointer<ct_coeff_type>::Aliasing(const_cast<ct_coeff_type *>(data_.cbegin()));
+                    swap(alias_data.data_, alias_ptr);
+                    alias_data.save(stream, compr_mode_type::none);
+                }
 
                 // Save the UniformRandomGeneratorInfo
                 info.save(stream, compr_mode_type::none);
             }
+            else if (compr_mode == compr_mode_type::bitpack)
+            {
+                // Pack each RNS component of each polynomial separately
+                save_bitpacked_array(data_.cbegin(), data_.size(), poly_modulus_degree_, stream);
+            }
             else
             {
                 // Save the DynArray
@@ -238,7 +269,9 @@ namespace seal
         stream.exceptions(old_except_mask);
     }
 
-    void Ciphertext::load_members(const SEALContext &context, istream &stream, SEAL_MAYBE_UNUSED SEALVersion version)
+    void Ciphertext::load_members(
+        const SEALContext &context, istream &stream, SEAL_MAYBE_UNUSED SEALVersion version, compr_mode_type compr_mode,
+        UniformRandomGeneratorInfo *seed_info)
     {
         // Verify parameters
         if (!context.parameters_set())
@@ -300,13 +333,21 @@ namespace seal
             // size of the loaded DynArray. This is an important security measure to
             // prevent a malformed DynArray from causing arbitrarily large memory
             // allocations.
-            new_data.data_.load(stream, total_uint64_count);
+            if (compr_mode == compr_mode_type::bitpack)
+            {
+                load_bitpacked_array(stream, total_uint64_count, new_data.data_);
+            }
+            else
+            {
+                new_data.data_.load(stream, total_uint64_count);
+            }
 
             // Expected buffer size in the seeded case
             auto seeded_uint64_count = poly_modulus_degree64 * coeff_modulus_size64;
 
             // This is the case where we need to expand a seed, otherwise full
             // ciphertext data was already (possibly) loaded and we are done
+            bool keep_seed = false;
             if (unsigned_eq(new_data.data_.size(), seeded_uint64_count))
             {
                 // Single polynomial size data was loaded, so we are in the seeded
@@ -329,13 +370,23 @@ namespace seal
                     throw logic_error("incompatible version");
                 }
 
-                // Set up a UniformRandomGenerator and expand
-                new_data.data_.resize(total_uint64_count);
-                new_data.expand_seed(context, prng_info, version);
+                if (seed_info)
+                {
+                    // The caller expands the seed later; keep only the first polynomial
+                    new_data.data_.shrink_to_fit();
+                    *seed_info = prng_info;
+                    keep_seed = true;
+                }
+                else
+                {
+                    // Set up a UniformRandomGenerator and expand
+                    new_data.data_.resize(total_uint64_count);
+                    new_data.expand_seed(context, prng_info, version);
+                }
             }
 
             // Verify that the buffer is correct
-            if (!is_buffer_valid(new_data))
+            if (!keep_seed && !is_buffer_valid(new_data))
             {
                 throw logic_error("ciphertext data is invalid");
             }
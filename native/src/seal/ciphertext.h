@@ -54,6 +54,8 @@ namespace seal
     */
     class Ciphertext
     {
+        friend class KSwitchKeys;
+
     public:
         using ct_coeff_type = std::uint64_t;
 
@@ -480,8 +482,8 @@ namespace seal
         {
             using namespace std::placeholders;
             return Serialization::Save(
-                std::bind(&Ciphertext::save_members, this, _1), save_size(compr_mode_type::none), stream, compr_mode,
-                false);
+                std::bind(&Ciphertext::save_members, this, _1, compr_mode),
+                save_size(Serialization::RawComprMode(compr_mode)), stream, compr_mode, false);
         }
 
         /**
@@ -500,7 +502,8 @@ namespace seal
         inline std::streamoff unsafe_load(const SEALContext &context, std::istream &stream)
         {
             using namespace std::placeholders;
-            return Serialization::Load(std::bind(&Ciphertext::load_members, this, context, _1, _2), stream, false);
+            return Serialization::LoadWithComprMode(
+                std::bind(&Ciphertext::load_members, this, context, _1, _2, _3, nullptr), stream, false);
         }
 
         /**
@@ -544,8 +547,8 @@ namespace seal
         {
             using namespace std::placeholders;
             return Serialization::Save(
-                std::bind(&Ciphertext::save_members, this, _1), save_size(compr_mode_type::none), out, size, compr_mode,
-                false);
+                std::bind(&Ciphertext::save_members, this, _1, compr_mode),
+                save_size(Serialization::RawComprMode(compr_mode)), out, size, compr_mode, false);
         }
 
         /**
@@ -567,7 +570,8 @@ namespace seal
         inline std::streamoff unsafe_load(const SEALContext &context, const seal_byte *in, std::size_t size)
         {
             using namespace std::placeholders;
-            return Serialization::Load(std::bind(&Ciphertext::load_members, this, context, _1, _2), in, size, false);
+            return Serialization::LoadWithComprMode(
+                std::bind(&Ciphertext::load_members, this, context, _1, _2, _3, nullptr), in, size, false);
         }
 
         /**
@@ -673,9 +677,15 @@ namespace seal
 
         void expand_seed(const SEALContext &context, const UniformRandomGeneratorInfo &prng_info, SEALVersion version);
 
-        void save_members(std::ostream &stream) const;
+        static void expand_seed(
+            const EncryptionParameters &parms, const UniformRandomGeneratorInfo &prng_info, SEALVersion version,
+            ct_coeff_type *destination);
+
+        void save_members(std::ostream &stream, compr_mode_type compr_mode) const;
 
-        void load_members(const SEALContext &context, std::istream &stream, SEALVersion version);
+        void load_members(
+            const SEALContext &context, std::istream &stream, SEALVersion version, compr_mode_type compr_mode,
+            UniformRandomGeneratorInfo *seed_info);
 
         inline bool has_seed_marker() const noexcept
         {
@@ -68,6 +68,22 @@ namespace seal
             inv_root_powers_[1] = { 0, -1 };
         }
 
+        // Real-valued data uses a half-size transform with the squared root, twisted by powers of the root
+        if (slots_ > 1)
+        {
+            int log_slots = logn - 1;
+            half_inv_root_powers_ = allocate<complex<double>>(slots_, pool_);
+            twist_powers_ = allocate<complex<double>>(slots_, pool_);
+            for (size_t i = 0; i < slots_; i++)
+            {
+                twist_powers_[i] = complex_roots_->get_root(i);
+            }
+            for (size_t i = 1; i < slots_; i++)
+            {
+                half_inv_root_powers_[i] = conj(complex_roots_->get_root((reverse_bits(i - 1, log_slots) + 1) << 1));
+            }
+        }
+
         complex_arith_ = ComplexArith();
         fft_handler_ = FFTHandler(complex_arith_);
     }
@@ -491,20 +491,47 @@ namespace seal
             // values_size is guaranteed to be no bigger than slots_
             std::size_t n = util::mul_safe(slots_, std::size_t(2));
 
-            auto conj_values = util::allocate<std::complex<double>>(n, pool, 0);
-            for (std::size_t i = 0; i < values_size; i++)
+            // Real-valued data uses a half-size transform whose output holds the coefficients i and i + slots_ as
+            // the real and imaginary parts of entry i; complex-valued data uses a full-size transform of the data
+            // extended by its complex conjugate.
+            bool real_fft = std::is_same<std::remove_cv_t<T>, double>::value && (slots_ > 1);
+            std::size_t fft_size = real_fft ? slots_ : n;
+            auto conj_values = util::allocate<std::complex<double>>(fft_size, pool, 0);
+            if (real_fft)
             {
-                conj_values[matrix_reps_index_map_[i]] = values[i];
-                // TODO: if values are real, the following values should be set to zero, and multiply results by 2.
-                conj_values[matrix_reps_index_map_[i + slots_]] = std::conj(values[i]);
+                // A real value is also the value at the conjugate root; the half-size transform needs the one of the
+                // two with an index below slots_
+                for (std::size_t i = 0; i < values_size; i++)
+                {
+                    conj_values[std::min<>(matrix_reps_index_map_[i], matrix_reps_index_map_[slots_ | i])] = values[i];
+                }
+                double fix = scale / static_cast<double>(slots_);
+                fft_handler_.transform_from_rev(
+                    conj_values.get(), util::get_power_of_two(slots_), half_inv_root_powers_.get(), &fix);
+                for (std::size_t i = 0; i < slots_; i++)
+                {
+                    conj_values[i] *= twist_powers_[i];
+                }
+            }
+            else
+            {
+                for (std::size_t i = 0; i < values_size; i++)
+                {
+                    conj_values[matrix_reps_index_map_[i]] = values[i];
+                    conj_values[matrix_reps_index_map_[i + slots_]] = std::conj(values[i]);
+                }
+                double fix = scale / static_cast<double>(n);
+                fft_handler_.transform_from_rev(
+                    conj_values.get(), util::get_power_of_two(n), inv_root_powers_.get(), &fix);
             }
-            double fix = scale / static_cast<double>(n);
-            fft_handler_.transform_from_rev(conj_values.get(), util::get_power_of_two(n), inv_root_powers_.get(), &fix);
+            auto get_coeff = [&](std::size_t i) {
+                return i < fft_size ? conj_values[i].real() : conj_values[i - fft_size].imag();
+            };
 
             double max_coeff = 0;
             for (std::size_t i = 0; i < n; i++)
             {
-                max_coeff = std::max<>(max_coeff, std::fabs(conj_values[i].real()));
+                max_coeff = std::max<>(max_coeff, std::fabs(get_coeff(i)));
             }
             // Verify that the values are not too large to fit in coeff_modulus
             // Note that we have an extra + 1 for the sign bit
@@ -528,7 +555,7 @@ namespace seal
             {
                 for (std::size_t i = 0; i < n; i++)
                 {
-                    double coeffd = std::round(conj_values[i].real());
+                    double coeffd = std::round(get_coeff(i));
                     bool is_negative = std::signbit(coeffd);
 
                     std::uint64_t coeffu = static_cast<std::uint64_t>(std::fabs(coeffd));
@@ -554,7 +581,7 @@ namespace seal
             {
                 for (std::size_t i = 0; i < n; i++)
                 {
-                    double coeffd = std::round(conj_values[i].real());
+                    double coeffd = std::round(get_coeff(i));
                     bool is_negative = std::signbit(coeffd);
                     coeffd = std::fabs(coeffd);
 
@@ -584,7 +611,7 @@ namespace seal
                 auto coeffu(util::allocate_uint(coeff_modulus_size, pool));
                 for (std::size_t i = 0; i < n; i++)
                 {
-                    double coeffd = std::round(conj_values[i].real());
+                    double coeffd = std::round(get_coeff(i));
                     bool is_negative = std::signbit(coeffd);
                     coeffd = std::fabs(coeffd);
 
@@ -692,12 +719,16 @@ namespace seal
             // CRT-compose the polynomial
             context_data.rns_tool()->base_q()->compose_array(plain_copy.get(), coeff_count, pool);
 
+            // Real-valued output uses a half-size transform; see encode_internal
+            bool real_fft = std::is_same<std::remove_cv_t<T>, double>::value && (slots_ > 1);
+            std::size_t fft_size = real_fft ? slots_ : coeff_count;
+
             // Create floating-point representations of the multi-precision integer coefficients
             double two_pow_64 = std::pow(2.0, 64);
-            auto res(util::allocate<std::complex<double>>(coeff_count, pool));
+            auto res(util::allocate<std::complex<double>>(fft_size, pool));
             for (std::size_t i = 0; i < coeff_count; i++)
             {
-                res[i] = 0.0;
+                double res_accum = 0.0;
                 if (util::is_greater_than_or_equal_uint(
                         plain_copy.get() + (i * coeff_modulus_size), upper_half_threshold, coeff_modulus_size))
                 {
@@ -707,12 +738,12 @@ namespace seal
                         if (plain_copy[i * coeff_modulus_size + j] > decryption_modulus[j])
                         {
                             auto diff = plain_copy[i * coeff_modulus_size + j] - decryption_modulus[j];
-                            res[i] += diff ? static_cast<double>(diff) * scaled_two_pow_64 : 0.0;
+                            res_accum += diff ? static_cast<double>(diff) * scaled_two_pow_64 : 0.0;
                         }
                         else
                         {
                             auto diff = decryption_modulus[j] - plain_copy[i * coeff_modulus_size + j];
-                            res[i] -= diff ? static_cast<double>(diff) * scaled_two_pow_64 : 0.0;
+                            res_accum -= diff ? static_cast<double>(diff) * scaled_two_pow_64 : 0.0;
                         }
                     }
                 }
@@ -722,7 +753,7 @@ namespace seal
                     for (std::size_t j = 0; j < coeff_modulus_size; j++, scaled_two_pow_64 *= two_pow_64)
                     {
                         auto curr_coeff = plain_copy[i * coeff_modulus_size + j];
-                        res[i] += curr_coeff ? static_cast<double>(curr_coeff) * scaled_two_pow_64 : 0.0;
+                        res_accum += curr_coeff ? static_cast<double>(curr_coeff) * scaled_two_pow_64 : 0.0;
                     }
                 }
 
@@ -730,13 +761,39 @@ namespace seal
                 // where otherwise pow(two_pow_64, j) would overflow due to very
                 // large coeff_modulus_size and very large scale
                 // res[i] = res_accum * inv_scale;
+                if (i < fft_size)
+                {
+                    res[i] = res_accum;
+                }
+                else
+                {
+                    res[i - fft_size].imag(res_accum);
+                }
             }
 
-            fft_handler_.transform_to_rev(res.get(), logn, root_powers_.get());
+            if (real_fft)
+            {
+                for (std::size_t i = 0; i < slots_; i++)
+                {
+                    res[i] *= std::conj(twist_powers_[i]);
+                }
+                fft_handler_.transform_to_rev(res.get(), logn - 1, root_powers_.get());
 
-            for (std::size_t i = 0; i < slots_; i++)
+                // The real part of the value at the conjugate root is the same
+                for (std::size_t i = 0; i < slots_; i++)
+                {
+                    destination[i] = from_complex<T>(
+                        res[std::min<>(matrix_reps_index_map_[i], matrix_reps_index_map_[slots_ | i])]);
+                }
+            }
+            else
             {
-                destination[i] = from_complex<T>(res[static_cast<std::size_t>(matrix_reps_index_map_[i])]);
+                fft_handler_.transform_to_rev(res.get(), logn, root_powers_.get());
+
+                for (std::size_t i = 0; i < slots_; i++)
+                {
+                    destination[i] = from_complex<T>(res[static_cast<std::size_t>(matrix_reps_index_map_[i])]);
+                }
             }
         }
 
@@ -767,6 +824,13 @@ namespace seal
         // Holds 1~(n-1)-th powers of inverse root in scrambled order, the 0-th power is left unset.
         util::Pointer<std::complex<double>> inv_root_powers_;
 
+        // Holds 1~(n/2-1)-th powers of the squared inverse root in scrambled order, the 0-th power is left unset.
+        // The first n/2 entries of root_powers_ serve as the corresponding forward table.
+        util::Pointer<std::complex<double>> half_inv_root_powers_;
+
+        // Holds 0~(n/2-1)-th powers of root for twisting the half-size transform of real-valued data.
+        util::Pointer<std::complex<double>> twist_powers_;
+
         util::Pointer<std::size_t> matrix_reps_index_map_;
 
         ComplexArith complex_arith_;
@@ -319,6 +319,26 @@ namespace seal
                 return rns_tool_.get();
             }
 
+            /**
+            Returns a constant pointer to the HybridKSwitchTool. This is set only for
+            the data levels of parameters that use more than one special prime for key
+            switching, and is nullptr otherwise.
+            */
+            SEAL_NODISCARD inline const util::HybridKSwitchTool *hybrid_kswitch_tool() const noexcept
+            {
+                return hybrid_kswitch_tool_.get();
+            }
+
+            /**
+            Returns a constant pointer to the KSwitchRescaleTool. This is set only for
+            the data levels of parameters that support key switching and have more than
+            one data prime, and is nullptr otherwise.
+            */
+            SEAL_NODISCARD inline const util::KSwitchRescaleTool *kswitch_rescale_tool() const noexcept
+            {
+                return kswitch_rescale_tool_.get();
+            }
+
             /**
             Returns a constant pointer to the NTT tables.
             */
@@ -451,6 +471,10 @@ namespace seal
 
             util::Pointer<util::RNSTool> rns_tool_;
 
+            util::Pointer<util::HybridKSwitchTool> hybrid_kswitch_tool_;
+
+            util::Pointer<util::KSwitchRescaleTool> kswitch_rescale_tool_;
+
             util::Pointer<util::NTTTables> small_ntt_tables_;
 
             util::Pointer<util::NTTTables> plain_ntt_tables_;
@@ -650,12 +674,12 @@ namespace seal
         ContextData validate(EncryptionParameters parms);
 
         /**
-        Create the next context_data by dropping the last element from coeff_modulus.
-        If the new encryption parameters are not valid, returns parms_id_zero.
-        Otherwise, returns the parms_id of the next parameter and appends the next
-        context_data to the chain.
+        Create the next context_data by dropping the last drop_count elements from
+        coeff_modulus. If the new encryption parameters are not valid, returns
+        parms_id_zero. Otherwise, returns the parms_id of the next parameter and
+        appends the next context_data to the chain.
         */
-        parms_id_type create_next_context_data(const parms_id_type &prev_parms);
+        parms_id_type create_next_context_data(const parms_id_type &prev_parms, std::size_t drop_count = 1);
 
         MemoryPoolHandle pool_;
 
@@ -32,6 +32,14 @@ namespace seal
                 mod.save(stream, compr_mode_type::none);
             }
 
+            // The number of special primes is saved only if it is not the default; save sets
+            // Serialization::header_flag_special_modulus_size in this case
+            if (special_modulus_size_ > 1)
+            {
+                uint64_t special_modulus_size64 = static_cast<uint64_t>(special_modulus_size_);
+                stream.write(reinterpret_cast<const char *>(&special_modulus_size64), sizeof(uint64_t));
+            }
+
             // Only BFV uses plain_modulus but save it in any case for simplicity
             plain_modulus_.save(stream, compr_mode_type::none);
         }
@@ -48,7 +56,8 @@ namespace seal
         stream.exceptions(old_except_mask);
     }
 
-    void EncryptionParameters::load_members(istream &stream, SEAL_MAYBE_UNUSED SEALVersion version)
+    void EncryptionParameters::load_members(
+        istream &stream, SEAL_MAYBE_UNUSED SEALVersion version, const Serialization::SEALHeader &header)
     {
         // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
         auto old_except_mask = stream.exceptions();
@@ -91,6 +100,17 @@ namespace seal
                 coeff_modulus.back().load(stream);
             }
 
+            // Read the number of special primes if it was saved
+            uint64_t special_modulus_size64 = 1;
+            if (header.reserved & Serialization::header_flag_special_modulus_size)
+            {
+                stream.read(reinterpret_cast<char *>(&special_modulus_size64), sizeof(uint64_t));
+                if (special_modulus_size64 < 2 || special_modulus_size64 > SEAL_COEFF_MOD_COUNT_MAX)
+                {
+                    throw logic_error("special_modulus_size is invalid");
+                }
+            }
+
             // Read the plain_modulus
             Modulus plain_modulus;
             plain_modulus.load(stream);
@@ -98,6 +118,7 @@ namespace seal
             // Supposedly everything worked so set the values of member variables
             parms.set_poly_modulus_degree(safe_cast<size_t>(poly_modulus_degree64));
             parms.set_coeff_modulus(coeff_modulus);
+            parms.set_special_modulus_size(safe_cast<size_t>(special_modulus_size64));
 
             // Only BFV uses plain_modulus; set_plain_modulus checks that for
             // other schemes it is zero
@@ -125,10 +146,14 @@ namespace seal
     {
         size_t coeff_modulus_size = coeff_modulus_.size();
 
+        // The number of special primes is hashed only if it differs from the default
+        // so that the parms_id of existing parameters does not change
+        size_t special_modulus_size_count = (special_modulus_size_ > 1) ? size_t(1) : size_t(0);
+
         size_t total_uint64_count = add_safe(
             size_t(1), // scheme
             size_t(1), // poly_modulus_degree
-            coeff_modulus_size, plain_modulus_.uint64_count());
+            coeff_modulus_size, plain_modulus_.uint64_count(), special_modulus_size_count);
 
         auto param_data(allocate_uint(total_uint64_count, pool_));
         uint64_t *param_data_ptr = param_data.get();
@@ -147,6 +172,11 @@ namespace seal
         set_uint(plain_modulus_.data(), plain_modulus_.uint64_count(), param_data_ptr);
         param_data_ptr += plain_modulus_.uint64_count();
 
+        if (special_modulus_size_count)
+        {
+            *param_data_ptr++ = static_cast<uint64_t>(special_modulus_size_);
+        }
+
         HashFunction::hash(param_data.get(), total_uint64_count, parms_id_);
 
         // Did we somehow manage to get a zero block as result? This is reserved for
@@ -252,6 +252,46 @@ namespace seal
             set_plain_modulus(Modulus(plain_modulus));
         }
 
+        /**
+        Sets the number of special primes used for key switching. The special primes
+        are the last special_modulus_size primes in coeff_modulus; they are present
+        only at the key level and are dropped from all data levels. With more than
+        one special prime, key switching uses hybrid decomposition: the data primes
+        are split into digits of special_modulus_size consecutive primes each, so
+        key switching keys consist of ceil(L / special_modulus_size) digits, where L
+        is the number of data primes, instead of L digits. This reduces both the size
+        of the keys and the number of NTTs performed per key switch. For the noise
+        growth to remain small, the product of the special primes should be at least
+        as large as the product of the primes in any one digit.
+
+        By default special_modulus_size is 1, which gives the standard key switching
+        with one digit per data prime. Other values are serialized in a field that
+        is flagged in the SEALHeader (see Serialization::header_flag_special_modulus_size),
+        which versions of Microsoft SEAL without hybrid key switching cannot load.
+
+        @param[in] special_modulus_size The new number of special primes
+        @throws std::logic_error if a valid scheme is not set and special_modulus_size
+        is not 1
+        @throws std::invalid_argument if special_modulus_size is zero or larger than
+        SEAL_COEFF_MOD_COUNT_MAX
+        */
+        inline void set_special_modulus_size(std::size_t special_modulus_size)
+        {
+            if (scheme_ == scheme_type::none && special_modulus_size != 1)
+            {
+                throw std::logic_error("special_modulus_size is not supported for this scheme");
+            }
+            if (!special_modulus_size || special_modulus_size > SEAL_COEFF_MOD_COUNT_MAX)
+            {
+                throw std::invalid_argument("special_modulus_size is invalid");
+            }
+
+            special_modulus_size_ = special_modulus_size;
+
+            // Re-compute the parms_id
+            compute_parms_id();
+        }
+
         /**
         Sets the random number generator factory to use for encryption. By default,
         the random generator is set to UniformRandomGeneratorFactory::default_factory().
@@ -289,6 +329,14 @@ namespace seal
             return coeff_modulus_;
         }
 
+        /**
+        Returns the number of special primes used for key switching.
+        */
+        SEAL_NODISCARD inline std::size_t special_modulus_size() const noexcept
+        {
+            return special_modulus_size_;
+        }
+
         /**
         Returns a const reference to the currently set plaintext modulus parameter.
         */
@@ -354,6 +402,7 @@ namespace seal
                     sizeof(std::uint64_t), // poly_modulus_degree_
                     sizeof(std::uint64_t), // coeff_modulus_size
                     coeff_modulus_total_size,
+                    special_modulus_size_ > 1 ? sizeof(std::uint64_t) : std::size_t(0), // special_modulus_size_
                     util::safe_cast<std::size_t>(plain_modulus_.save_size(compr_mode_type::none))),
                 compr_mode);
 
@@ -378,7 +427,7 @@ namespace seal
             using namespace std::placeholders;
             return Serialization::Save(
                 std::bind(&EncryptionParameters::save_members, this, _1), save_size(compr_mode_type::none), stream,
-                compr_mode, false);
+                compr_mode, false, save_header_flags());
         }
 
         /**
@@ -394,8 +443,8 @@ namespace seal
         {
             using namespace std::placeholders;
             EncryptionParameters new_parms(scheme_type::none);
-            auto in_size =
-                Serialization::Load(std::bind(&EncryptionParameters::load_members, &new_parms, _1, _2), stream, false);
+            auto in_size = Serialization::LoadWithHeader(
+                std::bind(&EncryptionParameters::load_members, &new_parms, _1, _2, _3), stream, false);
             std::swap(*this, new_parms);
             return in_size;
         }
@@ -419,7 +468,7 @@ namespace seal
             using namespace std::placeholders;
             return Serialization::Save(
                 std::bind(&EncryptionParameters::save_members, this, _1), save_size(compr_mode_type::none), out, size,
-                compr_mode, false);
+                compr_mode, false, save_header_flags());
         }
 
         /**
@@ -438,8 +487,8 @@ namespace seal
         {
             using namespace std::placeholders;
             EncryptionParameters new_parms(scheme_type::none);
-            auto in_size = Serialization::Load(
-                std::bind(&EncryptionParameters::load_members, &new_parms, _1, _2), in, size, false);
+            auto in_size = Serialization::LoadWithHeader(
+                std::bind(&EncryptionParameters::load_members, &new_parms, _1, _2, _3), in, size, false);
             std::swap(*this, new_parms);
             return in_size;
         }
@@ -484,7 +533,12 @@ namespace seal
 
         void save_members(std::ostream &stream) const;
 
-        void load_members(std::istream &stream, SEALVersion version);
+        void load_members(std::istream &stream, SEALVersion version, const Serialization::SEALHeader &header);
+
+        SEAL_NODISCARD inline std::uint16_t save_header_flags() const noexcept
+        {
+            return special_modulus_size_ > 1 ? Serialization::header_flag_special_modulus_size : std::uint16_t(0);
+        }
 
         MemoryPoolHandle pool_ = MemoryManager::GetPool();
 
@@ -498,6 +552,8 @@ namespace seal
 
         Modulus plain_modulus_{};
 
+        std::size_t special_modulus_size_ = 1;
+
         parms_id_type parms_id_ = parms_id_zero;
     };
 } // namespace seal
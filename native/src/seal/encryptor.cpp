@@ -85,9 +85,18 @@ namespace seal
         }
     }
 
+    void Encryptor::set_thread_count(size_t thread_count)
+    {
+        if (!thread_count)
+        {
+            throw invalid_argument("thread_count must be positive");
+        }
+        thread_pool_ = (thread_count > 1) ? make_shared<ThreadPool>(thread_count) : nullptr;
+    }
+
     void Encryptor::encrypt_zero_internal(
-        parms_id_type parms_id, bool is_asymmetric, bool save_seed, Ciphertext &destination,
-        MemoryPoolHandle pool) const
+        parms_id_type parms_id, bool is_asymmetric, bool save_seed, Ciphertext &destination, MemoryPoolHandle pool,
+        shared_ptr<UniformRandomGenerator> prng) const
     {
         // Verify parameters.
         if (!pool)
@@ -122,6 +131,17 @@ namespace seal
         // If asymmetric key encryption
         if (is_asymmetric)
         {
+            auto encrypt_zero_asymmetric = [&](parms_id_type zero_parms_id, Ciphertext &zero) {
+                if (prng)
+                {
+                    util::encrypt_zero_asymmetric(public_key_, context_, zero_parms_id, is_ntt_form, prng, zero, pool);
+                }
+                else
+                {
+                    util::encrypt_zero_asymmetric(public_key_, context_, zero_parms_id, is_ntt_form, zero);
+                }
+            };
+
             auto prev_context_data_ptr = context_data.prev_context_data();
             if (prev_context_data_ptr)
             {
@@ -132,7 +152,7 @@ namespace seal
 
                 // Zero encryption without modulus switching
                 Ciphertext temp(pool);
-                util::encrypt_zero_asymmetric(public_key_, context_, prev_parms_id, is_ntt_form, temp);
+                encrypt_zero_asymmetric(prev_parms_id, temp);
 
                 // Modulus switching
                 SEAL_ITERATE(iter(temp, destination), temp.size(), [&](auto I) {
@@ -155,7 +175,7 @@ namespace seal
             else
             {
                 // Does not require modulus switching
-                util::encrypt_zero_asymmetric(public_key_, context_, parms_id, is_ntt_form, destination);
+                encrypt_zero_asymmetric(parms_id, destination);
             }
         }
         else
@@ -165,9 +185,42 @@ namespace seal
         }
     }
 
+    void Encryptor::verify_plain(const Plaintext &plain) const
+    {
+        // Verify that plain is valid.
+        if (!is_metadata_valid_for(plain, context_) || !is_buffer_valid(plain))
+        {
+            throw invalid_argument("plain is not valid for encryption parameters");
+        }
+
+        auto scheme = context_.key_context_data()->parms().scheme();
+        if (scheme == scheme_type::bfv)
+        {
+            if (plain.is_ntt_form())
+            {
+                throw invalid_argument("plain cannot be in NTT form");
+            }
+        }
+        else if (scheme == scheme_type::ckks)
+        {
+            if (!plain.is_ntt_form())
+            {
+                throw invalid_argument("plain must be in NTT form");
+            }
+            if (!context_.get_context_data(plain.parms_id()))
+            {
+                throw invalid_argument("plain is not valid for encryption parameters");
+            }
+        }
+        else
+        {
+            throw invalid_argument("unsupported scheme");
+        }
+    }
+
     void Encryptor::encrypt_internal(
-        const Plaintext &plain, bool is_asymmetric, bool save_seed, Ciphertext &destination,
-        MemoryPoolHandle pool) const
+        const Plaintext &plain, bool is_asymmetric, bool save_seed, Ciphertext &destination, MemoryPoolHandle pool,
+        shared_ptr<UniformRandomGenerator> prng) const
     {
         // Minimal verification that the keys are set
         if (is_asymmetric)
@@ -184,40 +237,20 @@ namespace seal
                 throw logic_error("secret key is not set");
             }
         }
-
-        // Verify that plain is valid.
-        if (!is_metadata_valid_for(plain, context_) || !is_buffer_valid(plain))
-        {
-            throw invalid_argument("plain is not valid for encryption parameters");
-        }
+        verify_plain(plain);
 
         auto scheme = context_.key_context_data()->parms().scheme();
         if (scheme == scheme_type::bfv)
         {
-            if (plain.is_ntt_form())
-            {
-                throw invalid_argument("plain cannot be in NTT form");
-            }
-
-            encrypt_zero_internal(context_.first_parms_id(), is_asymmetric, save_seed, destination, pool);
+            encrypt_zero_internal(context_.first_parms_id(), is_asymmetric, save_seed, destination, pool, prng);
 
             // Multiply plain by scalar coeff_div_plaintext and reposition if in upper-half.
             // Result gets added into the c_0 term of ciphertext (c_0,c_1).
             multiply_add_plain_with_scaling_variant(plain, *context_.first_context_data(), *iter(destination));
         }
-        else if (scheme == scheme_type::ckks)
+        else
         {
-            if (!plain.is_ntt_form())
-            {
-                throw invalid_argument("plain must be in NTT form");
-            }
-
-            auto context_data_ptr = context_.get_context_data(plain.parms_id());
-            if (!context_data_ptr)
-            {
-                throw invalid_argument("plain is not valid for encryption parameters");
-            }
-            encrypt_zero_internal(plain.parms_id(), is_asymmetric, save_seed, destination, pool);
+            encrypt_zero_internal(plain.parms_id(), is_asymmetric, save_seed, destination, pool, prng);
 
             auto &parms = context_.get_context_data(plain.parms_id())->parms();
             auto &coeff_modulus = parms.coeff_modulus();
@@ -231,9 +264,82 @@ namespace seal
 
             destination.scale() = plain.scale();
         }
+    }
+
+    void Encryptor::encrypt_batch(
+        const vector<Plaintext> &plains, vector<Ciphertext> &destinations, MemoryPoolHandle pool) const
+    {
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        // Existing ciphertexts keep their memory pools
+        size_t count = plains.size();
+        if (destinations.size() > count)
+        {
+            destinations.resize(count);
+        }
+        destinations.reserve(count);
+        while (destinations.size() < count)
+        {
+            destinations.emplace_back(pool);
+        }
+
+        vector<const Plaintext *> plain_ptrs(count);
+        vector<Ciphertext *> destination_ptrs(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            plain_ptrs[i] = &plains[i];
+            destination_ptrs[i] = &destinations[i];
+        }
+        encrypt_batch_internal(plain_ptrs.data(), destination_ptrs.data(), count);
+    }
+
+    void Encryptor::encrypt_batch_internal(
+        const Plaintext *const *plains, Ciphertext *const *destinations, size_t count) const
+    {
+        if (!is_metadata_valid_for(public_key_, context_))
+        {
+            throw logic_error("public key is not set");
+        }
+
+        // Verify every plaintext before encrypting any of them
+        for (size_t i = 0; i < count; i++)
+        {
+            verify_plain(*plains[i]);
+        }
+
+        // Allocate the ciphertexts on the calling thread, so that the workers only use their own memory pools
+        bool is_ckks = context_.key_context_data()->parms().scheme() == scheme_type::ckks;
+        for (size_t i = 0; i < count; i++)
+        {
+            destinations[i]->resize(context_, is_ckks ? plains[i]->parms_id() : context_.first_parms_id(), 2);
+        }
+
+        // Every chunk has its own PRNG and its own scratch memory pool, which clears the secret polynomials u on
+        // destruction
+        size_t chunk_count = thread_pool_ ? min(thread_pool_->thread_count(), count) : min(size_t(1), count);
+        auto encrypt_chunk = [&](size_t chunk_index) {
+            size_t begin = count * chunk_index / chunk_count;
+            size_t end = count * (chunk_index + 1) / chunk_count;
+            auto prng = context_.key_context_data()->parms().random_generator()->create();
+            MemoryPoolHandle chunk_pool = MemoryManager::GetPool(mm_prof_opt::mm_force_new, true);
+            for (size_t i = begin; i < end; i++)
+            {
+                encrypt_internal(*plains[i], true, false, *destinations[i], chunk_pool, prng);
+            }
+        };
+        if (chunk_count > 1 && !ThreadPool::in_parallel_region())
+        {
+            thread_pool_->parallel_for(chunk_count, encrypt_chunk);
+        }
         else
         {
-            throw invalid_argument("unsupported scheme");
+            for (size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++)
+            {
+                encrypt_chunk(chunk_index);
+            }
         }
     }
 } // namespace seal
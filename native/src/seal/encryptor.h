@@ -13,6 +13,8 @@
 #include "seal/serializable.h"
 #include "seal/util/defines.h"
 #include "seal/util/ntt.h"
+#include "seal/util/threadpool.h"
+#include <memory>
 #include <vector>
 
 namespace seal
@@ -111,6 +113,24 @@ namespace seal
             secret_key_ = secret_key;
         }
 
+        /**
+        Sets the number of threads used by encrypt_batch. With more than one thread, the batch is split into
+        contiguous chunks that are encrypted in parallel by a pool of threads owned by this Encryptor. By default
+        only the calling thread is used.
+
+        @param[in] thread_count The number of threads, including the calling thread
+        @throws std::invalid_argument if thread_count is zero
+        */
+        void set_thread_count(std::size_t thread_count);
+
+        /**
+        Returns the number of threads used by encrypt_batch.
+        */
+        SEAL_NODISCARD inline std::size_t thread_count() const noexcept
+        {
+            return thread_pool_ ? thread_pool_->thread_count() : std::size_t(1);
+        }
+
         /**
         Encrypts a plaintext with the public key and stores the result in
         destination.
@@ -163,6 +183,34 @@ namespace seal
             return destination;
         }
 
+        /**
+        Encrypts a batch of plaintexts with the public key and stores the results
+        in destinations, which is resized to the number of plaintexts. The result
+        is the same as calling encrypt on every plaintext, but the work is
+        amortized over the batch: all plaintexts are validated up front, every
+        chunk of the batch draws its randomness from a single PRNG and reuses one
+        scratch memory pool, and the chunks are encrypted in parallel if more than
+        one thread is set with set_thread_count. Ciphertexts that destinations
+        grows by are created with the memory pool pointed to by the given
+        MemoryPoolHandle, while existing ones keep their own memory pools. The
+        scratch memory of every chunk comes from a new memory pool that is
+        cleared on destruction and does not use the given MemoryPoolHandle.
+
+        @param[in] plains The plaintexts to encrypt
+        @param[out] destinations The ciphertexts to overwrite with the encrypted
+        plaintexts
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool for
+        the ciphertexts added to destinations
+        @throws std::logic_error if a public key is not set
+        @throws std::invalid_argument if any of plains is not valid for the
+        encryption parameters
+        @throws std::invalid_argument if any of plains is not in default NTT form
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void encrypt_batch(
+            const std::vector<Plaintext> &plains, std::vector<Ciphertext> &destinations,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
         /**
         Encrypts a zero plaintext with the public key and stores the result in
         destination.
@@ -415,18 +463,36 @@ namespace seal
 
         Encryptor &operator=(Encryptor &&assign) = delete;
 
+        /**
+        If prng is set, an asymmetric encryption draws its randomness from prng and its secret scratch memory from
+        pool instead of creating a new PRNG and memory pool.
+        */
         void encrypt_zero_internal(
             parms_id_type parms_id, bool is_asymmetric, bool save_seed, Ciphertext &destination,
-            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+            MemoryPoolHandle pool = MemoryManager::GetPool(),
+            std::shared_ptr<UniformRandomGenerator> prng = nullptr) const;
 
         void encrypt_internal(
             const Plaintext &plain, bool is_asymmetric, bool save_seed, Ciphertext &destination,
-            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+            MemoryPoolHandle pool = MemoryManager::GetPool(),
+            std::shared_ptr<UniformRandomGenerator> prng = nullptr) const;
+
+        void verify_plain(const Plaintext &plain) const;
+
+        /**
+        Encrypts plains[i] into destinations[i] for i in [0, count) with the public key; see encrypt_batch. The
+        ciphertexts are resized with their own memory pools, and the scratch memory of every chunk comes from a new
+        memory pool that is cleared on destruction.
+        */
+        void encrypt_batch_internal(
+            const Plaintext *const *plains, Ciphertext *const *destinations, std::size_t count) const;
 
         SEALContext context_;
 
         PublicKey public_key_;
 
         SecretKey secret_key_;
+
+        std::shared_ptr<util::ThreadPool> thread_pool_{ nullptr };
     };
 } // namespace seal
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <cmath>
 #include <functional>
+#include <numeric>
 
 using namespace std;
 using namespace seal::util;
@@ -45,6 +46,204 @@ namespace seal
 
             return !(scale <= 0 || (static_cast<int>(log2(scale)) >= scale_bit_count_bound));
         }
+
+        // Number of baby steps in the baby-step giant-step matrix-vector product; the giant step is this many slots
+        SEAL_NODISCARD inline size_t get_baby_step_count(size_t diagonal_count) noexcept
+        {
+            size_t baby_step_count = static_cast<size_t>(ceil(sqrt(static_cast<double>(diagonal_count))));
+            return min(max(baby_step_count, size_t(1)), diagonal_count);
+        }
+
+        // Writes the residues of round(value) modulo the primes of context_data to destination
+        void encode_scalar(
+            double value, const SEALContext::ContextData &context_data, uint64_t *destination, MemoryPoolHandle pool)
+        {
+            auto &coeff_modulus = context_data.parms().coeff_modulus();
+            size_t coeff_modulus_size = coeff_modulus.size();
+
+            int coeff_bit_count = static_cast<int>(log2(fabs(value))) + 2;
+            if (coeff_bit_count >= context_data.total_coeff_modulus_bit_count())
+            {
+                throw invalid_argument("encoded value is too large");
+            }
+
+            double two_pow_64 = pow(2.0, 64);
+            double coeffd = round(value);
+            bool is_negative = signbit(coeffd);
+            coeffd = fabs(coeffd);
+
+            // Use faster decomposition methods when possible
+            if (coeff_bit_count <= 64)
+            {
+                uint64_t coeffu = static_cast<uint64_t>(coeffd);
+                for (size_t j = 0; j < coeff_modulus_size; j++)
+                {
+                    destination[j] = barrett_reduce_64(coeffu, coeff_modulus[j]);
+                }
+            }
+            else if (coeff_bit_count <= 128)
+            {
+                uint64_t coeffu[2]{ static_cast<uint64_t>(fmod(coeffd, two_pow_64)),
+                                    static_cast<uint64_t>(coeffd / two_pow_64) };
+                for (size_t j = 0; j < coeff_modulus_size; j++)
+                {
+                    destination[j] = barrett_reduce_128(coeffu, coeff_modulus[j]);
+                }
+            }
+            else
+            {
+                // Slow case
+                set_zero_uint(coeff_modulus_size, destination);
+                uint64_t *coeffu_ptr = destination;
+                while (coeffd >= 1)
+                {
+                    *coeffu_ptr++ = static_cast<uint64_t>(fmod(coeffd, two_pow_64));
+                    coeffd /= two_pow_64;
+                }
+                context_data.rns_tool()->base_q()->decompose(destination, pool);
+            }
+
+            if (is_negative)
+            {
+                for (size_t j = 0; j < coeff_modulus_size; j++)
+                {
+                    destination[j] = negate_uint_mod(destination[j], coeff_modulus[j]);
+                }
+            }
+        }
+
+        // Residues of the NTT form of round(Re(value)) + round(Im(value) / sqrt(2)) * (X^(N/4) + X^(3N/4)), which
+        // decodes to value in every CKKS slot. The NTT form of X^(N/4) + X^(3N/4) is r + r^3 for a primitive eighth
+        // root of unity r in the even quarters of the coefficients and -(r + r^3) in the odd quarters, so limb j is
+        // destination[j] in the even quarters and destination[coeff_modulus_size + j] in the odd quarters. Returns
+        // false if the imaginary part rounds to zero and both are the same.
+        bool encode_complex_scalar(
+            complex<double> value, const SEALContext::ContextData &context_data, uint64_t *destination,
+            MemoryPoolHandle pool)
+        {
+            auto &coeff_modulus = context_data.parms().coeff_modulus();
+            size_t coeff_count = context_data.parms().poly_modulus_degree();
+            size_t coeff_modulus_size = coeff_modulus.size();
+
+            encode_scalar(value.real(), context_data, destination, pool);
+            double imag_value = value.imag() / sqrt(2.0);
+            if (round(imag_value) == 0.0)
+            {
+                copy_n(destination, coeff_modulus_size, destination + coeff_modulus_size);
+                return false;
+            }
+            if (coeff_count < 4)
+            {
+                throw invalid_argument("poly_modulus_degree is too small for complex constants");
+            }
+
+            auto imag(allocate_uint(coeff_modulus_size, pool));
+            encode_scalar(imag_value, context_data, imag.get(), pool);
+            auto ntt_tables = iter(context_data.small_ntt_tables());
+            for (size_t j = 0; j < coeff_modulus_size; j++)
+            {
+                uint64_t root = exponentiate_uint_mod(ntt_tables[j].get_root(), coeff_count >> 2, coeff_modulus[j]);
+                uint64_t root_cubed = exponentiate_uint_mod(root, 3, coeff_modulus[j]);
+                uint64_t imag_unit = add_uint_mod(root, root_cubed, coeff_modulus[j]);
+                uint64_t imag_part = multiply_uint_mod(imag[j], imag_unit, coeff_modulus[j]);
+                destination[coeff_modulus_size + j] = sub_uint_mod(destination[j], imag_part, coeff_modulus[j]);
+                destination[j] = add_uint_mod(destination[j], imag_part, coeff_modulus[j]);
+            }
+            return true;
+        }
+
+        // Depth of x^i when computed as x^(2^a) * x^(i - 2^a) with 2^a < i <= 2^(a + 1)
+        SEAL_NODISCARD inline int get_power_depth(size_t i) noexcept
+        {
+            return get_significant_bit_count(static_cast<uint64_t>(i - 1));
+        }
+
+        // Paterson-Stockmeyer evaluation with k = 2^baby_log baby steps x, ..., x^k and giant steps x^(k * 2^j). The
+        // coefficients are split at the largest k * 2^j below their count until at most k of them remain.
+        struct PolynomialPlan
+        {
+            size_t baby_log = 0;
+
+            // powers[i] is true if x^i is computed, for i up to k
+            vector<bool> powers;
+
+            size_t giant_count = 0;
+
+            int depth = 0;
+
+            size_t mult_count = 0;
+        };
+
+        // Returns the depth of the term for the coefficients [lo, lo + len), or -1 if the term is constant
+        int plan_polynomial_term(const vector<bool> &nonzero, size_t lo, size_t len, PolynomialPlan &plan)
+        {
+            size_t k = size_t(1) << plan.baby_log;
+            if (len <= k)
+            {
+                // The scalar multiplications consume one level
+                int depth = -1;
+                for (size_t i = 1; i < len; i++)
+                {
+                    if (nonzero[lo + i])
+                    {
+                        plan.powers[i] = true;
+                        depth = max(depth, get_power_depth(i) + 1);
+                    }
+                }
+                return depth;
+            }
+
+            size_t j = 0;
+            while ((k << (j + 1)) < len)
+            {
+                j++;
+            }
+            size_t split = k << j;
+            int low_depth = plan_polynomial_term(nonzero, lo, split, plan);
+            int high_depth = plan_polynomial_term(nonzero, lo + split, len - split, plan);
+            if (high_depth < 0 && !nonzero[lo + split])
+            {
+                return low_depth;
+            }
+
+            plan.giant_count = max(plan.giant_count, j + 1);
+            int giant_depth = static_cast<int>(plan.baby_log + j);
+            if (high_depth < 0)
+            {
+                return max(low_depth, giant_depth + 1);
+            }
+            plan.mult_count++;
+            return max(low_depth, max(high_depth, giant_depth) + 1);
+        }
+
+        PolynomialPlan plan_polynomial(const vector<bool> &nonzero, size_t baby_log)
+        {
+            PolynomialPlan plan;
+            plan.baby_log = baby_log;
+            size_t k = size_t(1) << baby_log;
+            plan.powers.assign(k + 1, false);
+            plan.depth = plan_polynomial_term(nonzero, 0, nonzero.size(), plan);
+            if (plan.giant_count)
+            {
+                plan.powers[k] = true;
+                plan.mult_count += plan.giant_count - 1;
+            }
+
+            // Every power needs its two factors
+            plan.powers[1] = true;
+            for (size_t i = k; i > 1; i--)
+            {
+                if (plan.powers[i])
+                {
+                    size_t high = size_t(1) << get_power_depth(i);
+                    high = (high == i) ? i / 2 : high / 2;
+                    plan.powers[high] = true;
+                    plan.powers[i - high] = true;
+                    plan.mult_count++;
+                }
+            }
+            return plan;
+        }
     } // namespace
 
     Evaluator::Evaluator(const SEALContext &context) : context_(context)
@@ -56,6 +255,44 @@ namespace seal
         }
     }
 
+    void Evaluator::set_thread_count(size_t thread_count)
+    {
+        if (!thread_count)
+        {
+            throw invalid_argument("thread_count must be positive");
+        }
+        thread_pool_ = (thread_count > 1) ? make_shared<ThreadPool>(thread_count) : nullptr;
+    }
+
+    void Evaluator::set_bfv_mul(bfv_mul_type mul_type)
+    {
+        if (mul_type != bfv_mul_type::behz && mul_type != bfv_mul_type::hps)
+        {
+            throw invalid_argument("unsupported bfv_mul_type");
+        }
+        bfv_mul_ = mul_type;
+    }
+
+    void Evaluator::parallel_for(
+        size_t count, const MemoryPoolHandle &pool, const function<void(size_t, MemoryPoolHandle)> &func) const
+    {
+        if (!thread_pool_ || count < 2 || ThreadPool::in_parallel_region())
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                func(i, pool);
+            }
+            return;
+        }
+
+        // Allocations of the workers are tagged with the operation of the calling thread
+        const char *tag = MemoryPoolTraceScope::current_tag();
+        thread_pool_->parallel_for(count, [&](size_t i) {
+            MemoryPoolTraceScope trace_scope(tag);
+            func(i, MemoryPoolHandle::ThreadLocal());
+        });
+    }
+
     void Evaluator::negate_inplace(Ciphertext &encrypted) const
     {
         // Verify parameters.
@@ -228,6 +465,8 @@ namespace seal
 
     void Evaluator::multiply_inplace(Ciphertext &encrypted1, const Ciphertext &encrypted2, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("multiply");
+
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted1, context_) || !is_buffer_valid(encrypted1))
         {
@@ -292,6 +531,7 @@ namespace seal
         auto rns_tool = context_data.rns_tool();
         size_t base_Bsk_size = rns_tool->base_Bsk()->size();
         size_t base_Bsk_m_tilde_size = rns_tool->base_Bsk_m_tilde()->size();
+        bool use_hps = bfv_mul_ == bfv_mul_type::hps && rns_tool->hps_supported();
 
         // Determine destination.size()
         size_t dest_size = sub_safe(add_safe(encrypted1_size, encrypted2_size), size_t(1));
@@ -321,6 +561,13 @@ namespace seal
         // (6) Multiply the result by t (plain_modulus)
         // (7) Scale the result by q using a divide-and-floor algorithm, switching base to Bsk
         // (8) Use Shenoy-Kumaresan method to convert the result to base q
+        //
+        // With bfv_mul_type::hps the same base Bsk is used for HPS-style RNS multiplication instead:
+        //
+        // (1) Lift encrypted1 and encrypted2 exactly to base q U Bsk, with a floating-point correction of the fast base
+        //     conversion; steps (2)-(5) are as above except that (2) is not needed
+        // (6) Scale the result by t/q and round, producing a result in base Bsk
+        // (7) Convert the result exactly to base q, again with a floating-point correction
 
         // Resize encrypted1 to destination size
         encrypted1.resize(context_, context_data.parms_id(), dest_size);
@@ -331,23 +578,31 @@ namespace seal
         // 2. RNSIter for the output in base q
         // 3. RNSIter for the output in base Bsk
         //
-        // It performs steps (1)-(3) of the BEHZ multiplication (see above) on the given input polynomial (given as an
-        // RNSIter or ConstRNSIter) and writes the results in base q and base Bsk to the given output
-        // iterators.
+        // It performs steps (1)-(3) of the BEHZ multiplication, or of the HPS multiplication if use_hps is set (see
+        // above), on the given input polynomial (given as an RNSIter or ConstRNSIter) and writes the results in base q
+        // and base Bsk to the given output iterators.
         auto behz_extend_base_convert_to_ntt = [&](auto I) {
             // Make copy of input polynomial (in base q) and convert to NTT form
             // Lazy reduction
             set_poly(get<0>(I), coeff_count, base_q_size, get<1>(I));
             ntt_negacyclic_harvey_lazy(get<1>(I), base_q_size, base_q_ntt_tables);
 
-            // Allocate temporary space for a polynomial in the Bsk U {m_tilde} base
-            SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, base_Bsk_m_tilde_size, pool);
+            if (use_hps)
+            {
+                // HPS step (1): convert exactly from base q to base Bsk
+                rns_tool->hps_lift_q_to_Bsk(get<0>(I), get<2>(I), pool);
+            }
+            else
+            {
+                // Allocate temporary space for a polynomial in the Bsk U {m_tilde} base
+                SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, base_Bsk_m_tilde_size, pool);
 
-            // (1) Convert from base q to base Bsk U {m_tilde}
-            rns_tool->fastbconv_m_tilde(get<0>(I), temp, pool);
+                // (1) Convert from base q to base Bsk U {m_tilde}
+                rns_tool->fastbconv_m_tilde(get<0>(I), temp, pool);
 
-            // (2) Reduce q-overflows in with Montgomery reduction, switching base to Bsk
-            rns_tool->sm_mrq(temp, get<2>(I), pool);
+                // (2) Reduce q-overflows in with Montgomery reduction, switching base to Bsk
+                rns_tool->sm_mrq(temp, get<2>(I), pool);
+            }
 
             // Transform to NTT form in base Bsk
             // Lazy reduction
@@ -421,6 +676,29 @@ namespace seal
             behz_ciphertext_product(encrypted1_Bsk, encrypted2_Bsk, base_Bsk, base_Bsk_size, temp_dest_Bsk);
         });
 
+        if (use_hps)
+        {
+            // Perform HPS step (5): transform data from NTT form
+            inverse_ntt_negacyclic_harvey(temp_dest_q, dest_size, base_q_ntt_tables);
+            inverse_ntt_negacyclic_harvey(temp_dest_Bsk, dest_size, base_Bsk_ntt_tables);
+
+            // Perform HPS steps (6)-(7)
+            SEAL_ITERATE(iter(temp_dest_q, temp_dest_Bsk, encrypted1), dest_size, [&](auto I) {
+                // Allocate temporary space for the scaled result in base Bsk
+                SEAL_ALLOCATE_GET_RNS_ITER(temp_Bsk, coeff_count, base_Bsk_size, pool);
+
+                // Step (6): scale by t/q and round, producing a result in base Bsk
+                rns_tool->hps_scale_and_round(get<0>(I), get<1>(I), temp_Bsk, pool);
+
+                // Step (7): convert the result exactly to base q and write to encrypted1
+                rns_tool->hps_convert_Bsk_to_q(temp_Bsk, get<2>(I), pool);
+            });
+
+            // Set the scale
+            encrypted1.scale() = new_scale;
+            return;
+        }
+
         // Perform BEHZ step (5): transform data from NTT form
         // Lazy reduction here. The following multiply_poly_scalar_coeffmod will correct the value back to [0, p)
         inverse_ntt_negacyclic_harvey_lazy(temp_dest_q, dest_size, base_q_ntt_tables);
@@ -595,6 +873,8 @@ namespace seal
 
     void Evaluator::square_inplace(Ciphertext &encrypted, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("square");
+
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
@@ -648,6 +928,7 @@ namespace seal
         auto rns_tool = context_data.rns_tool();
         size_t base_Bsk_size = rns_tool->base_Bsk()->size();
         size_t base_Bsk_m_tilde_size = rns_tool->base_Bsk_m_tilde()->size();
+        bool use_hps = bfv_mul_ == bfv_mul_type::hps && rns_tool->hps_supported();
 
         // Optimization implemented currently only for size 2 ciphertexts
         if (encrypted_size != 2)
@@ -673,9 +954,10 @@ namespace seal
         auto base_q_ntt_tables = iter(context_data.small_ntt_tables());
         auto base_Bsk_ntt_tables = iter(rns_tool->base_Bsk_ntt_tables());
 
-        // Microsoft SEAL uses BEHZ-style RNS multiplication. For details, see Evaluator::bfv_multiply. This function
-        // uses additionally Karatsuba multiplication to reduce the complexity of squaring a size-2 ciphertext, but the
-        // steps are otherwise the same as in Evaluator::bfv_multiply.
+        // Microsoft SEAL uses BEHZ-style RNS multiplication, or HPS-style RNS multiplication if use_hps is set. For
+        // details, see Evaluator::bfv_multiply. This function uses additionally Karatsuba multiplication to reduce the
+        // complexity of squaring a size-2 ciphertext, but the steps are otherwise the same as in
+        // Evaluator::bfv_multiply.
 
         // Resize encrypted to destination size
         encrypted.resize(context_, context_data.parms_id(), dest_size);
@@ -686,22 +968,30 @@ namespace seal
         // 2. RNSIter for the output in base q
         // 3. RNSIter for the output in base Bsk
         //
-        // It performs steps (1)-(3) of the BEHZ multiplication on the given input polynomial (given as an RNSIter
-        // or ConstRNSIter) and writes the results in base q and base Bsk to the given output iterators.
+        // It performs steps (1)-(3) of the BEHZ or HPS multiplication on the given input polynomial (given as an
+        // RNSIter or ConstRNSIter) and writes the results in base q and base Bsk to the given output iterators.
         auto behz_extend_base_convert_to_ntt = [&](auto I) {
             // Make copy of input polynomial (in base q) and convert to NTT form
             // Lazy reduction
             set_poly(get<0>(I), coeff_count, base_q_size, get<1>(I));
             ntt_negacyclic_harvey_lazy(get<1>(I), base_q_size, base_q_ntt_tables);
 
-            // Allocate temporary space for a polynomial in the Bsk U {m_tilde} base
-            SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, base_Bsk_m_tilde_size, pool);
+            if (use_hps)
+            {
+                // HPS step (1): convert exactly from base q to base Bsk
+                rns_tool->hps_lift_q_to_Bsk(get<0>(I), get<2>(I), pool);
+            }
+            else
+            {
+                // Allocate temporary space for a polynomial in the Bsk U {m_tilde} base
+                SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, base_Bsk_m_tilde_size, pool);
 
-            // (1) Convert from base q to base Bsk U {m_tilde}
-            rns_tool->fastbconv_m_tilde(get<0>(I), temp, pool);
+                // (1) Convert from base q to base Bsk U {m_tilde}
+                rns_tool->fastbconv_m_tilde(get<0>(I), temp, pool);
 
-            // (2) Reduce q-overflows in with Montgomery reduction, switching base to Bsk
-            rns_tool->sm_mrq(temp, get<2>(I), pool);
+                // (2) Reduce q-overflows in with Montgomery reduction, switching base to Bsk
+                rns_tool->sm_mrq(temp, get<2>(I), pool);
+            }
 
             // Transform to NTT form in base Bsk
             // Lazy reduction
@@ -753,6 +1043,20 @@ namespace seal
         inverse_ntt_negacyclic_harvey(temp_dest_q, dest_size, base_q_ntt_tables);
         inverse_ntt_negacyclic_harvey(temp_dest_Bsk, dest_size, base_Bsk_ntt_tables);
 
+        if (use_hps)
+        {
+            // Perform HPS steps (6)-(7)
+            SEAL_ITERATE(iter(temp_dest_q, temp_dest_Bsk, encrypted), dest_size, [&](auto I) {
+                SEAL_ALLOCATE_GET_RNS_ITER(temp_Bsk, coeff_count, base_Bsk_size, pool);
+                rns_tool->hps_scale_and_round(get<0>(I), get<1>(I), temp_Bsk, pool);
+                rns_tool->hps_convert_Bsk_to_q(temp_Bsk, get<2>(I), pool);
+            });
+
+            // Set the scale
+            encrypted.scale() = new_scale;
+            return;
+        }
+
         // Perform BEHZ steps (6)-(8)
         SEAL_ITERATE(iter(temp_dest_q, temp_dest_Bsk, encrypted), dest_size, [&](auto I) {
             // Bring together the base q and base Bsk components into a single allocation
@@ -843,6 +1147,8 @@ namespace seal
     void Evaluator::relinearize_internal(
         Ciphertext &encrypted, const RelinKeys &relin_keys, size_t destination_size, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("relinearize");
+
         // Verify parameters.
         auto context_data_ptr = context_.get_context_data(encrypted.parms_id());
         if (!context_data_ptr)
@@ -897,6 +1203,178 @@ namespace seal
 #endif
     }
 
+    void Evaluator::multiply_relin_rescale_inplace(
+        Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys, MemoryPoolHandle pool) const
+    {
+        MemoryPoolTraceScope trace_scope("multiply_relin_rescale");
+
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted1, context_) || !is_buffer_valid(encrypted1))
+        {
+            throw invalid_argument("encrypted1 is not valid for encryption parameters");
+        }
+        if (!context_.using_keyswitching())
+        {
+            throw logic_error("keyswitching is not supported by the context");
+        }
+        if (relin_keys.parms_id() != context_.key_parms_id())
+        {
+            throw invalid_argument("relin_keys is not valid for encryption parameters");
+        }
+        auto &context_data = *context_.get_context_data(encrypted1.parms_id());
+        if (!context_data.next_context_data() || !context_data.kswitch_rescale_tool())
+        {
+            throw invalid_argument("end of modulus switching chain reached");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        multiply_inplace(encrypted1, encrypted2, pool);
+        relinearize_rescale_internal(encrypted1, relin_keys, move(pool));
+    }
+
+    void Evaluator::inner_product(
+        const vector<Ciphertext> &encrypteds1, const vector<Ciphertext> &encrypteds2, const RelinKeys &relin_keys,
+        Ciphertext &destination, MemoryPoolHandle pool) const
+    {
+        MemoryPoolTraceScope trace_scope("inner_product");
+
+        // Verify parameters.
+        if (encrypteds1.empty())
+        {
+            throw invalid_argument("encrypteds1 cannot be empty");
+        }
+        if (encrypteds1.size() != encrypteds2.size())
+        {
+            throw invalid_argument("encrypteds1 and encrypteds2 size mismatch");
+        }
+        for (size_t i = 0; i < encrypteds1.size(); i++)
+        {
+            if (&encrypteds1[i] == &destination || &encrypteds2[i] == &destination)
+            {
+                throw invalid_argument("encrypteds1 and encrypteds2 must be different from destination");
+            }
+        }
+        if (!context_.using_keyswitching())
+        {
+            throw logic_error("keyswitching is not supported by the context");
+        }
+        if (relin_keys.parms_id() != context_.key_parms_id())
+        {
+            throw invalid_argument("relin_keys is not valid for encryption parameters");
+        }
+        auto context_data_ptr = context_.get_context_data(encrypteds1[0].parms_id());
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("encrypteds1 is not valid for encryption parameters");
+        }
+        bool rescale = context_data_ptr->parms().scheme() == scheme_type::ckks;
+        if (rescale && !context_data_ptr->kswitch_rescale_tool())
+        {
+            throw invalid_argument("end of modulus switching chain reached");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        // The products are accumulated without relinearization
+        multiply(encrypteds1[0], encrypteds2[0], destination, pool);
+        Ciphertext product(pool);
+        for (size_t i = 1; i < encrypteds1.size(); i++)
+        {
+            multiply(encrypteds1[i], encrypteds2[i], product, pool);
+            add_inplace(destination, product);
+        }
+
+        // A single key switching for the whole sum
+        if (rescale)
+        {
+            relinearize_rescale_internal(destination, relin_keys, move(pool));
+        }
+        else
+        {
+            relinearize_internal(destination, relin_keys, 2, move(pool));
+        }
+    }
+
+    void Evaluator::relinearize_rescale_internal(
+        Ciphertext &encrypted, const RelinKeys &relin_keys, MemoryPoolHandle pool) const
+    {
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+
+        // Larger products are first relinearized down to size 3 as usual
+        relinearize_internal(encrypted, relin_keys, 3, pool);
+
+        // Extract encryption parameters.
+        auto &key_context_data = *context_.key_context_data();
+        size_t coeff_count = context_data.parms().poly_modulus_degree();
+        size_t decomp_modulus_size = context_data.parms().coeff_modulus().size();
+        size_t ext_modulus_size = decomp_modulus_size + key_context_data.parms().special_modulus_size();
+        size_t digit_count = context_data.hybrid_kswitch_tool() ? context_data.hybrid_kswitch_tool()->digit_count()
+                                                                 : decomp_modulus_size;
+
+        // Seeded keys are used in place and expanded one component at a time
+        if (relin_keys.is_seeded())
+        {
+            // Check only the used component in RelinKeys
+            if (relin_keys.seeded_key_size(RelinKeys::get_index(2), context_) < digit_count)
+            {
+                throw invalid_argument("relin_keys is not valid for encryption parameters");
+            }
+            if (!product_fits_in(coeff_count, ext_modulus_size, max(digit_count, size_t(2))))
+            {
+                throw logic_error("invalid parameters");
+            }
+
+            // Key switch the last component but leave the products modulo the data and special primes
+            SEAL_ALLOCATE_GET_POLY_ITER(t_poly_prod, 2, coeff_count, ext_modulus_size, pool);
+            kswitch_products_seeded(
+                iter(encrypted)[2], relin_keys, RelinKeys::get_index(2), context_data, t_poly_prod, pool);
+
+            // Divide by the special primes and the last data prime at once
+            kswitch_mod_down_rescale(t_poly_prod, 2, encrypted, pool);
+        }
+        else
+        {
+            // Check only the used component in RelinKeys
+            auto key_ptr = relin_keys.acquire(RelinKeys::get_index(2));
+            auto &key_vector = *key_ptr;
+            if (key_vector.size() < digit_count)
+            {
+                throw invalid_argument("relin_keys is not valid for encryption parameters");
+            }
+            for (auto &each_key : key_vector)
+            {
+                if (!is_metadata_valid_for(each_key, context_) || !is_buffer_valid(each_key))
+                {
+                    throw invalid_argument("relin_keys is not valid for encryption parameters");
+                }
+            }
+            size_t key_component_count = key_vector[0].data().size();
+            if (!product_fits_in(coeff_count, ext_modulus_size, max(digit_count, key_component_count)))
+            {
+                throw logic_error("invalid parameters");
+            }
+
+            // Key switch the last component but leave the products modulo the data and special primes
+            SEAL_ALLOCATE_GET_POLY_ITER(t_poly_prod, key_component_count, coeff_count, ext_modulus_size, pool);
+            kswitch_products(iter(encrypted)[2], key_vector, context_data, t_poly_prod, pool);
+
+            // Divide by the special primes and the last data prime at once
+            kswitch_mod_down_rescale(t_poly_prod, key_component_count, encrypted, pool);
+        }
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
     void Evaluator::mod_switch_scale_to_next(
         const Ciphertext &encrypted, Ciphertext &destination, MemoryPoolHandle pool) const
     {
@@ -1065,6 +1543,8 @@ namespace seal
     void Evaluator::mod_switch_to_next(
         const Ciphertext &encrypted, Ciphertext &destination, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("mod_switch_to_next");
+
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
@@ -1107,6 +1587,8 @@ namespace seal
 
     void Evaluator::mod_switch_to_inplace(Ciphertext &encrypted, parms_id_type parms_id, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("mod_switch_to");
+
         // Verify parameters.
         auto context_data_ptr = context_.get_context_data(encrypted.parms_id());
         auto target_context_data_ptr = context_.get_context_data(parms_id);
@@ -1159,6 +1641,8 @@ namespace seal
 
     void Evaluator::rescale_to_next(const Ciphertext &encrypted, Ciphertext &destination, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("rescale_to_next");
+
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
@@ -1197,6 +1681,8 @@ namespace seal
 
     void Evaluator::rescale_to_inplace(Ciphertext &encrypted, parms_id_type parms_id, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("rescale_to");
+
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
@@ -1251,6 +1737,8 @@ namespace seal
         const vector<Ciphertext> &encrypteds, const RelinKeys &relin_keys, Ciphertext &destination,
         MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("multiply_many");
+
         // Verify parameters.
         if (encrypteds.size() == 0)
         {
@@ -1279,7 +1767,7 @@ namespace seal
         auto &context_data = *context_data_ptr;
         auto &parms = context_data.parms();
 
-        if (parms.scheme() != scheme_type::bfv)
+        if (parms.scheme() != scheme_type::bfv && parms.scheme() != scheme_type::ckks)
         {
             throw logic_error("unsupported scheme");
         }
@@ -1291,42 +1779,97 @@ namespace seal
             return;
         }
 
-        // Do first level of multiplications
-        vector<Ciphertext> product_vec;
-        for (size_t i = 0; i < encrypteds.size() - 1; i += 2)
-        {
-            Ciphertext temp(context_, context_data.parms_id(), pool);
-            if (encrypteds[i].data() == encrypteds[i + 1].data())
+        // Multiplies two ciphertexts and relinearizes the product; in CKKS the product is also rescaled
+        auto multiply_pair = [&](const Ciphertext &encrypted1, const Ciphertext &encrypted2, Ciphertext &product,
+                                 MemoryPoolHandle node_pool) {
+            if (parms.scheme() == scheme_type::ckks)
             {
-                square(encrypteds[i], temp);
+                multiply_relin_rescale_aligned(encrypted1, encrypted2, relin_keys, product, move(node_pool));
+                return;
+            }
+
+            if (encrypted1.data() == encrypted2.data())
+            {
+                square(encrypted1, product, node_pool);
             }
             else
             {
-                multiply(encrypteds[i], encrypteds[i + 1], temp);
+                multiply(encrypted1, encrypted2, product, node_pool);
             }
-            relinearize_inplace(temp, relin_keys, pool);
-            product_vec.emplace_back(move(temp));
-        }
-        if (encrypteds.size() & 1)
-        {
-            product_vec.emplace_back(encrypteds.back());
-        }
+            relinearize_inplace(product, relin_keys, node_pool);
+        };
 
-        // Repeatedly multiply and add to the back of the vector until the end is reached
-        for (size_t i = 0; i < product_vec.size() - 1; i += 2)
+        // Multiply the tree level by level; an odd ciphertext out is carried to the end of the next level
+        const vector<Ciphertext> *level_ptr = &encrypteds;
+        vector<Ciphertext> level_vec;
+        while (level_ptr->size() > 1)
         {
-            Ciphertext temp(context_, context_data.parms_id(), pool);
-            multiply(product_vec[i], product_vec[i + 1], temp);
-            relinearize_inplace(temp, relin_keys, pool);
-            product_vec.emplace_back(move(temp));
+            const vector<Ciphertext> &level = *level_ptr;
+            size_t pair_count = level.size() / 2;
+
+            // Reserve the products here so that the threads only allocate from thread-local memory pools
+            vector<Ciphertext> next_level_vec;
+            next_level_vec.reserve(pair_count + (level.size() & 1));
+            for (size_t i = 0; i < pair_count; i++)
+            {
+                const Ciphertext &encrypted1 = level[2 * i];
+                const Ciphertext &encrypted2 = level[2 * i + 1];
+                auto &higher = context_.get_context_data(encrypted1.parms_id())->chain_index() >=
+                                       context_.get_context_data(encrypted2.parms_id())->chain_index()
+                                   ? encrypted1
+                                   : encrypted2;
+                size_t size_capacity = max(encrypted1.size() + encrypted2.size() - 1, size_t(3));
+                next_level_vec.emplace_back(context_, higher.parms_id(), size_capacity, pool);
+            }
+
+            // The products of one level are independent of each other
+            parallel_for(pair_count, pool, [&](size_t i, MemoryPoolHandle node_pool) {
+                multiply_pair(level[2 * i], level[2 * i + 1], next_level_vec[i], node_pool);
+            });
+            if (level.size() & 1)
+            {
+                next_level_vec.emplace_back(level.back());
+            }
+
+            level_vec = move(next_level_vec);
+            level_ptr = &level_vec;
         }
 
-        destination = product_vec.back();
+        destination = level_vec[0];
     }
 
-    void Evaluator::exponentiate_inplace(
+    void Evaluator::multiply_relin_rescale_aligned(
+        const Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys,
+        Ciphertext &destination, MemoryPoolHandle pool) const
+    {
+        size_t level1 = context_.get_context_data(encrypted1.parms_id())->chain_index();
+        size_t level2 = context_.get_context_data(encrypted2.parms_id())->chain_index();
+        if (level1 == level2)
+        {
+            multiply_relin_rescale(encrypted1, encrypted2, relin_keys, destination, move(pool));
+            return;
+        }
+
+        // The operand at the higher level is first switched down to the level of the other
+        const Ciphertext &higher = (level1 > level2) ? encrypted1 : encrypted2;
+        const Ciphertext &lower = (level1 > level2) ? encrypted2 : encrypted1;
+        if (&destination == &lower)
+        {
+            Ciphertext temp(higher, pool);
+            mod_switch_to_inplace(temp, lower.parms_id(), pool);
+            multiply_relin_rescale_inplace(destination, temp, relin_keys, move(pool));
+            return;
+        }
+        destination = higher;
+        mod_switch_to_inplace(destination, lower.parms_id(), pool);
+        multiply_relin_rescale_inplace(destination, lower, relin_keys, move(pool));
+    }
+
+    void Evaluator::exponentiate_inplace(
         Ciphertext &encrypted, uint64_t exponent, const RelinKeys &relin_keys, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("exponentiate");
+
         // Verify parameters.
         auto context_data_ptr = context_.get_context_data(encrypted.parms_id());
         if (!context_data_ptr)
@@ -1357,71 +1900,92 @@ namespace seal
         multiply_many(exp_vector, relin_keys, encrypted, move(pool));
     }
 
-    void Evaluator::add_plain_inplace(Ciphertext &encrypted, const Plaintext &plain) const
+    void Evaluator::multiply_const_inplace(
+        Ciphertext &encrypted, double value, double scale, MemoryPoolHandle pool) const
+    {
+        multiply_const_inplace(encrypted, complex<double>(value, 0.0), scale, move(pool));
+    }
+
+    void Evaluator::multiply_const_inplace(
+        Ciphertext &encrypted, complex<double> value, double scale, MemoryPoolHandle pool) const
     {
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-        if (!is_metadata_valid_for(plain, context_) || !is_buffer_valid(plain))
+        if (context_.get_context_data(encrypted.parms_id())->parms().scheme() != scheme_type::ckks)
         {
-            throw invalid_argument("plain is not valid for encryption parameters");
+            throw logic_error("unsupported scheme");
         }
-
-        auto &context_data = *context_.get_context_data(encrypted.parms_id());
-        auto &parms = context_data.parms();
-        if (parms.scheme() == scheme_type::bfv && encrypted.is_ntt_form())
+        if (!encrypted.is_ntt_form())
         {
-            throw invalid_argument("BFV encrypted cannot be in NTT form");
+            throw invalid_argument("CKKS encrypted must be in NTT form");
         }
-        if (parms.scheme() == scheme_type::ckks && !encrypted.is_ntt_form())
+        if (!pool)
         {
-            throw invalid_argument("CKKS encrypted must be in NTT form");
+            throw invalid_argument("pool is uninitialized");
         }
-        if (plain.is_ntt_form() != encrypted.is_ntt_form())
+
+        multiply_const_internal(encrypted, value, scale, move(pool));
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
         {
-            throw invalid_argument("NTT form mismatch");
+            throw logic_error("result ciphertext is transparent");
         }
-        if (encrypted.is_ntt_form() && (encrypted.parms_id() != plain.parms_id()))
+#endif
+    }
+
+    void Evaluator::multiply_const_inplace(Ciphertext &encrypted, uint64_t value) const
+    {
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
-            throw invalid_argument("encrypted and plain parameter mismatch");
+            throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-        if (!are_same_scale(encrypted, plain))
+        auto &parms = context_.get_context_data(encrypted.parms_id())->parms();
+        if (parms.scheme() != scheme_type::bfv)
         {
-            throw invalid_argument("scale mismatch");
+            throw logic_error("unsupported scheme");
         }
 
-        // Extract encryption parameters.
-        auto &coeff_modulus = parms.coeff_modulus();
-        size_t coeff_count = parms.poly_modulus_degree();
-        size_t coeff_modulus_size = coeff_modulus.size();
-
-        // Size check
-        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        multiply_const_internal(encrypted, barrett_reduce_64(value, parms.plain_modulus()));
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
         {
-            throw logic_error("invalid parameters");
+            throw logic_error("result ciphertext is transparent");
         }
+#endif
+    }
 
-        switch (parms.scheme())
+    void Evaluator::add_const_inplace(Ciphertext &encrypted, double value, MemoryPoolHandle pool) const
+    {
+        add_const_inplace(encrypted, complex<double>(value, 0.0), move(pool));
+    }
+
+    void Evaluator::add_const_inplace(Ciphertext &encrypted, complex<double> value, MemoryPoolHandle pool) const
+    {
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
-        case scheme_type::bfv:
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (context_.get_context_data(encrypted.parms_id())->parms().scheme() != scheme_type::ckks)
         {
-            multiply_add_plain_with_scaling_variant(plain, context_data, *iter(encrypted));
-            break;
+            throw logic_error("unsupported scheme");
         }
-
-        case scheme_type::ckks:
+        if (!encrypted.is_ntt_form())
         {
-            RNSIter encrypted_iter(encrypted.data(), coeff_count);
-            ConstRNSIter plain_iter(plain.data(), coeff_count);
-            add_poly_coeffmod(encrypted_iter, plain_iter, coeff_modulus_size, coeff_modulus, encrypted_iter);
-            break;
+            throw invalid_argument("CKKS encrypted must be in NTT form");
         }
-
-        default:
-            throw invalid_argument("unsupported scheme");
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
         }
+
+        add_const_internal(encrypted, value, move(pool));
 #ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
         // Transparent ciphertext output is not allowed.
         if (encrypted.is_transparent())
@@ -1431,339 +1995,843 @@ namespace seal
 #endif
     }
 
-    void Evaluator::sub_plain_inplace(Ciphertext &encrypted, const Plaintext &plain) const
+    void Evaluator::add_const_inplace(Ciphertext &encrypted, uint64_t value) const
     {
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-        if (!is_metadata_valid_for(plain, context_) || !is_buffer_valid(plain))
+        auto &parms = context_.get_context_data(encrypted.parms_id())->parms();
+        if (parms.scheme() != scheme_type::bfv)
         {
-            throw invalid_argument("plain is not valid for encryption parameters");
+            throw logic_error("unsupported scheme");
         }
-
-        auto &context_data = *context_.get_context_data(encrypted.parms_id());
-        auto &parms = context_data.parms();
-        if (parms.scheme() == scheme_type::bfv && encrypted.is_ntt_form())
+        if (encrypted.is_ntt_form())
         {
             throw invalid_argument("BFV encrypted cannot be in NTT form");
         }
-        if (parms.scheme() == scheme_type::ckks && !encrypted.is_ntt_form())
-        {
-            throw invalid_argument("CKKS encrypted must be in NTT form");
-        }
-        if (plain.is_ntt_form() != encrypted.is_ntt_form())
+
+        add_const_internal(encrypted, barrett_reduce_64(value, parms.plain_modulus()));
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
         {
-            throw invalid_argument("NTT form mismatch");
+            throw logic_error("result ciphertext is transparent");
         }
-        if (encrypted.is_ntt_form() && (encrypted.parms_id() != plain.parms_id()))
+#endif
+    }
+
+    void Evaluator::multiply_const_internal(
+        Ciphertext &encrypted, complex<double> value, double scale, MemoryPoolHandle pool) const
+    {
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &coeff_modulus = context_data.parms().coeff_modulus();
+        size_t coeff_count = context_data.parms().poly_modulus_degree();
+        size_t coeff_modulus_size = coeff_modulus.size();
+        double new_scale = encrypted.scale() * scale;
+        if (!is_scale_within_bounds(new_scale, context_data))
         {
-            throw invalid_argument("encrypted and plain parameter mismatch");
+            throw invalid_argument("scale out of bounds");
         }
-        if (!are_same_scale(encrypted, plain))
+
+        // The encoding of a real scalar is the same constant in every NTT coefficient
+        auto scalars(allocate_uint(2 * coeff_modulus_size, pool));
+        bool is_complex = encode_complex_scalar(value * scale, context_data, scalars.get(), pool);
+        size_t block_count = is_complex ? 4 : 1;
+        size_t block_size = coeff_count / block_count;
+        SEAL_ITERATE(iter(encrypted), encrypted.size(), [&](auto I) {
+            for (size_t j = 0; j < coeff_modulus_size; j++)
+            {
+                for (size_t k = 0; k < block_count; k++)
+                {
+                    CoeffIter block = I[j] + k * block_size;
+                    uint64_t scalar = scalars[(k & 1) * coeff_modulus_size + j];
+                    multiply_poly_scalar_coeffmod(block, block_size, scalar, coeff_modulus[j], block);
+                }
+            }
+        });
+        encrypted.scale() = new_scale;
+    }
+
+    void Evaluator::add_const_internal(Ciphertext &encrypted, complex<double> value, MemoryPoolHandle pool) const
+    {
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &coeff_modulus = context_data.parms().coeff_modulus();
+        size_t coeff_count = context_data.parms().poly_modulus_degree();
+        size_t coeff_modulus_size = coeff_modulus.size();
+
+        auto scalars(allocate_uint(2 * coeff_modulus_size, pool));
+        bool is_complex = encode_complex_scalar(value * encrypted.scale(), context_data, scalars.get(), pool);
+        size_t block_count = is_complex ? 4 : 1;
+        size_t block_size = coeff_count / block_count;
+        RNSIter encrypted_iter = *iter(encrypted);
+        for (size_t j = 0; j < coeff_modulus_size; j++)
         {
-            throw invalid_argument("scale mismatch");
+            for (size_t k = 0; k < block_count; k++)
+            {
+                CoeffIter block = encrypted_iter[j] + k * block_size;
+                uint64_t scalar = scalars[(k & 1) * coeff_modulus_size + j];
+                add_poly_scalar_coeffmod(block, block_size, scalar, coeff_modulus[j], block);
+            }
         }
+    }
 
-        // Extract encryption parameters.
+    void Evaluator::multiply_const_internal(Ciphertext &encrypted, uint64_t value) const
+    {
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
         auto &coeff_modulus = parms.coeff_modulus();
         size_t coeff_count = parms.poly_modulus_degree();
         size_t coeff_modulus_size = coeff_modulus.size();
 
-        // Size check
-        if (!product_fits_in(coeff_count, coeff_modulus_size))
-        {
-            throw logic_error("invalid parameters");
-        }
+        // Multiply by the centered representative modulo the plaintext modulus to limit the noise growth
+        uint64_t plain_modulus = parms.plain_modulus().value();
+        bool is_negative = value > (plain_modulus >> 1);
+        uint64_t abs_value = is_negative ? plain_modulus - value : value;
+        SEAL_ITERATE(iter(encrypted), encrypted.size(), [&](auto I) {
+            SEAL_ITERATE(iter(I, coeff_modulus), coeff_modulus_size, [&](auto J) {
+                uint64_t scalar = barrett_reduce_64(abs_value, get<1>(J));
+                scalar = is_negative ? negate_uint_mod(scalar, get<1>(J)) : scalar;
+                multiply_poly_scalar_coeffmod(get<0>(J), coeff_count, scalar, get<1>(J), get<0>(J));
+            });
+        });
+    }
 
-        switch (parms.scheme())
-        {
-        case scheme_type::bfv:
-        {
-            multiply_sub_plain_with_scaling_variant(plain, context_data, *iter(encrypted));
-            break;
-        }
+    void Evaluator::add_const_internal(Ciphertext &encrypted, uint64_t value) const
+    {
+        // Delta * value is added to the first component
+        Plaintext plain(1);
+        plain[0] = value;
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        multiply_add_plain_with_scaling_variant(plain, context_data, *iter(encrypted));
+    }
 
-        case scheme_type::ckks:
-        {
-            RNSIter encrypted_iter(encrypted.data(), coeff_count);
-            ConstRNSIter plain_iter(plain.data(), coeff_count);
-            sub_poly_coeffmod(encrypted_iter, plain_iter, coeff_modulus_size, coeff_modulus, encrypted_iter);
-            break;
-        }
+    void Evaluator::evaluate_polynomial(
+        const Ciphertext &encrypted, const vector<double> &coeffs, const RelinKeys &relin_keys,
+        Ciphertext &destination, MemoryPoolHandle pool) const
+    {
+        MemoryPoolTraceScope trace_scope("evaluate_polynomial");
 
-        default:
-            throw invalid_argument("unsupported scheme");
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
-        // Transparent ciphertext output is not allowed.
-        if (encrypted.is_transparent())
+        if (context_.get_context_data(encrypted.parms_id())->parms().scheme() != scheme_type::ckks)
         {
-            throw logic_error("result ciphertext is transparent");
+            throw logic_error("unsupported scheme");
         }
-#endif
+
+        vector<bool> nonzero(coeffs.size());
+        transform(coeffs.cbegin(), coeffs.cend(), nonzero.begin(), [](double coeff) { return coeff != 0.0; });
+        evaluate_polynomial_internal(
+            encrypted, nonzero,
+            [&](Ciphertext &term, size_t index, double scale) {
+                multiply_const_internal(term, coeffs[index], scale, pool);
+            },
+            [&](Ciphertext &term, size_t index) { add_const_internal(term, coeffs[index], pool); }, relin_keys,
+            destination, pool);
     }
 
-    void Evaluator::multiply_plain_inplace(Ciphertext &encrypted, const Plaintext &plain, MemoryPoolHandle pool) const
+    void Evaluator::evaluate_polynomial(
+        const Ciphertext &encrypted, const vector<uint64_t> &coeffs, const RelinKeys &relin_keys,
+        Ciphertext &destination, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("evaluate_polynomial");
+
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-        if (!is_metadata_valid_for(plain, context_) || !is_buffer_valid(plain))
+        auto &parms = context_.get_context_data(encrypted.parms_id())->parms();
+        if (parms.scheme() != scheme_type::bfv)
         {
-            throw invalid_argument("plain is not valid for encryption parameters");
+            throw logic_error("unsupported scheme");
         }
-        if (encrypted.is_ntt_form() != plain.is_ntt_form())
+
+        // The coefficients are reduced modulo the plaintext modulus
+        auto &plain_modulus = parms.plain_modulus();
+        vector<uint64_t> reduced_coeffs(coeffs.size());
+        vector<bool> nonzero(coeffs.size());
+        for (size_t i = 0; i < coeffs.size(); i++)
         {
-            throw invalid_argument("NTT form mismatch");
+            reduced_coeffs[i] = barrett_reduce_64(coeffs[i], plain_modulus);
+            nonzero[i] = reduced_coeffs[i] != 0;
         }
+        evaluate_polynomial_internal(
+            encrypted, nonzero,
+            [&](Ciphertext &term, size_t index, double) { multiply_const_internal(term, reduced_coeffs[index]); },
+            [&](Ciphertext &term, size_t index) { add_const_internal(term, reduced_coeffs[index]); }, relin_keys,
+            destination, pool);
+    }
+
+    void Evaluator::evaluate_polynomial_internal(
+        const Ciphertext &encrypted, vector<bool> nonzero,
+        const function<void(Ciphertext &, size_t, double)> &multiply_coeff,
+        const function<void(Ciphertext &, size_t)> &add_coeff, const RelinKeys &relin_keys, Ciphertext &destination,
+        MemoryPoolHandle pool) const
+    {
         if (!pool)
         {
             throw invalid_argument("pool is uninitialized");
         }
-
-        if (encrypted.is_ntt_form())
+        if (!context_.using_keyswitching())
         {
-            multiply_plain_ntt(encrypted, plain);
+            throw logic_error("keyswitching is not supported by the context");
         }
-        else
+
+        // The degree is that of the highest nonzero coefficient
+        while (!nonzero.empty() && !nonzero.back())
         {
-            multiply_plain_normal(encrypted, plain, move(pool));
+            nonzero.pop_back();
         }
-#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
-        // Transparent ciphertext output is not allowed.
-        if (encrypted.is_transparent())
+        if (nonzero.size() < 2)
         {
-            throw logic_error("result ciphertext is transparent");
+            throw invalid_argument("coeffs must have a nonzero coefficient of degree at least 1");
         }
-#endif
-    }
-
-    void Evaluator::multiply_plain_normal(Ciphertext &encrypted, const Plaintext &plain, MemoryPoolHandle pool) const
-    {
-        // Extract encryption parameters.
-        auto &context_data = *context_.get_context_data(encrypted.parms_id());
-        auto &parms = context_data.parms();
-        auto &coeff_modulus = parms.coeff_modulus();
-        size_t coeff_count = parms.poly_modulus_degree();
-        size_t coeff_modulus_size = coeff_modulus.size();
-
-        uint64_t plain_upper_half_threshold = context_data.plain_upper_half_threshold();
-        auto plain_upper_half_increment = context_data.plain_upper_half_increment();
-        auto ntt_tables = iter(context_data.small_ntt_tables());
+        size_t degree = nonzero.size() - 1;
 
-        size_t encrypted_size = encrypted.size();
-        size_t plain_coeff_count = plain.coeff_count();
-        size_t plain_nonzero_coeff_count = plain.nonzero_coeff_count();
+        auto context_data_ptr = context_.get_context_data(encrypted.parms_id());
+        bool is_ckks = context_data_ptr->parms().scheme() == scheme_type::ckks;
 
-        // Size check
-        if (!product_fits_in(encrypted_size, coeff_count, coeff_modulus_size))
+        // Context data of every level below encrypted; in CKKS every level is a number of remaining rescalings
+        vector<shared_ptr<const SEALContext::ContextData>> level_data(context_data_ptr->chain_index() + 1);
+        for (auto data_ptr = context_data_ptr; data_ptr; data_ptr = data_ptr->next_context_data())
         {
-            throw logic_error("invalid parameters");
+            level_data[data_ptr->chain_index()] = data_ptr;
         }
 
-        double new_scale = encrypted.scale() * plain.scale();
-        if (!is_scale_within_bounds(new_scale, context_data))
+        // Use the fewest ciphertext multiplications with at most one level more than the minimal depth
+        int max_depth = is_ckks ? static_cast<int>(context_data_ptr->chain_index()) : numeric_limits<int>::max();
+        vector<PolynomialPlan> plans;
+        int min_depth = numeric_limits<int>::max();
+        for (size_t baby_log = 0; baby_log <= static_cast<size_t>(get_significant_bit_count(degree)); baby_log++)
         {
-            throw invalid_argument("scale out of bounds");
+            plans.emplace_back(plan_polynomial(nonzero, baby_log));
+            min_depth = min(min_depth, plans.back().depth);
         }
-
-        /*
-        Optimizations for constant / monomial multiplication can lead to the presence of a timing side-channel in
-        use-cases where the plaintext data should also be kept private.
-        */
-        if (plain_nonzero_coeff_count == 1)
+        if (min_depth > max_depth)
         {
-            // Multiplying by a monomial?
-            size_t mono_exponent = plain.significant_coeff_count() - 1;
-
-            if (plain[mono_exponent] >= plain_upper_half_threshold)
+            throw invalid_argument("not enough levels to evaluate the polynomial");
+        }
+        max_depth = min(max_depth, min_depth + 1);
+        auto plan_it = plans.cend();
+        for (auto it = plans.cbegin(); it != plans.cend(); it++)
+        {
+            if (it->depth <= max_depth &&
+                (plan_it == plans.cend() || it->mult_count < plan_it->mult_count ||
+                 (it->mult_count == plan_it->mult_count && it->depth < plan_it->depth)))
             {
-                if (!context_data.qualifiers().using_fast_plain_lift)
-                {
-                    // Allocate temporary space for a single RNS coefficient
-                    SEAL_ALLOCATE_GET_COEFF_ITER(temp, coeff_modulus_size, pool);
+                plan_it = it;
+            }
+        }
+        const PolynomialPlan &plan = *plan_it;
+        size_t k = size_t(1) << plan.baby_log;
 
-                    // We need to adjust the monomial modulo each coeff_modulus prime separately when the coeff_modulus
-                    // primes may be larger than the plain_modulus. We add plain_upper_half_increment (i.e., q-t) to
-                    // the monomial to ensure it is smaller than coeff_modulus and then do an RNS multiplication. Note
-                    // that in this case plain_upper_half_increment contains a multi-precision integer, so after the
-                    // addition we decompose the multi-precision integer into RNS components, and then multiply.
-                    add_uint(plain_upper_half_increment, coeff_modulus_size, plain[mono_exponent], temp);
-                    context_data.rns_tool()->base_q()->decompose(temp, pool);
-                    negacyclic_multiply_poly_mono_coeffmod(
-                        encrypted, encrypted_size, temp, mono_exponent, coeff_modulus, encrypted, pool);
-                }
-                else
-                {
-                    // Every coeff_modulus prime is larger than plain_modulus, so there is no need to adjust the
-                    // monomial. Instead, just do an RNS multiplication.
-                    negacyclic_multiply_poly_mono_coeffmod(
-                        encrypted, encrypted_size, plain[mono_exponent], mono_exponent, coeff_modulus, encrypted, pool);
-                }
+        // Multiplies two powers of the input with relinearization, and rescaling in CKKS
+        auto multiply_powers = [&](const Ciphertext &encrypted1, const Ciphertext &encrypted2, Ciphertext &product) {
+            if (is_ckks)
+            {
+                multiply_relin_rescale_aligned(encrypted1, encrypted2, relin_keys, product, pool);
+                return;
+            }
+            if (&encrypted1 == &encrypted2)
+            {
+                square(encrypted1, product, pool);
             }
             else
             {
-                // The monomial represents a positive number, so no RNS multiplication is needed.
-                negacyclic_multiply_poly_mono_coeffmod(
-                    encrypted, encrypted_size, plain[mono_exponent], mono_exponent, coeff_modulus, encrypted, pool);
+                multiply(encrypted1, encrypted2, product, pool);
             }
+            relinearize_inplace(product, relin_keys, pool);
+        };
 
-            // Set the scale
-            encrypted.scale() = new_scale;
-
-            return;
+        // Baby steps at the lowest possible depth
+        vector<Ciphertext> powers(k + 1, Ciphertext(pool));
+        powers[1] = encrypted;
+        for (size_t i = 2; i <= k; i++)
+        {
+            if (plan.powers[i])
+            {
+                size_t high = size_t(1) << get_power_depth(i);
+                high = (high == i) ? i / 2 : high / 2;
+                multiply_powers(powers[high], powers[i - high], powers[i]);
+            }
         }
 
-        // Generic case: any plaintext polynomial
-        // Allocate temporary space for an entire RNS polynomial
-        auto temp(allocate_zero_poly(coeff_count, coeff_modulus_size, pool));
+        // Giant steps by repeated squaring
+        vector<Ciphertext> giants(plan.giant_count, Ciphertext(pool));
+        for (size_t j = 0; j < plan.giant_count; j++)
+        {
+            if (j == 0)
+            {
+                giants[0] = powers[k];
+            }
+            else
+            {
+                multiply_powers(giants[j - 1], giants[j - 1], giants[j]);
+            }
+        }
 
-        if (!context_data.qualifiers().using_fast_plain_lift)
+        struct PolynomialTerm
         {
-            StrideIter<uint64_t *> temp_iter(temp.get(), coeff_modulus_size);
+            // Index of the constant coefficient if the term is constant
+            bool is_constant;
 
-            SEAL_ITERATE(iter(plain.data(), temp_iter), plain_coeff_count, [&](auto I) {
-                auto plain_value = get<0>(I);
-                if (plain_value >= plain_upper_half_threshold)
+            size_t index;
+
+            Ciphertext encrypted;
+        };
+
+        // Evaluates the coefficients [lo, lo + len) into a term; in CKKS the term is computed at the given level with
+        // the given scale, so that the terms in every sum match exactly
+        function<PolynomialTerm(size_t, size_t, size_t, double)> evaluate_term = [&](size_t lo, size_t len,
+                                                                                      size_t level, double scale) {
+            PolynomialTerm term{ true, lo, Ciphertext(pool) };
+
+            // Scalar multiplications in CKKS are done one level above the term and rescaled
+            parms_id_type mult_parms_id = parms_id_zero;
+            double mult_scale = 1.0;
+            if (is_ckks && level + 1 < level_data.size())
+            {
+                auto &mult_context_data = *level_data[level + 1];
+                mult_parms_id = mult_context_data.parms_id();
+                mult_scale = scale * static_cast<double>(mult_context_data.parms().coeff_modulus().back().value());
+            }
+
+            if (len <= k)
+            {
+                // Linear combination of the baby steps
+                Ciphertext temp(pool);
+                for (size_t i = 1; i < len; i++)
                 {
-                    add_uint(plain_upper_half_increment, coeff_modulus_size, plain_value, get<1>(I));
+                    if (!nonzero[lo + i])
+                    {
+                        continue;
+                    }
+                    temp = powers[i];
+                    if (is_ckks)
+                    {
+                        mod_switch_to_inplace(temp, mult_parms_id, pool);
+                    }
+                    multiply_coeff(temp, lo + i, mult_scale / temp.scale());
+                    if (term.is_constant)
+                    {
+                        term.encrypted = temp;
+                        term.is_constant = false;
+                    }
+                    else
+                    {
+                        add_inplace(term.encrypted, temp);
+                    }
+                }
+                if (term.is_constant)
+                {
+                    return term;
+                }
+                if (nonzero[lo])
+                {
+                    add_coeff(term.encrypted, lo);
+                }
+            }
+            else
+            {
+                size_t j = 0;
+                while ((k << (j + 1)) < len)
+                {
+                    j++;
+                }
+                size_t split = k << j;
+                PolynomialTerm low = evaluate_term(lo, split, level, scale);
+                if (none_of(nonzero.cbegin() + static_cast<ptrdiff_t>(lo + split),
+                            nonzero.cbegin() + static_cast<ptrdiff_t>(lo + len), [](bool value) { return value; }))
+                {
+                    return low;
+                }
+
+                // Multiply the higher coefficients by the giant step
+                term.is_constant = false;
+                term.encrypted = giants[j];
+                if (is_ckks)
+                {
+                    mod_switch_to_inplace(term.encrypted, mult_parms_id, pool);
+                }
+                double high_scale = mult_scale / term.encrypted.scale();
+                PolynomialTerm high = evaluate_term(lo + split, len - split, level + 1, high_scale);
+                if (high.is_constant)
+                {
+                    multiply_coeff(term.encrypted, high.index, high_scale);
+                    if (is_ckks)
+                    {
+                        rescale_to_next_inplace(term.encrypted, pool);
+                    }
                 }
                 else
                 {
-                    *get<1>(I) = plain_value;
+                    // Products are relinearized only when they become factors
+                    if (high.encrypted.size() > 2)
+                    {
+                        relinearize_inplace(high.encrypted, relin_keys, pool);
+                    }
+                    if (is_ckks)
+                    {
+                        multiply_relin_rescale_inplace(term.encrypted, high.encrypted, relin_keys, pool);
+                    }
+                    else
+                    {
+                        multiply_inplace(term.encrypted, high.encrypted, pool);
+                    }
+                }
+                if (is_ckks)
+                {
+                    term.encrypted.scale() = scale;
                 }
-            });
 
-            context_data.rns_tool()->base_q()->decompose_array(temp_iter, coeff_count, pool);
+                if (!low.is_constant)
+                {
+                    add_inplace(term.encrypted, low.encrypted);
+                }
+                else if (nonzero[low.index])
+                {
+                    add_coeff(term.encrypted, low.index);
+                }
+                return term;
+            }
+
+            if (is_ckks)
+            {
+                rescale_to_next_inplace(term.encrypted, pool);
+                term.encrypted.scale() = scale;
+            }
+            return term;
+        };
+
+        size_t level = is_ckks ? context_data_ptr->chain_index() - static_cast<size_t>(plan.depth) : 0;
+        destination = evaluate_term(0, degree + 1, level, encrypted.scale()).encrypted;
+        if (destination.size() > 2)
+        {
+            relinearize_inplace(destination, relin_keys, pool);
         }
-        else
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (destination.is_transparent())
         {
-            // Note that in this case plain_upper_half_increment holds its value in RNS form modulo the coeff_modulus
-            // primes.
-            RNSIter temp_iter(temp.get(), coeff_count);
-            SEAL_ITERATE(iter(temp_iter, plain_upper_half_increment), coeff_modulus_size, [&](auto I) {
-                SEAL_ITERATE(iter(get<0>(I), plain.data()), plain_coeff_count, [&](auto J) {
-                    get<0>(J) =
-                        SEAL_COND_SELECT(get<1>(J) >= plain_upper_half_threshold, get<1>(J) + get<1>(I), get<1>(J));
-                });
-            });
+            throw logic_error("result ciphertext is transparent");
         }
-
-        // Need to multiply each component in encrypted with temp; first step is to transform to NTT form
-        RNSIter temp_iter(temp.get(), coeff_count);
-        ntt_negacyclic_harvey(temp_iter, coeff_modulus_size, ntt_tables);
-
-        SEAL_ITERATE(iter(encrypted), encrypted_size, [&](auto I) {
-            SEAL_ITERATE(iter(I, temp_iter, coeff_modulus, ntt_tables), coeff_modulus_size, [&](auto J) {
-                // Lazy reduction
-                ntt_negacyclic_harvey_lazy(get<0>(J), get<3>(J));
-                dyadic_product_coeffmod(get<0>(J), get<1>(J), coeff_count, get<2>(J), get<0>(J));
-                inverse_ntt_negacyclic_harvey(get<0>(J), get<3>(J));
-            });
-        });
-
-        // Set the scale
-        encrypted.scale() = new_scale;
+#endif
     }
 
-    void Evaluator::multiply_plain_ntt(Ciphertext &encrypted_ntt, const Plaintext &plain_ntt) const
+    void Evaluator::add_plain_inplace(Ciphertext &encrypted, const Plaintext &plain) const
     {
         // Verify parameters.
-        if (!plain_ntt.is_ntt_form())
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
-            throw invalid_argument("plain_ntt is not in NTT form");
+            throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-        if (encrypted_ntt.parms_id() != plain_ntt.parms_id())
+        if (!is_metadata_valid_for(plain, context_) || !is_buffer_valid(plain))
         {
-            throw invalid_argument("encrypted_ntt and plain_ntt parameter mismatch");
+            throw invalid_argument("plain is not valid for encryption parameters");
         }
 
-        // Extract encryption parameters.
-        auto &context_data = *context_.get_context_data(encrypted_ntt.parms_id());
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
         auto &parms = context_data.parms();
+        if (parms.scheme() == scheme_type::bfv && encrypted.is_ntt_form())
+        {
+            throw invalid_argument("BFV encrypted cannot be in NTT form");
+        }
+        if (parms.scheme() == scheme_type::ckks && !encrypted.is_ntt_form())
+        {
+            throw invalid_argument("CKKS encrypted must be in NTT form");
+        }
+        if (plain.is_ntt_form() != encrypted.is_ntt_form())
+        {
+            throw invalid_argument("NTT form mismatch");
+        }
+        if (encrypted.is_ntt_form() && (encrypted.parms_id() != plain.parms_id()))
+        {
+            throw invalid_argument("encrypted and plain parameter mismatch");
+        }
+        if (!are_same_scale(encrypted, plain))
+        {
+            throw invalid_argument("scale mismatch");
+        }
+
+        // Extract encryption parameters.
         auto &coeff_modulus = parms.coeff_modulus();
         size_t coeff_count = parms.poly_modulus_degree();
         size_t coeff_modulus_size = coeff_modulus.size();
-        size_t encrypted_ntt_size = encrypted_ntt.size();
 
         // Size check
-        if (!product_fits_in(encrypted_ntt_size, coeff_count, coeff_modulus_size))
+        if (!product_fits_in(coeff_count, coeff_modulus_size))
         {
             throw logic_error("invalid parameters");
         }
 
-        double new_scale = encrypted_ntt.scale() * plain_ntt.scale();
-        if (!is_scale_within_bounds(new_scale, context_data))
+        switch (parms.scheme())
         {
-            throw invalid_argument("scale out of bounds");
+        case scheme_type::bfv:
+        {
+            multiply_add_plain_with_scaling_variant(plain, context_data, *iter(encrypted));
+            break;
         }
 
-        ConstRNSIter plain_ntt_iter(plain_ntt.data(), coeff_count);
-        SEAL_ITERATE(iter(encrypted_ntt), encrypted_ntt_size, [&](auto I) {
-            dyadic_product_coeffmod(I, plain_ntt_iter, coeff_modulus_size, coeff_modulus, I);
-        });
+        case scheme_type::ckks:
+        {
+            RNSIter encrypted_iter(encrypted.data(), coeff_count);
+            ConstRNSIter plain_iter(plain.data(), coeff_count);
+            add_poly_coeffmod(encrypted_iter, plain_iter, coeff_modulus_size, coeff_modulus, encrypted_iter);
+            break;
+        }
 
-        // Set the scale
-        encrypted_ntt.scale() = new_scale;
+        default:
+            throw invalid_argument("unsupported scheme");
+        }
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
     }
 
-    void Evaluator::transform_to_ntt_inplace(Plaintext &plain, parms_id_type parms_id, MemoryPoolHandle pool) const
+    void Evaluator::add_plain_inplace(Ciphertext &encrypted, const PreparedPlaintext &plain) const
     {
         // Verify parameters.
-        if (!is_valid_for(plain, context_))
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (plain.context().key_parms_id() != context_.key_parms_id())
         {
             throw invalid_argument("plain is not valid for encryption parameters");
         }
 
-        auto context_data_ptr = context_.get_context_data(parms_id);
-        if (!context_data_ptr)
+        // BFV adds the plaintext in coefficient form
+        if (encrypted.is_ntt_form())
         {
-            throw invalid_argument("parms_id is not valid for the current context");
+            add_plain_inplace(encrypted, plain.at(encrypted.parms_id()));
         }
-        if (plain.is_ntt_form())
+        else
         {
-            throw invalid_argument("plain is already in NTT form");
+            add_plain_inplace(encrypted, plain.plain());
         }
-        if (!pool)
+    }
+
+    void Evaluator::sub_plain_inplace(Ciphertext &encrypted, const Plaintext &plain) const
+    {
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
-            throw invalid_argument("pool is uninitialized");
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (!is_metadata_valid_for(plain, context_) || !is_buffer_valid(plain))
+        {
+            throw invalid_argument("plain is not valid for encryption parameters");
         }
 
-        // Extract encryption parameters.
-        auto &context_data = *context_data_ptr;
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
         auto &parms = context_data.parms();
+        if (parms.scheme() == scheme_type::bfv && encrypted.is_ntt_form())
+        {
+            throw invalid_argument("BFV encrypted cannot be in NTT form");
+        }
+        if (parms.scheme() == scheme_type::ckks && !encrypted.is_ntt_form())
+        {
+            throw invalid_argument("CKKS encrypted must be in NTT form");
+        }
+        if (plain.is_ntt_form() != encrypted.is_ntt_form())
+        {
+            throw invalid_argument("NTT form mismatch");
+        }
+        if (encrypted.is_ntt_form() && (encrypted.parms_id() != plain.parms_id()))
+        {
+            throw invalid_argument("encrypted and plain parameter mismatch");
+        }
+        if (!are_same_scale(encrypted, plain))
+        {
+            throw invalid_argument("scale mismatch");
+        }
+
+        // Extract encryption parameters.
         auto &coeff_modulus = parms.coeff_modulus();
         size_t coeff_count = parms.poly_modulus_degree();
         size_t coeff_modulus_size = coeff_modulus.size();
-        size_t plain_coeff_count = plain.coeff_count();
 
-        uint64_t plain_upper_half_threshold = context_data.plain_upper_half_threshold();
-        auto plain_upper_half_increment = context_data.plain_upper_half_increment();
+        // Size check
+        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        switch (parms.scheme())
+        {
+        case scheme_type::bfv:
+        {
+            multiply_sub_plain_with_scaling_variant(plain, context_data, *iter(encrypted));
+            break;
+        }
+
+        case scheme_type::ckks:
+        {
+            RNSIter encrypted_iter(encrypted.data(), coeff_count);
+            ConstRNSIter plain_iter(plain.data(), coeff_count);
+            sub_poly_coeffmod(encrypted_iter, plain_iter, coeff_modulus_size, coeff_modulus, encrypted_iter);
+            break;
+        }
+
+        default:
+            throw invalid_argument("unsupported scheme");
+        }
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
+    void Evaluator::multiply_plain_inplace(Ciphertext &encrypted, const Plaintext &plain, MemoryPoolHandle pool) const
+    {
+        MemoryPoolTraceScope trace_scope("multiply_plain");
+
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (!is_metadata_valid_for(plain, context_) || !is_buffer_valid(plain))
+        {
+            throw invalid_argument("plain is not valid for encryption parameters");
+        }
+        if (encrypted.is_ntt_form() != plain.is_ntt_form())
+        {
+            throw invalid_argument("NTT form mismatch");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        if (encrypted.is_ntt_form())
+        {
+            multiply_plain_ntt(encrypted, plain);
+        }
+        else
+        {
+            multiply_plain_normal(encrypted, plain, move(pool));
+        }
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
+    void Evaluator::multiply_plain_inplace(
+        Ciphertext &encrypted, const PreparedPlaintext &plain, MemoryPoolHandle pool) const
+    {
+        MemoryPoolTraceScope trace_scope("multiply_plain");
+
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (plain.context().key_parms_id() != context_.key_parms_id())
+        {
+            throw invalid_argument("plain is not valid for encryption parameters");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        const Plaintext &plain_ntt = plain.at(encrypted.parms_id());
+        if (encrypted.is_ntt_form())
+        {
+            multiply_plain_ntt(encrypted, plain_ntt);
+        }
+        else
+        {
+            // BFV: multiply in NTT form with the pre-lifted plaintext
+            transform_to_ntt_inplace(encrypted);
+            multiply_plain_ntt(encrypted, plain_ntt);
+            transform_from_ntt_inplace(encrypted);
+        }
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
+    void Evaluator::kswitch_mod_down_rescale(
+        PolyIter poly_prod, size_t key_component_count, Ciphertext &encrypted, MemoryPoolHandle pool) const
+    {
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &next_context_data = *context_data.next_context_data();
+        auto &key_context_data = *context_.key_context_data();
+        auto &key_parms = key_context_data.parms();
+        auto scheme = parms.scheme();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t decomp_modulus_size = parms.coeff_modulus().size();
+        size_t next_modulus_size = decomp_modulus_size - 1;
+        size_t ext_modulus_size = decomp_modulus_size + key_parms.special_modulus_size();
+        auto &key_modulus = key_parms.coeff_modulus();
+        size_t key_modulus_size = key_modulus.size();
+        auto key_ntt_tables = iter(key_context_data.small_ntt_tables());
+        auto kswitch_rescale_tool = context_data.kswitch_rescale_tool();
+        auto special_prod = kswitch_rescale_tool->special_prod_mod_data();
+        auto inv_divisor = kswitch_rescale_tool->inv_divisor_mod_next();
+
+        // Index of the key modulus for each RNS factor: data primes come first, special primes last
+        auto get_key_index = [&](size_t index) {
+            return index < decomp_modulus_size ? index : index - ext_modulus_size + key_modulus_size;
+        };
+
+        SEAL_ITERATE(iter(encrypted, poly_prod), key_component_count, [&](auto I) {
+            // Compute P * ct + poly_prod; modulo the special primes this is just poly_prod. In CKKS only the RNS
+            // factors to be divided out (q_last and the special primes) are switched to normal form.
+            parallel_for(ext_modulus_size, pool, [&](size_t j, MemoryPoolHandle) {
+                CoeffIter prod_iter = get<1>(I)[j];
+                if (scheme == scheme_type::bfv)
+                {
+                    inverse_ntt_negacyclic_harvey(prod_iter, key_ntt_tables[get_key_index(j)]);
+                }
+                if (j < decomp_modulus_size)
+                {
+                    CoeffIter ct_iter = get<0>(I)[j];
+                    multiply_poly_scalar_coeffmod(ct_iter, coeff_count, special_prod[j], key_modulus[j], ct_iter);
+                    add_poly_coeffmod(prod_iter, ct_iter, coeff_count, key_modulus[j], prod_iter);
+                }
+                if (scheme == scheme_type::ckks && j >= next_modulus_size)
+                {
+                    inverse_ntt_negacyclic_harvey(prod_iter, key_ntt_tables[get_key_index(j)]);
+                }
+            });
+
+            // Convert q_last and the special primes to the remaining data primes
+            SEAL_ALLOCATE_GET_RNS_ITER(t_conv, coeff_count, next_modulus_size, pool);
+            kswitch_rescale_tool->convert(get<1>(I) + next_modulus_size, t_conv, pool);
+
+            // (P * q_last)^(-1) * ((ct mod qi) - (ct mod P * q_last)) mod qi
+            parallel_for(next_modulus_size, pool, [&](size_t j, MemoryPoolHandle) {
+                CoeffIter prod_iter = get<1>(I)[j];
+                if (scheme == scheme_type::ckks)
+                {
+                    ntt_negacyclic_harvey(t_conv[j], key_ntt_tables[j]);
+                }
+                sub_poly_coeffmod(prod_iter, t_conv[j], coeff_count, key_modulus[j], prod_iter);
+                multiply_poly_scalar_coeffmod(prod_iter, coeff_count, inv_divisor[j], key_modulus[j], prod_iter);
+            });
+        });
+
+        // Move the result to the next level
+        double scale = encrypted.scale();
+        encrypted.resize(context_, next_context_data.parms_id(), key_component_count);
+        SEAL_ITERATE(iter(poly_prod, encrypted), key_component_count, [&](auto I) {
+            set_poly(get<0>(I), coeff_count, next_modulus_size, get<1>(I));
+        });
+        if (scheme == scheme_type::ckks)
+        {
+            encrypted.scale() = scale / static_cast<double>(parms.coeff_modulus().back().value());
+        }
+    }
+
+    void Evaluator::multiply_plain_normal(Ciphertext &encrypted, const Plaintext &plain, MemoryPoolHandle pool) const
+    {
+        // Extract encryption parameters.
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = coeff_modulus.size();
 
+        uint64_t plain_upper_half_threshold = context_data.plain_upper_half_threshold();
+        auto plain_upper_half_increment = context_data.plain_upper_half_increment();
         auto ntt_tables = iter(context_data.small_ntt_tables());
 
+        size_t encrypted_size = encrypted.size();
+        size_t plain_coeff_count = plain.coeff_count();
+        size_t plain_nonzero_coeff_count = plain.nonzero_coeff_count();
+
         // Size check
-        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        if (!product_fits_in(encrypted_size, coeff_count, coeff_modulus_size))
         {
             throw logic_error("invalid parameters");
         }
 
-        // Resize to fit the entire NTT transformed (ciphertext size) polynomial
-        // Note that the new coefficients are automatically set to 0
-        plain.resize(coeff_count * coeff_modulus_size);
-        RNSIter plain_iter(plain.data(), coeff_count);
+        double new_scale = encrypted.scale() * plain.scale();
+        if (!is_scale_within_bounds(new_scale, context_data))
+        {
+            throw invalid_argument("scale out of bounds");
+        }
+
+        /*
+        Optimizations for constant / monomial multiplication can lead to the presence of a timing side-channel in
+        use-cases where the plaintext data should also be kept private.
+        */
+        if (plain_nonzero_coeff_count == 1)
+        {
+            // Multiplying by a monomial?
+            size_t mono_exponent = plain.significant_coeff_count() - 1;
+
+            if (plain[mono_exponent] >= plain_upper_half_threshold)
+            {
+                if (!context_data.qualifiers().using_fast_plain_lift)
+                {
+                    // Allocate temporary space for a single RNS coefficient
+                    SEAL_ALLOCATE_GET_COEFF_ITER(temp, coeff_modulus_size, pool);
+
+                    // We need to adjust the monomial modulo each coeff_modulus prime separately when the coeff_modulus
+                    // primes may be larger than the plain_modulus. We add plain_upper_half_increment (i.e., q-t) to
+                    // the monomial to ensure it is smaller than coeff_modulus and then do an RNS multiplication. Note
+                    // that in this case plain_upper_half_increment contains a multi-precision integer, so after the
+                    // addition we decompose the multi-precision integer into RNS components, and then multiply.
+                    add_uint(plain_upper_half_increment, coeff_modulus_size, plain[mono_exponent], temp);
+                    context_data.rns_tool()->base_q()->decompose(temp, pool);
+                    negacyclic_multiply_poly_mono_coeffmod(
+                        encrypted, encrypted_size, temp, mono_exponent, coeff_modulus, encrypted, pool);
+                }
+                else
+                {
+                    // Every coeff_modulus prime is larger than plain_modulus, so there is no need to adjust the
+                    // monomial. Instead, just do an RNS multiplication.
+                    negacyclic_multiply_poly_mono_coeffmod(
+                        encrypted, encrypted_size, plain[mono_exponent], mono_exponent, coeff_modulus, encrypted, pool);
+                }
+            }
+            else
+            {
+                // The monomial represents a positive number, so no RNS multiplication is needed.
+                negacyclic_multiply_poly_mono_coeffmod(
+                    encrypted, encrypted_size, plain[mono_exponent], mono_exponent, coeff_modulus, encrypted, pool);
+            }
+
+            // Set the scale
+            encrypted.scale() = new_scale;
+
+            return;
+        }
+
+        // Generic case: any plaintext polynomial
+        // Allocate temporary space for an entire RNS polynomial
+        auto temp(allocate_zero_poly(coeff_count, coeff_modulus_size, pool));
 
         if (!context_data.qualifiers().using_fast_plain_lift)
         {
-            // Allocate temporary space for an entire RNS polynomial
-            // Slight semantic misuse of RNSIter here, but this works well
-            SEAL_ALLOCATE_ZERO_GET_RNS_ITER(temp, coeff_modulus_size, coeff_count, pool);
+            StrideIter<uint64_t *> temp_iter(temp.get(), coeff_modulus_size);
 
-            SEAL_ITERATE(iter(plain.data(), temp), plain_coeff_count, [&](auto I) {
+            SEAL_ITERATE(iter(plain.data(), temp_iter), plain_coeff_count, [&](auto I) {
                 auto plain_value = get<0>(I);
                 if (plain_value >= plain_upper_half_threshold)
                 {
@@ -1775,225 +2843,821 @@ namespace seal
                 }
             });
 
-            context_data.rns_tool()->base_q()->decompose_array(temp, coeff_count, pool);
-
-            // Copy data back to plain
-            set_poly(temp, coeff_count, coeff_modulus_size, plain.data());
+            context_data.rns_tool()->base_q()->decompose_array(temp_iter, coeff_count, pool);
         }
         else
         {
             // Note that in this case plain_upper_half_increment holds its value in RNS form modulo the coeff_modulus
             // primes.
-
-            // Create a "reversed" helper iterator that iterates in the reverse order both plain RNS components and
-            // the plain_upper_half_increment values.
-            auto helper_iter = reverse_iter(plain_iter, plain_upper_half_increment);
-            advance(helper_iter, -safe_cast<ptrdiff_t>(coeff_modulus_size - 1));
-
-            SEAL_ITERATE(helper_iter, coeff_modulus_size, [&](auto I) {
-                SEAL_ITERATE(iter(*plain_iter, get<0>(I)), plain_coeff_count, [&](auto J) {
-                    get<1>(J) =
-                        SEAL_COND_SELECT(get<0>(J) >= plain_upper_half_threshold, get<0>(J) + get<1>(I), get<0>(J));
+            RNSIter temp_iter(temp.get(), coeff_count);
+            SEAL_ITERATE(iter(temp_iter, plain_upper_half_increment), coeff_modulus_size, [&](auto I) {
+                SEAL_ITERATE(iter(get<0>(I), plain.data()), plain_coeff_count, [&](auto J) {
+                    get<0>(J) =
+                        SEAL_COND_SELECT(get<1>(J) >= plain_upper_half_threshold, get<1>(J) + get<1>(I), get<1>(J));
                 });
             });
         }
 
-        // Transform to NTT domain
-        ntt_negacyclic_harvey(plain_iter, coeff_modulus_size, ntt_tables);
+        // Need to multiply each component in encrypted with temp; first step is to transform to NTT form
+        RNSIter temp_iter(temp.get(), coeff_count);
+        ntt_negacyclic_harvey(temp_iter, coeff_modulus_size, ntt_tables);
 
-        plain.parms_id() = parms_id;
-    }
+        SEAL_ITERATE(iter(encrypted), encrypted_size, [&](auto I) {
+            SEAL_ITERATE(iter(I, temp_iter, coeff_modulus, ntt_tables), coeff_modulus_size, [&](auto J) {
+                // Lazy reduction
+                ntt_negacyclic_harvey_lazy(get<0>(J), get<3>(J));
+                dyadic_product_coeffmod(get<0>(J), get<1>(J), coeff_count, get<2>(J), get<0>(J));
+                inverse_ntt_negacyclic_harvey(get<0>(J), get<3>(J));
+            });
+        });
 
-    void Evaluator::transform_to_ntt_inplace(Ciphertext &encrypted) const
+        // Set the scale
+        encrypted.scale() = new_scale;
+    }
+
+    void Evaluator::multiply_plain_ntt(Ciphertext &encrypted_ntt, const Plaintext &plain_ntt) const
+    {
+        // Verify parameters.
+        if (!plain_ntt.is_ntt_form())
+        {
+            throw invalid_argument("plain_ntt is not in NTT form");
+        }
+        if (encrypted_ntt.parms_id() != plain_ntt.parms_id())
+        {
+            throw invalid_argument("encrypted_ntt and plain_ntt parameter mismatch");
+        }
+
+        // Extract encryption parameters.
+        auto &context_data = *context_.get_context_data(encrypted_ntt.parms_id());
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = coeff_modulus.size();
+        size_t encrypted_ntt_size = encrypted_ntt.size();
+
+        // Size check
+        if (!product_fits_in(encrypted_ntt_size, coeff_count, coeff_modulus_size))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        double new_scale = encrypted_ntt.scale() * plain_ntt.scale();
+        if (!is_scale_within_bounds(new_scale, context_data))
+        {
+            throw invalid_argument("scale out of bounds");
+        }
+
+        ConstRNSIter plain_ntt_iter(plain_ntt.data(), coeff_count);
+        SEAL_ITERATE(iter(encrypted_ntt), encrypted_ntt_size, [&](auto I) {
+            dyadic_product_coeffmod(I, plain_ntt_iter, coeff_modulus_size, coeff_modulus, I);
+        });
+
+        // Set the scale
+        encrypted_ntt.scale() = new_scale;
+    }
+
+    void Evaluator::transform_to_ntt_inplace(Plaintext &plain, parms_id_type parms_id, MemoryPoolHandle pool) const
+    {
+        MemoryPoolTraceScope trace_scope("transform_to_ntt");
+
+        // Verify parameters.
+        if (!is_valid_for(plain, context_))
+        {
+            throw invalid_argument("plain is not valid for encryption parameters");
+        }
+
+        auto context_data_ptr = context_.get_context_data(parms_id);
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("parms_id is not valid for the current context");
+        }
+        if (plain.is_ntt_form())
+        {
+            throw invalid_argument("plain is already in NTT form");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        // Extract encryption parameters.
+        auto &context_data = *context_data_ptr;
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = coeff_modulus.size();
+        size_t plain_coeff_count = plain.coeff_count();
+
+        uint64_t plain_upper_half_threshold = context_data.plain_upper_half_threshold();
+        auto plain_upper_half_increment = context_data.plain_upper_half_increment();
+
+        auto ntt_tables = iter(context_data.small_ntt_tables());
+
+        // Size check
+        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        // Resize to fit the entire NTT transformed (ciphertext size) polynomial
+        // Note that the new coefficients are automatically set to 0
+        plain.resize(coeff_count * coeff_modulus_size);
+        RNSIter plain_iter(plain.data(), coeff_count);
+
+        if (!context_data.qualifiers().using_fast_plain_lift)
+        {
+            // Allocate temporary space for an entire RNS polynomial
+            // Slight semantic misuse of RNSIter here, but this works well
+            SEAL_ALLOCATE_ZERO_GET_RNS_ITER(temp, coeff_modulus_size, coeff_count, pool);
+
+            SEAL_ITERATE(iter(plain.data(), temp), plain_coeff_count, [&](auto I) {
+                auto plain_value = get<0>(I);
+                if (plain_value >= plain_upper_half_threshold)
+                {
+                    add_uint(plain_upper_half_increment, coeff_modulus_size, plain_value, get<1>(I));
+                }
+                else
+                {
+                    *get<1>(I) = plain_value;
+                }
+            });
+
+            context_data.rns_tool()->base_q()->decompose_array(temp, coeff_count, pool);
+
+            // Copy data back to plain
+            set_poly(temp, coeff_count, coeff_modulus_size, plain.data());
+        }
+        else
+        {
+            // Note that in this case plain_upper_half_increment holds its value in RNS form modulo the coeff_modulus
+            // primes.
+
+            // Create a "reversed" helper iterator that iterates in the reverse order both plain RNS components and
+            // the plain_upper_half_increment values.
+            auto helper_iter = reverse_iter(plain_iter, plain_upper_half_increment);
+            advance(helper_iter, -safe_cast<ptrdiff_t>(coeff_modulus_size - 1));
+
+            SEAL_ITERATE(helper_iter, coeff_modulus_size, [&](auto I) {
+                SEAL_ITERATE(iter(*plain_iter, get<0>(I)), plain_coeff_count, [&](auto J) {
+                    get<1>(J) =
+                        SEAL_COND_SELECT(get<0>(J) >= plain_upper_half_threshold, get<0>(J) + get<1>(I), get<0>(J));
+                });
+            });
+        }
+
+        // Transform to NTT domain
+        ntt_negacyclic_harvey(plain_iter, coeff_modulus_size, ntt_tables);
+
+        plain.parms_id() = parms_id;
+    }
+
+    void Evaluator::transform_to_ntt_inplace(Ciphertext &encrypted) const
+    {
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+
+        auto context_data_ptr = context_.get_context_data(encrypted.parms_id());
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (encrypted.is_ntt_form())
+        {
+            throw invalid_argument("encrypted is already in NTT form");
+        }
+
+        // Extract encryption parameters.
+        auto &context_data = *context_data_ptr;
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = coeff_modulus.size();
+        size_t encrypted_size = encrypted.size();
+
+        auto ntt_tables = iter(context_data.small_ntt_tables());
+
+        // Size check
+        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        // Transform each polynomial to NTT domain
+        ntt_negacyclic_harvey(encrypted, encrypted_size, ntt_tables);
+
+        // Finally change the is_ntt_transformed flag
+        encrypted.is_ntt_form() = true;
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
+    void Evaluator::transform_from_ntt_inplace(Ciphertext &encrypted_ntt) const
+    {
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted_ntt, context_) || !is_buffer_valid(encrypted_ntt))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+
+        auto context_data_ptr = context_.get_context_data(encrypted_ntt.parms_id());
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("encrypted_ntt is not valid for encryption parameters");
+        }
+        if (!encrypted_ntt.is_ntt_form())
+        {
+            throw invalid_argument("encrypted_ntt is not in NTT form");
+        }
+
+        // Extract encryption parameters.
+        auto &context_data = *context_data_ptr;
+        auto &parms = context_data.parms();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = parms.coeff_modulus().size();
+        size_t encrypted_ntt_size = encrypted_ntt.size();
+
+        auto ntt_tables = iter(context_data.small_ntt_tables());
+
+        // Size check
+        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        // Transform each polynomial from NTT domain
+        inverse_ntt_negacyclic_harvey(encrypted_ntt, encrypted_ntt_size, ntt_tables);
+
+        // Finally change the is_ntt_transformed flag
+        encrypted_ntt.is_ntt_form() = false;
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted_ntt.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
+    void Evaluator::apply_galois_inplace(
+        Ciphertext &encrypted, uint32_t galois_elt, const GaloisKeys &galois_keys, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("apply_galois");
+
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
-            throw invalid_argument("encrypted is not valid for encryption parameters");
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+
+        // Don't validate all of galois_keys but just check the parms_id.
+        if (galois_keys.parms_id() != context_.key_parms_id())
+        {
+            throw invalid_argument("galois_keys is not valid for encryption parameters");
+        }
+
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = coeff_modulus.size();
+        size_t encrypted_size = encrypted.size();
+        // Use key_context_data where permutation tables exist since previous runs.
+        auto galois_tool = context_.key_context_data()->galois_tool();
+
+        // Size check
+        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        // Check if Galois key is generated or not.
+        if (!galois_keys.has_key(galois_elt))
+        {
+            throw invalid_argument("Galois key not present");
+        }
+
+        uint64_t m = mul_safe(static_cast<uint64_t>(coeff_count), uint64_t(2));
+
+        // Verify parameters
+        if (!(galois_elt & 1) || unsigned_geq(galois_elt, m))
+        {
+            throw invalid_argument("Galois element is not valid");
+        }
+        if (encrypted_size > 2)
+        {
+            throw invalid_argument("encrypted size must be 2");
+        }
+
+        SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, coeff_modulus_size, pool);
+
+        // DO NOT CHANGE EXECUTION ORDER OF FOLLOWING SECTION
+        // BEGIN: Apply Galois for each ciphertext
+        // Execution order is sensitive, since apply_galois is not inplace!
+        if (parms.scheme() == scheme_type::bfv)
+        {
+            // !!! DO NOT CHANGE EXECUTION ORDER!!!
+
+            // First transform encrypted.data(0)
+            auto encrypted_iter = iter(encrypted);
+            galois_tool->apply_galois(encrypted_iter[0], coeff_modulus_size, galois_elt, coeff_modulus, temp);
+
+            // Copy result to encrypted.data(0)
+            set_poly(temp, coeff_count, coeff_modulus_size, encrypted.data(0));
+
+            // Next transform encrypted.data(1)
+            galois_tool->apply_galois(encrypted_iter[1], coeff_modulus_size, galois_elt, coeff_modulus, temp);
+        }
+        else if (parms.scheme() == scheme_type::ckks)
+        {
+            // !!! DO NOT CHANGE EXECUTION ORDER!!!
+
+            // First transform encrypted.data(0)
+            auto encrypted_iter = iter(encrypted);
+            galois_tool->apply_galois_ntt(encrypted_iter[0], coeff_modulus_size, galois_elt, temp);
+
+            // Copy result to encrypted.data(0)
+            set_poly(temp, coeff_count, coeff_modulus_size, encrypted.data(0));
+
+            // Next transform encrypted.data(1)
+            galois_tool->apply_galois_ntt(encrypted_iter[1], coeff_modulus_size, galois_elt, temp);
+        }
+        else
+        {
+            throw logic_error("scheme not implemented");
+        }
+
+        // Wipe encrypted.data(1)
+        set_zero_poly(coeff_count, coeff_modulus_size, encrypted.data(1));
+
+        // END: Apply Galois for each ciphertext
+        // REORDERING IS SAFE NOW
+
+        // Calculate (temp * galois_key[0], temp * galois_key[1]) + (ct[0], 0)
+        switch_key_inplace(
+            encrypted, temp, static_cast<const KSwitchKeys &>(galois_keys), GaloisKeys::get_index(galois_elt), pool);
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
+    void Evaluator::rotate_internal(
+        Ciphertext &encrypted, int steps, const GaloisKeys &galois_keys, MemoryPoolHandle pool) const
+    {
+        MemoryPoolTraceScope trace_scope("rotate");
+
+        auto context_data_ptr = context_.get_context_data(encrypted.parms_id());
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (!context_data_ptr->qualifiers().using_batching)
+        {
+            throw logic_error("encryption parameters do not support batching");
+        }
+        if (galois_keys.parms_id() != context_.key_parms_id())
+        {
+            throw invalid_argument("galois_keys is not valid for encryption parameters");
+        }
+
+        // Is there anything to do?
+        if (steps == 0)
+        {
+            return;
+        }
+
+        size_t coeff_count = context_data_ptr->parms().poly_modulus_degree();
+        auto galois_tool = context_data_ptr->galois_tool();
+
+        // Check if Galois key is generated or not.
+        if (galois_keys.has_key(galois_tool->get_elt_from_step(steps)))
+        {
+            // Perform rotation and key switching
+            apply_galois_inplace(encrypted, galois_tool->get_elt_from_step(steps), galois_keys, move(pool));
+        }
+        else
+        {
+            // Convert the steps to NAF: guarantees using smallest HW
+            vector<int> naf_steps = naf(steps);
+
+            // If naf_steps contains only one element, then this is a power-of-two
+            // rotation and we would have expected not to get to this part of the
+            // if-statement.
+            if (naf_steps.size() == 1)
+            {
+                throw invalid_argument("Galois key not present");
+            }
+
+            SEAL_ITERATE(naf_steps.cbegin(), naf_steps.size(), [&](auto step) {
+                // We might have a NAF-term of size coeff_count / 2; this corresponds
+                // to no rotation so we skip it. Otherwise call rotate_internal.
+                if (safe_cast<size_t>(abs(step)) != (coeff_count >> 1))
+                {
+                    // Apply rotation for this step
+                    this->rotate_internal(encrypted, step, galois_keys, pool);
+                }
+            });
+        }
+    }
+
+    void Evaluator::rotate_vector_many(
+        const Ciphertext &encrypted, const vector<int> &steps, const GaloisKeys &galois_keys,
+        vector<Ciphertext> &destination, MemoryPoolHandle pool) const
+    {
+        MemoryPoolTraceScope trace_scope("rotate_vector_many");
+
+        if (context_.key_context_data()->parms().scheme() != scheme_type::ckks)
+        {
+            throw logic_error("unsupported scheme");
+        }
+        rotate_many_internal(encrypted, steps, galois_keys, destination, move(pool));
+    }
+
+    void Evaluator::rotate_many_internal(
+        const Ciphertext &encrypted, const vector<int> &steps, const GaloisKeys &galois_keys,
+        vector<Ciphertext> &destination, MemoryPoolHandle pool) const
+    {
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (galois_keys.parms_id() != context_.key_parms_id())
+        {
+            throw invalid_argument("galois_keys is not valid for encryption parameters");
+        }
+        if (!context_.using_keyswitching())
+        {
+            throw logic_error("keyswitching is not supported by the context");
+        }
+        if (encrypted.size() > 2)
+        {
+            throw invalid_argument("encrypted size must be 2");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto scheme = parms.scheme();
+        if (!context_data.qualifiers().using_batching)
+        {
+            throw logic_error("encryption parameters do not support batching");
+        }
+        if (scheme == scheme_type::bfv && encrypted.is_ntt_form())
+        {
+            throw invalid_argument("BFV encrypted cannot be in NTT form");
+        }
+        else if (scheme == scheme_type::ckks && !encrypted.is_ntt_form())
+        {
+            throw invalid_argument("CKKS encrypted must be in NTT form");
+        }
+        else if (scheme != scheme_type::bfv && scheme != scheme_type::ckks)
+        {
+            throw logic_error("scheme not implemented");
+        }
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = parms.coeff_modulus().size();
+        size_t ext_modulus_size = coeff_modulus_size + context_.key_context_data()->parms().special_modulus_size();
+        size_t digit_count = context_data.hybrid_kswitch_tool() ? context_data.hybrid_kswitch_tool()->digit_count()
+                                                                 : coeff_modulus_size;
+        // Use key_context_data where permutation tables exist since previous runs.
+        auto galois_tool = context_.key_context_data()->galois_tool();
+
+        // Size check
+        if (!product_fits_in(coeff_count, ext_modulus_size, max(digit_count, size_t(2))))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        // Decompose encrypted.data(1) once. The Galois automorphism commutes with the decomposition up to the choice
+        // of representatives of each digit, which does not change the noise bound of key switching.
+        SEAL_ALLOCATE_GET_POLY_ITER(t_digits, digit_count, coeff_count, ext_modulus_size, pool);
+        kswitch_mod_up(iter(encrypted)[1], context_data, t_digits, pool);
+
+        SEAL_ALLOCATE_GET_POLY_ITER(t_digits_rotated, digit_count, coeff_count, ext_modulus_size, pool);
+        SEAL_ALLOCATE_GET_POLY_ITER(t_poly_prod, 2, coeff_count, ext_modulus_size, pool);
+        SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, coeff_modulus_size, pool);
+
+        destination.resize(steps.size());
+        SEAL_ITERATE(iter(size_t(0)), steps.size(), [&](auto I) {
+            int step = steps[I];
+            Ciphertext &rotated = destination[I];
+            rotated = encrypted;
+
+            uint32_t galois_elt = galois_tool->get_elt_from_step(step);
+            if (!step || !galois_keys.has_key(galois_elt))
+            {
+                // Nothing to hoist; rotate_internal handles zero steps and NAF decomposition
+                rotate_internal(rotated, step, galois_keys, pool);
+                return;
+            }
+
+            // Apply the Galois automorphism to the decomposed digits
+            galois_tool->apply_galois_ntt(t_digits, digit_count, galois_elt, t_digits_rotated);
+
+            // Check only the used component in GaloisKeys and multiply with the keys; seeded keys are used in place
+            // and expanded one component at a time
+            if (galois_keys.is_seeded())
+            {
+                size_t key_index = GaloisKeys::get_index(galois_elt);
+                if (galois_keys.seeded_key_size(key_index, context_) < digit_count)
+                {
+                    throw invalid_argument("galois_keys is not valid for encryption parameters");
+                }
+                kswitch_inner_product_seeded(
+                    [&](size_t j, size_t i, CoeffIter) { return ConstCoeffIter(t_digits_rotated[j][i]); },
+                    galois_keys, key_index, context_data, t_poly_prod, pool);
+            }
+            else
+            {
+                // Keys from an archive are loaded here
+                auto key_ptr = galois_keys.acquire_key(galois_elt);
+                auto &key_vector = *key_ptr;
+                if (key_vector.size() < digit_count)
+                {
+                    throw invalid_argument("galois_keys is not valid for encryption parameters");
+                }
+                for (auto &each_key : key_vector)
+                {
+                    if (!is_metadata_valid_for(each_key, context_) || !is_buffer_valid(each_key))
+                    {
+                        throw invalid_argument("galois_keys is not valid for encryption parameters");
+                    }
+                }
+                kswitch_inner_product(t_digits_rotated, key_vector, context_data, t_poly_prod, pool);
+            }
+
+            // Apply the Galois automorphism to encrypted.data(0) and wipe encrypted.data(1)
+            auto rotated_iter = iter(rotated);
+            if (scheme == scheme_type::bfv)
+            {
+                galois_tool->apply_galois(rotated_iter[0], coeff_modulus_size, galois_elt, parms.coeff_modulus(), temp);
+            }
+            else
+            {
+                galois_tool->apply_galois_ntt(rotated_iter[0], coeff_modulus_size, galois_elt, temp);
+            }
+            set_poly(temp, coeff_count, coeff_modulus_size, rotated.data(0));
+            set_zero_poly(coeff_count, coeff_modulus_size, rotated.data(1));
+
+            // Calculate (t_poly_prod[0], t_poly_prod[1]) / P + (ct[0], 0)
+            kswitch_mod_down_add(t_poly_prod, 2, rotated, pool);
+#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
+            // Transparent ciphertext output is not allowed.
+            if (rotated.is_transparent())
+            {
+                throw logic_error("result ciphertext is transparent");
+            }
+#endif
+        });
+    }
+
+    void Evaluator::multiply_plain_matrix(
+        const Ciphertext &encrypted, const vector<Plaintext> &diagonals, const GaloisKeys &galois_keys,
+        Ciphertext &destination, MemoryPoolHandle pool) const
+    {
+        MemoryPoolTraceScope trace_scope("multiply_plain_matrix");
+
+        // Verify parameters.
+        if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto scheme = parms.scheme();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_modulus_size = parms.coeff_modulus().size();
+        size_t diagonal_count = diagonals.size();
+        if (scheme != scheme_type::bfv && scheme != scheme_type::ckks)
+        {
+            throw logic_error("unsupported scheme");
         }
-
-        auto context_data_ptr = context_.get_context_data(encrypted.parms_id());
-        if (!context_data_ptr)
+        if (!context_data.qualifiers().using_batching)
         {
-            throw invalid_argument("encrypted is not valid for encryption parameters");
+            throw logic_error("encryption parameters do not support batching");
         }
-        if (encrypted.is_ntt_form())
+        if (!diagonal_count || diagonal_count > (coeff_count >> 1))
         {
-            throw invalid_argument("encrypted is already in NTT form");
+            throw invalid_argument("diagonals has invalid size");
+        }
+        for (auto &diagonal : diagonals)
+        {
+            if (!is_metadata_valid_for(diagonal, context_) || !is_buffer_valid(diagonal))
+            {
+                throw invalid_argument("diagonals is not valid for encryption parameters");
+            }
+            if (!diagonal.is_ntt_form() || diagonal.parms_id() != encrypted.parms_id())
+            {
+                throw invalid_argument("diagonals must be in NTT form at the level of encrypted");
+            }
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
         }
 
-        // Extract encryption parameters.
-        auto &context_data = *context_data_ptr;
-        auto &parms = context_data.parms();
-        auto &coeff_modulus = parms.coeff_modulus();
-        size_t coeff_count = parms.poly_modulus_degree();
-        size_t coeff_modulus_size = coeff_modulus.size();
-        size_t encrypted_size = encrypted.size();
-
-        auto ntt_tables = iter(context_data.small_ntt_tables());
+        // Use key_context_data where permutation tables exist since previous runs.
+        auto galois_tool = context_.key_context_data()->galois_tool();
+        size_t baby_step_count = get_baby_step_count(diagonal_count);
+        size_t giant_step_count = (diagonal_count + baby_step_count - 1) / baby_step_count;
 
-        // Size check
-        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        // Baby steps: all rotations share a single decomposition of encrypted
+        vector<int> baby_steps(baby_step_count);
+        iota(baby_steps.begin(), baby_steps.end(), 0);
+        vector<Ciphertext> baby_rotated;
+        rotate_many_internal(encrypted, baby_steps, galois_keys, baby_rotated, pool);
+        if (scheme == scheme_type::bfv)
         {
-            throw logic_error("invalid parameters");
+            for (auto &rotated : baby_rotated)
+            {
+                transform_to_ntt_inplace(rotated);
+            }
         }
 
-        // Transform each polynomial to NTT domain
-        ntt_negacyclic_harvey(encrypted, encrypted_size, ntt_tables);
+        // Giant steps: rot(d_(gb+i) * rot(ct, gb + i)) = rot(rot(d_(gb+i), -gb) * rot(ct, i), gb). The rotations of
+        // the diagonals are plaintext automorphisms and need no key switching.
+        Plaintext rotated_diagonal(pool);
+        Ciphertext giant_sum(pool);
+        Ciphertext product(pool);
+        for (size_t giant = 0; giant < giant_step_count; giant++)
+        {
+            size_t giant_begin = giant * baby_step_count;
+            size_t baby_count = min(baby_step_count, diagonal_count - giant_begin);
+            int giant_step = safe_cast<int>(giant_begin);
+            uint32_t galois_elt = giant_step ? galois_tool->get_elt_from_step(-giant_step) : 0;
 
-        // Finally change the is_ntt_transformed flag
-        encrypted.is_ntt_form() = true;
+            for (size_t baby = 0; baby < baby_count; baby++)
+            {
+                const Plaintext &diagonal = diagonals[giant_begin + baby];
+                product = baby_rotated[baby];
+                if (giant_step)
+                {
+                    rotated_diagonal = diagonal;
+                    galois_tool->apply_galois_ntt(
+                        ConstRNSIter(diagonal.data(), coeff_count), coeff_modulus_size, galois_elt,
+                        RNSIter(rotated_diagonal.data(), coeff_count));
+                    multiply_plain_ntt(product, rotated_diagonal);
+                }
+                else
+                {
+                    multiply_plain_ntt(product, diagonal);
+                }
+
+                if (baby)
+                {
+                    add_inplace(giant_sum, product);
+                }
+                else
+                {
+                    swap(giant_sum, product);
+                }
+            }
+
+            if (scheme == scheme_type::bfv)
+            {
+                transform_from_ntt_inplace(giant_sum);
+            }
+            rotate_internal(giant_sum, giant_step, galois_keys, pool);
+
+            if (giant)
+            {
+                add_inplace(destination, giant_sum);
+            }
+            else
+            {
+                destination = giant_sum;
+            }
+        }
 #ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
         // Transparent ciphertext output is not allowed.
-        if (encrypted.is_transparent())
+        if (destination.is_transparent())
         {
             throw logic_error("result ciphertext is transparent");
         }
 #endif
     }
 
-    void Evaluator::transform_from_ntt_inplace(Ciphertext &encrypted_ntt) const
+    vector<uint32_t> Evaluator::multiply_plain_matrix_galois_elts(size_t diagonal_count) const
     {
-        // Verify parameters.
-        if (!is_metadata_valid_for(encrypted_ntt, context_) || !is_buffer_valid(encrypted_ntt))
-        {
-            throw invalid_argument("encrypted is not valid for encryption parameters");
-        }
-
-        auto context_data_ptr = context_.get_context_data(encrypted_ntt.parms_id());
-        if (!context_data_ptr)
+        auto &key_context_data = *context_.key_context_data();
+        if (!context_.first_context_data()->qualifiers().using_batching)
         {
-            throw invalid_argument("encrypted_ntt is not valid for encryption parameters");
+            throw logic_error("encryption parameters do not support batching");
         }
-        if (!encrypted_ntt.is_ntt_form())
+        if (!diagonal_count || diagonal_count > (key_context_data.parms().poly_modulus_degree() >> 1))
         {
-            throw invalid_argument("encrypted_ntt is not in NTT form");
+            throw invalid_argument("diagonal_count is out of range");
         }
 
-        // Extract encryption parameters.
-        auto &context_data = *context_data_ptr;
-        auto &parms = context_data.parms();
-        size_t coeff_count = parms.poly_modulus_degree();
-        size_t coeff_modulus_size = parms.coeff_modulus().size();
-        size_t encrypted_ntt_size = encrypted_ntt.size();
-
-        auto ntt_tables = iter(context_data.small_ntt_tables());
-
-        // Size check
-        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        // Baby steps 1, ..., b - 1 and giant steps b, 2b, ... below diagonal_count
+        size_t baby_step_count = get_baby_step_count(diagonal_count);
+        vector<int> steps;
+        for (size_t baby = 1; baby < baby_step_count; baby++)
         {
-            throw logic_error("invalid parameters");
+            steps.push_back(safe_cast<int>(baby));
         }
-
-        // Transform each polynomial from NTT domain
-        inverse_ntt_negacyclic_harvey(encrypted_ntt, encrypted_ntt_size, ntt_tables);
-
-        // Finally change the is_ntt_transformed flag
-        encrypted_ntt.is_ntt_form() = false;
-#ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
-        // Transparent ciphertext output is not allowed.
-        if (encrypted_ntt.is_transparent())
+        for (size_t giant_step = baby_step_count; giant_step < diagonal_count; giant_step += baby_step_count)
         {
-            throw logic_error("result ciphertext is transparent");
+            steps.push_back(safe_cast<int>(giant_step));
         }
-#endif
+        return key_context_data.galois_tool()->get_elts_from_steps(steps);
     }
 
-    void Evaluator::apply_galois_inplace(
-        Ciphertext &encrypted, uint32_t galois_elt, const GaloisKeys &galois_keys, MemoryPoolHandle pool) const
+    void Evaluator::sum_slots_inplace(
+        Ciphertext &encrypted, size_t block_width, const GaloisKeys &galois_keys, MemoryPoolHandle pool) const
     {
+        MemoryPoolTraceScope trace_scope("sum_slots");
+
         // Verify parameters.
         if (!is_metadata_valid_for(encrypted, context_) || !is_buffer_valid(encrypted))
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
 
-        // Don't validate all of galois_keys but just check the parms_id.
-        if (galois_keys.parms_id() != context_.key_parms_id())
-        {
-            throw invalid_argument("galois_keys is not valid for encryption parameters");
-        }
-
         auto &context_data = *context_.get_context_data(encrypted.parms_id());
         auto &parms = context_data.parms();
-        auto &coeff_modulus = parms.coeff_modulus();
-        size_t coeff_count = parms.poly_modulus_degree();
-        size_t coeff_modulus_size = coeff_modulus.size();
-        size_t encrypted_size = encrypted.size();
-        // Use key_context_data where permutation tables exist since previous runs.
-        auto galois_tool = context_.key_context_data()->galois_tool();
-
-        // Size check
-        if (!product_fits_in(coeff_count, coeff_modulus_size))
+        auto scheme = parms.scheme();
+        if (scheme != scheme_type::bfv && scheme != scheme_type::ckks)
         {
-            throw logic_error("invalid parameters");
+            throw logic_error("unsupported scheme");
         }
-
-        // Check if Galois key is generated or not.
-        if (!galois_keys.has_key(galois_elt))
+        if (!context_data.qualifiers().using_batching)
         {
-            throw invalid_argument("Galois key not present");
+            throw logic_error("encryption parameters do not support batching");
         }
 
-        uint64_t m = mul_safe(static_cast<uint64_t>(coeff_count), uint64_t(2));
-
-        // Verify parameters
-        if (!(galois_elt & 1) || unsigned_geq(galois_elt, m))
+        // BFV has two rows of slots; CKKS has a single row
+        size_t row_size = parms.poly_modulus_degree() >> 1;
+        size_t slot_count = (scheme == scheme_type::bfv) ? (row_size << 1) : row_size;
+        if (get_power_of_two(static_cast<uint64_t>(block_width)) < 0 || block_width > slot_count)
         {
-            throw invalid_argument("Galois element is not valid");
+            throw invalid_argument("block_width must be a power of two not larger than the slot count");
         }
-        if (encrypted_size > 2)
+        if (!pool)
         {
-            throw invalid_argument("encrypted size must be 2");
+            throw invalid_argument("pool is uninitialized");
         }
 
-        SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, coeff_modulus_size, pool);
-
-        // DO NOT CHANGE EXECUTION ORDER OF FOLLOWING SECTION
-        // BEGIN: Apply Galois for each ciphertext
-        // Execution order is sensitive, since apply_galois is not inplace!
-        if (parms.scheme() == scheme_type::bfv)
-        {
-            // !!! DO NOT CHANGE EXECUTION ORDER!!!
-
-            // First transform encrypted.data(0)
-            auto encrypted_iter = iter(encrypted);
-            galois_tool->apply_galois(encrypted_iter[0], coeff_modulus_size, galois_elt, coeff_modulus, temp);
+        // Use key_context_data where permutation tables exist since previous runs.
+        auto galois_tool = context_.key_context_data()->galois_tool();
+        auto has_key = [&](size_t step) {
+            return galois_keys.has_key(galois_tool->get_elt_from_step(safe_cast<int>(step)));
+        };
 
-            // Copy result to encrypted.data(0)
-            set_poly(temp, coeff_count, coeff_modulus_size, encrypted.data(0));
+        // Temporaries reused by all steps of the ladder
+        Ciphertext rotated(pool);
+        vector<Ciphertext> hoisted;
+        vector<int> hoisted_steps(3);
 
-            // Next transform encrypted.data(1)
-            galois_tool->apply_galois(encrypted_iter[1], coeff_modulus_size, galois_elt, coeff_modulus, temp);
-        }
-        else if (parms.scheme() == scheme_type::ckks)
+        size_t row_block_width = min(block_width, row_size);
+        size_t step = 1;
+        while (step < row_block_width)
         {
-            // !!! DO NOT CHANGE EXECUTION ORDER!!!
-
-            // First transform encrypted.data(0)
-            auto encrypted_iter = iter(encrypted);
-            galois_tool->apply_galois_ntt(encrypted_iter[0], coeff_modulus_size, galois_elt, temp);
-
-            // Copy result to encrypted.data(0)
-            set_poly(temp, coeff_count, coeff_modulus_size, encrypted.data(0));
-
-            // Next transform encrypted.data(1)
-            galois_tool->apply_galois_ntt(encrypted_iter[1], coeff_modulus_size, galois_elt, temp);
+            if ((step << 2) <= row_block_width && has_key(step) && has_key(step << 1) && has_key(step * 3))
+            {
+                // Combine four partial sums with rotations sharing a single decomposition
+                hoisted_steps[0] = safe_cast<int>(step);
+                hoisted_steps[1] = safe_cast<int>(step << 1);
+                hoisted_steps[2] = safe_cast<int>(step * 3);
+                rotate_many_internal(encrypted, hoisted_steps, galois_keys, hoisted, pool);
+                for (auto &each_rotated : hoisted)
+                {
+                    add_inplace(encrypted, each_rotated);
+                }
+                step <<= 2;
+            }
+            else
+            {
+                rotated = encrypted;
+                rotate_internal(rotated, safe_cast<int>(step), galois_keys, pool);
+                add_inplace(encrypted, rotated);
+                step <<= 1;
+            }
         }
-        else
+
+        // Add the two rows of a BFV ciphertext together
+        if (block_width > row_size)
         {
-            throw logic_error("scheme not implemented");
+            rotated = encrypted;
+            conjugate_internal(rotated, galois_keys, pool);
+            add_inplace(encrypted, rotated);
         }
-
-        // Wipe encrypted.data(1)
-        set_zero_poly(coeff_count, coeff_modulus_size, encrypted.data(1));
-
-        // END: Apply Galois for each ciphertext
-        // REORDERING IS SAFE NOW
-
-        // Calculate (temp * galois_key[0], temp * galois_key[1]) + (ct[0], 0)
-        switch_key_inplace(
-            encrypted, temp, static_cast<const KSwitchKeys &>(galois_keys), GaloisKeys::get_index(galois_elt), pool);
 #ifdef SEAL_THROW_ON_TRANSPARENT_CIPHERTEXT
         // Transparent ciphertext output is not allowed.
         if (encrypted.is_transparent())
@@ -2003,61 +3667,51 @@ namespace seal
 #endif
     }
 
-    void Evaluator::rotate_internal(
-        Ciphertext &encrypted, int steps, const GaloisKeys &galois_keys, MemoryPoolHandle pool) const
+    vector<uint32_t> Evaluator::sum_slots_galois_elts(size_t block_width) const
     {
-        auto context_data_ptr = context_.get_context_data(encrypted.parms_id());
-        if (!context_data_ptr)
+        auto &key_context_data = *context_.key_context_data();
+        auto &parms = context_.first_context_data()->parms();
+        auto scheme = parms.scheme();
+        if (scheme != scheme_type::bfv && scheme != scheme_type::ckks)
         {
-            throw invalid_argument("encrypted is not valid for encryption parameters");
+            throw logic_error("unsupported scheme");
         }
-        if (!context_data_ptr->qualifiers().using_batching)
+        if (!context_.first_context_data()->qualifiers().using_batching)
         {
             throw logic_error("encryption parameters do not support batching");
         }
-        if (galois_keys.parms_id() != context_.key_parms_id())
-        {
-            throw invalid_argument("galois_keys is not valid for encryption parameters");
-        }
-
-        // Is there anything to do?
-        if (steps == 0)
+        size_t row_size = parms.poly_modulus_degree() >> 1;
+        size_t slot_count = (scheme == scheme_type::bfv) ? (row_size << 1) : row_size;
+        if (get_power_of_two(static_cast<uint64_t>(block_width)) < 0 || block_width > slot_count)
         {
-            return;
+            throw invalid_argument("block_width must be a power of two not larger than the slot count");
         }
 
-        size_t coeff_count = context_data_ptr->parms().poly_modulus_degree();
-        auto galois_tool = context_data_ptr->galois_tool();
-
-        // Check if Galois key is generated or not.
-        if (galois_keys.has_key(galois_tool->get_elt_from_step(steps)))
-        {
-            // Perform rotation and key switching
-            apply_galois_inplace(encrypted, galois_tool->get_elt_from_step(steps), galois_keys, move(pool));
-        }
-        else
+        // Same step sequence as sum_slots_inplace with every possible step hoisted
+        vector<int> steps;
+        size_t row_block_width = min(block_width, row_size);
+        size_t step = 1;
+        while (step < row_block_width)
         {
-            // Convert the steps to NAF: guarantees using smallest HW
-            vector<int> naf_steps = naf(steps);
-
-            // If naf_steps contains only one element, then this is a power-of-two
-            // rotation and we would have expected not to get to this part of the
-            // if-statement.
-            if (naf_steps.size() == 1)
+            steps.push_back(safe_cast<int>(step));
+            if ((step << 2) <= row_block_width)
             {
-                throw invalid_argument("Galois key not present");
+                steps.push_back(safe_cast<int>(step << 1));
+                steps.push_back(safe_cast<int>(step * 3));
+                step <<= 2;
+            }
+            else
+            {
+                step <<= 1;
             }
+        }
 
-            SEAL_ITERATE(naf_steps.cbegin(), naf_steps.size(), [&](auto step) {
-                // We might have a NAF-term of size coeff_count / 2; this corresponds
-                // to no rotation so we skip it. Otherwise call rotate_internal.
-                if (safe_cast<size_t>(abs(step)) != (coeff_count >> 1))
-                {
-                    // Apply rotation for this step
-                    this->rotate_internal(encrypted, step, galois_keys, pool);
-                }
-            });
+        // Step zero is the BFV row swap
+        if (block_width > row_size)
+        {
+            steps.push_back(0);
         }
+        return key_context_data.galois_tool()->get_elts_from_steps(steps);
     }
 
     void Evaluator::switch_key_inplace(
@@ -2091,7 +3745,8 @@ namespace seal
             throw invalid_argument("parameter mismatch");
         }
 
-        if (kswitch_keys_index >= kswitch_keys.data().size())
+        if (!kswitch_keys.is_archived() && !kswitch_keys.is_seeded() &&
+            kswitch_keys_index >= kswitch_keys.data().size())
         {
             throw out_of_range("kswitch_keys_index");
         }
@@ -2111,20 +3766,35 @@ namespace seal
         // Extract encryption parameters.
         size_t coeff_count = parms.poly_modulus_degree();
         size_t decomp_modulus_size = parms.coeff_modulus().size();
-        auto &key_modulus = key_parms.coeff_modulus();
-        size_t key_modulus_size = key_modulus.size();
-        size_t rns_modulus_size = decomp_modulus_size + 1;
-        auto key_ntt_tables = iter(key_context_data.small_ntt_tables());
-        auto modswitch_factors = key_context_data.rns_tool()->inv_q_last_mod_q();
 
-        // Size check
-        if (!product_fits_in(coeff_count, rns_modulus_size, size_t(2)))
+        size_t ext_modulus_size = decomp_modulus_size + key_parms.special_modulus_size();
+        size_t digit_count = context_data.hybrid_kswitch_tool() ? context_data.hybrid_kswitch_tool()->digit_count()
+                                                                 : decomp_modulus_size;
+
+        // Seeded keys are used in place and expanded one component at a time
+        if (kswitch_keys.is_seeded())
         {
-            throw logic_error("invalid parameters");
+            // Check only the used component in KSwitchKeys.
+            if (kswitch_keys.seeded_key_size(kswitch_keys_index, context_) < digit_count)
+            {
+                throw invalid_argument("kswitch_keys is not valid for encryption parameters");
+            }
+            if (!product_fits_in(coeff_count, ext_modulus_size, max(digit_count, size_t(2))))
+            {
+                throw logic_error("invalid parameters");
+            }
+
+            SEAL_ALLOCATE_GET_POLY_ITER(t_poly_prod, 2, coeff_count, ext_modulus_size, pool);
+            kswitch_products_seeded(target_iter, kswitch_keys, kswitch_keys_index, context_data, t_poly_prod, pool);
+
+            // Perform modulus switching with scaling
+            kswitch_mod_down_add(t_poly_prod, 2, encrypted, pool);
+            return;
         }
 
-        // Prepare input
-        auto &key_vector = kswitch_keys.data()[kswitch_keys_index];
+        // Prepare input; keys from an archive are loaded here and kept alive until we are done
+        auto key_ptr = kswitch_keys.acquire(kswitch_keys_index);
+        auto &key_vector = *key_ptr;
         size_t key_component_count = key_vector[0].data().size();
 
         // Check only the used component in KSwitchKeys.
@@ -2136,6 +3806,49 @@ namespace seal
             }
         }
 
+        if (key_vector.size() < digit_count)
+        {
+            throw invalid_argument("kswitch_keys is not valid for encryption parameters");
+        }
+        if (!product_fits_in(coeff_count, ext_modulus_size, max(digit_count, key_component_count)))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        SEAL_ALLOCATE_GET_POLY_ITER(t_poly_prod, key_component_count, coeff_count, ext_modulus_size, pool);
+        kswitch_products(target_iter, key_vector, context_data, t_poly_prod, pool);
+
+        // Perform modulus switching with scaling
+        kswitch_mod_down_add(t_poly_prod, key_component_count, encrypted, pool);
+    }
+
+    void Evaluator::kswitch_products(
+        ConstRNSIter target_iter, const vector<PublicKey> &key_vector, const SEALContext::ContextData &context_data,
+        PolyIter destination, MemoryPoolHandle pool) const
+    {
+        auto &parms = context_data.parms();
+        auto &key_context_data = *context_.key_context_data();
+        auto &key_parms = key_context_data.parms();
+        auto scheme = parms.scheme();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t decomp_modulus_size = parms.coeff_modulus().size();
+        auto &key_modulus = key_parms.coeff_modulus();
+        size_t key_modulus_size = key_modulus.size();
+        size_t rns_modulus_size = decomp_modulus_size + 1;
+        size_t key_component_count = key_vector[0].data().size();
+        auto key_ntt_tables = iter(key_context_data.small_ntt_tables());
+
+        // With more than one special prime the digits span several data primes (hybrid key switching)
+        if (key_parms.special_modulus_size() > 1)
+        {
+            size_t ext_modulus_size = decomp_modulus_size + key_parms.special_modulus_size();
+            size_t digit_count = context_data.hybrid_kswitch_tool()->digit_count();
+            SEAL_ALLOCATE_GET_POLY_ITER(t_digits, digit_count, coeff_count, ext_modulus_size, pool);
+            kswitch_mod_up(target_iter, context_data, t_digits, pool);
+            kswitch_inner_product(t_digits, key_vector, context_data, destination, pool);
+            return;
+        }
+
         // Create a copy of target_iter
         SEAL_ALLOCATE_GET_RNS_ITER(t_target, coeff_count, decomp_modulus_size, pool);
         set_uint(target_iter, decomp_modulus_size * coeff_count, t_target);
@@ -2143,13 +3856,13 @@ namespace seal
         // In CKKS t_target is in NTT form; switch back to normal form
         if (scheme == scheme_type::ckks)
         {
-            inverse_ntt_negacyclic_harvey(t_target, decomp_modulus_size, key_ntt_tables);
+            parallel_for(decomp_modulus_size, pool, [&](size_t i, MemoryPoolHandle) {
+                inverse_ntt_negacyclic_harvey(t_target[i], key_ntt_tables[i]);
+            });
         }
 
-        // Temporary result
-        auto t_poly_prod(allocate_zero_poly_array(key_component_count, coeff_count, rns_modulus_size, pool));
-
-        SEAL_ITERATE(iter(size_t(0)), rns_modulus_size, [&](auto I) {
+        // Each RNS factor of the result is independent of the others
+        parallel_for(rns_modulus_size, pool, [&](size_t I, MemoryPoolHandle scratch_pool) {
             size_t key_index = (I == decomp_modulus_size ? key_modulus_size - 1 : I);
 
             // Product of two numbers is up to 60 + 60 = 120 bits, so we can sum up to 256 of them without reduction.
@@ -2157,14 +3870,14 @@ namespace seal
             size_t lazy_reduction_counter = lazy_reduction_summand_bound;
 
             // Allocate memory for a lazy accumulator (128-bit coefficients)
-            auto t_poly_lazy(allocate_zero_poly_array(key_component_count, coeff_count, 2, pool));
+            auto t_poly_lazy(allocate_zero_poly_array(key_component_count, coeff_count, 2, scratch_pool));
 
             // Semantic misuse of PolyIter; this is really pointing to the data for a single RNS factor
             PolyIter accumulator_iter(t_poly_lazy.get(), 2, coeff_count);
 
             // Multiply with keys and perform lazy reduction on product's coefficients
             SEAL_ITERATE(iter(size_t(0)), decomp_modulus_size, [&](auto J) {
-                SEAL_ALLOCATE_GET_COEFF_ITER(t_ntt, coeff_count, pool);
+                SEAL_ALLOCATE_GET_COEFF_ITER(t_ntt, coeff_count, scratch_pool);
                 ConstCoeffIter t_operand;
 
                 // RNS-NTT form exists in input
@@ -2223,31 +3936,422 @@ namespace seal
                 }
             });
 
-            // PolyIter pointing to the destination t_poly_prod, shifted to the appropriate modulus
-            PolyIter t_poly_prod_iter(t_poly_prod.get() + (I * coeff_count), coeff_count, rns_modulus_size);
+            // Final modular reduction
+            SEAL_ITERATE(iter(accumulator_iter, destination), key_component_count, [&](auto K) {
+                if (lazy_reduction_counter == lazy_reduction_summand_bound)
+                {
+                    SEAL_ITERATE(iter(get<0>(K), get<1>(K)[I]), coeff_count, [&](auto L) {
+                        get<1>(L) = static_cast<uint64_t>(*get<0>(L));
+                    });
+                }
+                else
+                {
+                    // Same as above except need to still do reduction
+                    SEAL_ITERATE(iter(get<0>(K), get<1>(K)[I]), coeff_count, [&](auto L) {
+                        get<1>(L) = barrett_reduce_128(get<0>(L).ptr(), key_modulus[key_index]);
+                    });
+                }
+            });
+        });
+    }
+
+    void Evaluator::kswitch_mod_up(
+        ConstRNSIter target_iter, const SEALContext::ContextData &context_data, PolyIter digits,
+        MemoryPoolHandle pool) const
+    {
+        auto &parms = context_data.parms();
+        auto &key_context_data = *context_.key_context_data();
+        auto &key_modulus = key_context_data.parms().coeff_modulus();
+        auto scheme = parms.scheme();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t decomp_modulus_size = parms.coeff_modulus().size();
+        size_t key_modulus_size = key_modulus.size();
+        size_t special_modulus_size = key_context_data.parms().special_modulus_size();
+        size_t ext_modulus_size = decomp_modulus_size + special_modulus_size;
+        auto key_ntt_tables = iter(key_context_data.small_ntt_tables());
+        auto hybrid_kswitch_tool = context_data.hybrid_kswitch_tool();
+
+        // Index of the key modulus for each RNS factor of a digit: data primes come first, special primes last
+        auto get_key_index = [&](size_t index) {
+            return index < decomp_modulus_size ? index : index - ext_modulus_size + key_modulus_size;
+        };
+
+        // Create a copy of target_iter
+        SEAL_ALLOCATE_GET_RNS_ITER(t_target, coeff_count, decomp_modulus_size, pool);
+        set_uint(target_iter, decomp_modulus_size * coeff_count, t_target);
+
+        // In CKKS t_target is in NTT form; switch back to normal form
+        if (scheme == scheme_type::ckks)
+        {
+            parallel_for(decomp_modulus_size, pool, [&](size_t i, MemoryPoolHandle) {
+                inverse_ntt_negacyclic_harvey(t_target[i], key_ntt_tables[i]);
+            });
+        }
+
+        if (!hybrid_kswitch_tool)
+        {
+            // Each digit is a single RNS factor; all RNS factors of all digits are independent
+            parallel_for(decomp_modulus_size * ext_modulus_size, pool, [&](size_t index, MemoryPoolHandle) {
+                size_t digit_index = index / ext_modulus_size;
+                size_t rns_index = index % ext_modulus_size;
+                size_t key_index = get_key_index(rns_index);
+                CoeffIter digit_iter = digits[digit_index][rns_index];
+
+                // RNS-NTT form exists in input
+                if ((scheme == scheme_type::ckks) && (rns_index == digit_index))
+                {
+                    set_uint(target_iter[digit_index], coeff_count, digit_iter);
+                    return;
+                }
+
+                // No need to perform RNS conversion (modular reduction)
+                if (key_modulus[digit_index] <= key_modulus[key_index])
+                {
+                    set_uint(t_target[digit_index], coeff_count, digit_iter);
+                }
+                // Perform RNS conversion (modular reduction)
+                else
+                {
+                    modulo_poly_coeffs(t_target[digit_index], coeff_count, key_modulus[key_index], digit_iter);
+                }
+                // NTT conversion lazy outputs in [0, 4q)
+                ntt_negacyclic_harvey_lazy(digit_iter, key_ntt_tables[key_index]);
+            });
+            return;
+        }
+
+        // Each digit spans several RNS factors and is extended by fast base conversion
+        size_t digit_count = hybrid_kswitch_tool->digit_count();
+        parallel_for(digit_count, pool, [&](size_t digit_index, MemoryPoolHandle scratch_pool) {
+            size_t digit_begin = hybrid_kswitch_tool->digit_begin(digit_index);
+            hybrid_kswitch_tool->mod_up(digit_index, t_target + digit_begin, digits[digit_index], scratch_pool);
+        });
+
+        parallel_for(digit_count * ext_modulus_size, pool, [&](size_t index, MemoryPoolHandle) {
+            size_t digit_index = index / ext_modulus_size;
+            size_t rns_index = index % ext_modulus_size;
+            size_t digit_begin = hybrid_kswitch_tool->digit_begin(digit_index);
+            size_t digit_end = digit_begin + hybrid_kswitch_tool->digit_size(digit_index);
+            CoeffIter digit_iter = digits[digit_index][rns_index];
+
+            // RNS-NTT form exists in input
+            if ((scheme == scheme_type::ckks) && (rns_index >= digit_begin) && (rns_index < digit_end))
+            {
+                set_uint(target_iter[rns_index], coeff_count, digit_iter);
+            }
+            else
+            {
+                ntt_negacyclic_harvey_lazy(digit_iter, key_ntt_tables[get_key_index(rns_index)]);
+            }
+        });
+    }
+
+    void Evaluator::kswitch_inner_product(
+        ConstPolyIter digits, const vector<PublicKey> &key_vector, const SEALContext::ContextData &context_data,
+        PolyIter destination, MemoryPoolHandle pool) const
+    {
+        auto &key_context_data = *context_.key_context_data();
+        auto &key_modulus = key_context_data.parms().coeff_modulus();
+        size_t coeff_count = context_data.parms().poly_modulus_degree();
+        size_t decomp_modulus_size = context_data.parms().coeff_modulus().size();
+        size_t key_modulus_size = key_modulus.size();
+        size_t ext_modulus_size = decomp_modulus_size + key_context_data.parms().special_modulus_size();
+        size_t digit_count = context_data.hybrid_kswitch_tool() ? context_data.hybrid_kswitch_tool()->digit_count()
+                                                                 : decomp_modulus_size;
+        size_t key_component_count = key_vector[0].data().size();
+
+        // Each RNS factor of the result is independent of the others
+        parallel_for(ext_modulus_size, pool, [&](size_t I, MemoryPoolHandle scratch_pool) {
+            size_t key_index = I < decomp_modulus_size ? I : I - ext_modulus_size + key_modulus_size;
+
+            // Product of two numbers is up to 60 + 60 = 120 bits, so we can sum up to 256 of them without reduction.
+            size_t lazy_reduction_summand_bound = size_t(SEAL_MULTIPLY_ACCUMULATE_USER_MOD_MAX);
+            size_t lazy_reduction_counter = lazy_reduction_summand_bound;
+
+            // Allocate memory for a lazy accumulator (128-bit coefficients)
+            auto t_poly_lazy(allocate_zero_poly_array(key_component_count, coeff_count, 2, scratch_pool));
+
+            // Semantic misuse of PolyIter; this is really pointing to the data for a single RNS factor
+            PolyIter accumulator_iter(t_poly_lazy.get(), 2, coeff_count);
+
+            // Multiply with keys and perform lazy reduction on product's coefficients
+            SEAL_ITERATE(iter(digits, size_t(0)), digit_count, [&](auto J) {
+                ConstCoeffIter t_operand = get<0>(J)[I];
+
+                // Multiply with keys and modular accumulate products in a lazy fashion
+                SEAL_ITERATE(iter(key_vector[get<1>(J)].data(), accumulator_iter), key_component_count, [&](auto K) {
+                    if (!lazy_reduction_counter)
+                    {
+                        SEAL_ITERATE(iter(t_operand, get<0>(K)[key_index], get<1>(K)), coeff_count, [&](auto L) {
+                            unsigned long long qword[2]{ 0, 0 };
+                            multiply_uint64(get<0>(L), get<1>(L), qword);
+
+                            // Accumulate product of t_operand and t_key_acc to t_poly_lazy and reduce
+                            add_uint128(qword, get<2>(L).ptr(), qword);
+                            get<2>(L)[0] = barrett_reduce_128(qword, key_modulus[key_index]);
+                            get<2>(L)[1] = 0;
+                        });
+                    }
+                    else
+                    {
+                        // Same as above but no reduction
+                        SEAL_ITERATE(iter(t_operand, get<0>(K)[key_index], get<1>(K)), coeff_count, [&](auto L) {
+                            unsigned long long qword[2]{ 0, 0 };
+                            multiply_uint64(get<0>(L), get<1>(L), qword);
+                            add_uint128(qword, get<2>(L).ptr(), qword);
+                            get<2>(L)[0] = qword[0];
+                            get<2>(L)[1] = qword[1];
+                        });
+                    }
+                });
+
+                if (!--lazy_reduction_counter)
+                {
+                    lazy_reduction_counter = lazy_reduction_summand_bound;
+                }
+            });
 
             // Final modular reduction
-            SEAL_ITERATE(iter(accumulator_iter, t_poly_prod_iter), key_component_count, [&](auto K) {
+            SEAL_ITERATE(iter(accumulator_iter, destination), key_component_count, [&](auto K) {
                 if (lazy_reduction_counter == lazy_reduction_summand_bound)
                 {
-                    SEAL_ITERATE(iter(get<0>(K), *get<1>(K)), coeff_count, [&](auto L) {
+                    SEAL_ITERATE(iter(get<0>(K), get<1>(K)[I]), coeff_count, [&](auto L) {
                         get<1>(L) = static_cast<uint64_t>(*get<0>(L));
                     });
                 }
                 else
                 {
                     // Same as above except need to still do reduction
-                    SEAL_ITERATE(iter(get<0>(K), *get<1>(K)), coeff_count, [&](auto L) {
+                    SEAL_ITERATE(iter(get<0>(K), get<1>(K)[I]), coeff_count, [&](auto L) {
                         get<1>(L) = barrett_reduce_128(get<0>(L).ptr(), key_modulus[key_index]);
                     });
                 }
             });
         });
-        // Accumulated products are now stored in t_poly_prod
+    }
 
-        // Perform modulus switching with scaling
-        PolyIter t_poly_prod_iter(t_poly_prod.get(), coeff_count, rns_modulus_size);
-        SEAL_ITERATE(iter(encrypted, t_poly_prod_iter), key_component_count, [&](auto I) {
+    void Evaluator::kswitch_products_seeded(
+        ConstRNSIter target_iter, const KSwitchKeys &kswitch_keys, size_t kswitch_keys_index,
+        const SEALContext::ContextData &context_data, PolyIter destination, MemoryPoolHandle pool) const
+    {
+        auto &parms = context_data.parms();
+        auto &key_context_data = *context_.key_context_data();
+        auto &key_parms = key_context_data.parms();
+        auto &key_modulus = key_parms.coeff_modulus();
+        auto scheme = parms.scheme();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t decomp_modulus_size = parms.coeff_modulus().size();
+        size_t key_modulus_size = key_modulus.size();
+        size_t ext_modulus_size = decomp_modulus_size + key_parms.special_modulus_size();
+        auto key_ntt_tables = iter(key_context_data.small_ntt_tables());
+
+        // With more than one special prime the digits span several data primes (hybrid key switching)
+        if (key_parms.special_modulus_size() > 1)
+        {
+            size_t digit_count = context_data.hybrid_kswitch_tool()->digit_count();
+            SEAL_ALLOCATE_GET_POLY_ITER(t_digits, digit_count, coeff_count, ext_modulus_size, pool);
+            kswitch_mod_up(target_iter, context_data, t_digits, pool);
+            kswitch_inner_product_seeded(
+                [&](size_t J, size_t I, CoeffIter) { return ConstCoeffIter(t_digits[J][I]); }, kswitch_keys,
+                kswitch_keys_index, context_data, destination, pool);
+            return;
+        }
+
+        // Create a copy of target_iter
+        SEAL_ALLOCATE_GET_RNS_ITER(t_target, coeff_count, decomp_modulus_size, pool);
+        set_uint(target_iter, decomp_modulus_size * coeff_count, t_target);
+
+        // In CKKS t_target is in NTT form; switch back to normal form
+        if (scheme == scheme_type::ckks)
+        {
+            parallel_for(decomp_modulus_size, pool, [&](size_t i, MemoryPoolHandle) {
+                inverse_ntt_negacyclic_harvey(t_target[i], key_ntt_tables[i]);
+            });
+        }
+
+        // Compute the digits on the fly as in kswitch_products
+        kswitch_inner_product_seeded(
+            [&](size_t J, size_t I, CoeffIter t_ntt) {
+                size_t key_index = (I == decomp_modulus_size ? key_modulus_size - 1 : I);
+
+                // RNS-NTT form exists in input
+                if ((scheme == scheme_type::ckks) && (I == J))
+                {
+                    return target_iter[J];
+                }
+
+                // No need to perform RNS conversion (modular reduction)
+                if (key_modulus[J] <= key_modulus[key_index])
+                {
+                    set_uint(t_target[J], coeff_count, t_ntt);
+                }
+                // Perform RNS conversion (modular reduction)
+                else
+                {
+                    modulo_poly_coeffs(t_target[J], coeff_count, key_modulus[key_index], t_ntt);
+                }
+                // NTT conversion lazy outputs in [0, 4q)
+                ntt_negacyclic_harvey_lazy(t_ntt, key_ntt_tables[key_index]);
+                return ConstCoeffIter(t_ntt);
+            },
+            kswitch_keys, kswitch_keys_index, context_data, destination, pool);
+    }
+
+    void Evaluator::kswitch_inner_product_seeded(
+        const function<ConstCoeffIter(size_t, size_t, CoeffIter)> &get_digit, const KSwitchKeys &kswitch_keys,
+        size_t kswitch_keys_index, const SEALContext::ContextData &context_data, PolyIter destination,
+        MemoryPoolHandle pool) const
+    {
+        auto &key_context_data = *context_.key_context_data();
+        auto &key_modulus = key_context_data.parms().coeff_modulus();
+        size_t coeff_count = context_data.parms().poly_modulus_degree();
+        size_t decomp_modulus_size = context_data.parms().coeff_modulus().size();
+        size_t key_modulus_size = key_modulus.size();
+        size_t ext_modulus_size = decomp_modulus_size + key_context_data.parms().special_modulus_size();
+        size_t digit_count = context_data.hybrid_kswitch_tool() ? context_data.hybrid_kswitch_tool()->digit_count()
+                                                                 : decomp_modulus_size;
+        size_t key_component_count = 2;
+
+        // Product of two numbers is up to 60 + 60 = 120 bits, so we can sum up to 256 of them without reduction.
+        size_t lazy_reduction_summand_bound = size_t(SEAL_MULTIPLY_ACCUMULATE_USER_MOD_MAX);
+        size_t lazy_reduction_counter = lazy_reduction_summand_bound;
+
+        // Allocate memory for lazy accumulators (128-bit coefficients) of all RNS factors, since the loop over the
+        // digits is the outer one here
+        auto t_poly_lazy(
+            allocate_zero_poly_array(mul_safe(ext_modulus_size, key_component_count), coeff_count, 2, pool));
+
+        // Room for the second polynomial of one key component expanded from its seed
+        auto t_key_second(allocate_poly(coeff_count, key_modulus_size, pool));
+
+        SEAL_ITERATE(iter(size_t(0)), digit_count, [&](auto J) {
+            // The first polynomial is used in place; the second one is expanded unless it is resident
+            ConstRNSIter key_first(kswitch_keys.seeded_key_first(kswitch_keys_index, J), coeff_count);
+            ConstRNSIter key_second(
+                kswitch_keys.seeded_key_second(kswitch_keys_index, J, t_key_second.get()), coeff_count);
+
+            // Each RNS factor of the result is independent of the others
+            parallel_for(ext_modulus_size, pool, [&](size_t I, MemoryPoolHandle scratch_pool) {
+                size_t key_index = I < decomp_modulus_size ? I : I - ext_modulus_size + key_modulus_size;
+                SEAL_ALLOCATE_GET_COEFF_ITER(t_ntt, coeff_count, scratch_pool);
+                ConstCoeffIter t_operand = get_digit(J, I, t_ntt);
+
+                // Semantic misuse of PolyIter; this is really pointing to the data for a single RNS factor
+                PolyIter accumulator_iter(
+                    t_poly_lazy.get() + mul_safe(I, key_component_count, coeff_count, size_t(2)), 2, coeff_count);
+
+                // Multiply with keys and modular accumulate products in a lazy fashion
+                SEAL_ITERATE(iter(size_t(0)), key_component_count, [&](auto K) {
+                    ConstCoeffIter t_key = K ? key_second[key_index] : key_first[key_index];
+                    if (!lazy_reduction_counter)
+                    {
+                        SEAL_ITERATE(iter(t_operand, t_key, accumulator_iter[K]), coeff_count, [&](auto L) {
+                            unsigned long long qword[2]{ 0, 0 };
+                            multiply_uint64(get<0>(L), get<1>(L), qword);
+
+                            // Accumulate product of t_operand and t_key to t_poly_lazy and reduce
+                            add_uint128(qword, get<2>(L).ptr(), qword);
+                            get<2>(L)[0] = barrett_reduce_128(qword, key_modulus[key_index]);
+                            get<2>(L)[1] = 0;
+                        });
+                    }
+                    else
+                    {
+                        // Same as above but no reduction
+                        SEAL_ITERATE(iter(t_operand, t_key, accumulator_iter[K]), coeff_count, [&](auto L) {
+                            unsigned long long qword[2]{ 0, 0 };
+                            multiply_uint64(get<0>(L), get<1>(L), qword);
+                            add_uint128(qword, get<2>(L).ptr(), qword);
+                            get<2>(L)[0] = qword[0];
+                            get<2>(L)[1] = qword[1];
+                        });
+                    }
+                });
+            });
+
+            if (!--lazy_reduction_counter)
+            {
+                lazy_reduction_counter = lazy_reduction_summand_bound;
+            }
+        });
+
+        // Final modular reduction
+        parallel_for(ext_modulus_size, pool, [&](size_t I, MemoryPoolHandle) {
+            size_t key_index = I < decomp_modulus_size ? I : I - ext_modulus_size + key_modulus_size;
+            PolyIter accumulator_iter(
+                t_poly_lazy.get() + mul_safe(I, key_component_count, coeff_count, size_t(2)), 2, coeff_count);
+            SEAL_ITERATE(iter(accumulator_iter, destination), key_component_count, [&](auto K) {
+                if (lazy_reduction_counter == lazy_reduction_summand_bound)
+                {
+                    SEAL_ITERATE(iter(get<0>(K), get<1>(K)[I]), coeff_count, [&](auto L) {
+                        get<1>(L) = static_cast<uint64_t>(*get<0>(L));
+                    });
+                }
+                else
+                {
+                    // Same as above except need to still do reduction
+                    SEAL_ITERATE(iter(get<0>(K), get<1>(K)[I]), coeff_count, [&](auto L) {
+                        get<1>(L) = barrett_reduce_128(get<0>(L).ptr(), key_modulus[key_index]);
+                    });
+                }
+            });
+        });
+    }
+
+    void Evaluator::kswitch_mod_down_add(
+        PolyIter poly_prod, size_t key_component_count, Ciphertext &encrypted, MemoryPoolHandle pool) const
+    {
+        auto &context_data = *context_.get_context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &key_context_data = *context_.key_context_data();
+        auto &key_parms = key_context_data.parms();
+        auto scheme = parms.scheme();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t decomp_modulus_size = parms.coeff_modulus().size();
+        auto &key_modulus = key_parms.coeff_modulus();
+        size_t key_modulus_size = key_modulus.size();
+        auto key_ntt_tables = iter(key_context_data.small_ntt_tables());
+        auto hybrid_kswitch_tool = context_data.hybrid_kswitch_tool();
+
+        if (hybrid_kswitch_tool)
+        {
+            size_t special_modulus_size = key_parms.special_modulus_size();
+            auto inv_special_prod = hybrid_kswitch_tool->inv_special_prod_mod_data();
+
+            SEAL_ITERATE(iter(encrypted, poly_prod), key_component_count, [&](auto I) {
+                // Switch the special primes to normal form and convert them to the data primes; the conversion is
+                // offset by floor(P/2) to change from flooring to rounding, as with a single special prime below
+                RNSIter t_special(get<1>(I) + decomp_modulus_size);
+                inverse_ntt_negacyclic_harvey(
+                    t_special, special_modulus_size, key_ntt_tables + (key_modulus_size - special_modulus_size));
+
+                SEAL_ALLOCATE_GET_RNS_ITER(t_conv, coeff_count, decomp_modulus_size, pool);
+                hybrid_kswitch_tool->mod_down_convert(t_special, t_conv, pool);
+
+                auto mod_down_iter = iter(get<0>(I), get<1>(I), t_conv, key_modulus, key_ntt_tables, inv_special_prod);
+                parallel_for(decomp_modulus_size, pool, [&](size_t j, MemoryPoolHandle) {
+                    auto J = mod_down_iter[j];
+                    if (scheme == scheme_type::ckks)
+                    {
+                        ntt_negacyclic_harvey(get<2>(J), get<4>(J));
+                    }
+                    else if (scheme == scheme_type::bfv)
+                    {
+                        inverse_ntt_negacyclic_harvey(get<1>(J), get<4>(J));
+                    }
+
+                    // P^(-1) * ((ct mod qi) - (ct mod P)) mod qi
+                    sub_poly_coeffmod(get<1>(J), get<2>(J), coeff_count, get<3>(J), get<1>(J));
+                    multiply_poly_scalar_coeffmod(get<1>(J), coeff_count, get<5>(J), get<3>(J), get<1>(J));
+                    add_poly_coeffmod(get<1>(J), get<0>(J), coeff_count, get<3>(J), get<0>(J));
+                });
+            });
+            return;
+        }
+
+        // With a single special prime qk the division is exact up to rounding
+        auto modswitch_factors = key_context_data.rns_tool()->inv_q_last_mod_q();
+        SEAL_ITERATE(iter(encrypted, poly_prod), key_component_count, [&](auto I) {
             // Lazy reduction; this needs to be then reduced mod qi
             CoeffIter t_last(get<1>(I)[decomp_modulus_size]);
             inverse_ntt_negacyclic_harvey_lazy(t_last, key_ntt_tables[key_modulus_size - 1]);
@@ -2259,8 +4363,11 @@ namespace seal
                 J = barrett_reduce_64(J + qk_half, key_modulus[key_modulus_size - 1]);
             });
 
-            SEAL_ITERATE(iter(I, key_modulus, key_ntt_tables, modswitch_factors), decomp_modulus_size, [&](auto J) {
-                SEAL_ALLOCATE_GET_COEFF_ITER(t_ntt, coeff_count, pool);
+            // Each RNS factor of the result is independent of the others
+            auto mod_down_iter = iter(I, key_modulus, key_ntt_tables, modswitch_factors);
+            parallel_for(decomp_modulus_size, pool, [&](size_t j, MemoryPoolHandle scratch_pool) {
+                auto J = mod_down_iter[j];
+                SEAL_ALLOCATE_GET_COEFF_ITER(t_ntt, coeff_count, scratch_pool);
 
                 // (ct mod 4qk) mod qi
                 uint64_t qi = get<1>(J).value();
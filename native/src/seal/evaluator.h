@@ -9,16 +9,39 @@
 #include "seal/memorymanager.h"
 #include "seal/modulus.h"
 #include "seal/plaintext.h"
+#include "seal/preparedplaintext.h"
 #include "seal/relinkeys.h"
 #include "seal/secretkey.h"
 #include "seal/valcheck.h"
 #include "seal/util/iterator.h"
+#include "seal/util/threadpool.h"
+#include <complex>
+#include <functional>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
 namespace seal
 {
+    /**
+    Describes the RNS algorithm used for BFV ciphertext multiplication.
+    */
+    enum class bfv_mul_type : std::uint8_t
+    {
+        /**
+        Bajard-Eynard-Hasan-Zucca: extends the ciphertexts to an auxiliary base with Montgomery reduction and scales
+        down with a fast floor followed by Shenoy-Kumaresan base conversion.
+        */
+        behz = 0x0,
+
+        /**
+        Halevi-Polyakov-Shoup: extends the ciphertexts to the auxiliary base exactly, using floating-point arithmetic
+        to correct the fast base conversion, and scales down with a single combined scale-and-round step.
+        */
+        hps = 0x1
+    };
+
     /**
     Provides operations on ciphertexts. Due to the properties of the encryption scheme, the arithmetic operations pass
     through the encryption layer to the underlying plaintext, changing it according to the type of the operation. Since
@@ -82,6 +105,50 @@ namespace seal
         */
         Evaluator(const SEALContext &context);
 
+        /**
+        Sets the number of threads used for key switching in relinearization, rotations, and other operations that
+        apply Galois automorphisms. With more than one thread, the independent work on each RNS limb (decomposition,
+        NTTs, key inner products, and modulus switching) is distributed over a pool of threads owned by this
+        Evaluator. The results are bit-identical to single-threaded execution. By default only the calling thread is
+        used.
+
+        In the parallel sections, scratch memory of every thread, including the calling one, is allocated from the
+        thread-local memory pool of that thread rather than from the MemoryPoolHandle passed to the operation, so
+        such allocations do not show up in the caller's pool. Copies of this Evaluator share the same threads, and
+        parallel sections started from different threads on the same threads run one at a time; to evaluate
+        concurrently from several threads, call set_thread_count on each copy to give it threads of its own.
+
+        @param[in] thread_count The number of threads, including the calling thread
+        @throws std::invalid_argument if thread_count is zero
+        */
+        void set_thread_count(std::size_t thread_count);
+
+        /**
+        Returns the number of threads used for key switching.
+        */
+        SEAL_NODISCARD inline std::size_t thread_count() const noexcept
+        {
+            return thread_pool_ ? thread_pool_->thread_count() : std::size_t(1);
+        }
+
+        /**
+        Sets the RNS algorithm used for BFV multiplication and squaring. Both algorithms produce valid ciphertexts with
+        comparable noise growth, but the results are not bit-identical. HPS is used only when the auxiliary base of
+        the encryption parameters is large enough for it; otherwise BEHZ is used. The default is BEHZ.
+
+        @param[in] mul_type The multiplication algorithm
+        @throws std::invalid_argument if mul_type is not a valid bfv_mul_type
+        */
+        void set_bfv_mul(bfv_mul_type mul_type);
+
+        /**
+        Returns the RNS algorithm used for BFV multiplication and squaring.
+        */
+        SEAL_NODISCARD inline bfv_mul_type bfv_mul() const noexcept
+        {
+            return bfv_mul_;
+        }
+
         /**
         Negates a ciphertext.
 
@@ -330,6 +397,101 @@ namespace seal
             relinearize_inplace(destination, relin_keys, std::move(pool));
         }
 
+        /**
+        Multiplies two ciphertexts, relinearizes the product, and switches it to the next level of the modulus
+        switching chain, storing the result in encrypted1. For CKKS the message is rescaled; for BFV the modulus is
+        switched as in mod_switch_to_next. The result is equivalent to calling multiply_inplace, relinearize_inplace,
+        and rescale_to_next_inplace (CKKS) or mod_switch_to_next_inplace (BFV), but the ModDown of key switching and
+        the division by the last prime are folded into a single division, saving one NTT round trip per prime in CKKS.
+        The outputs of the fused and sequential operations differ by a small rounding error. Dynamic memory
+        allocations in the process are allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted1 The first ciphertext to multiply
+        @param[in] encrypted2 The second ciphertext to multiply
+        @param[in] relin_keys The relinearization keys
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted1, encrypted2, or relin_keys is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is not in the default NTT form
+        @throws std::invalid_argument if encrypted1 and encrypted2 are at different level
+        @throws std::invalid_argument if encrypted1 is already at lowest level
+        @throws std::invalid_argument if the size of relin_keys is too small
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_relin_rescale_inplace(
+            Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Multiplies two ciphertexts, relinearizes the product, and switches it to the next level of the modulus
+        switching chain, storing the result in the destination parameter. See multiply_relin_rescale_inplace for
+        details. Dynamic memory allocations in the process are allocated from the memory pool pointed to by the given
+        MemoryPoolHandle.
+
+        @param[in] encrypted1 The first ciphertext to multiply
+        @param[in] encrypted2 The second ciphertext to multiply
+        @param[in] relin_keys The relinearization keys
+        @param[out] destination The ciphertext to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted1, encrypted2, or relin_keys is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is not in the default NTT form
+        @throws std::invalid_argument if encrypted1 and encrypted2 are at different level
+        @throws std::invalid_argument if encrypted1 is already at lowest level
+        @throws std::invalid_argument if the size of relin_keys is too small
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void multiply_relin_rescale(
+            const Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys,
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            if (&encrypted2 == &destination)
+            {
+                multiply_relin_rescale_inplace(destination, encrypted1, relin_keys, std::move(pool));
+            }
+            else
+            {
+                destination = encrypted1;
+                multiply_relin_rescale_inplace(destination, encrypted2, relin_keys, std::move(pool));
+            }
+        }
+
+        /**
+        Computes the inner product of two vectors of ciphertexts, i.e., the sum of the products of encrypteds1[i] and
+        encrypteds2[i], and stores the result in the destination parameter. The products are added together before
+        relinearization, so only one key switching is performed for the whole sum. For CKKS the result is also rescaled
+        to the next level as in multiply_relin_rescale; for BFV the result stays at the level of the inputs. Dynamic
+        memory allocations in the process are allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypteds1 The first vector of ciphertexts
+        @param[in] encrypteds2 The second vector of ciphertexts
+        @param[in] relin_keys The relinearization keys
+        @param[out] destination The ciphertext to overwrite with the inner product
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypteds1 is empty
+        @throws std::invalid_argument if encrypteds1 and encrypteds2 have different sizes
+        @throws std::invalid_argument if ciphertexts or relin_keys are not valid for the encryption parameters
+        @throws std::invalid_argument if ciphertexts are not in the default NTT form
+        @throws std::invalid_argument if ciphertexts are at different level or scale
+        @throws std::invalid_argument if scheme is scheme_type::ckks and the ciphertexts are already at lowest level
+        @throws std::invalid_argument if destination is one of the ciphertexts
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if the size of relin_keys is too small
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void inner_product(
+            const std::vector<Ciphertext> &encrypteds1, const std::vector<Ciphertext> &encrypteds2,
+            const RelinKeys &relin_keys, Ciphertext &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
         /**
         Given a ciphertext encrypted modulo q_1...q_k, this function switches the modulus down to q_1...q_{k-1} and
         stores the result in the destination parameter. Dynamic memory allocations in the process are allocated from the
@@ -577,17 +739,23 @@ namespace seal
         Multiplies several ciphertexts together. This function computes the product of several ciphertext given as an
         std::vector and stores the result in the destination parameter. The multiplication is done in a depth-optimal
         order, and relinearization is performed automatically after every multiplication in the process. In
-        relinearization the given relinearization keys are used. Dynamic memory allocations in the process are allocated
-        from the memory pool pointed to by the given MemoryPoolHandle.
+        relinearization the given relinearization keys are used. For CKKS every product is also rescaled, and a
+        ciphertext at a higher level than the one it is multiplied with is first switched down to the lower level, so
+        the inputs may be at different levels. If more than one thread is set with set_thread_count, the independent
+        multiplications of each level of the product tree are computed in parallel. Dynamic memory allocations in the
+        process are allocated from the memory pool pointed to by the given MemoryPoolHandle.
 
         @param[in] encrypteds The ciphertexts to multiply
         @param[in] relin_keys The relinearization keys
         @param[out] destination The ciphertext to overwrite with the multiplication result
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
-        @throws std::logic_error if scheme is not scheme_type::bfv
+        @throws std::logic_error if scheme is not scheme_type::bfv or scheme_type::ckks
         @throws std::invalid_argument if encrypteds is empty
         @throws std::invalid_argument if ciphertexts or relin_keys are not valid for the encryption parameters
         @throws std::invalid_argument if encrypteds are not in the default NTT form
+        @throws std::invalid_argument if scheme is scheme_type::bfv and encrypteds are at different level
+        @throws std::invalid_argument if scheme is scheme_type::ckks and the modulus switching chain is too short for
+        the depth of the product tree
         @throws std::invalid_argument if the output scale is too large for the encryption parameters
         @throws std::invalid_argument if the size of relin_keys is too small
         @throws std::invalid_argument if pool is uninitialized
@@ -601,16 +769,19 @@ namespace seal
         /**
         Exponentiates a ciphertext. This functions raises encrypted to a power. Dynamic memory allocations in the
         process are allocated from the memory pool pointed to by the given MemoryPoolHandle. The exponentiation is done
-        in a depth-optimal order, and relinearization is performed automatically after every multiplication in the
-        process. In relinearization the given relinearization keys are used.
+        in a depth-optimal order as in multiply_many, and relinearization is performed automatically after every
+        multiplication in the process. In relinearization the given relinearization keys are used. For CKKS every
+        product is also rescaled.
 
         @param[in] encrypted The ciphertext to exponentiate
         @param[in] exponent The power to raise the ciphertext to
         @param[in] relin_keys The relinearization keys
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
-        @throws std::logic_error if scheme is not scheme_type::bfv
+        @throws std::logic_error if scheme is not scheme_type::bfv or scheme_type::ckks
         @throws std::invalid_argument if encrypted or relin_keys is not valid for the encryption parameters
         @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if scheme is scheme_type::ckks and the modulus switching chain is too short for
+        the exponent
         @throws std::invalid_argument if the output scale is too large for the encryption parameters
         @throws std::invalid_argument if exponent is zero
         @throws std::invalid_argument if the size of relin_keys is too small
@@ -625,18 +796,20 @@ namespace seal
         /**
         Exponentiates a ciphertext. This functions raises encrypted to a power and stores the result in the destination
         parameter. Dynamic memory allocations in the process are allocated from the memory pool pointed to by the given
-        MemoryPoolHandle. The exponentiation is done in a depth-optimal order, and relinearization is performed
-        automatically after every multiplication in the process. In relinearization the given relinearization keys are
-        used.
+        MemoryPoolHandle. The exponentiation is done in a depth-optimal order as in multiply_many, and relinearization
+        is performed automatically after every multiplication in the process. In relinearization the given
+        relinearization keys are used. For CKKS every product is also rescaled.
 
         @param[in] encrypted The ciphertext to exponentiate
         @param[in] exponent The power to raise the ciphertext to
         @param[in] relin_keys The relinearization keys
         @param[out] destination The ciphertext to overwrite with the power
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
-        @throws std::logic_error if scheme is not scheme_type::bfv
+        @throws std::logic_error if scheme is not scheme_type::bfv or scheme_type::ckks
         @throws std::invalid_argument if encrypted or relin_keys is not valid for the encryption parameters
         @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if scheme is scheme_type::ckks and the modulus switching chain is too short for
+        the exponent
         @throws std::invalid_argument if the output scale is too large for the encryption parameters
         @throws std::invalid_argument if exponent is zero
         @throws std::invalid_argument if the size of relin_keys is too small
@@ -652,6 +825,62 @@ namespace seal
             exponentiate_inplace(destination, exponent, relin_keys, std::move(pool));
         }
 
+        /**
+        Evaluates a polynomial with real coefficients on a CKKS ciphertext and stores the result in the destination
+        parameter. The coefficient of x^i is coeffs[i]. The polynomial is evaluated with the Paterson-Stockmeyer
+        algorithm: the baby-step powers x, ..., x^k and the giant-step powers x^(2k), x^(4k), ... are computed at the
+        lowest possible depth, the coefficients are applied with scalar multiplications without encoding plaintexts,
+        and the number of baby steps is chosen to minimize the number of ciphertext multiplications while using at most
+        one level more than the minimal depth ceil(log2(degree + 1)) + 1, if that many levels are available. Scales
+        are managed so that the result has the scale of encrypted. Dynamic memory allocations in the process are
+        allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to evaluate the polynomial on
+        @param[in] coeffs The coefficients of the polynomial, from the constant term up
+        @param[in] relin_keys The relinearization keys
+        @param[out] destination The ciphertext to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted or relin_keys is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if coeffs has no nonzero coefficient of degree at least 1
+        @throws std::invalid_argument if encrypted does not have enough levels left for the polynomial
+        @throws std::invalid_argument if a scaled coefficient is too large for the encryption parameters
+        @throws std::invalid_argument if the size of relin_keys is too small
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void evaluate_polynomial(
+            const Ciphertext &encrypted, const std::vector<double> &coeffs, const RelinKeys &relin_keys,
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Evaluates a polynomial with coefficients modulo the plaintext modulus on a BFV ciphertext and stores the
+        result in the destination parameter. The coefficient of x^i is coeffs[i]. The polynomial is evaluated with the
+        Paterson-Stockmeyer algorithm as in the CKKS overload, using at most one multiplicative level more than the
+        minimal depth. Ciphertexts are relinearized only when they are multiplied. Dynamic memory allocations in the
+        process are allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to evaluate the polynomial on
+        @param[in] coeffs The coefficients of the polynomial, from the constant term up
+        @param[in] relin_keys The relinearization keys
+        @param[out] destination The ciphertext to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::bfv
+        @throws std::invalid_argument if encrypted or relin_keys is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if coeffs has no nonzero coefficient of degree at least 1 modulo the plaintext
+        modulus
+        @throws std::invalid_argument if the size of relin_keys is too small
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void evaluate_polynomial(
+            const Ciphertext &encrypted, const std::vector<std::uint64_t> &coeffs, const RelinKeys &relin_keys,
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
         /**
         Adds a ciphertext and a plaintext.
 
@@ -683,6 +912,42 @@ namespace seal
             add_plain_inplace(destination, plain);
         }
 
+        /**
+        Adds a ciphertext and a prepared plaintext. In CKKS the plaintext is taken at the level of encrypted from the
+        cache of the PreparedPlaintext, computing it if necessary. In BFV this is the same as adding the plaintext the
+        PreparedPlaintext was created from.
+
+        @param[in] encrypted The ciphertext to add
+        @param[in] plain The prepared plaintext to add
+        @throws std::invalid_argument if encrypted or plain is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if encrypted is above the level of plain in CKKS
+        @throws std::invalid_argument if encrypted and plain have different scale
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void add_plain_inplace(Ciphertext &encrypted, const PreparedPlaintext &plain) const;
+
+        /**
+        Adds a ciphertext and a prepared plaintext and stores the result in the destination parameter. In CKKS the
+        plaintext is taken at the level of encrypted from the cache of the PreparedPlaintext, computing it if
+        necessary. In BFV this is the same as adding the plaintext the PreparedPlaintext was created from.
+
+        @param[in] encrypted The ciphertext to add
+        @param[in] plain The prepared plaintext to add
+        @param[out] destination The ciphertext to overwrite with the addition result
+        @throws std::invalid_argument if encrypted or plain is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if encrypted is above the level of plain in CKKS
+        @throws std::invalid_argument if encrypted and plain have different scale
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void add_plain(
+            const Ciphertext &encrypted, const PreparedPlaintext &plain, Ciphertext &destination) const
+        {
+            destination = encrypted;
+            add_plain_inplace(destination, plain);
+        }
+
         /**
         Subtracts a plaintext from a ciphertext.
 
@@ -752,6 +1017,292 @@ namespace seal
             multiply_plain_inplace(destination, plain, std::move(pool));
         }
 
+        /**
+        Multiplies a ciphertext with a prepared plaintext. The NTT form of the plaintext at the level of encrypted is
+        taken from the cache of the PreparedPlaintext, computing it if necessary, so repeated multiplications with the
+        same plaintext do not re-encode, lift, or NTT transform it. In BFV a ciphertext in the default (non-NTT) form
+        is transformed to NTT form for the multiplication and back; the result is the same as that of multiplying
+        with the original plaintext. Dynamic memory allocations in the process are allocated from the memory pool
+        pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] plain The prepared plaintext to multiply
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted or plain is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is above the level of plain in CKKS
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_plain_inplace(
+            Ciphertext &encrypted, const PreparedPlaintext &plain,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Multiplies a ciphertext with a prepared plaintext and stores the result in the destination parameter. See
+        multiply_plain_inplace for details. Dynamic memory allocations in the process are allocated from the memory
+        pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] plain The prepared plaintext to multiply
+        @param[out] destination The ciphertext to overwrite with the multiplication result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted or plain is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is above the level of plain in CKKS
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void multiply_plain(
+            const Ciphertext &encrypted, const PreparedPlaintext &plain, Ciphertext &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            destination = encrypted;
+            multiply_plain_inplace(destination, plain, std::move(pool));
+        }
+
+        /**
+        Multiplies a CKKS ciphertext with a real constant. The constant is encoded with the given scale directly in RNS
+        form, which is the same residue in every NTT coefficient, so this is equivalent to, but much cheaper than,
+        encoding the constant with CKKSEncoder and calling multiply_plain_inplace. The scale of the result is the
+        product of the scales. Dynamic memory allocations in the process are allocated from the memory pool pointed to
+        by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The constant to multiply with
+        @param[in] scale The scale to encode the constant with
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in NTT form
+        @throws std::invalid_argument if the scaled constant is too large for the encryption parameters
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_const_inplace(
+            Ciphertext &encrypted, double value, double scale, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Multiplies a CKKS ciphertext with a complex constant. The imaginary unit is encoded as
+        (X^(N/4) + X^(3N/4)) / sqrt(2), which is one residue in the even quarters and its negative in the odd quarters
+        of the NTT coefficients, so the constant is applied with two scalars per RNS limb. The scale of the result is
+        the product of the scales. Dynamic memory allocations in the process are allocated from the memory pool pointed
+        to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The constant to multiply with
+        @param[in] scale The scale to encode the constant with
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in NTT form
+        @throws std::invalid_argument if the scaled constant is too large for the encryption parameters
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_const_inplace(
+            Ciphertext &encrypted, std::complex<double> value, double scale,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Multiplies a CKKS ciphertext with a real constant and stores the result in the destination parameter. See
+        multiply_const_inplace for details. Dynamic memory allocations in the process are allocated from the memory
+        pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The constant to multiply with
+        @param[in] scale The scale to encode the constant with
+        @param[out] destination The ciphertext to overwrite with the multiplication result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in NTT form
+        @throws std::invalid_argument if the scaled constant is too large for the encryption parameters
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void multiply_const(
+            const Ciphertext &encrypted, double value, double scale, Ciphertext &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            destination = encrypted;
+            multiply_const_inplace(destination, value, scale, std::move(pool));
+        }
+
+        /**
+        Multiplies a CKKS ciphertext with a complex constant and stores the result in the destination parameter. See
+        multiply_const_inplace for details. Dynamic memory allocations in the process are allocated from the memory
+        pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The constant to multiply with
+        @param[in] scale The scale to encode the constant with
+        @param[out] destination The ciphertext to overwrite with the multiplication result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in NTT form
+        @throws std::invalid_argument if the scaled constant is too large for the encryption parameters
+        @throws std::invalid_argument if the output scale is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void multiply_const(
+            const Ciphertext &encrypted, std::complex<double> value, double scale, Ciphertext &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            destination = encrypted;
+            multiply_const_inplace(destination, value, scale, std::move(pool));
+        }
+
+        /**
+        Multiplies a BFV ciphertext with an integer constant modulo the plaintext modulus. The constant is applied to
+        every RNS limb as a scalar, using its representative in [-t/2, t/2) for the plaintext modulus t to limit the
+        noise growth. The result is the same as that of multiply_plain_inplace with the constant polynomial value.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The constant to multiply with
+        @throws std::logic_error if scheme is not scheme_type::bfv
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_const_inplace(Ciphertext &encrypted, std::uint64_t value) const;
+
+        /**
+        Multiplies a BFV ciphertext with an integer constant modulo the plaintext modulus and stores the result in the
+        destination parameter. See multiply_const_inplace for details.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The constant to multiply with
+        @param[out] destination The ciphertext to overwrite with the multiplication result
+        @throws std::logic_error if scheme is not scheme_type::bfv
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void multiply_const(const Ciphertext &encrypted, std::uint64_t value, Ciphertext &destination) const
+        {
+            destination = encrypted;
+            multiply_const_inplace(destination, value);
+        }
+
+        /**
+        Adds a real constant to a CKKS ciphertext. The constant is encoded at the scale of encrypted directly in RNS
+        form and added to every NTT coefficient of the first ciphertext component. Dynamic memory allocations in the
+        process are allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The constant to add
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in NTT form
+        @throws std::invalid_argument if the scaled constant is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void add_const_inplace(
+            Ciphertext &encrypted, double value, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Adds a complex constant to a CKKS ciphertext. The constant value is encoded at the scale of encrypted as in the
+        complex overload of multiply_const_inplace and added to the first ciphertext component. Dynamic memory
+        allocations in the process are allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The constant to add
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in NTT form
+        @throws std::invalid_argument if the scaled constant is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void add_const_inplace(
+            Ciphertext &encrypted, std::complex<double> value, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Adds a real constant to a CKKS ciphertext and stores the result in the destination parameter. See
+        add_const_inplace for details. Dynamic memory allocations in the process are allocated from the memory pool
+        pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The constant to add
+        @param[out] destination The ciphertext to overwrite with the addition result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in NTT form
+        @throws std::invalid_argument if the scaled constant is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void add_const(
+            const Ciphertext &encrypted, double value, Ciphertext &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            destination = encrypted;
+            add_const_inplace(destination, value, std::move(pool));
+        }
+
+        /**
+        Adds a complex constant to a CKKS ciphertext and stores the result in the destination parameter. See
+        add_const_inplace for details. Dynamic memory allocations in the process are allocated from the memory pool
+        pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The constant to add
+        @param[out] destination The ciphertext to overwrite with the addition result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in NTT form
+        @throws std::invalid_argument if the scaled constant is too large for the encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void add_const(
+            const Ciphertext &encrypted, std::complex<double> value, Ciphertext &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            destination = encrypted;
+            add_const_inplace(destination, value, std::move(pool));
+        }
+
+        /**
+        Adds an integer constant modulo the plaintext modulus to a BFV ciphertext. The result is the same as that of
+        add_plain_inplace with the constant polynomial value.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The constant to add
+        @throws std::logic_error if scheme is not scheme_type::bfv
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void add_const_inplace(Ciphertext &encrypted, std::uint64_t value) const;
+
+        /**
+        Adds an integer constant modulo the plaintext modulus to a BFV ciphertext and stores the result in the
+        destination parameter. See add_const_inplace for details.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The constant to add
+        @param[out] destination The ciphertext to overwrite with the addition result
+        @throws std::logic_error if scheme is not scheme_type::bfv
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void add_const(const Ciphertext &encrypted, std::uint64_t value, Ciphertext &destination) const
+        {
+            destination = encrypted;
+            add_const_inplace(destination, value);
+        }
+
         /**
         Transforms a plaintext to NTT domain. This functions applies the Number Theoretic Transform to a plaintext by
         first embedding integers modulo the plaintext modulus to integers modulo the coefficient modulus and then
@@ -1131,6 +1682,163 @@ namespace seal
             rotate_vector_inplace(destination, steps, galois_keys, std::move(pool));
         }
 
+        /**
+        Rotates plaintext vector cyclically by each of the given numbers of steps. When using the CKKS scheme, this
+        function writes to destination[i] the encrypted plaintext vector rotated cyclically to the left (steps[i] > 0)
+        or to the right (steps[i] < 0). The key switching decomposition of the input ciphertext is computed only once
+        and shared by all rotations (hoisting), so rotating one ciphertext by many steps is considerably faster than
+        calling rotate_vector repeatedly. The results decrypt to the same values as those of rotate_vector, but the
+        ciphertexts are not bit-identical. Rotations for which no Galois key is present fall back to rotate_vector.
+        Dynamic memory allocations in the process are allocated from the memory pool pointed to by the given
+        MemoryPoolHandle; note that the shared decomposition needs memory for one polynomial per decomposition digit.
+
+        @param[in] encrypted The ciphertext to rotate
+        @param[in] steps The numbers of steps to rotate (positive left, negative right)
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The ciphertexts to overwrite with the rotated results
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::ckks
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for
+        the encryption parameters
+        @throws std::invalid_argument if galois_keys do not correspond to the top
+        level parameters in the current context
+        @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if steps has too big absolute value
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void rotate_vector_many(
+            const Ciphertext &encrypted, const std::vector<int> &steps, const GaloisKeys &galois_keys,
+            std::vector<Ciphertext> &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Multiplies a batched ciphertext with a plaintext matrix given by its generalized diagonals. With d denoting the
+        number of diagonals, this function computes the sum of diagonals[i] * rot(encrypted, i) for i = 0, ..., d-1,
+        where rot rotates the plaintext vector cyclically to the left (rotate_vector in CKKS and rotate_rows in BFV).
+        If each row of slots of encrypted holds a vector v of length d repeated (d must divide the row size) and
+        diagonals[i][j] = M[j % d][(j + i) % d] for a d-by-d matrix M, the result holds M * v repeated likewise. The
+        product is computed with the baby-step giant-step method: the
+        baby-step rotations share a single key switching decomposition (hoisting), and the diagonals are rotated in
+        plaintext, so only O(sqrt(d)) key switching operations are needed. The Galois elements for which keys must be
+        present are returned by multiply_plain_matrix_galois_elts. Dynamic memory allocations in the process are
+        allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        The diagonals must be in NTT form at the same level as encrypted. In CKKS this is what CKKSEncoder outputs and
+        the diagonals must all have the same scale. In BFV the diagonals are made with BatchEncoder and then converted
+        with transform_to_ntt_inplace(diagonal, encrypted.parms_id()).
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] diagonals The generalized diagonals of the matrix in NTT form
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The ciphertext to overwrite with the product
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::bfv or scheme_type::ckks
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if encrypted, diagonals, or galois_keys is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if galois_keys do not correspond to the top level parameters in the current
+        context
+        @throws std::invalid_argument if diagonals is empty or has more elements than there are slots in a row
+        @throws std::invalid_argument if encrypted or diagonals are not in the NTT form expected by the scheme
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_plain_matrix(
+            const Ciphertext &encrypted, const std::vector<Plaintext> &diagonals, const GaloisKeys &galois_keys,
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Returns the Galois elements used by multiply_plain_matrix for a matrix with the given number of diagonals.
+        Passing the result to KeyGenerator::create_galois_keys generates exactly the keys multiply_plain_matrix needs.
+
+        @param[in] diagonal_count The number of generalized diagonals of the matrix
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if diagonal_count is zero or larger than the number of slots in a row
+        */
+        SEAL_NODISCARD std::vector<std::uint32_t> multiply_plain_matrix_galois_elts(std::size_t diagonal_count) const;
+
+        /**
+        Sums blocks of consecutive slots of a batched ciphertext. After the call every slot j holds the sum of the
+        block_width slots j, j+1, ..., j+block_width-1 (cyclically within its row), so in particular the first slot of
+        every block holds the sum of the block. The rows of a BFV ciphertext hold slot_count/2 slots each; block_width
+        equal to slot_count additionally adds the two rows together, so that every slot holds the sum of all slots.
+        The computation is a rotate-and-add ladder that reuses its temporary ciphertexts. When Galois keys for the
+        rotations by s, 2s, and 3s are all present, four partial sums are combined at once using rotations that share
+        a single key switching decomposition (hoisting). The default KeyGenerator::create_galois_keys only generates
+        rotations by powers of two, so with such keys every step uses the ladder; the keys for the hoisted steps are
+        returned by sum_slots_galois_elts. Dynamic memory allocations in the process are allocated from the memory
+        pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext whose slots to sum
+        @param[in] block_width The number of consecutive slots to sum; a power of two
+        @param[in] galois_keys The Galois keys
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::bfv or scheme_type::ckks
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for the encryption parameters
+        @throws std::invalid_argument if galois_keys do not correspond to the top level parameters in the current
+        context
+        @throws std::invalid_argument if block_width is not a power of two or is larger than the number of slots
+        @throws std::invalid_argument if encrypted is not in the NTT form expected by the scheme
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void sum_slots_inplace(
+            Ciphertext &encrypted, std::size_t block_width, const GaloisKeys &galois_keys,
+            MemoryPoolHandle pool = MemoryManager::GetPool()) const;
+
+        /**
+        Sums blocks of consecutive slots of a batched ciphertext and writes the result to the destination parameter.
+        See sum_slots_inplace for details. Dynamic memory allocations in the process are allocated from the memory
+        pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext whose slots to sum
+        @param[in] block_width The number of consecutive slots to sum; a power of two
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The ciphertext to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::bfv or scheme_type::ckks
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for the encryption parameters
+        @throws std::invalid_argument if galois_keys do not correspond to the top level parameters in the current
+        context
+        @throws std::invalid_argument if block_width is not a power of two or is larger than the number of slots
+        @throws std::invalid_argument if encrypted is not in the NTT form expected by the scheme
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if keyswitching is not supported by the context
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void sum_slots(
+            const Ciphertext &encrypted, std::size_t block_width, const GaloisKeys &galois_keys,
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool()) const
+        {
+            destination = encrypted;
+            sum_slots_inplace(destination, block_width, galois_keys, std::move(pool));
+        }
+
+        /**
+        Returns the Galois elements with which sum_slots_inplace hoists every step it can for the given block width.
+        Passing the result to KeyGenerator::create_galois_keys generates exactly the keys sum_slots_inplace needs;
+        unlike the default power-of-two keys they include the rotations by 3s that the hoisted steps use.
+
+        @param[in] block_width The number of consecutive slots to sum; a power of two
+        @throws std::logic_error if scheme is not scheme_type::bfv or scheme_type::ckks
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if block_width is not a power of two or is larger than the number of slots
+        */
+        SEAL_NODISCARD std::vector<std::uint32_t> sum_slots_galois_elts(std::size_t block_width) const;
+
         /**
         Complex conjugates plaintext slot values. When using the CKKS scheme, this function complex conjugates all
         values in the underlying plaintext. Dynamic memory allocations in the process are allocated from the memory pool
@@ -1218,6 +1926,53 @@ namespace seal
             Ciphertext &encrypted, const RelinKeys &relin_keys, std::size_t destination_size,
             MemoryPoolHandle pool) const;
 
+        /**
+        Multiplies two CKKS ciphertexts with multiply_relin_rescale after switching the one at the higher level down to
+        the level of the other.
+        */
+        void multiply_relin_rescale_aligned(
+            const Ciphertext &encrypted1, const Ciphertext &encrypted2, const RelinKeys &relin_keys,
+            Ciphertext &destination, MemoryPoolHandle pool) const;
+
+        /**
+        Multiplies a CKKS ciphertext by the encoding of value with the given scale and multiplies its scale by scale.
+        */
+        void multiply_const_internal(
+            Ciphertext &encrypted, std::complex<double> value, double scale, MemoryPoolHandle pool) const;
+
+        /**
+        Adds the encoding of value to a CKKS ciphertext at the scale of the ciphertext.
+        */
+        void add_const_internal(Ciphertext &encrypted, std::complex<double> value, MemoryPoolHandle pool) const;
+
+        /**
+        Multiplies a BFV ciphertext by a value modulo the plaintext modulus.
+        */
+        void multiply_const_internal(Ciphertext &encrypted, std::uint64_t value) const;
+
+        /**
+        Adds a value modulo the plaintext modulus to a BFV ciphertext.
+        */
+        void add_const_internal(Ciphertext &encrypted, std::uint64_t value) const;
+
+        /**
+        Paterson-Stockmeyer polynomial evaluation shared by BFV and CKKS. The term nonzero[i] tells whether the
+        coefficient of x^i is nonzero, multiply_coeff(term, i, scale) multiplies term by the coefficient of x^i with
+        the given scale (CKKS only), and add_coeff(term, i) adds the coefficient of x^i to term.
+        */
+        void evaluate_polynomial_internal(
+            const Ciphertext &encrypted, std::vector<bool> nonzero,
+            const std::function<void(Ciphertext &, std::size_t, double)> &multiply_coeff,
+            const std::function<void(Ciphertext &, std::size_t)> &add_coeff, const RelinKeys &relin_keys,
+            Ciphertext &destination, MemoryPoolHandle pool) const;
+
+        /**
+        Relinearizes encrypted down to size 2 and switches it to the next level, folding the ModDown of the last key
+        switching into the division by the last prime. Assumes the next level exists.
+        */
+        void relinearize_rescale_internal(
+            Ciphertext &encrypted, const RelinKeys &relin_keys, MemoryPoolHandle pool) const;
+
         void mod_switch_scale_to_next(
             const Ciphertext &encrypted, Ciphertext &destination, MemoryPoolHandle pool) const;
 
@@ -1228,6 +1983,10 @@ namespace seal
         void rotate_internal(
             Ciphertext &encrypted, int steps, const GaloisKeys &galois_keys, MemoryPoolHandle pool) const;
 
+        void rotate_many_internal(
+            const Ciphertext &encrypted, const std::vector<int> &steps, const GaloisKeys &galois_keys,
+            std::vector<Ciphertext> &destination, MemoryPoolHandle pool) const;
+
         inline void conjugate_internal(
             Ciphertext &encrypted, const GaloisKeys &galois_keys, MemoryPoolHandle pool) const
         {
@@ -1255,10 +2014,83 @@ namespace seal
             Ciphertext &encrypted, util::ConstRNSIter target_iter, const KSwitchKeys &kswitch_keys,
             std::size_t key_index, MemoryPoolHandle pool = MemoryManager::GetPool()) const;
 
+        /**
+        Computes the products of target_iter with key_vector modulo the data primes of context_data and the special
+        primes, before ModDown. The output has one polynomial per key component in fully reduced NTT form.
+        */
+        void kswitch_products(
+            util::ConstRNSIter target_iter, const std::vector<PublicKey> &key_vector,
+            const SEALContext::ContextData &context_data, util::PolyIter destination, MemoryPoolHandle pool) const;
+
+        /**
+        Decomposes target_iter into key switching digits and extends every digit to the data primes of context_data
+        and the special primes (ModUp). The output has one polynomial per digit, each with the data primes followed
+        by the special primes, in NTT form with coefficients in [0, 4q).
+        */
+        void kswitch_mod_up(
+            util::ConstRNSIter target_iter, const SEALContext::ContextData &context_data, util::PolyIter digits,
+            MemoryPoolHandle pool) const;
+
+        /**
+        Multiplies the digits produced by kswitch_mod_up with key_vector and accumulates the products into
+        destination, which has one polynomial per key component in fully reduced NTT form.
+        */
+        void kswitch_inner_product(
+            util::ConstPolyIter digits, const std::vector<PublicKey> &key_vector,
+            const SEALContext::ContextData &context_data, util::PolyIter destination, MemoryPoolHandle pool) const;
+
+        /**
+        Same as kswitch_products but with the key at kswitch_keys_index of seeded kswitch_keys, which is expanded one
+        component at a time by kswitch_inner_product_seeded.
+        */
+        void kswitch_products_seeded(
+            util::ConstRNSIter target_iter, const KSwitchKeys &kswitch_keys, std::size_t kswitch_keys_index,
+            const SEALContext::ContextData &context_data, util::PolyIter destination, MemoryPoolHandle pool) const;
+
+        /**
+        Multiplies digits with the key at kswitch_keys_index of seeded kswitch_keys and accumulates the products into
+        destination, which has two polynomials in fully reduced NTT form. The loop over the key components is the
+        outermost one, so that only the second polynomial of a single component is expanded from its seed at a time.
+        get_digit(j, i, scratch) returns the RNS factor i of digit j in NTT form, possibly computed into scratch.
+        */
+        void kswitch_inner_product_seeded(
+            const std::function<util::ConstCoeffIter(std::size_t, std::size_t, util::CoeffIter)> &get_digit,
+            const KSwitchKeys &kswitch_keys, std::size_t kswitch_keys_index,
+            const SEALContext::ContextData &context_data, util::PolyIter destination, MemoryPoolHandle pool) const;
+
+        /**
+        Divides the output of kswitch_inner_product by the product of the special primes (ModDown) and adds the
+        result to the first key_component_count polynomials of encrypted. The contents of poly_prod are destroyed.
+        */
+        void kswitch_mod_down_add(
+            util::PolyIter poly_prod, std::size_t key_component_count, Ciphertext &encrypted,
+            MemoryPoolHandle pool) const;
+
+        /**
+        Divides P*encrypted + poly_prod, where poly_prod is the output of kswitch_inner_product and P is the product
+        of the special primes, by P*q_last in a single pass. Replaces encrypted with the key_component_count
+        polynomials of the result at the next level. The contents of poly_prod are destroyed.
+        */
+        void kswitch_mod_down_rescale(
+            util::PolyIter poly_prod, std::size_t key_component_count, Ciphertext &encrypted,
+            MemoryPoolHandle pool) const;
+
         void multiply_plain_normal(Ciphertext &encrypted, const Plaintext &plain, MemoryPoolHandle pool) const;
 
         void multiply_plain_ntt(Ciphertext &encrypted_ntt, const Plaintext &plain_ntt) const;
 
+        /**
+        Calls func(i, pool) for every i in [0, count), in parallel if more than one thread is set. In parallel
+        execution func receives a thread-local memory pool instead of pool.
+        */
+        void parallel_for(
+            std::size_t count, const MemoryPoolHandle &pool,
+            const std::function<void(std::size_t, MemoryPoolHandle)> &func) const;
+
         SEALContext context_;
+
+        std::shared_ptr<util::ThreadPool> thread_pool_{ nullptr };
+
+        bfv_mul_type bfv_mul_ = bfv_mul_type::behz;
     };
 } // namespace seal
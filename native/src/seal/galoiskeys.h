@@ -8,6 +8,8 @@
 #include "seal/memorymanager.h"
 #include "seal/util/defines.h"
 #include "seal/util/galois.h"
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace seal
@@ -25,6 +27,14 @@ namespace seal
     scheme Galois keys can enable cyclic vector rotations, as well as a complex
     conjugation operation.
 
+    @par Key Archives
+    A request often needs only a few of many Galois keys. save_archive writes the
+    keys to an archive with a table of contents and one separately serialized and
+    optionally compressed blob per key; when saved from Serializable<GaloisKeys>,
+    the blobs are also seeded. load_archive opens such an archive without reading
+    any keys. Each key is then read and expanded the first time an Evaluator uses
+    it, and at most a given number of keys stays resident, evicting the least
+    recently used ones.
 
     @par Thread Safety
     In general, reading from GaloisKeys is thread-safe as long as no other thread is
@@ -58,13 +68,14 @@ namespace seal
         */
         SEAL_NODISCARD inline bool has_key(std::uint32_t galois_elt) const
         {
-            std::size_t index = get_index(galois_elt);
-            return data().size() > index && !data()[index].empty();
+            return contains(get_index(galois_elt));
         }
 
         /**
         Returns a const reference to a Galois key. The returned Galois key corresponds
-        to the given Galois element.
+        to the given Galois element. Keys loaded from an archive or kept in seeded
+        form are not stored in the GaloisKeys instance in full; use acquire_key for
+        them instead.
 
         @param[in] galois_elt The Galois element
         @throws std::invalid_argument if the key corresponding to galois_elt does not exist
@@ -73,5 +84,69 @@ namespace seal
         {
             return KSwitchKeys::data(get_index(galois_elt));
         }
+
+        /**
+        Returns a Galois key corresponding to the given Galois element, reading it
+        from the archive if the keys were loaded with load_archive and the key is
+        not resident. The returned pointer keeps the key alive.
+
+        @param[in] galois_elt The Galois element
+        @throws std::invalid_argument if the key corresponding to galois_elt does not exist
+        @throws std::logic_error if the key cannot be loaded from the archive
+        @throws std::runtime_error if I/O operations failed
+        */
+        SEAL_NODISCARD inline std::shared_ptr<const std::vector<PublicKey>> acquire_key(std::uint32_t galois_elt) const
+        {
+            return acquire(get_index(galois_elt));
+        }
+
+        /**
+        Saves the GaloisKeys to an output stream as a key archive that can be
+        opened with load_archive. Each key is saved separately with the given
+        compression mode. The output stream must have the "binary" flag set and
+        must support seeking, as the table of contents is written last.
+
+        @param[out] stream The stream to save the GaloisKeys to
+        @param[in] compr_mode The desired compression mode
+        @throws std::invalid_argument if the compression mode is not supported
+        @throws std::logic_error if the keys were loaded from an archive, if the
+        data to be saved is invalid, or if compression failed
+        @throws std::runtime_error if I/O operations failed
+        */
+        inline std::streamoff save_archive(
+            std::ostream &stream, compr_mode_type compr_mode = Serialization::compr_mode_default) const
+        {
+            return KSwitchKeys::save_archive(stream, compr_mode);
+        }
+
+        /**
+        Opens a key archive written by save_archive, overwriting the current
+        GaloisKeys. Only the table of contents is read; each key is read, expanded,
+        and verified to be valid for the SEALContext when it is first used. The
+        archive file must remain in place while the GaloisKeys is in use.
+
+        @param[in] context The SEALContext
+        @param[in] path The path of the archive file
+        @param[in] max_resident_keys The maximum number of keys kept in memory
+        @throws std::invalid_argument if the encryption parameters are not valid,
+        or if max_resident_keys is zero
+        @throws std::logic_error if the archive is invalid or not valid for the
+        encryption parameters
+        @throws std::runtime_error if the file cannot be opened or I/O operations
+        failed
+        */
+        inline void load_archive(const SEALContext &context, const std::string &path, std::size_t max_resident_keys)
+        {
+            KSwitchKeys::load_archive(context, path, max_resident_keys);
+        }
+
+        /**
+        Returns the number of keys currently kept in memory for keys loaded from
+        an archive, and zero otherwise.
+        */
+        SEAL_NODISCARD inline std::size_t resident_key_count() const
+        {
+            return archive_resident_key_count();
+        }
     };
 } // namespace seal
@@ -310,6 +310,11 @@ namespace seal
         auto &key_context_data = *context_.key_context_data();
         auto &key_parms = key_context_data.parms();
         auto &key_modulus = key_parms.coeff_modulus();
+        size_t key_modulus_size = key_modulus.size();
+
+        // Each digit consists of special_modulus_size consecutive data primes; the last one may be shorter
+        size_t special_modulus_size = key_parms.special_modulus_size();
+        size_t digit_count = (decomp_mod_count + special_modulus_size - 1) / special_modulus_size;
 
         // Size check
         if (!product_fits_in(coeff_count, decomp_mod_count))
@@ -317,19 +322,36 @@ namespace seal
             throw logic_error("invalid parameters");
         }
 
+        // Compute the product of the special primes modulo each data prime
+        auto special_prod_mod_q(allocate_uint(decomp_mod_count, pool_));
+        SEAL_ITERATE(iter(special_prod_mod_q.get(), key_modulus), decomp_mod_count, [&](auto I) {
+            get<0>(I) = 1;
+            for (size_t i = decomp_mod_count; i < key_modulus_size; i++)
+            {
+                get<0>(I) =
+                    multiply_uint_mod(get<0>(I), barrett_reduce_64(key_modulus[i].value(), get<1>(I)), get<1>(I));
+            }
+        });
+
         // KSwitchKeys data allocated from pool given by MemoryManager::GetPool.
-        destination.resize(decomp_mod_count);
+        destination.resize(digit_count);
 
-        SEAL_ITERATE(iter(new_key, key_modulus, destination, size_t(0)), decomp_mod_count, [&](auto I) {
+        SEAL_ITERATE(iter(destination, size_t(0)), digit_count, [&](auto I) {
             SEAL_ALLOCATE_GET_COEFF_ITER(temp, coeff_count, pool_);
             encrypt_zero_symmetric(
-                secret_key_, context_, key_context_data.parms_id(), true, save_seed, get<2>(I).data());
-            uint64_t factor = barrett_reduce_64(key_modulus.back().value(), get<1>(I));
-            multiply_poly_scalar_coeffmod(get<0>(I), coeff_count, factor, get<1>(I), temp);
+                secret_key_, context_, key_context_data.parms_id(), true, save_seed, get<0>(I).data());
+
+            // Add the product of the special primes times new_key to the RNS factors of this digit
+            size_t digit_begin = get<1>(I) * special_modulus_size;
+            size_t digit_end = min(digit_begin + special_modulus_size, decomp_mod_count);
+            for (size_t i = digit_begin; i < digit_end; i++)
+            {
+                multiply_poly_scalar_coeffmod(new_key[i], coeff_count, special_prod_mod_q[i], key_modulus[i], temp);
 
-            // We use the SeqIter at get<3>(I) to find the i-th RNS factor of the first destination polynomial.
-            CoeffIter destination_iter = (*iter(get<2>(I).data()))[get<3>(I)];
-            add_poly_coeffmod(destination_iter, temp, coeff_count, get<1>(I), destination_iter);
+                // Find the i-th RNS factor of the first destination polynomial.
+                CoeffIter destination_iter = (*iter(get<0>(I).data()))[i];
+                add_poly_coeffmod(destination_iter, temp, coeff_count, key_modulus[i], destination_iter);
+            }
         });
     }
 
@@ -2,13 +2,144 @@
 // Licensed under the MIT license.
 
 #include "seal/kswitchkeys.h"
+#include "seal/util/pointer.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 using namespace std;
 using namespace seal::util;
 
 namespace seal
 {
+    namespace
+    {
+        // "SEALKSKM" in little-endian byte order
+        constexpr uint64_t mapped_magic = 0x4D4B534B4C414553ULL;
+
+        // The beginning of the save_mapped format; the header is followed by
+        // keys_dim1 second dimensions, key_count MappedKeyEntry objects, and
+        // then the data of each key at its data_offset.
+        struct MappedHeader
+        {
+            uint64_t magic;
+            uint8_t version_major;
+            uint8_t version_minor;
+            uint16_t reserved;
+            uint32_t alignment;
+            uint64_t file_size;
+            parms_id_type parms_id;
+            uint64_t keys_dim1;
+            uint64_t key_count;
+        };
+
+        static_assert(sizeof(MappedHeader) == 72, "MappedHeader has unexpected size");
+
+        // The metadata of a single PublicKey in the save_mapped format
+        struct MappedKeyEntry
+        {
+            parms_id_type parms_id;
+            uint64_t size;
+            uint64_t poly_modulus_degree;
+            uint64_t coeff_modulus_size;
+            double scale;
+            uint64_t is_ntt_form;
+            uint64_t data_offset;
+        };
+
+        static_assert(sizeof(MappedKeyEntry) == 80, "MappedKeyEntry has unexpected size");
+
+        // "SEALKSAR" in little-endian byte order
+        constexpr uint64_t archive_magic = 0x5241534B4C414553ULL;
+
+        // The beginning of the archive format; the header is followed by
+        // key_count ArchiveEntry objects and then the key blobs.
+        struct ArchiveHeader
+        {
+            uint64_t magic;
+            uint8_t version_major;
+            uint8_t version_minor;
+            uint16_t reserved;
+            uint32_t reserved2;
+            parms_id_type parms_id;
+            uint64_t key_count;
+        };
+
+        static_assert(sizeof(ArchiveHeader) == 56, "ArchiveHeader has unexpected size");
+
+        // The location of the blob holding the key at a given index; the offset
+        // is relative to the beginning of the archive. Each blob is saved with
+        // Serialization::Save and holds the number of PublicKey objects followed
+        // by the PublicKey objects themselves.
+        struct ArchiveEntry
+        {
+            uint64_t index;
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        static_assert(sizeof(ArchiveEntry) == 24, "ArchiveEntry has unexpected size");
+
+        inline size_t align_mapped_offset(size_t offset)
+        {
+            return add_safe(offset, KSwitchKeys::mapped_alignment - 1) & ~(KSwitchKeys::mapped_alignment - 1);
+        }
+    } // namespace
+
+    struct KSwitchKeys::Archive
+    {
+        Archive(const SEALContext &archive_context, const string &path, size_t max_keys, MemoryPoolHandle archive_pool)
+            : context(archive_context), stream(path, ios::binary), max_resident_keys(max_keys),
+              pool(move(archive_pool))
+        {}
+
+        SEALContext context;
+
+        ifstream stream;
+
+        size_t max_resident_keys;
+
+        MemoryPoolHandle pool;
+
+        // Blob offset and size by key index
+        unordered_map<size_t, pair<uint64_t, uint64_t>> toc;
+
+        // Resident keys by index, with their position in the LRU list
+        unordered_map<size_t, pair<shared_ptr<const vector<PublicKey>>, list<size_t>::iterator>> resident;
+
+        // Key indices from the most to the least recently used
+        list<size_t> lru;
+
+        // Guards stream, resident, and lru
+        mutex archive_mutex;
+    };
+
+    struct KSwitchKeys::Seeded
+    {
+        // A key holding only its first polynomial and the seed of the second one;
+        // keys that were not seeded are held in full with an unknown prng_type
+        struct Key
+        {
+            PublicKey key;
+
+            UniformRandomGeneratorInfo seed;
+
+            SEALVersion version;
+        };
+
+        Seeded(const SEALContext &seeded_context) : context(seeded_context)
+        {}
+
+        SEALContext context;
+
+        vector<vector<Key>> keys;
+    };
+
     KSwitchKeys &KSwitchKeys::operator=(const KSwitchKeys &assign)
     {
         // Check for self-assignment
@@ -36,11 +167,25 @@ namespace seal
             }
         }
 
+        // The copied keys own their data; an archive and seeded keys are shared
+        mapping_.reset();
+        archive_ = assign.archive_;
+        seeded_ = assign.seeded_;
+
         return *this;
     }
 
-    void KSwitchKeys::save_members(ostream &stream) const
+    void KSwitchKeys::save_members(ostream &stream, compr_mode_type compr_mode) const
     {
+        if (archive_)
+        {
+            throw logic_error("keys loaded from an archive cannot be saved");
+        }
+        if (seeded_)
+        {
+            throw logic_error("keys kept in seeded form cannot be saved");
+        }
+
         auto old_except_mask = stream.exceptions();
         try
         {
@@ -49,6 +194,10 @@ namespace seal
 
             uint64_t keys_dim1 = static_cast<uint64_t>(keys_.size());
 
+            // The keys carry their own headers, so they can be loaded without
+            // knowing whether they were packed
+            compr_mode_type key_compr_mode = Serialization::RawComprMode(compr_mode);
+
             // Save the parms_id
             stream.write(reinterpret_cast<const char *>(&parms_id_), sizeof(parms_id_type));
 
@@ -66,7 +215,7 @@ namespace seal
                 for (size_t j = 0; j < keys_dim2; j++)
                 {
                     // Save the key
-                    keys_[index][j].save(stream, compr_mode_type::none);
+                    keys_[index][j].save(stream, key_compr_mode);
                 }
             }
         }
@@ -83,7 +232,8 @@ namespace seal
         stream.exceptions(old_except_mask);
     }
 
-    void KSwitchKeys::load_members(const SEALContext &context, istream &stream, SEAL_MAYBE_UNUSED SEALVersion version)
+    void KSwitchKeys::load_members(
+        const SEALContext &context, istream &stream, SEALVersion version, bool keep_seeds)
     {
         // Verify parameters
         if (!context.parameters_set())
@@ -93,6 +243,7 @@ namespace seal
 
         // Create new keys
         vector<vector<PublicKey>> new_keys;
+        shared_ptr<Seeded> new_seeded = keep_seeds ? make_shared<Seeded>(context) : nullptr;
 
         auto old_except_mask = stream.exceptions();
         try
@@ -108,7 +259,14 @@ namespace seal
             stream.read(reinterpret_cast<char *>(&keys_dim1), sizeof(uint64_t));
 
             // Reserve first for dimension of keys_
-            new_keys.reserve(safe_cast<size_t>(keys_dim1));
+            if (keep_seeds)
+            {
+                new_seeded->keys.reserve(safe_cast<size_t>(keys_dim1));
+            }
+            else
+            {
+                new_keys.reserve(safe_cast<size_t>(keys_dim1));
+            }
 
             // Loop over the first dimension of keys_
             for (size_t index = 0; index < keys_dim1; index++)
@@ -117,14 +275,34 @@ namespace seal
                 uint64_t keys_dim2 = 0;
                 stream.read(reinterpret_cast<char *>(&keys_dim2), sizeof(uint64_t));
 
-                // Don't resize; only reserve
-                new_keys.emplace_back();
-                new_keys.back().reserve(safe_cast<size_t>(keys_dim2));
-                for (size_t j = 0; j < keys_dim2; j++)
+                if (keep_seeds)
+                {
+                    // Load the keys without expanding their seeds
+                    new_seeded->keys.emplace_back();
+                    new_seeded->keys.back().reserve(safe_cast<size_t>(keys_dim2));
+                    for (size_t j = 0; j < keys_dim2; j++)
+                    {
+                        Seeded::Key key{ PublicKey(pool_), UniformRandomGeneratorInfo(), version };
+                        Serialization::LoadWithComprMode(
+                            [&](istream &in, SEALVersion key_version, compr_mode_type key_compr_mode) {
+                                key.key.pk_.load_members(context, in, key_version, key_compr_mode, &key.seed);
+                                key.version = key_version;
+                            },
+                            stream, false);
+                        new_seeded->keys[index].emplace_back(move(key));
+                    }
+                }
+                else
                 {
-                    PublicKey key(pool_);
-                    key.unsafe_load(context, stream);
-                    new_keys[index].emplace_back(move(key));
+                    // Don't resize; only reserve
+                    new_keys.emplace_back();
+                    new_keys.back().reserve(safe_cast<size_t>(keys_dim2));
+                    for (size_t j = 0; j < keys_dim2; j++)
+                    {
+                        PublicKey key(pool_);
+                        key.unsafe_load(context, stream);
+                        new_keys[index].emplace_back(move(key));
+                    }
                 }
             }
         }
@@ -141,5 +319,597 @@ namespace seal
         stream.exceptions(old_except_mask);
 
         swap(keys_, new_keys);
+        mapping_.reset();
+        archive_.reset();
+        seeded_ = move(new_seeded);
+    }
+
+    streamoff KSwitchKeys::save_mapped(ostream &stream) const
+    {
+        if (archive_)
+        {
+            throw logic_error("keys loaded from an archive cannot be saved");
+        }
+        if (seeded_)
+        {
+            throw logic_error("keys kept in seeded form cannot be saved");
+        }
+
+        size_t keys_dim1 = keys_.size();
+        size_t key_count = 0;
+        for (auto &key_dim1 : keys_)
+        {
+            key_count = add_safe(key_count, key_dim1.size());
+        }
+
+        // Lay out the key data after the header and the tables
+        vector<MappedKeyEntry> entries;
+        entries.reserve(key_count);
+        size_t table_end = add_safe(
+            sizeof(MappedHeader), mul_safe(keys_dim1, sizeof(uint64_t)), mul_safe(key_count, sizeof(MappedKeyEntry)));
+        size_t offset = align_mapped_offset(table_end);
+        for (auto &key_dim1 : keys_)
+        {
+            for (auto &key : key_dim1)
+            {
+                const Ciphertext &key_data = key.data();
+                MappedKeyEntry entry{};
+                entry.parms_id = key_data.parms_id_;
+                entry.size = safe_cast<uint64_t>(key_data.size_);
+                entry.poly_modulus_degree = safe_cast<uint64_t>(key_data.poly_modulus_degree_);
+                entry.coeff_modulus_size = safe_cast<uint64_t>(key_data.coeff_modulus_size_);
+                entry.scale = key_data.scale_;
+                entry.is_ntt_form = key_data.is_ntt_form_ ? 1 : 0;
+                entry.data_offset = safe_cast<uint64_t>(offset);
+
+                // Seeded keys cannot be mapped
+                if (key_data.data_.size() !=
+                    mul_safe(key_data.size_, key_data.poly_modulus_degree_, key_data.coeff_modulus_size_))
+                {
+                    throw logic_error("KSwitchKeys data is invalid");
+                }
+                offset = align_mapped_offset(add_safe(offset, mul_safe(key_data.data_.size(), sizeof(uint64_t))));
+                entries.push_back(entry);
+            }
+        }
+
+        MappedHeader header{};
+        header.magic = mapped_magic;
+        header.version_major = static_cast<uint8_t>(SEAL_VERSION_MAJOR);
+        header.version_minor = static_cast<uint8_t>(SEAL_VERSION_MINOR);
+        header.alignment = static_cast<uint32_t>(mapped_alignment);
+        header.file_size = safe_cast<uint64_t>(offset);
+        header.parms_id = parms_id_;
+        header.keys_dim1 = safe_cast<uint64_t>(keys_dim1);
+        header.key_count = safe_cast<uint64_t>(key_count);
+
+        static const array<char, mapped_alignment> padding{};
+        auto old_except_mask = stream.exceptions();
+        try
+        {
+            // Throw exceptions on ios_base::badbit and ios_base::failbit
+            stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+            stream.write(reinterpret_cast<const char *>(&header), sizeof(MappedHeader));
+            for (auto &key_dim1 : keys_)
+            {
+                uint64_t keys_dim2 = static_cast<uint64_t>(key_dim1.size());
+                stream.write(reinterpret_cast<const char *>(&keys_dim2), sizeof(uint64_t));
+            }
+            stream.write(
+                reinterpret_cast<const char *>(entries.data()),
+                safe_cast<streamsize>(mul_safe(key_count, sizeof(MappedKeyEntry))));
+
+            // Write each key at its offset
+            size_t written = table_end;
+            auto entry = entries.cbegin();
+            for (auto &key_dim1 : keys_)
+            {
+                for (auto &key : key_dim1)
+                {
+                    auto &key_array = key.data().data_;
+                    size_t data_offset = static_cast<size_t>((entry++)->data_offset);
+                    stream.write(padding.data(), static_cast<streamsize>(data_offset - written));
+                    stream.write(
+                        reinterpret_cast<const char *>(key_array.cbegin()),
+                        safe_cast<streamsize>(mul_safe(key_array.size(), sizeof(uint64_t))));
+                    written = add_safe(data_offset, mul_safe(key_array.size(), sizeof(uint64_t)));
+                }
+            }
+            stream.write(padding.data(), static_cast<streamsize>(offset - written));
+        }
+        catch (const ios_base::failure &)
+        {
+            stream.exceptions(old_except_mask);
+            throw runtime_error("I/O error");
+        }
+        catch (...)
+        {
+            stream.exceptions(old_except_mask);
+            throw;
+        }
+        stream.exceptions(old_except_mask);
+
+        return safe_cast<streamoff>(offset);
+    }
+
+    streamoff KSwitchKeys::unsafe_load_mapped(const SEALContext &context, const string &path)
+    {
+        // Verify parameters
+        if (!context.parameters_set())
+        {
+            throw invalid_argument("encryption parameters are not set correctly");
+        }
+
+        auto mapping = make_shared<MappedFile>(path);
+        size_t file_size = mapping->size();
+
+        MappedHeader header;
+        if (file_size < sizeof(MappedHeader))
+        {
+            throw logic_error("invalid mapped KSwitchKeys file");
+        }
+        memcpy(&header, mapping->data(), sizeof(MappedHeader));
+        if (header.magic != mapped_magic || header.version_major != SEAL_VERSION_MAJOR ||
+            header.alignment != mapped_alignment || header.file_size != file_size)
+        {
+            throw logic_error("invalid mapped KSwitchKeys file");
+        }
+
+        // The tables must fit in the file
+        size_t keys_dim1 = safe_cast<size_t>(header.keys_dim1);
+        size_t key_count = safe_cast<size_t>(header.key_count);
+        if (unsigned_gt(keys_dim1, file_size / sizeof(uint64_t)) ||
+            unsigned_gt(key_count, file_size / sizeof(MappedKeyEntry)) ||
+            unsigned_gt(
+                add_safe(
+                    sizeof(MappedHeader), mul_safe(keys_dim1, sizeof(uint64_t)),
+                    mul_safe(key_count, sizeof(MappedKeyEntry))),
+                file_size))
+        {
+            throw logic_error("invalid mapped KSwitchKeys file");
+        }
+        const seal_byte *dims_ptr = mapping->data() + sizeof(MappedHeader);
+        const seal_byte *entries_ptr = dims_ptr + keys_dim1 * sizeof(uint64_t);
+
+        vector<vector<PublicKey>> new_keys;
+        new_keys.reserve(keys_dim1);
+        size_t entry_index = 0;
+        for (size_t index = 0; index < keys_dim1; index++)
+        {
+            uint64_t keys_dim2 = 0;
+            memcpy(&keys_dim2, dims_ptr + index * sizeof(uint64_t), sizeof(uint64_t));
+            if (unsigned_gt(keys_dim2, key_count - entry_index))
+            {
+                throw logic_error("invalid mapped KSwitchKeys file");
+            }
+
+            new_keys.emplace_back();
+            new_keys.back().reserve(static_cast<size_t>(keys_dim2));
+            for (uint64_t j = 0; j < keys_dim2; j++)
+            {
+                MappedKeyEntry entry;
+                memcpy(&entry, entries_ptr + (entry_index++) * sizeof(MappedKeyEntry), sizeof(MappedKeyEntry));
+
+                PublicKey key(pool_);
+                Ciphertext &key_data = key.pk_;
+                key_data.parms_id_ = entry.parms_id;
+                key_data.is_ntt_form_ = entry.is_ntt_form != 0;
+                key_data.size_ = safe_cast<size_t>(entry.size);
+                key_data.poly_modulus_degree_ = safe_cast<size_t>(entry.poly_modulus_degree);
+                key_data.coeff_modulus_size_ = safe_cast<size_t>(entry.coeff_modulus_size);
+                key_data.scale_ = entry.scale;
+
+                // Keys are at the key level; the checked metadata bounds the data size
+                if (!is_metadata_valid_for(key_data, context, true))
+                {
+                    throw logic_error("KSwitchKeys data is invalid");
+                }
+                size_t uint64_count =
+                    mul_safe(key_data.size_, key_data.poly_modulus_degree_, key_data.coeff_modulus_size_);
+                if (entry.data_offset % mapped_alignment || unsigned_gt(entry.data_offset, file_size) ||
+                    unsigned_gt(mul_safe(uint64_count, sizeof(uint64_t)), file_size - entry.data_offset))
+                {
+                    throw logic_error("invalid mapped KSwitchKeys file");
+                }
+
+                // Point the key at the mapping
+                auto data_ptr = reinterpret_cast<Ciphertext::ct_coeff_type *>(
+                    mapping->data() + static_cast<size_t>(entry.data_offset));
+                key_data.data_ = DynArray<Ciphertext::ct_coeff_type>(
+                    Pointer<Ciphertext::ct_coeff_type>::Aliasing(data_ptr), uint64_count, false, pool_);
+                new_keys.back().emplace_back(move(key));
+            }
+        }
+        if (entry_index != key_count)
+        {
+            throw logic_error("invalid mapped KSwitchKeys file");
+        }
+
+        parms_id_ = header.parms_id;
+        swap(keys_, new_keys);
+        mapping_ = move(mapping);
+        archive_.reset();
+        seeded_.reset();
+        return safe_cast<streamoff>(file_size);
+    }
+
+    shared_ptr<const vector<PublicKey>> KSwitchKeys::acquire(size_t index) const
+    {
+        if (seeded_)
+        {
+            if (index >= seeded_->keys.size() || seeded_->keys[index].empty())
+            {
+                throw invalid_argument("keyswitching key does not exist");
+            }
+
+            // Copy the first polynomials and regenerate the second ones from their seeds
+            auto new_key = make_shared<vector<PublicKey>>();
+            new_key->reserve(seeded_->keys[index].size());
+            for (auto &seeded_key : seeded_->keys[index])
+            {
+                PublicKey key(pool_);
+                key.pk_ = seeded_key.key.pk_;
+                if (seeded_key.seed.type() != prng_type::unknown)
+                {
+                    key.pk_.expand_seed(seeded_->context, seeded_key.seed, seeded_key.version);
+                }
+                new_key->emplace_back(move(key));
+            }
+            return new_key;
+        }
+        if (!archive_)
+        {
+            // Refer to the stored key without owning it
+            return shared_ptr<const vector<PublicKey>>(shared_ptr<const void>(), &data(index));
+        }
+
+        lock_guard<mutex> lock(archive_->archive_mutex);
+        auto resident_it = archive_->resident.find(index);
+        if (resident_it != archive_->resident.end())
+        {
+            archive_->lru.splice(archive_->lru.begin(), archive_->lru, resident_it->second.second);
+            return resident_it->second.first;
+        }
+
+        auto toc_it = archive_->toc.find(index);
+        if (toc_it == archive_->toc.end())
+        {
+            throw invalid_argument("keyswitching key does not exist");
+        }
+
+        // Read and expand the key
+        auto &context = archive_->context;
+        size_t max_keys_dim2 = context.key_context_data()->parms().coeff_modulus().size();
+        auto new_key = make_shared<vector<PublicKey>>();
+        auto &stream = archive_->stream;
+        try
+        {
+            stream.clear();
+            stream.seekg(safe_cast<streamoff>(toc_it->second.first));
+            auto in_size = Serialization::Load(
+                [&](istream &in, SEAL_MAYBE_UNUSED SEALVersion version) {
+                    uint64_t keys_dim2 = 0;
+                    in.read(reinterpret_cast<char *>(&keys_dim2), sizeof(uint64_t));
+                    if (!in || unsigned_gt(keys_dim2, max_keys_dim2))
+                    {
+                        throw logic_error("KSwitchKeys data is invalid");
+                    }
+                    new_key->reserve(static_cast<size_t>(keys_dim2));
+                    for (uint64_t j = 0; j < keys_dim2; j++)
+                    {
+                        PublicKey key(archive_->pool);
+                        key.unsafe_load(context, in);
+                        new_key->emplace_back(move(key));
+                    }
+                },
+                stream, false);
+            if (!unsigned_eq(in_size, toc_it->second.second))
+            {
+                throw logic_error("KSwitchKeys data is invalid");
+            }
+        }
+        catch (const ios_base::failure &)
+        {
+            throw runtime_error("I/O error");
+        }
+        for (auto &key : *new_key)
+        {
+            if (key.parms_id() != parms_id_ || !is_valid_for(key, context))
+            {
+                throw logic_error("KSwitchKeys data is invalid");
+            }
+        }
+
+        // Make it the most recently used key and evict the least recently used
+        // keys; callers still using an evicted key keep it alive
+        archive_->lru.push_front(index);
+        shared_ptr<const vector<PublicKey>> key_ptr = move(new_key);
+        archive_->resident.emplace(index, make_pair(key_ptr, archive_->lru.begin()));
+        while (archive_->resident.size() > archive_->max_resident_keys)
+        {
+            archive_->resident.erase(archive_->lru.back());
+            archive_->lru.pop_back();
+        }
+        return key_ptr;
+    }
+
+    streamoff KSwitchKeys::save_archive(ostream &stream, compr_mode_type compr_mode) const
+    {
+        if (archive_)
+        {
+            throw logic_error("keys loaded from an archive cannot be saved");
+        }
+        if (seeded_)
+        {
+            throw logic_error("keys kept in seeded form cannot be saved");
+        }
+        if (!Serialization::IsSupportedComprMode(compr_mode))
+        {
+            throw invalid_argument("unsupported compression mode");
+        }
+
+        vector<ArchiveEntry> entries;
+        for (size_t index = 0; index < keys_.size(); index++)
+        {
+            if (!keys_[index].empty())
+            {
+                entries.push_back({ safe_cast<uint64_t>(index), 0, 0 });
+            }
+        }
+
+        ArchiveHeader header{};
+        header.magic = archive_magic;
+        header.version_major = static_cast<uint8_t>(SEAL_VERSION_MAJOR);
+        header.version_minor = static_cast<uint8_t>(SEAL_VERSION_MINOR);
+        header.parms_id = parms_id_;
+        header.key_count = safe_cast<uint64_t>(entries.size());
+
+        // With compr_mode_type::bitpack the individual keys are packed
+        compr_mode_type key_compr_mode = Serialization::RawComprMode(compr_mode);
+        streamsize entries_size = safe_cast<streamsize>(mul_safe(entries.size(), sizeof(ArchiveEntry)));
+        streampos stream_start_pos;
+        streampos stream_end_pos;
+        auto old_except_mask = stream.exceptions();
+        try
+        {
+            // Throw exceptions on ios_base::badbit and ios_base::failbit
+            stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+            // Write the header and a placeholder for the entries
+            stream_start_pos = stream.tellp();
+            stream.write(reinterpret_cast<const char *>(&header), sizeof(ArchiveHeader));
+            stream.write(reinterpret_cast<const char *>(entries.data()), entries_size);
+
+            for (auto &entry : entries)
+            {
+                // The exact size of the blob before compression, including its SEALHeader
+                auto &key_vector = keys_[static_cast<size_t>(entry.index)];
+                size_t raw_size = add_safe(sizeof(Serialization::SEALHeader), sizeof(uint64_t)); // keys_dim2
+                for (auto &key : key_vector)
+                {
+                    raw_size = add_safe(raw_size, safe_cast<size_t>(key.save_size(key_compr_mode)));
+                }
+
+                entry.offset = safe_cast<uint64_t>(stream.tellp() - stream_start_pos);
+                entry.size = safe_cast<uint64_t>(Serialization::Save(
+                    [&](ostream &out) {
+                        uint64_t keys_dim2 = static_cast<uint64_t>(key_vector.size());
+                        out.write(reinterpret_cast<const char *>(&keys_dim2), sizeof(uint64_t));
+                        for (auto &key : key_vector)
+                        {
+                            key.save(out, key_compr_mode);
+                        }
+                    },
+                    safe_cast<streamoff>(raw_size), stream, compr_mode, false));
+            }
+
+            // Fill in the entries
+            stream_end_pos = stream.tellp();
+            stream.seekp(stream_start_pos + static_cast<streamoff>(sizeof(ArchiveHeader)));
+            stream.write(reinterpret_cast<const char *>(entries.data()), entries_size);
+            stream.seekp(stream_end_pos);
+        }
+        catch (const ios_base::failure &)
+        {
+            stream.exceptions(old_except_mask);
+            throw runtime_error("I/O error");
+        }
+        catch (...)
+        {
+            stream.exceptions(old_except_mask);
+            throw;
+        }
+        stream.exceptions(old_except_mask);
+
+        return safe_cast<streamoff>(stream_end_pos - stream_start_pos);
+    }
+
+    void KSwitchKeys::load_archive(const SEALContext &context, const string &path, size_t max_resident_keys)
+    {
+        // Verify parameters
+        if (!context.parameters_set())
+        {
+            throw invalid_argument("encryption parameters are not set correctly");
+        }
+        if (!max_resident_keys)
+        {
+            throw invalid_argument("max_resident_keys must be positive");
+        }
+
+        auto archive = make_shared<Archive>(context, path, max_resident_keys, pool_);
+        auto &stream = archive->stream;
+        if (!stream.is_open())
+        {
+            throw runtime_error("failed to open file");
+        }
+
+        ArchiveHeader header;
+        try
+        {
+            // Throw exceptions on ios_base::badbit and ios_base::failbit
+            stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+            stream.seekg(0, ios_base::end);
+            auto file_size = safe_cast<uint64_t>(streamoff(stream.tellg()));
+            stream.seekg(0, ios_base::beg);
+
+            if (file_size < sizeof(ArchiveHeader))
+            {
+                throw logic_error("invalid KSwitchKeys archive");
+            }
+            stream.read(reinterpret_cast<char *>(&header), sizeof(ArchiveHeader));
+            if (header.magic != archive_magic || header.version_major != SEAL_VERSION_MAJOR ||
+                unsigned_gt(header.key_count, (file_size - sizeof(ArchiveHeader)) / sizeof(ArchiveEntry)))
+            {
+                throw logic_error("invalid KSwitchKeys archive");
+            }
+            if (header.parms_id != context.key_parms_id())
+            {
+                throw logic_error("KSwitchKeys data is invalid");
+            }
+
+            vector<ArchiveEntry> entries(static_cast<size_t>(header.key_count));
+            stream.read(
+                reinterpret_cast<char *>(entries.data()),
+                safe_cast<streamsize>(mul_safe(entries.size(), sizeof(ArchiveEntry))));
+            for (auto &entry : entries)
+            {
+                if (unsigned_gt(entry.offset, file_size) || unsigned_gt(entry.size, file_size - entry.offset) ||
+                    !archive->toc
+                         .emplace(safe_cast<size_t>(entry.index), make_pair(entry.offset, entry.size))
+                         .second)
+                {
+                    throw logic_error("invalid KSwitchKeys archive");
+                }
+            }
+        }
+        catch (const ios_base::failure &)
+        {
+            throw runtime_error("I/O error");
+        }
+
+        parms_id_ = header.parms_id;
+        keys_.clear();
+        mapping_.reset();
+        archive_ = move(archive);
+        seeded_.reset();
+    }
+
+    bool KSwitchKeys::contains(size_t index) const
+    {
+        if (archive_)
+        {
+            return archive_->toc.count(index);
+        }
+        if (seeded_)
+        {
+            return seeded_->keys.size() > index && !seeded_->keys[index].empty();
+        }
+        return keys_.size() > index && !keys_[index].empty();
+    }
+
+    size_t KSwitchKeys::archive_key_count() const noexcept
+    {
+        return archive_ ? archive_->toc.size() : 0;
+    }
+
+    size_t KSwitchKeys::archive_resident_key_count() const
+    {
+        if (!archive_)
+        {
+            return 0;
+        }
+        lock_guard<mutex> lock(archive_->archive_mutex);
+        return archive_->resident.size();
+    }
+
+    size_t KSwitchKeys::seeded_key_count() const noexcept
+    {
+        if (!seeded_)
+        {
+            return 0;
+        }
+        return static_cast<size_t>(count_if(
+            seeded_->keys.cbegin(), seeded_->keys.cend(), [](auto &key_dim1) { return !key_dim1.empty(); }));
+    }
+
+    bool KSwitchKeys::seeded_keys_valid_for(const SEALContext &context) const
+    {
+        if (!seeded_)
+        {
+            return true;
+        }
+
+        // With hybrid key switching each key has one component per digit instead of one per data prime
+        auto &first_context_data = *context.first_context_data();
+        size_t decomp_mod_count = first_context_data.hybrid_kswitch_tool()
+                                      ? first_context_data.hybrid_kswitch_tool()->digit_count()
+                                      : first_context_data.parms().coeff_modulus().size();
+        for (size_t index = 0; index < seeded_->keys.size(); index++)
+        {
+            if (seeded_->keys[index].empty())
+            {
+                continue;
+            }
+            if (seeded_->keys[index].size() != decomp_mod_count)
+            {
+                return false;
+            }
+
+            // Check the keys as they are used
+            auto key_ptr = acquire(index);
+            for (auto &key : *key_ptr)
+            {
+                if (!is_valid_for(key, context))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    size_t KSwitchKeys::seeded_key_size(size_t index, const SEALContext &context) const
+    {
+        if (!seeded_ || index >= seeded_->keys.size())
+        {
+            return 0;
+        }
+
+        // Check the metadata and that the resident data holds one polynomial, or two if the key is not seeded
+        for (auto &seeded_key : seeded_->keys[index])
+        {
+            auto &data = seeded_key.key.data();
+            if (!is_metadata_valid_for(seeded_key.key, context))
+            {
+                return 0;
+            }
+            size_t poly_count = (seeded_key.seed.type() == prng_type::unknown) ? 2 : 1;
+            if (data.dyn_array().size() != mul_safe(poly_count, data.poly_modulus_degree(), data.coeff_modulus_size()))
+            {
+                return 0;
+            }
+        }
+        return seeded_->keys[index].size();
+    }
+
+    const uint64_t *KSwitchKeys::seeded_key_first(size_t index, size_t component) const
+    {
+        return seeded_->keys[index][component].key.data().data();
+    }
+
+    const uint64_t *KSwitchKeys::seeded_key_second(size_t index, size_t component, uint64_t *scratch) const
+    {
+        auto &seeded_key = seeded_->keys[index][component];
+        if (seeded_key.seed.type() == prng_type::unknown)
+        {
+            return seeded_key.key.data().data(1);
+        }
+        Ciphertext::expand_seed(
+            seeded_->context.get_context_data(seeded_key.key.parms_id())->parms(), seeded_key.seed,
+            seeded_key.version, scratch);
+        return scratch;
     }
 } // namespace seal
@@ -8,7 +8,10 @@
 #include "seal/publickey.h"
 #include "seal/valcheck.h"
 #include "seal/version.h"
+#include "seal/util/mappedfile.h"
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace seal
@@ -25,6 +28,23 @@ namespace seal
     (vector) of keys. In RelinKeys, each key is an encryption of a power of the
     secret key. In GaloisKeys, each key corresponds to a type of rotation.
 
+    @par Memory-Mapped Keys
+    Large keys can be saved once with save_mapped to a file in an uncompressed
+    format where every key polynomial is aligned in the file, and then loaded
+    with load_mapped, which maps the file into memory and points the keys at
+    the mapping instead of copying them. Loading is then nearly instantaneous,
+    and processes mapping the same file share one copy of it in the page cache.
+    Copies of such KSwitchKeys own their data as usual.
+
+    @par Seeded Keys
+    Keys created by KeyGenerator and saved through a Serializable are seeded:
+    the second polynomial of each key is replaced by the seed of the PRNG that
+    produced it. load_seeded keeps such keys in seeded form in memory, which
+    halves the memory they use. Evaluator uses the resident first polynomials
+    in place and regenerates the second polynomials from their seeds in every
+    keyswitching operation that uses the key, one key component at a time into
+    a single scratch polynomial, so that no expanded copy of the key is made.
+
     @par Thread Safety
     In general, reading from KSwitchKeys is thread-safe as long as no
     other thread is concurrently mutating it. This is due to the underlying
@@ -35,6 +55,7 @@ namespace seal
     */
     class KSwitchKeys
     {
+        friend class Evaluator;
         friend class KeyGenerator;
         friend class RelinKeys;
         friend class GaloisKeys;
@@ -50,7 +71,10 @@ namespace seal
 
         @param[in] copy The KSwitchKeys to copy from
         */
-        KSwitchKeys(const KSwitchKeys &copy) = default;
+        KSwitchKeys(const KSwitchKeys &copy)
+            : pool_(copy.pool_), parms_id_(copy.parms_id_), keys_(copy.keys_), archive_(copy.archive_),
+              seeded_(copy.seeded_)
+        {}
 
         /**
         Creates a new KSwitchKeys instance by moving a given instance.
@@ -75,10 +99,19 @@ namespace seal
 
         /**
         Returns the current number of keyswitching keys. Only keys that are
-        non-empty are counted.
+        non-empty are counted. For keys loaded from an archive, this is the
+        number of keys in the archive.
         */
         SEAL_NODISCARD inline std::size_t size() const noexcept
         {
+            if (archive_)
+            {
+                return archive_key_count();
+            }
+            if (seeded_)
+            {
+                return seeded_key_count();
+            }
             return std::accumulate(keys_.cbegin(), keys_.cend(), std::size_t(0), [](std::size_t res, auto &next_key) {
                 return res + (next_key.empty() ? 0 : 1);
             });
@@ -161,13 +194,15 @@ namespace seal
         SEAL_NODISCARD inline std::streamoff save_size(
             compr_mode_type compr_mode = Serialization::compr_mode_default) const
         {
+            // With compr_mode_type::bitpack the individual keys are packed
+            compr_mode_type key_compr_mode = Serialization::RawComprMode(compr_mode);
             std::size_t total_key_size = util::mul_safe(keys_.size(), sizeof(std::uint64_t)); // keys_dim2
             for (auto &key_dim1 : keys_)
             {
                 for (auto &key_dim2 : key_dim1)
                 {
                     total_key_size = util::add_safe(
-                        total_key_size, util::safe_cast<std::size_t>(key_dim2.save_size(compr_mode_type::none)));
+                        total_key_size, util::safe_cast<std::size_t>(key_dim2.save_size(key_compr_mode)));
                 }
             }
 
@@ -198,8 +233,8 @@ namespace seal
         {
             using namespace std::placeholders;
             return Serialization::Save(
-                std::bind(&KSwitchKeys::save_members, this, _1), save_size(compr_mode_type::none), stream, compr_mode,
-                false);
+                std::bind(&KSwitchKeys::save_members, this, _1, compr_mode),
+                save_size(Serialization::RawComprMode(compr_mode)), stream, compr_mode, false);
         }
 
         /**
@@ -218,7 +253,8 @@ namespace seal
         inline std::streamoff unsafe_load(const SEALContext &context, std::istream &stream)
         {
             using namespace std::placeholders;
-            return Serialization::Load(std::bind(&KSwitchKeys::load_members, this, context, _1, _2), stream, false);
+            return Serialization::Load(
+                std::bind(&KSwitchKeys::load_members, this, context, _1, _2, false), stream, false);
         }
 
         /**
@@ -263,8 +299,8 @@ namespace seal
         {
             using namespace std::placeholders;
             return Serialization::Save(
-                std::bind(&KSwitchKeys::save_members, this, _1), save_size(compr_mode_type::none), out, size,
-                compr_mode, false);
+                std::bind(&KSwitchKeys::save_members, this, _1, compr_mode),
+                save_size(Serialization::RawComprMode(compr_mode)), out, size, compr_mode, false);
         }
 
         /**
@@ -286,7 +322,8 @@ namespace seal
         inline std::streamoff unsafe_load(const SEALContext &context, const seal_byte *in, std::size_t size)
         {
             using namespace std::placeholders;
-            return Serialization::Load(std::bind(&KSwitchKeys::load_members, this, context, _1, _2), in, size, false);
+            return Serialization::Load(
+                std::bind(&KSwitchKeys::load_members, this, context, _1, _2, false), in, size, false);
         }
 
         /**
@@ -317,6 +354,152 @@ namespace seal
             return in_size;
         }
 
+        /**
+        Saves the KSwitchKeys instance to an output stream in the format read by
+        load_mapped. The data is not compressed, and each key polynomial starts
+        at an offset from the beginning of the output that is a multiple of
+        mapped_alignment. The output stream must have the "binary" flag set and
+        should write to the beginning of a file.
+
+        @param[out] stream The stream to save the KSwitchKeys to
+        @throws std::logic_error if the data to be saved is invalid
+        @throws std::runtime_error if I/O operations failed
+        */
+        std::streamoff save_mapped(std::ostream &stream) const;
+
+        /**
+        Loads a KSwitchKeys from a file written by save_mapped, overwriting the
+        current KSwitchKeys. The file is mapped into memory and the keys refer
+        to the mapping; the mapping is private, so the file is never modified.
+        Only the metadata of the keys is checked against the SEALContext, so
+        that no key data is read. This function should not be used unless the
+        file comes from a fully trusted source.
+
+        @param[in] context The SEALContext
+        @param[in] path The path of the file to load the KSwitchKeys from
+        @throws std::invalid_argument if the encryption parameters are not valid
+        @throws std::logic_error if the file is not in the expected format, if
+        the loaded data is invalid, or if memory-mapped files are not supported
+        on this platform
+        @throws std::runtime_error if the file cannot be opened or mapped
+        */
+        std::streamoff unsafe_load_mapped(const SEALContext &context, const std::string &path);
+
+        /**
+        Loads a KSwitchKeys from a file written by save_mapped, overwriting the
+        current KSwitchKeys, like unsafe_load_mapped. The loaded KSwitchKeys is
+        verified to be valid for the given SEALContext, which reads all of the
+        key data once.
+
+        @param[in] context The SEALContext
+        @param[in] path The path of the file to load the KSwitchKeys from
+        @throws std::invalid_argument if the encryption parameters are not valid
+        @throws std::logic_error if the file is not in the expected format, if
+        the loaded data is invalid, or if memory-mapped files are not supported
+        on this platform
+        @throws std::runtime_error if the file cannot be opened or mapped
+        */
+        inline std::streamoff load_mapped(const SEALContext &context, const std::string &path)
+        {
+            KSwitchKeys new_keys;
+            new_keys.pool_ = pool_;
+            auto in_size = new_keys.unsafe_load_mapped(context, path);
+            if (!is_valid_for(new_keys, context))
+            {
+                throw std::logic_error("KSwitchKeys data is invalid");
+            }
+            std::swap(*this, new_keys);
+            return in_size;
+        }
+
+        /**
+        Loads a KSwitchKeys from an input stream overwriting the current KSwitchKeys,
+        like unsafe_load, but keeps seeded keys in seeded form in memory. Keys that
+        are not seeded are stored in full. No checking of the validity of the
+        KSwitchKeys data against encryption parameters is performed. This function
+        should not be used unless the KSwitchKeys comes from a fully trusted source.
+
+        @param[in] context The SEALContext
+        @param[in] stream The stream to load the KSwitchKeys from
+        @throws std::invalid_argument if the encryption parameters are not valid
+        @throws std::logic_error if the data cannot be loaded by this version of
+        Microsoft SEAL, if the loaded data is invalid, or if decompression failed
+        @throws std::runtime_error if I/O operations failed
+        */
+        inline std::streamoff unsafe_load_seeded(const SEALContext &context, std::istream &stream)
+        {
+            using namespace std::placeholders;
+            return Serialization::Load(
+                std::bind(&KSwitchKeys::load_members, this, context, _1, _2, true), stream, false);
+        }
+
+        /**
+        Loads a KSwitchKeys from an input stream overwriting the current KSwitchKeys,
+        and keeps seeded keys in seeded form in memory, like unsafe_load_seeded.
+        The loaded KSwitchKeys is verified to be valid for the given SEALContext,
+        which expands every seeded key once.
+
+        @param[in] context The SEALContext
+        @param[in] stream The stream to load the KSwitchKeys from
+        @throws std::invalid_argument if the encryption parameters are not valid
+        @throws std::logic_error if the data cannot be loaded by this version of
+        Microsoft SEAL, if the loaded data is invalid, or if decompression failed
+        @throws std::runtime_error if I/O operations failed
+        */
+        inline std::streamoff load_seeded(const SEALContext &context, std::istream &stream)
+        {
+            KSwitchKeys new_keys;
+            new_keys.pool_ = pool_;
+            auto in_size = new_keys.unsafe_load_seeded(context, stream);
+            if (!is_valid_for(new_keys, context) || !new_keys.seeded_keys_valid_for(context))
+            {
+                throw std::logic_error("KSwitchKeys data is invalid");
+            }
+            std::swap(*this, new_keys);
+            return in_size;
+        }
+
+        /**
+        Returns a keyswitching key at a given index. For keys loaded from an
+        archive (see GaloisKeys::load_archive), the key is read from the archive
+        if it is not resident, and the returned pointer keeps it alive even if
+        it is evicted afterwards. For keys kept in seeded form (see load_seeded),
+        the returned pointer owns a copy of the key whose second polynomials have
+        been expanded from their seeds; Evaluator does not make this copy.
+        Otherwise the returned pointer refers to the key stored in this
+        KSwitchKeys instance.
+
+        @param[in] index The index of the keyswitching key
+        @throws std::invalid_argument if the key at the given index does not exist
+        @throws std::logic_error if the key cannot be loaded from the archive
+        @throws std::runtime_error if I/O operations failed
+        */
+        SEAL_NODISCARD std::shared_ptr<const std::vector<PublicKey>> acquire(std::size_t index) const;
+
+        /**
+        Returns true if the keys are loaded on demand from an archive.
+        */
+        SEAL_NODISCARD inline bool is_archived() const noexcept
+        {
+            return static_cast<bool>(archive_);
+        }
+
+        /**
+        Returns true if the keys are kept in seeded form and expanded on use.
+        */
+        SEAL_NODISCARD inline bool is_seeded() const noexcept
+        {
+            return static_cast<bool>(seeded_);
+        }
+
+        /**
+        Returns true if the keys refer to a file mapped by load_mapped.
+        */
+        SEAL_NODISCARD inline bool is_mapped() const noexcept
+        {
+            return static_cast<bool>(mapping_);
+        }
+
         /**
         Returns the currently used MemoryPoolHandle.
         */
@@ -325,10 +508,49 @@ namespace seal
             return pool_;
         }
 
+        /**
+        The alignment in bytes of key polynomials in the output of save_mapped.
+        */
+        static constexpr std::size_t mapped_alignment = 64;
+
     private:
-        void save_members(std::ostream &stream) const;
+        void save_members(std::ostream &stream, compr_mode_type compr_mode) const;
+
+        void load_members(const SEALContext &context, std::istream &stream, SEALVersion version, bool keep_seeds);
+
+        std::streamoff save_archive(std::ostream &stream, compr_mode_type compr_mode) const;
+
+        void load_archive(const SEALContext &context, const std::string &path, std::size_t max_resident_keys);
+
+        SEAL_NODISCARD bool contains(std::size_t index) const;
+
+        SEAL_NODISCARD std::size_t archive_key_count() const noexcept;
+
+        SEAL_NODISCARD std::size_t archive_resident_key_count() const;
+
+        SEAL_NODISCARD std::size_t seeded_key_count() const noexcept;
+
+        SEAL_NODISCARD bool seeded_keys_valid_for(const SEALContext &context) const;
+
+        /*
+        Returns the number of components of the key at index kept in seeded form, or zero if the key does not exist
+        or the resident data of a component does not match context. Keyswitching reads the components with
+        seeded_key_first and seeded_key_second one at a time, so that at most one second polynomial is expanded.
+        */
+        SEAL_NODISCARD std::size_t seeded_key_size(std::size_t index, const SEALContext &context) const;
+
+        SEAL_NODISCARD const std::uint64_t *seeded_key_first(std::size_t index, std::size_t component) const;
+
+        /*
+        Returns the second polynomial of a key component kept in seeded form. Unless the component is stored in full,
+        the polynomial is expanded from its seed into scratch, which must hold a polynomial at the key level.
+        */
+        SEAL_NODISCARD const std::uint64_t *seeded_key_second(
+            std::size_t index, std::size_t component, std::uint64_t *scratch) const;
 
-        void load_members(const SEALContext &context, std::istream &stream, SEALVersion version);
+        struct Archive;
+
+        struct Seeded;
 
         MemoryPoolHandle pool_ = MemoryManager::GetPool();
 
@@ -338,5 +560,21 @@ namespace seal
         The vector of keyswitching keys.
         */
         std::vector<std::vector<PublicKey>> keys_{};
+
+        /**
+        The file mapping the keys refer to, if they were loaded with load_mapped.
+        */
+        std::shared_ptr<util::MappedFile> mapping_{};
+
+        /**
+        The archive the keys are loaded from on demand; copies share it.
+        */
+        std::shared_ptr<Archive> archive_{};
+
+        /**
+        The keys kept in seeded form, if they were loaded with load_seeded; copies
+        share them.
+        */
+        std::shared_ptr<const Seeded> seeded_{};
     };
 } // namespace seal
@@ -161,6 +161,25 @@ namespace seal
         {
             return MemoryPoolHandle(std::make_shared<util::MemoryPoolMT>(clear_on_destruction));
         }
+#ifndef _M_CEE
+        /**
+        Returns a MemoryPoolHandle pointing to a new thread-safe memory pool that
+        caches free allocations per thread. Allocations and deallocations served
+        from the cache of the calling thread take no locks, which removes most
+        of the contention of a pool returned by New() when many threads allocate
+        simultaneously. Unlike the thread-local memory pool, memory can be shared
+        and released across threads. Each thread may hold on to a small number of
+        free allocations of every size it has used.
+
+        @param[in] clear_on_destruction Indicates whether the memory pool data
+        should be cleared when destroyed. This can be important when memory pools
+        are used to store private data.
+        */
+        SEAL_NODISCARD inline static MemoryPoolHandle NewThreadCaching(bool clear_on_destruction = false)
+        {
+            return MemoryPoolHandle(std::make_shared<util::MemoryPoolTC>(clear_on_destruction));
+        }
+#endif
 
         /**
         Returns a reference to the internal memory pool that the MemoryPoolHandle
@@ -200,6 +219,42 @@ namespace seal
             return !pool_ ? std::size_t(0) : pool_->alloc_byte_count();
         }
 
+        /**
+        Returns a snapshot of the usage statistics of the memory pool pointed to
+        by the current MemoryPoolHandle. For every allocation size the statistics
+        report the number of items allocated from the system, the number of items
+        currently in use and its high-water mark, the number of allocations, and
+        the time spent allocating memory from the system. Items that remain in use
+        after all objects using the pool have been destroyed indicate a leak.
+        Returns empty statistics if the MemoryPoolHandle is uninitialized.
+        */
+        SEAL_NODISCARD inline util::MemoryPoolStats stats() const
+        {
+            return !pool_ ? util::MemoryPoolStats() : pool_->stats();
+        }
+
+        /**
+        Sets a function to be called on every allocation from the memory pool
+        pointed to by the current MemoryPoolHandle. The function receives the
+        allocation size and the tag of the outermost util::MemoryPoolTraceScope
+        of the allocating thread; Evaluator operations open a scope named after
+        the operation. The function may be called concurrently from different
+        threads and must not throw. Passing an empty function removes the
+        callback. Tracing adds overhead to every allocation and is intended for
+        diagnostics only.
+
+        @param[in] callback The function to call on every allocation
+        @throws std::logic_error if the MemoryPoolHandle is uninitialized
+        */
+        inline void set_alloc_callback(util::MemoryPoolAllocCallback callback) const
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            pool_->set_alloc_callback(std::move(callback));
+        }
+
         /**
         Returns the number of MemoryPoolHandle objects sharing this memory pool.
         */
@@ -422,6 +477,46 @@ namespace seal
 
     private:
     };
+
+    /**
+    A memory manager profile that always returns a MemoryPoolHandle pointing to
+    a thread-caching memory pool created by MemoryPoolHandle::NewThreadCaching.
+    This profile is useful when a high number of threads doing simultaneous
+    allocations would cause contention in the global memory pool, but memory
+    must still be shared across threads.
+    */
+    class MMProfThreadCaching : public MMProf
+    {
+    public:
+        /**
+        Creates a new MMProfThreadCaching with a new thread-caching memory pool.
+
+        @param[in] clear_on_destruction Indicates whether the memory pool data
+        should be cleared when destroyed. This can be important when memory pools
+        are used to store private data.
+        */
+        MMProfThreadCaching(bool clear_on_destruction = false)
+            : pool_(MemoryPoolHandle::NewThreadCaching(clear_on_destruction))
+        {}
+
+        /**
+        Destroys the MMProfThreadCaching.
+        */
+        virtual ~MMProfThreadCaching() noexcept override
+        {}
+
+        /**
+        Returns a MemoryPoolHandle pointing to the thread-caching memory pool.
+        The mm_prof_opt_t input parameter has no effect.
+        */
+        SEAL_NODISCARD inline virtual MemoryPoolHandle get_pool(mm_prof_opt_t) override
+        {
+            return pool_;
+        }
+
+    private:
+        MemoryPoolHandle pool_;
+    };
 #endif
     /**
     The MemoryManager class can be used to create instances of MemoryPoolHandle
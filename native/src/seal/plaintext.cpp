@@ -201,7 +201,7 @@ namespace seal
         return *this;
     }
 
-    void Plaintext::save_members(ostream &stream) const
+    void Plaintext::save_members(ostream &stream, compr_mode_type compr_mode) const
     {
         auto old_except_mask = stream.exceptions();
         try
@@ -213,7 +213,14 @@ namespace seal
             uint64_t coeff_count64 = static_cast<uint64_t>(coeff_count_);
             stream.write(reinterpret_cast<const char *>(&coeff_count64), sizeof(uint64_t));
             stream.write(reinterpret_cast<const char *>(&scale_), sizeof(double));
-            data_.save(stream, compr_mode_type::none);
+            if (compr_mode == compr_mode_type::bitpack)
+            {
+                save_bitpacked_array(data_.cbegin(), data_.size(), bitpack_chunk_size_, stream);
+            }
+            else
+            {
+                data_.save(stream, compr_mode_type::none);
+            }
         }
         catch (const ios_base::failure &)
         {
@@ -228,7 +235,8 @@ namespace seal
         stream.exceptions(old_except_mask);
     }
 
-    void Plaintext::load_members(const SEALContext &context, istream &stream, SEAL_MAYBE_UNUSED SEALVersion version)
+    void Plaintext::load_members(
+        const SEALContext &context, istream &stream, SEAL_MAYBE_UNUSED SEALVersion version, compr_mode_type compr_mode)
     {
         // Verify parameters
         if (!context.parameters_set())
@@ -278,7 +286,14 @@ namespace seal
             // size of the loaded DynArray. This is an important security measure to
             // prevent a malformed DynArray from causing arbitrarily large memory
             // allocations.
-            new_data.data_.load(stream, new_data.coeff_count_);
+            if (compr_mode == compr_mode_type::bitpack)
+            {
+                load_bitpacked_array(stream, new_data.coeff_count_, new_data.data_);
+            }
+            else
+            {
+                new_data.data_.load(stream, new_data.coeff_count_);
+            }
 
             // Verify that the buffer is correct
             if (!is_buffer_valid(new_data))
@@ -9,6 +9,7 @@
 #include "seal/memorymanager.h"
 #include "seal/valcheck.h"
 #include "seal/version.h"
+#include "seal/util/bitpack.h"
 #include "seal/util/common.h"
 #include "seal/util/defines.h"
 #include "seal/util/polycore.h"
@@ -587,11 +588,15 @@ namespace seal
         SEAL_NODISCARD inline std::streamoff save_size(
             compr_mode_type compr_mode = Serialization::compr_mode_default) const
         {
+            std::size_t data_size =
+                (compr_mode == compr_mode_type::bitpack)
+                    ? util::bitpacked_array_save_size(data_.cbegin(), data_.size(), bitpack_chunk_size_)
+                    : util::safe_cast<std::size_t>(data_.save_size(compr_mode_type::none));
             std::size_t members_size = Serialization::ComprSizeEstimate(
                 util::add_safe(
                     sizeof(parms_id_),
                     sizeof(std::uint64_t), // coeff_count_
-                    sizeof(scale_), util::safe_cast<std::size_t>(data_.save_size(compr_mode_type::none))),
+                    sizeof(scale_), data_size),
                 compr_mode);
 
             return util::safe_cast<std::streamoff>(util::add_safe(sizeof(Serialization::SEALHeader), members_size));
@@ -613,8 +618,8 @@ namespace seal
         {
             using namespace std::placeholders;
             return Serialization::Save(
-                std::bind(&Plaintext::save_members, this, _1), save_size(compr_mode_type::none), stream, compr_mode,
-                false);
+                std::bind(&Plaintext::save_members, this, _1, compr_mode),
+                save_size(Serialization::RawComprMode(compr_mode)), stream, compr_mode, false);
         }
 
         /**
@@ -633,7 +638,8 @@ namespace seal
         inline std::streamoff unsafe_load(const SEALContext &context, std::istream &stream)
         {
             using namespace std::placeholders;
-            return Serialization::Load(std::bind(&Plaintext::load_members, this, context, _1, _2), stream, false);
+            return Serialization::LoadWithComprMode(
+                std::bind(&Plaintext::load_members, this, context, _1, _2, _3), stream, false);
         }
 
         /**
@@ -677,8 +683,8 @@ namespace seal
         {
             using namespace std::placeholders;
             return Serialization::Save(
-                std::bind(&Plaintext::save_members, this, _1), save_size(compr_mode_type::none), out, size, compr_mode,
-                false);
+                std::bind(&Plaintext::save_members, this, _1, compr_mode),
+                save_size(Serialization::RawComprMode(compr_mode)), out, size, compr_mode, false);
         }
 
         /**
@@ -700,7 +706,8 @@ namespace seal
         inline std::streamoff unsafe_load(const SEALContext &context, const seal_byte *in, std::size_t size)
         {
             using namespace std::placeholders;
-            return Serialization::Load(std::bind(&Plaintext::load_members, this, context, _1, _2), in, size, false);
+            return Serialization::LoadWithComprMode(
+                std::bind(&Plaintext::load_members, this, context, _1, _2, _3), in, size, false);
         }
 
         /**
@@ -792,9 +799,16 @@ namespace seal
         struct PlaintextPrivateHelper;
 
     private:
-        void save_members(std::ostream &stream) const;
+        void save_members(std::ostream &stream, compr_mode_type compr_mode) const;
 
-        void load_members(const SEALContext &context, std::istream &stream, SEALVersion version);
+        void load_members(
+            const SEALContext &context, std::istream &stream, SEALVersion version, compr_mode_type compr_mode);
+
+        // Number of coefficients sharing a bit count with compr_mode_type::bitpack.
+        // The last chunk may be partial, e.g. when there are fewer than 1024
+        // coefficients. In NTT form with degree at least 1024 each chunk lies
+        // within a single RNS component; smaller degrees share chunks.
+        static constexpr std::size_t bitpack_chunk_size_ = 1024;
 
         parms_id_type parms_id_ = parms_id_zero;
 
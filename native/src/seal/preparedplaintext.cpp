@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/evaluator.h"
+#include "seal/preparedplaintext.h"
+#include "seal/valcheck.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace seal
+{
+    PreparedPlaintext::PreparedPlaintext(const SEALContext &context, const Plaintext &plain, MemoryPoolHandle pool)
+        : context_(context), plain_(plain, pool), pool_(move(pool))
+    {
+        // Verify parameters
+        if (!context_.parameters_set())
+        {
+            throw invalid_argument("encryption parameters are not set correctly");
+        }
+        if (!is_valid_for(plain_, context_))
+        {
+            throw invalid_argument("plain is not valid for encryption parameters");
+        }
+
+        auto scheme = context_.key_context_data()->parms().scheme();
+        if (scheme == scheme_type::ckks && !plain_.is_ntt_form())
+        {
+            throw invalid_argument("CKKS plain must be in NTT form");
+        }
+        else if (scheme == scheme_type::bfv && plain_.is_ntt_form())
+        {
+            throw invalid_argument("BFV plain cannot be in NTT form");
+        }
+        else if (scheme != scheme_type::bfv && scheme != scheme_type::ckks)
+        {
+            throw invalid_argument("unsupported scheme");
+        }
+    }
+
+    const Plaintext &PreparedPlaintext::at(parms_id_type parms_id) const
+    {
+        auto context_data_ptr = context_.get_context_data(parms_id);
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("parms_id is not valid for encryption parameters");
+        }
+
+        // A CKKS plaintext is already prepared at its own level
+        if (plain_.is_ntt_form() && plain_.parms_id() == parms_id)
+        {
+            return plain_;
+        }
+
+        lock_guard<mutex> lock(cache_mutex_);
+        auto it = cache_.find(parms_id);
+        if (it != cache_.end())
+        {
+            return it->second;
+        }
+
+        Evaluator evaluator(context_);
+        Plaintext prepared(plain_, pool_);
+        if (prepared.is_ntt_form())
+        {
+            evaluator.mod_switch_to_inplace(prepared, parms_id);
+        }
+        else
+        {
+            evaluator.transform_to_ntt_inplace(prepared, parms_id, pool_);
+        }
+        return cache_.emplace(parms_id, move(prepared)).first->second;
+    }
+
+    size_t PreparedPlaintext::cached_level_count() const
+    {
+        lock_guard<mutex> lock(cache_mutex_);
+        return cache_.size();
+    }
+} // namespace seal
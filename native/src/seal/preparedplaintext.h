@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/context.h"
+#include "seal/encryptionparams.h"
+#include "seal/memorymanager.h"
+#include "seal/plaintext.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace seal
+{
+    /**
+    Class to store a plaintext together with its NTT forms at every level of the modulus switching chain. A plaintext
+    that is multiplied with many ciphertexts, possibly at different levels, normally has to be re-encoded at the
+    right parms_id (CKKS) or lifted to the coefficient modulus and NTT transformed in every multiplication (BFV).
+    A PreparedPlaintext does this work once per level: the first time a level is requested its NTT form is computed
+    and cached, and subsequent requests return the cached plaintext. The Evaluator overloads of multiply_plain and
+    add_plain taking a PreparedPlaintext pick the level of the ciphertext automatically.
+
+    In CKKS the plaintext must be in NTT form, and only its own level and the levels below it are available. Lower
+    levels are obtained by mod_switch_to_inplace, so the results are identical to those of switching the plaintext
+    manually. In BFV the plaintext must be in coefficient form; the cached NTT forms are those produced by
+    Evaluator::transform_to_ntt_inplace, i.e., the plaintext lifted to the coefficient modulus.
+
+    @par Thread Safety
+    Requesting levels from a PreparedPlaintext is thread-safe; the cache is protected by a mutex and cached
+    plaintexts are never moved or modified once created.
+
+    @see Evaluator for the operations that accept a PreparedPlaintext.
+    */
+    class PreparedPlaintext
+    {
+    public:
+        /**
+        Creates a PreparedPlaintext from a given plaintext. No NTT forms are computed until they are requested.
+
+        @param[in] context The SEALContext
+        @param[in] plain The plaintext to prepare
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if the encryption parameters are not valid
+        @throws std::invalid_argument if plain is not valid for the encryption parameters
+        @throws std::invalid_argument if plain is not in NTT form in CKKS or is in NTT form in BFV
+        @throws std::invalid_argument if the scheme is not scheme_type::bfv or scheme_type::ckks
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        PreparedPlaintext(
+            const SEALContext &context, const Plaintext &plain, MemoryPoolHandle pool = MemoryManager::GetPool());
+
+        PreparedPlaintext(const PreparedPlaintext &copy) = delete;
+
+        PreparedPlaintext &operator=(const PreparedPlaintext &assign) = delete;
+
+        /**
+        Returns the plaintext the PreparedPlaintext was created from.
+        */
+        SEAL_NODISCARD inline const Plaintext &plain() const noexcept
+        {
+            return plain_;
+        }
+
+        /**
+        Returns the plaintext in NTT form at the level given by parms_id, computing and caching it if this level has
+        not been requested before. The returned reference remains valid for the lifetime of the PreparedPlaintext.
+
+        @param[in] parms_id The parms_id of the level
+        @throws std::invalid_argument if parms_id is not valid for the encryption parameters
+        @throws std::invalid_argument if the level is above the level of the plaintext in CKKS
+        */
+        SEAL_NODISCARD const Plaintext &at(parms_id_type parms_id) const;
+
+        /**
+        Returns the number of levels for which an NTT form has been computed.
+        */
+        SEAL_NODISCARD std::size_t cached_level_count() const;
+
+        /**
+        Returns a reference to the underlying SEALContext.
+        */
+        SEAL_NODISCARD inline const SEALContext &context() const noexcept
+        {
+            return context_;
+        }
+
+    private:
+        SEALContext context_;
+
+        Plaintext plain_;
+
+        MemoryPoolHandle pool_;
+
+        mutable std::mutex cache_mutex_;
+
+        mutable std::unordered_map<parms_id_type, Plaintext> cache_;
+    };
+} // namespace seal
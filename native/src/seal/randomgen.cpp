@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 #include "seal/randomgen.h"
+#include "seal/util/aes.h"
 #include "seal/util/blake2.h"
 #include "seal/util/common.h"
 #include "seal/util/fips202.h"
@@ -167,6 +168,9 @@ namespace seal
         case prng_type::shake256:
             return make_shared<Shake256PRNG>(seed_);
 
+        case prng_type::aes256ctr:
+            return make_shared<AES256CTRPRNG>(seed_);
+
         case prng_type::unknown:
             return nullptr;
         }
@@ -222,4 +226,32 @@ namespace seal
         seal_memzero(seed_ext.data(), seed_ext.size() * bytes_per_uint64);
         counter_++;
     }
+
+    AES256CTRPRNG::AES256CTRPRNG(prng_seed_type seed) : UniformRandomGenerator(seed)
+    {
+        // The key consists of the first four seed words in little-endian byte order
+        array<uint8_t, aes256_key_byte_count> key;
+        for (size_t i = 0; i < aes256_key_byte_count; i++)
+        {
+            key[i] = static_cast<uint8_t>(seed[i / bytes_per_uint64] >> (bits_per_byte * (i % bytes_per_uint64)));
+        }
+        aes256_expand_key(key.data(), round_keys_.data());
+        seal_memzero(key.data(), key.size());
+        nonce_ = seed[aes256_key_byte_count / bytes_per_uint64];
+    }
+
+    AES256CTRPRNG::~AES256CTRPRNG()
+    {
+        seal_memzero(round_keys_.data(), round_keys_.size());
+        nonce_ = 0;
+        counter_ = 0;
+    }
+
+    void AES256CTRPRNG::refill_buffer()
+    {
+        // Fill the randomness buffer with the keystream for the next blocks
+        size_t block_count = buffer_size_ / aes_block_byte_count;
+        aes256_ctr_keystream(round_keys_.data(), nonce_, counter_, block_count, buffer_begin_);
+        counter_ += block_count;
+    }
 } // namespace seal
@@ -73,8 +73,7 @@ namespace seal
         */
         SEAL_NODISCARD inline bool has_key(std::size_t key_power) const
         {
-            std::size_t index = get_index(key_power);
-            return data().size() > index && !data()[index].empty();
+            return contains(get_index(key_power));
         }
 
         /**
@@ -17,6 +17,7 @@
 #include "seal/memorymanager.h"
 #include "seal/modulus.h"
 #include "seal/plaintext.h"
+#include "seal/preparedplaintext.h"
 #include "seal/publickey.h"
 #include "seal/randomgen.h"
 #include "seal/randomtostd.h"
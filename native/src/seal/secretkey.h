@@ -133,8 +133,8 @@ namespace seal
         {
             using namespace std::placeholders;
             return Serialization::Save(
-                std::bind(&Plaintext::save_members, &sk_, _1), sk_.save_size(compr_mode_type::none), stream, compr_mode,
-                true);
+                std::bind(&Plaintext::save_members, &sk_, _1, compr_mode),
+                sk_.save_size(Serialization::RawComprMode(compr_mode)), stream, compr_mode, true);
         }
 
         /**
@@ -156,8 +156,8 @@ namespace seal
 
             // We use a fresh memory pool with `clear_on_destruction' enabled.
             Plaintext new_sk(MemoryManager::GetPool(mm_prof_opt::mm_force_new, true));
-            auto in_size = Serialization::Load(
-                std::bind(&Plaintext::load_members, &new_sk, std::move(context), _1, _2), stream, true);
+            auto in_size = Serialization::LoadWithComprMode(
+                std::bind(&Plaintext::load_members, &new_sk, std::move(context), _1, _2, _3), stream, true);
             std::swap(sk_, new_sk);
             return in_size;
         }
@@ -203,8 +203,8 @@ namespace seal
         {
             using namespace std::placeholders;
             return Serialization::Save(
-                std::bind(&Plaintext::save_members, &sk_, _1), sk_.save_size(compr_mode_type::none), out, size,
-                compr_mode, true);
+                std::bind(&Plaintext::save_members, &sk_, _1, compr_mode),
+                sk_.save_size(Serialization::RawComprMode(compr_mode)), out, size, compr_mode, true);
         }
 
         /**
@@ -229,8 +229,8 @@ namespace seal
 
             // We use a fresh memory pool with `clear_on_destruction' enabled.
             Plaintext new_sk(MemoryManager::GetPool(mm_prof_opt::mm_force_new, true));
-            auto in_size = Serialization::Load(
-                std::bind(&Plaintext::load_members, &new_sk, std::move(context), _1, _2), in, size, true);
+            auto in_size = Serialization::LoadWithComprMode(
+                std::bind(&Plaintext::load_members, &new_sk, std::move(context), _1, _2, _3), in, size, true);
             std::swap(sk_, new_sk);
             return in_size;
         }
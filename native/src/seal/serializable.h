@@ -135,6 +135,25 @@ namespace seal
             return obj_.save(out, size, compr_mode);
         }
 
+        /**
+        Saves the serializable object to an output stream as a key archive; this
+        is available only for Serializable<GaloisKeys>. The keys in the archive
+        remain seeded.
+
+        @param[out] stream The stream to save the archive to
+        @param[in] compr_mode The desired compression mode
+        @throws std::invalid_argument if the compression mode is not supported
+        @throws std::logic_error if the data to be saved is invalid, or if
+        compression failed
+        @throws std::runtime_error if I/O operations failed
+        @see GaloisKeys::save_archive for the archive format.
+        */
+        inline std::streamoff save_archive(
+            std::ostream &stream, compr_mode_type compr_mode = Serialization::compr_mode_default) const
+        {
+            return obj_.save_archive(stream, compr_mode);
+        }
+
     private:
         Serializable(T &&obj) : obj_(std::move(obj))
         {}
@@ -6,9 +6,15 @@
 #include "seal/serialization.h"
 #include "seal/util/common.h"
 #include "seal/util/streambuf.h"
+#include "seal/util/threadpool.h"
 #include "seal/util/ztools.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <typeinfo>
+#include <vector>
 
 using namespace std;
 using namespace seal::util;
@@ -27,6 +33,15 @@ namespace seal
     // symbol is created.
     constexpr uint8_t Serialization::seal_header_size;
 
+    // Required for C++14 compliance: static constexpr member variables are not necessarily inlined so need to ensure
+    // symbol is created.
+    constexpr uint16_t Serialization::header_flag_framed;
+    constexpr uint16_t Serialization::header_flag_special_modulus_size;
+
+    // Required for C++14 compliance: static constexpr member variables are not necessarily inlined so need to ensure
+    // symbol is created.
+    constexpr size_t Serialization::compr_frame_size_default;
+
     namespace
     {
         [[noreturn]] void expressive_rethrow_on_ios_base_failure(const ostream &stream)
@@ -80,8 +95,291 @@ namespace seal
             // Generic message
             throw runtime_error("I/O error");
         }
+
+        // The threads and the frame size for framed compression; see Serialization::SetComprThreadCount
+        struct ComprThreads
+        {
+            shared_ptr<ThreadPool> thread_pool;
+
+            size_t frame_size = Serialization::compr_frame_size_default;
+        };
+
+        mutex compr_threads_mutex;
+
+        ComprThreads compr_threads;
+
+        ComprThreads get_compr_threads()
+        {
+            lock_guard<mutex> lock(compr_threads_mutex);
+            return compr_threads;
+        }
+
+#if defined(SEAL_USE_ZLIB) || defined(SEAL_USE_ZSTD)
+        // Calls func(i) for every i in [0, count), in parallel if thread_pool is set
+        void compr_parallel_for(
+            const shared_ptr<ThreadPool> &thread_pool, size_t count, const function<void(size_t)> &func)
+        {
+            if (thread_pool)
+            {
+                thread_pool->parallel_for(count, func);
+                return;
+            }
+            for (size_t i = 0; i < count; i++)
+            {
+                func(i);
+            }
+        }
+
+        // Returns an upper bound on the size of framed data after the SEALHeader, given the bound for a single frame
+        template <typename BoundFunc>
+        size_t framed_size_bound(size_t in_size, size_t frame_size, BoundFunc frame_bound)
+        {
+            size_t frame_count = in_size / frame_size + (in_size % frame_size ? 1 : 0);
+            size_t out_size = add_safe(sizeof(uint64_t), mul_safe(frame_count, 2 * sizeof(uint64_t)));
+            if (frame_count)
+            {
+                size_t last_frame_size = in_size - (frame_count - 1) * frame_size;
+                out_size = add_safe(
+                    out_size, mul_safe(frame_count - 1, frame_bound(frame_size)), frame_bound(last_frame_size));
+            }
+            return out_size;
+        }
+
+        // Compresses a single frame in place
+        void deflate_frame(DynArray<seal_byte> &frame, compr_mode_type compr_mode, MemoryPoolHandle pool)
+        {
+            switch (compr_mode)
+            {
+#ifdef SEAL_USE_ZLIB
+            case compr_mode_type::zlib:
+                if (ztools::zlib_deflate_array_inplace(frame, move(pool)))
+                {
+                    throw logic_error("ZLIB compression failed");
+                }
+                break;
+#endif
+#ifdef SEAL_USE_ZSTD
+            case compr_mode_type::zstd:
+                if (ztools::zstd_deflate_array_inplace(frame, move(pool)))
+                {
+                    throw logic_error("Zstandard compression failed");
+                }
+                break;
+#endif
+            default:
+                throw invalid_argument("unsupported compression mode");
+            }
+        }
+
+        // Decompresses a single frame of in_size bytes; returns false if decompression failed
+        bool inflate_frame(
+            istream &in_stream, streamoff in_size, ostream &out_stream, compr_mode_type compr_mode,
+            MemoryPoolHandle pool)
+        {
+            switch (compr_mode)
+            {
+#ifdef SEAL_USE_ZLIB
+            case compr_mode_type::zlib:
+                return !ztools::zlib_inflate_stream(in_stream, in_size, out_stream, move(pool));
+#endif
+#ifdef SEAL_USE_ZSTD
+            case compr_mode_type::zstd:
+                return !ztools::zstd_inflate_stream(in_stream, in_size, out_stream, move(pool));
+#endif
+            default:
+                return false;
+            }
+        }
+
+        // Writes the SEALHeader, the frame index, and the frames compressed in parallel; the stream must throw
+        // exceptions on ios_base::badbit and ios_base::failbit
+        void save_framed(
+            const function<void(ostream &)> &save_members, streamoff raw_size, ostream &stream,
+            compr_mode_type compr_mode, bool clear_buffers, uint16_t header_flags, const ComprThreads &threads)
+        {
+            // First save_members to a temporary byte stream
+            SafeByteBuffer safe_buffer(
+                raw_size - static_cast<streamoff>(sizeof(Serialization::SEALHeader)), clear_buffers);
+            iostream temp_stream(&safe_buffer);
+            temp_stream.exceptions(ios_base::badbit | ios_base::failbit);
+            save_members(temp_stream);
+
+            size_t data_size = static_cast<size_t>(temp_stream.tellp());
+            size_t frame_size = threads.frame_size;
+            size_t frame_count = data_size / frame_size + (data_size % frame_size ? 1 : 0);
+
+            auto safe_pool(MemoryManager::GetPool(mm_prof_opt::mm_force_new, clear_buffers));
+            vector<DynArray<seal_byte>> frames;
+            frames.reserve(frame_count);
+            for (size_t i = 0; i < frame_count; i++)
+            {
+                frames.emplace_back(safe_pool);
+            }
+
+            // Compress the frames independently of each other
+            compr_parallel_for(threads.thread_pool, frame_count, [&](size_t i) {
+                size_t frame_begin = i * frame_size;
+                size_t frame_raw_size = min(frame_size, data_size - frame_begin);
+                frames[i].resize(frame_raw_size, false);
+                memcpy(frames[i].begin(), safe_buffer.data() + frame_begin, frame_raw_size);
+                deflate_frame(frames[i], compr_mode, safe_pool);
+            });
+
+            // The frame index holds the uncompressed and the compressed size of each frame
+            vector<uint64_t> frame_index;
+            frame_index.reserve(mul_safe(frame_count, size_t(2)));
+            size_t out_size = add_safe(
+                sizeof(Serialization::SEALHeader), sizeof(uint64_t), mul_safe(frame_count, 2 * sizeof(uint64_t)));
+            for (size_t i = 0; i < frame_count; i++)
+            {
+                frame_index.push_back(static_cast<uint64_t>(min(frame_size, data_size - i * frame_size)));
+                frame_index.push_back(static_cast<uint64_t>(frames[i].size()));
+                out_size = add_safe(out_size, frames[i].size());
+            }
+
+            Serialization::SEALHeader header;
+            header.compr_mode = compr_mode;
+            header.reserved = Serialization::header_flag_framed | header_flags;
+            header.size = safe_cast<uint64_t>(out_size);
+            Serialization::SaveHeader(header, stream);
+
+            uint64_t frame_count64 = static_cast<uint64_t>(frame_count);
+            stream.write(reinterpret_cast<const char *>(&frame_count64), sizeof(uint64_t));
+            stream.write(
+                reinterpret_cast<const char *>(frame_index.data()),
+                safe_cast<streamsize>(mul_safe(frame_index.size(), sizeof(uint64_t))));
+            for (auto &frame : frames)
+            {
+                stream.write(reinterpret_cast<const char *>(frame.cbegin()), safe_cast<streamsize>(frame.size()));
+            }
+        }
+
+        // Reads the frame index and the frames following a SEALHeader, decompresses them in parallel, and calls
+        // load_members on the result. Frames are read and decompressed in batches of one frame per thread, so only
+        // a batch of compressed frames is held in memory at a time. The stream must throw exceptions on
+        // ios_base::badbit and ios_base::failbit.
+        void load_framed(
+            const function<void(istream &, SEALVersion, const Serialization::SEALHeader &)> &load_members,
+            istream &stream, const Serialization::SEALHeader &header, SEALVersion version, bool clear_buffers,
+            const ComprThreads &threads)
+        {
+            // Read the frame index; the compressed frames must exactly fill the rest of the data
+            size_t index_begin = add_safe(sizeof(Serialization::SEALHeader), sizeof(uint64_t));
+            if (unsigned_lt(header.size, index_begin))
+            {
+                throw logic_error("invalid frame index");
+            }
+            uint64_t frame_count64 = 0;
+            stream.read(reinterpret_cast<char *>(&frame_count64), sizeof(uint64_t));
+            if (unsigned_gt(frame_count64, (header.size - index_begin) / (2 * sizeof(uint64_t))))
+            {
+                throw logic_error("invalid frame index");
+            }
+            size_t frame_count = static_cast<size_t>(frame_count64);
+            vector<uint64_t> frame_index(mul_safe(frame_count, size_t(2)));
+            stream.read(
+                reinterpret_cast<char *>(frame_index.data()),
+                safe_cast<streamsize>(mul_safe(frame_index.size(), sizeof(uint64_t))));
+
+            uint64_t expected_size = add_safe(
+                static_cast<uint64_t>(index_begin), static_cast<uint64_t>(frame_index.size() * sizeof(uint64_t)));
+            for (size_t i = 0; i < frame_count; i++)
+            {
+                if (!fits_in<streamsize>(frame_index[2 * i]) || !fits_in<streamsize>(frame_index[2 * i + 1]))
+                {
+                    throw logic_error("invalid frame index");
+                }
+                expected_size = add_safe(expected_size, frame_index[2 * i + 1]);
+            }
+            if (expected_size != header.size)
+            {
+                throw logic_error("invalid frame index");
+            }
+
+            SafeByteBuffer safe_buffer(
+                safe_cast<streamsize>(header.size - static_cast<uint64_t>(sizeof(Serialization::SEALHeader))),
+                clear_buffers);
+            iostream temp_stream(&safe_buffer);
+            temp_stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+            auto safe_pool = MemoryManager::GetPool(mm_prof_opt::mm_force_new, clear_buffers);
+            size_t batch_size = threads.thread_pool ? threads.thread_pool->thread_count() : size_t(1);
+            for (size_t batch_begin = 0; batch_begin < frame_count; batch_begin += batch_size)
+            {
+                size_t batch_count = min(batch_size, frame_count - batch_begin);
+
+                // Read the compressed frames of this batch
+                vector<size_t> compr_offsets(batch_count + 1, 0);
+                for (size_t i = 0; i < batch_count; i++)
+                {
+                    compr_offsets[i + 1] =
+                        add_safe(compr_offsets[i], static_cast<size_t>(frame_index[2 * (batch_begin + i) + 1]));
+                }
+                DynArray<seal_byte> compr_batch(compr_offsets[batch_count], safe_pool);
+                stream.read(
+                    reinterpret_cast<char *>(compr_batch.begin()), safe_cast<streamsize>(compr_batch.size()));
+
+                // Decompress the frames independently of each other
+                vector<unique_ptr<SafeByteBuffer>> raw_frames(batch_count);
+                compr_parallel_for(threads.thread_pool, batch_count, [&](size_t i) {
+                    auto compr_size = static_cast<streamsize>(frame_index[2 * (batch_begin + i) + 1]);
+                    ArrayGetBuffer agbuf(
+                        reinterpret_cast<const char *>(compr_batch.cbegin() + compr_offsets[i]), compr_size);
+                    istream frame_in(&agbuf);
+                    raw_frames[i] = make_unique<SafeByteBuffer>(compr_size, clear_buffers);
+                    iostream frame_out(raw_frames[i].get());
+                    if (!inflate_frame(frame_in, compr_size, frame_out, header.compr_mode, safe_pool) ||
+                        static_cast<uint64_t>(frame_out.tellp()) != frame_index[2 * (batch_begin + i)])
+                    {
+                        throw logic_error("stream decompression failed");
+                    }
+                });
+
+                // Append the frames in order
+                for (size_t i = 0; i < batch_count; i++)
+                {
+                    temp_stream.write(
+                        reinterpret_cast<const char *>(raw_frames[i]->data()),
+                        static_cast<streamsize>(frame_index[2 * (batch_begin + i)]));
+                }
+            }
+
+            load_members(temp_stream, version, header);
+        }
+#endif
     } // namespace
 
+    void Serialization::SetComprThreadCount(size_t thread_count, size_t frame_size)
+    {
+        if (!thread_count)
+        {
+            throw invalid_argument("thread_count must be positive");
+        }
+        if (!frame_size)
+        {
+            throw invalid_argument("frame_size must be positive");
+        }
+
+        ComprThreads new_threads;
+        new_threads.thread_pool = (thread_count > 1) ? make_shared<ThreadPool>(thread_count) : nullptr;
+        new_threads.frame_size = frame_size;
+
+        // The previous threads are released outside the lock, once no Save or Load uses them
+        lock_guard<mutex> lock(compr_threads_mutex);
+        swap(compr_threads, new_threads);
+    }
+
+    size_t Serialization::ComprThreadCount()
+    {
+        auto threads = get_compr_threads();
+        return threads.thread_pool ? threads.thread_pool->thread_count() : size_t(1);
+    }
+
+    size_t Serialization::ComprFrameSize()
+    {
+        return get_compr_threads().frame_size;
+    }
+
     size_t Serialization::ComprSizeEstimate(size_t in_size, compr_mode_type compr_mode)
     {
         if (!IsSupportedComprMode(compr_mode))
@@ -89,17 +387,26 @@ namespace seal
             throw invalid_argument("unsupported compression mode");
         }
 
+        // With more than one thread the data is framed
+        auto threads = get_compr_threads();
+        SEAL_MAYBE_UNUSED bool framed = static_cast<bool>(threads.thread_pool);
+
         switch (compr_mode)
         {
 #ifdef SEAL_USE_ZSTD
         case compr_mode_type::zstd:
-            return ztools::zstd_deflate_size_bound(in_size);
+            return framed ? framed_size_bound(in_size, threads.frame_size, ztools::zstd_deflate_size_bound<size_t>)
+                          : ztools::zstd_deflate_size_bound(in_size);
 #endif
 #ifdef SEAL_USE_ZLIB
         case compr_mode_type::zlib:
-            return ztools::zlib_deflate_size_bound(in_size);
+            return framed ? framed_size_bound(in_size, threads.frame_size, ztools::zlib_deflate_size_bound<size_t>)
+                          : ztools::zlib_deflate_size_bound(in_size);
 #endif
         case compr_mode_type::none:
+            /* fall through */
+
+        case compr_mode_type::bitpack:
             // No compression
             return in_size;
 
@@ -223,7 +530,7 @@ namespace seal
 
     streamoff Serialization::Save(
         function<void(ostream &)> save_members, streamoff raw_size, ostream &stream, compr_mode_type compr_mode,
-        SEAL_MAYBE_UNUSED bool clear_buffers)
+        SEAL_MAYBE_UNUSED bool clear_buffers, uint16_t header_flags)
     {
         if (!save_members)
         {
@@ -251,10 +558,17 @@ namespace seal
 
             // Create the header
             SEALHeader header;
+            header.reserved = header_flags;
+
+            // With more than one thread, compressed data is split into frames compressed in parallel
+            SEAL_MAYBE_UNUSED auto threads = get_compr_threads();
 
             switch (compr_mode)
             {
             case compr_mode_type::none:
+                /* fall through */
+
+            case compr_mode_type::bitpack:
                 // We set the compression mode and size here, and save the header
                 header.compr_mode = compr_mode;
                 header.size = safe_cast<uint64_t>(raw_size);
@@ -266,6 +580,12 @@ namespace seal
 #ifdef SEAL_USE_ZLIB
             case compr_mode_type::zlib:
             {
+                if (threads.thread_pool)
+                {
+                    save_framed(save_members, raw_size, stream, compr_mode, clear_buffers, header_flags, threads);
+                    break;
+                }
+
                 // First save_members to a temporary byte stream; set the size of the temporary stream to be right from
                 // the start to avoid extra reallocs.
                 SafeByteBuffer safe_buffer(
@@ -292,6 +612,12 @@ namespace seal
 #ifdef SEAL_USE_ZSTD
             case compr_mode_type::zstd:
             {
+                if (threads.thread_pool)
+                {
+                    save_framed(save_members, raw_size, stream, compr_mode, clear_buffers, header_flags, threads);
+                    break;
+                }
+
                 // First save_members to a temporary byte stream; set the size of the temporary stream to be right from
                 // the start to avoid extra reallocs.
                 SafeByteBuffer safe_buffer(
@@ -339,7 +665,34 @@ namespace seal
     }
 
     streamoff Serialization::Load(
-        function<void(istream &, SEALVersion)> load_members, istream &stream, SEAL_MAYBE_UNUSED bool clear_buffers)
+        function<void(istream &, SEALVersion)> load_members, istream &stream, bool clear_buffers)
+    {
+        if (!load_members)
+        {
+            throw invalid_argument("load_members is invalid");
+        }
+        return LoadWithComprMode(
+            [&](istream &in, SEALVersion version, compr_mode_type) { load_members(in, version); }, stream,
+            clear_buffers);
+    }
+
+    streamoff Serialization::LoadWithComprMode(
+        function<void(istream &, SEALVersion, compr_mode_type)> load_members, istream &stream, bool clear_buffers)
+    {
+        if (!load_members)
+        {
+            throw invalid_argument("load_members is invalid");
+        }
+        return LoadWithHeader(
+            [&](istream &in, SEALVersion version, const SEALHeader &header) {
+                load_members(in, version, header.compr_mode);
+            },
+            stream, clear_buffers);
+    }
+
+    streamoff Serialization::LoadWithHeader(
+        function<void(istream &, SEALVersion, const SEALHeader &)> load_members, istream &stream,
+        SEAL_MAYBE_UNUSED bool clear_buffers)
     {
         if (!load_members)
         {
@@ -376,8 +729,11 @@ namespace seal
             switch (header.compr_mode)
             {
             case compr_mode_type::none:
+                /* fall through */
+
+            case compr_mode_type::bitpack:
                 // Read rest of the data
-                load_members(stream, version);
+                load_members(stream, version, header);
                 if (header.size != safe_cast<uint64_t>(stream.tellg() - stream_start_pos))
                 {
                     throw logic_error("invalid data size");
@@ -386,6 +742,12 @@ namespace seal
 #ifdef SEAL_USE_ZLIB
             case compr_mode_type::zlib:
             {
+                if (header.reserved & header_flag_framed)
+                {
+                    load_framed(load_members, stream, header, version, clear_buffers, get_compr_threads());
+                    break;
+                }
+
                 auto compr_size = header.size - safe_cast<uint64_t>(stream.tellg() - stream_start_pos);
 
                 // We don't know the decompressed size, but use compr_size as
@@ -402,13 +764,19 @@ namespace seal
                 {
                     throw logic_error("stream decompression failed");
                 }
-                load_members(temp_stream, version);
+                load_members(temp_stream, version, header);
                 break;
             }
 #endif
 #ifdef SEAL_USE_ZSTD
             case compr_mode_type::zstd:
             {
+                if (header.reserved & header_flag_framed)
+                {
+                    load_framed(load_members, stream, header, version, clear_buffers, get_compr_threads());
+                    break;
+                }
+
                 auto compr_size = header.size - safe_cast<uint64_t>(stream.tellg() - stream_start_pos);
 
                 // We don't know the decompressed size, but use compr_size as
@@ -425,7 +793,7 @@ namespace seal
                 {
                     throw logic_error("stream decompression failed");
                 }
-                load_members(temp_stream, version);
+                load_members(temp_stream, version, header);
                 break;
             }
 #endif
@@ -452,7 +820,7 @@ namespace seal
 
     streamoff Serialization::Save(
         function<void(ostream &)> save_members, streamoff raw_size, seal_byte *out, size_t size,
-        compr_mode_type compr_mode, bool clear_buffers)
+        compr_mode_type compr_mode, bool clear_buffers, uint16_t header_flags)
     {
         if (!out)
         {
@@ -468,7 +836,7 @@ namespace seal
         }
         ArrayPutBuffer apbuf(reinterpret_cast<char *>(out), static_cast<streamsize>(size));
         ostream stream(&apbuf);
-        return Save(save_members, raw_size, stream, compr_mode, clear_buffers);
+        return Save(save_members, raw_size, stream, compr_mode, clear_buffers, header_flags);
     }
 
     streamoff Serialization::Load(
@@ -490,4 +858,46 @@ namespace seal
         istream stream(&agbuf);
         return Load(load_members, stream, clear_buffers);
     }
+
+    streamoff Serialization::LoadWithComprMode(
+        function<void(istream &, SEALVersion, compr_mode_type)> load_members, const seal_byte *in, size_t size,
+        bool clear_buffers)
+    {
+        if (!in)
+        {
+            throw invalid_argument("in cannot be null");
+        }
+        if (size < sizeof(SEALHeader))
+        {
+            throw invalid_argument("insufficient size");
+        }
+        if (!fits_in<streamsize>(size))
+        {
+            throw invalid_argument("size is too large");
+        }
+        ArrayGetBuffer agbuf(reinterpret_cast<const char *>(in), static_cast<streamsize>(size));
+        istream stream(&agbuf);
+        return LoadWithComprMode(load_members, stream, clear_buffers);
+    }
+
+    streamoff Serialization::LoadWithHeader(
+        function<void(istream &, SEALVersion, const SEALHeader &)> load_members, const seal_byte *in, size_t size,
+        bool clear_buffers)
+    {
+        if (!in)
+        {
+            throw invalid_argument("in cannot be null");
+        }
+        if (size < sizeof(SEALHeader))
+        {
+            throw invalid_argument("insufficient size");
+        }
+        if (!fits_in<streamsize>(size))
+        {
+            throw invalid_argument("size is too large");
+        }
+        ArrayGetBuffer agbuf(reinterpret_cast<const char *>(in), static_cast<streamsize>(size));
+        istream stream(&agbuf);
+        return LoadWithHeader(load_members, stream, clear_buffers);
+    }
 } // namespace seal
@@ -5,6 +5,7 @@
 
 #include "seal/version.h"
 #include "seal/util/defines.h"
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
@@ -32,6 +33,11 @@ namespace seal
         // Use Zstandard compression
         zstd = 2,
 #endif
+        // Store each coefficient of Ciphertext, Plaintext, SecretKey, PublicKey,
+        // and KSwitchKeys (including RelinKeys and GaloisKeys) data with only as
+        // many bits as the largest coefficient in its RNS component needs. Other
+        // objects are saved uncompressed in this mode.
+        bitpack = 3
     };
 
     /**
@@ -62,6 +68,26 @@ namespace seal
         */
         static constexpr std::uint8_t seal_header_size = 0x10;
 
+        /**
+        The bit in the reserved field of the SEALHeader indicating that the
+        compressed data is split into independently compressed frames.
+        */
+        static constexpr std::uint16_t header_flag_framed = 0x0001;
+
+        /**
+        The bit in the reserved field of the SEALHeader indicating that serialized
+        EncryptionParameters store special_modulus_size after coeff_modulus. It
+        is set only when special_modulus_size is larger than one, so that other
+        parameters keep their format, and readers that do not know the bit
+        reject the header instead of misreading the data.
+        */
+        static constexpr std::uint16_t header_flag_special_modulus_size = 0x0002;
+
+        /**
+        The default number of uncompressed bytes in each frame of framed data.
+        */
+        static constexpr std::size_t compr_frame_size_default = std::size_t(1) << 22;
+
         /**
         Struct to contain metadata for serialization comprising the following fields:
 
@@ -70,8 +96,14 @@ namespace seal
         3. Microsoft SEAL's major version number (1 byte)
         4. Microsoft SEAL's minor version number (1 byte)
         5. a compr_mode_type indicating whether data after the header is compressed (1 byte)
-        6. reserved for future use and data alignment (2 bytes)
+        6. flags describing the layout of the data after the header, namely
+        header_flag_framed and header_flag_special_modulus_size; the remaining
+        bits are reserved for future use (2 bytes)
         7. the size in bytes of the entire serialized object, including the header (8 bytes)
+
+        Framed data starts after the header with the number of frames (8 bytes)
+        and, for each frame, its uncompressed and compressed size (8 bytes each),
+        followed by the compressed frames in order.
         */
         struct SEALHeader
         {
@@ -109,7 +141,9 @@ namespace seal
 #endif
 #ifdef SEAL_USE_ZSTD
             case static_cast<std::uint8_t>(compr_mode_type::zstd):
+                /* fall through */
 #endif
+            case static_cast<std::uint8_t>(compr_mode_type::bitpack):
                 return true;
             }
             return false;
@@ -128,14 +162,30 @@ namespace seal
         /**
         Returns an upper bound on the output size of data compressed according to
         a given compression mode with given input size. If compr_mode is
-        compr_mode_type::none, the return value is exactly in_size.
+        compr_mode_type::none or compr_mode_type::bitpack, the return value is
+        exactly in_size; objects supporting compr_mode_type::bitpack account for
+        the packing in in_size themselves.
 
         @param[in] in_size The input size to a compression algorithm
         @param[in] in_size The compression mode
         @throws std::invalid_argument if the compression mode is not supported
+        @see SetComprThreadCount for the framing of compressed data.
         */
         SEAL_NODISCARD static std::size_t ComprSizeEstimate(std::size_t in_size, compr_mode_type compr_mode);
 
+        /**
+        Returns the mode in which an object's members are written before Save
+        applies any compression: compr_mode_type::bitpack if compr_mode is
+        compr_mode_type::bitpack, and compr_mode_type::none otherwise. Objects
+        pass save_size(RawComprMode(compr_mode)) as raw_size to Save.
+
+        @param[in] compr_mode The compression mode
+        */
+        SEAL_NODISCARD static constexpr compr_mode_type RawComprMode(compr_mode_type compr_mode) noexcept
+        {
+            return (compr_mode == compr_mode_type::bitpack) ? compr_mode_type::bitpack : compr_mode_type::none;
+        }
+
         /**
         Returns true if the SEALHeader has a version number compatible with this version of Microsoft SEAL.
 
@@ -187,9 +237,48 @@ namespace seal
             {
                 return false;
             }
+            if (header.reserved & ~(header_flag_framed | header_flag_special_modulus_size))
+            {
+                return false;
+            }
+
+            // Only compressed data can be framed
+            if ((header.reserved & header_flag_framed) &&
+                (header.compr_mode == compr_mode_type::none || header.compr_mode == compr_mode_type::bitpack))
+            {
+                return false;
+            }
             return true;
         }
 
+        /**
+        Sets the number of threads used to compress and decompress data with
+        compression modes other than compr_mode_type::none and compr_mode_type::bitpack.
+        With more than one thread, Save splits the data into frames of frame_size
+        bytes that are compressed independently and in parallel, and records the
+        size of each frame after the SEALHeader; Load decompresses such frames in
+        parallel. With a single thread Save writes unframed data, which earlier
+        versions of Microsoft SEAL can load. The threads are shared by all calls
+        to Save and Load, and ComprSizeEstimate accounts for the framing. By default
+        only the calling thread is used.
+
+        @param[in] thread_count The number of threads, including the calling thread
+        @param[in] frame_size The number of uncompressed bytes in each frame
+        @throws std::invalid_argument if thread_count or frame_size is zero
+        */
+        static void SetComprThreadCount(std::size_t thread_count, std::size_t frame_size = compr_frame_size_default);
+
+        /**
+        Returns the number of threads used for compression and decompression.
+        */
+        SEAL_NODISCARD static std::size_t ComprThreadCount();
+
+        /**
+        Returns the number of uncompressed bytes in each frame written by Save
+        when more than one thread is used for compression.
+        */
+        SEAL_NODISCARD static std::size_t ComprFrameSize();
+
         /**
         Saves a SEALHeader to a given stream. The output is in binary format and
         not human-readable. The output stream must have the "binary" flag set.
@@ -247,7 +336,10 @@ namespace seal
         For any given compression mode, raw_size must be the exact right size
         (in bytes) of what save_members writes to a stream in the uncompressed
         mode plus the size of SEALHeader. Otherwise the behavior of Save is
-        unspecified.
+        unspecified. With compr_mode_type::bitpack no further compression is
+        applied and save_members is expected to pack its output itself, so
+        raw_size must be the exact size of that packed output plus the size of
+        SEALHeader.
 
         @param[in] save_members A function taking an std::ostream reference as an
         argument, possibly writing some number of bytes into it
@@ -256,6 +348,8 @@ namespace seal
         @param[out] stream The stream to write to
         @param[in] compr_mode The desired compression mode
         @param[in] clear_buffers Whether internal buffers should be cleared
+        @param[in] header_flags Flags describing the layout of the output of
+        save_members, to be set in the reserved field of the SEALHeader
         @throws std::invalid_argument if save_members is invalid
         @throws std::invalid_argument if raw_size is smaller than SEALHeader size
         @throws std::logic_error if the data to be saved is invalid, if compression
@@ -264,7 +358,7 @@ namespace seal
         */
         static std::streamoff Save(
             std::function<void(std::ostream &)> save_members, std::streamoff raw_size, std::ostream &stream,
-            compr_mode_type compr_mode, bool clear_buffers);
+            compr_mode_type compr_mode, bool clear_buffers, std::uint16_t header_flags = 0);
 
         /**
         Deserializes data from stream that was serialized by Save. Once stream has
@@ -286,6 +380,45 @@ namespace seal
         static std::streamoff Load(
             std::function<void(std::istream &, SEALVersion)> load_members, std::istream &stream, bool clear_buffers);
 
+        /**
+        Deserializes data from stream that was serialized by Save, like Load,
+        but additionally passes the compression mode recorded in the header to
+        load_members. Objects supporting compr_mode_type::bitpack use this to
+        know whether their data was packed; all other compression is undone
+        before load_members is called.
+
+        @param[in] load_members A function taking an std::istream reference, a
+        SEALVersion struct, and a compr_mode_type as arguments
+        @param[in] stream The stream to read from
+        @param[in] clear_buffers Whether internal buffers should be cleared
+        @throws std::invalid_argument if load_members is invalid
+        @throws std::logic_error if the data cannot be loaded by this version of
+        Microsoft SEAL, if the loaded data is invalid, or if decompression failed
+        @throws std::runtime_error if I/O operations failed
+        */
+        static std::streamoff LoadWithComprMode(
+            std::function<void(std::istream &, SEALVersion, compr_mode_type)> load_members, std::istream &stream,
+            bool clear_buffers);
+
+        /**
+        Deserializes data from stream that was serialized by Save, like Load,
+        but additionally passes the loaded SEALHeader to load_members. Objects
+        whose layout depends on flags in the reserved field of the header use
+        this; all compression is undone before load_members is called.
+
+        @param[in] load_members A function taking an std::istream reference, a
+        SEALVersion struct, and a SEALHeader as arguments
+        @param[in] stream The stream to read from
+        @param[in] clear_buffers Whether internal buffers should be cleared
+        @throws std::invalid_argument if load_members is invalid
+        @throws std::logic_error if the data cannot be loaded by this version of
+        Microsoft SEAL, if the loaded data is invalid, or if decompression failed
+        @throws std::runtime_error if I/O operations failed
+        */
+        static std::streamoff LoadWithHeader(
+            std::function<void(std::istream &, SEALVersion, const SEALHeader &)> load_members, std::istream &stream,
+            bool clear_buffers);
+
         /**
         Evaluates save_members and compresses the output according to the given
         compr_mode_type. The resulting data is written to a given memory location
@@ -297,7 +430,8 @@ namespace seal
         For any given compression mode, raw_size must be the exact right size
         (in bytes) of what save_members writes to a stream in the uncompressed
         mode plus the size of SEALHeader. Otherwise the behavior of Save is
-        unspecified.
+        unspecified. With compr_mode_type::bitpack, raw_size must be the exact
+        size of the packed output of save_members plus the size of SEALHeader.
 
         @param[in] save_members A function that takes an std::ostream reference as
         an argument and writes some number of bytes into it
@@ -307,6 +441,8 @@ namespace seal
         @param[in] size The number of bytes available in the given memory location
         @param[in] compr_mode The desired compression mode
         @param[in] clear_buffers Whether internal buffers should be cleared
+        @param[in] header_flags Flags describing the layout of the output of
+        save_members, to be set in the reserved field of the SEALHeader
         @throws std::invalid_argument if save_members is invalid, if raw_size or
         size is smaller than SEALHeader size, or if out is null
         @throws std::logic_error if the data to be saved is invalid, if compression
@@ -315,7 +451,7 @@ namespace seal
         */
         static std::streamoff Save(
             std::function<void(std::ostream &)> save_members, std::streamoff raw_size, seal_byte *out, std::size_t size,
-            compr_mode_type compr_mode, bool clear_buffers);
+            compr_mode_type compr_mode, bool clear_buffers, std::uint16_t header_flags = 0);
 
         /**
         Deserializes data from a memory location that was serialized by Save.
@@ -340,6 +476,45 @@ namespace seal
             std::function<void(std::istream &, SEALVersion)> load_members, const seal_byte *in, std::size_t size,
             bool clear_buffers);
 
+        /**
+        Deserializes data from a memory location that was serialized by Save,
+        like Load, but additionally passes the compression mode recorded in the
+        header to load_members.
+
+        @param[in] load_members A function taking an std::istream reference, a
+        SEALVersion struct, and a compr_mode_type as arguments
+        @param[in] in The memory location to read from
+        @param[in] size The number of bytes available in the given memory location
+        @param[in] clear_buffers Whether internal buffers should be cleared
+        @throws std::invalid_argument if load_members is invalid, if in is null,
+        or if size is too small to contain a SEALHeader
+        @throws std::logic_error if the data cannot be loaded by this version of
+        Microsoft SEAL, if the loaded data is invalid, or if decompression failed
+        @throws std::runtime_error if I/O operations failed
+        */
+        static std::streamoff LoadWithComprMode(
+            std::function<void(std::istream &, SEALVersion, compr_mode_type)> load_members, const seal_byte *in,
+            std::size_t size, bool clear_buffers);
+
+        /**
+        Deserializes data from a memory location that was serialized by Save,
+        like Load, but additionally passes the loaded SEALHeader to load_members.
+
+        @param[in] load_members A function taking an std::istream reference, a
+        SEALVersion struct, and a SEALHeader as arguments
+        @param[in] in The memory location to read from
+        @param[in] size The number of bytes available in the given memory location
+        @param[in] clear_buffers Whether internal buffers should be cleared
+        @throws std::invalid_argument if load_members is invalid, if in is null,
+        or if size is too small to contain a SEALHeader
+        @throws std::logic_error if the data cannot be loaded by this version of
+        Microsoft SEAL, if the loaded data is invalid, or if decompression failed
+        @throws std::runtime_error if I/O operations failed
+        */
+        static std::streamoff LoadWithHeader(
+            std::function<void(std::istream &, SEALVersion, const SEALHeader &)> load_members, const seal_byte *in,
+            std::size_t size, bool clear_buffers);
+
     private:
         Serialization() = delete;
     };
@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/aes.h"
+#include "seal/util/common.h"
+#include "seal/util/cpufeatures.h"
+#include <cstring>
+#ifdef SEAL_USE_AESNI
+#include <wmmintrin.h>
+#endif
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            // clang-format off
+            constexpr uint8_t sbox[256] = {
+                0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+                0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+                0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+                0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+                0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+                0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+                0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+                0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+                0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+                0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+                0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+                0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+                0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+                0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+                0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+                0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+            };
+            // clang-format on
+
+            constexpr uint8_t rcon[7] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40 };
+
+            inline uint8_t xtime(uint8_t x)
+            {
+                return static_cast<uint8_t>((x << 1) ^ ((x >> 7) * 0x1b));
+            }
+
+            // Writes the counter block nonce || counter in little-endian byte order
+            inline void set_counter_block(uint64_t nonce, uint64_t counter, uint8_t *block)
+            {
+                for (size_t i = 0; i < 8; i++)
+                {
+                    block[i] = static_cast<uint8_t>(nonce >> (8 * i));
+                    block[i + 8] = static_cast<uint8_t>(counter >> (8 * i));
+                }
+            }
+
+#ifdef SEAL_USE_AESNI
+            // Number of blocks encrypted in an interleaved fashion to hide the latency of aesenc
+            constexpr size_t aesni_lane_count = 8;
+
+            SEAL_TARGET_AESNI inline void aesni_encrypt_lanes(const __m128i *rk, __m128i *x, size_t count)
+            {
+                for (size_t j = 0; j < count; j++)
+                {
+                    x[j] = _mm_xor_si128(x[j], rk[0]);
+                }
+                for (size_t r = 1; r < aes256_round_count; r++)
+                {
+                    for (size_t j = 0; j < count; j++)
+                    {
+                        x[j] = _mm_aesenc_si128(x[j], rk[r]);
+                    }
+                }
+                for (size_t j = 0; j < count; j++)
+                {
+                    x[j] = _mm_aesenclast_si128(x[j], rk[aes256_round_count]);
+                }
+            }
+#endif
+        } // namespace
+
+        void aes256_expand_key(const uint8_t *key, uint8_t *round_keys)
+        {
+            constexpr size_t key_word_count = aes256_key_byte_count / 4;
+            constexpr size_t word_count = aes256_round_key_byte_count / 4;
+
+            memcpy(round_keys, key, aes256_key_byte_count);
+            for (size_t i = key_word_count; i < word_count; i++)
+            {
+                uint8_t temp[4];
+                memcpy(temp, round_keys + 4 * (i - 1), 4);
+                if (i % key_word_count == 0)
+                {
+                    // RotWord followed by SubWord and the round constant
+                    uint8_t t0 = temp[0];
+                    temp[0] = static_cast<uint8_t>(sbox[temp[1]] ^ rcon[i / key_word_count - 1]);
+                    temp[1] = sbox[temp[2]];
+                    temp[2] = sbox[temp[3]];
+                    temp[3] = sbox[t0];
+                }
+                else if (i % key_word_count == 4)
+                {
+                    for (size_t k = 0; k < 4; k++)
+                    {
+                        temp[k] = sbox[temp[k]];
+                    }
+                }
+                for (size_t k = 0; k < 4; k++)
+                {
+                    round_keys[4 * i + k] = static_cast<uint8_t>(round_keys[4 * (i - key_word_count) + k] ^ temp[k]);
+                }
+            }
+        }
+
+        void aes256_encrypt_block(const uint8_t *round_keys, const uint8_t *in, uint8_t *out)
+        {
+            // The state is stored column by column, as in the input block
+            uint8_t s[aes_block_byte_count];
+            for (size_t i = 0; i < aes_block_byte_count; i++)
+            {
+                s[i] = static_cast<uint8_t>(in[i] ^ round_keys[i]);
+            }
+
+            for (size_t round = 1; round <= aes256_round_count; round++)
+            {
+                // SubBytes and ShiftRows: row r is rotated left by r columns
+                uint8_t t[aes_block_byte_count];
+                for (size_t c = 0; c < 4; c++)
+                {
+                    for (size_t r = 0; r < 4; r++)
+                    {
+                        t[r + 4 * c] = sbox[s[r + 4 * ((c + r) & 3)]];
+                    }
+                }
+
+                // MixColumns is skipped in the last round
+                if (round != aes256_round_count)
+                {
+                    for (size_t c = 0; c < 4; c++)
+                    {
+                        uint8_t *col = t + 4 * c;
+                        uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                        uint8_t all = static_cast<uint8_t>(a0 ^ a1 ^ a2 ^ a3);
+                        col[0] = static_cast<uint8_t>(a0 ^ all ^ xtime(static_cast<uint8_t>(a0 ^ a1)));
+                        col[1] = static_cast<uint8_t>(a1 ^ all ^ xtime(static_cast<uint8_t>(a1 ^ a2)));
+                        col[2] = static_cast<uint8_t>(a2 ^ all ^ xtime(static_cast<uint8_t>(a2 ^ a3)));
+                        col[3] = static_cast<uint8_t>(a3 ^ all ^ xtime(static_cast<uint8_t>(a3 ^ a0)));
+                    }
+                }
+
+                // AddRoundKey
+                const uint8_t *rk = round_keys + round * aes_block_byte_count;
+                for (size_t i = 0; i < aes_block_byte_count; i++)
+                {
+                    s[i] = static_cast<uint8_t>(t[i] ^ rk[i]);
+                }
+            }
+
+            memcpy(out, s, aes_block_byte_count);
+            seal_memzero(s, sizeof(s));
+        }
+
+        void aes256_ctr_keystream_portable(
+            const uint8_t *round_keys, uint64_t nonce, uint64_t counter, size_t block_count, seal_byte *destination)
+        {
+            auto out = reinterpret_cast<uint8_t *>(destination);
+            for (size_t i = 0; i < block_count; i++, out += aes_block_byte_count)
+            {
+                set_counter_block(nonce, counter + i, out);
+                aes256_encrypt_block(round_keys, out, out);
+            }
+        }
+
+#ifdef SEAL_USE_AESNI
+        SEAL_TARGET_AESNI void aes256_ctr_keystream_aesni(
+            const uint8_t *round_keys, uint64_t nonce, uint64_t counter, size_t block_count, seal_byte *destination)
+        {
+            __m128i rk[aes256_round_count + 1];
+            for (size_t r = 0; r <= aes256_round_count; r++)
+            {
+                rk[r] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(round_keys + r * aes_block_byte_count));
+            }
+
+            auto out = reinterpret_cast<__m128i *>(destination);
+            __m128i x[aesni_lane_count];
+            while (block_count)
+            {
+                size_t count = block_count < aesni_lane_count ? block_count : aesni_lane_count;
+                for (size_t j = 0; j < count; j++)
+                {
+                    // The low 64 bits hold the nonce and the high 64 bits the counter, as in set_counter_block
+                    x[j] = _mm_set_epi64x(static_cast<long long>(counter + j), static_cast<long long>(nonce));
+                }
+                aesni_encrypt_lanes(rk, x, count);
+                for (size_t j = 0; j < count; j++)
+                {
+                    _mm_storeu_si128(out + j, x[j]);
+                }
+                out += count;
+                counter += count;
+                block_count -= count;
+            }
+
+            for (size_t r = 0; r <= aes256_round_count; r++)
+            {
+                rk[r] = _mm_setzero_si128();
+            }
+        }
+#endif
+
+        void aes256_ctr_keystream(
+            const uint8_t *round_keys, uint64_t nonce, uint64_t counter, size_t block_count, seal_byte *destination)
+        {
+#ifdef SEAL_USE_AESNI
+            if (cpu_has_aesni())
+            {
+                aes256_ctr_keystream_aesni(round_keys, nonce, counter, block_count, destination);
+                return;
+            }
+#endif
+            aes256_ctr_keystream_portable(round_keys, nonce, counter, block_count, destination);
+        }
+    } // namespace util
+} // namespace seal
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/util/defines.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace seal
+{
+    namespace util
+    {
+        constexpr std::size_t aes_block_byte_count = 16;
+
+        constexpr std::size_t aes256_key_byte_count = 32;
+
+        constexpr std::size_t aes256_round_count = 14;
+
+        constexpr std::size_t aes256_round_key_byte_count = (aes256_round_count + 1) * aes_block_byte_count;
+
+        /**
+        Expands a 256-bit AES key into the 15 round keys of AES-256 as specified in FIPS-197.
+
+        @param[in] key The 32-byte key
+        @param[out] round_keys The 240-byte output buffer for the round keys
+        */
+        void aes256_expand_key(const std::uint8_t *key, std::uint8_t *round_keys);
+
+        /**
+        Encrypts a single 16-byte block with AES-256 using the portable implementation.
+
+        @param[in] round_keys The round keys computed by aes256_expand_key
+        @param[in] in The input block
+        @param[out] out The output block; may be equal to in
+        */
+        void aes256_encrypt_block(const std::uint8_t *round_keys, const std::uint8_t *in, std::uint8_t *out);
+
+        /**
+        Writes block_count blocks of AES-256 keystream in counter mode to destination. The counter block for the
+        i-th output block consists of nonce followed by counter + i, both encoded as 64-bit little-endian integers.
+        The AES-NI implementation is used if cpu_has_aesni() returns true; the output is the same in either case.
+
+        @param[in] round_keys The round keys computed by aes256_expand_key
+        @param[in] nonce The nonce forming the first half of each counter block
+        @param[in] counter The counter value for the first output block
+        @param[in] block_count The number of 16-byte blocks to write
+        @param[out] destination The output buffer of block_count * 16 bytes
+        */
+        void aes256_ctr_keystream(
+            const std::uint8_t *round_keys, std::uint64_t nonce, std::uint64_t counter, std::size_t block_count,
+            seal_byte *destination);
+
+        /**
+        The portable implementation of aes256_ctr_keystream. Its running time depends on the key through table
+        lookups, so it is used only on CPUs without AES-NI; it is exposed only for testing and benchmarking.
+        */
+        void aes256_ctr_keystream_portable(
+            const std::uint8_t *round_keys, std::uint64_t nonce, std::uint64_t counter, std::size_t block_count,
+            seal_byte *destination);
+
+#ifdef SEAL_USE_AESNI
+        /**
+        The AES-NI implementation of aes256_ctr_keystream. This function must only be called if cpu_has_aesni()
+        returns true; it is exposed only for testing and benchmarking.
+        */
+        void aes256_ctr_keystream_aesni(
+            const std::uint8_t *round_keys, std::uint64_t nonce, std::uint64_t counter, std::size_t block_count,
+            seal_byte *destination);
+#endif
+    } // namespace util
+} // namespace seal
@@ -0,0 +1,197 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/memorymanager.h"
+#include "seal/util/bitpack.h"
+#include "seal/util/pointer.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        int max_bit_count(const uint64_t *values, size_t count)
+        {
+            // A bitwise OR has the same number of significant bits as the maximum
+            uint64_t acc = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                acc |= values[i];
+            }
+            return get_significant_bit_count(acc);
+        }
+
+        void bitpack_uint64(const uint64_t *values, size_t count, int bit_count, seal_byte *destination)
+        {
+            auto out = reinterpret_cast<unsigned char *>(destination);
+
+            // Bits are collected in a 64-bit accumulator that is flushed whenever it is full; acc_bits < 64 holds
+            // at the start of every iteration.
+            uint64_t acc = 0;
+            int acc_bits = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                uint64_t value = values[i];
+                acc |= value << acc_bits;
+                acc_bits += bit_count;
+                if (acc_bits >= 64)
+                {
+                    memcpy(out, &acc, sizeof(uint64_t));
+                    out += sizeof(uint64_t);
+                    acc_bits -= 64;
+
+                    // Keep the high bits of value that did not fit
+                    acc = acc_bits ? value >> (bit_count - acc_bits) : 0;
+                }
+            }
+            for (; acc_bits > 0; acc_bits -= bits_per_byte)
+            {
+                *out++ = static_cast<unsigned char>(acc);
+                acc >>= bits_per_byte;
+            }
+        }
+
+        void bitunpack_uint64(const seal_byte *source, size_t count, int bit_count, uint64_t *destination)
+        {
+            auto in = reinterpret_cast<const unsigned char *>(source);
+            auto in_end = in + bitpacked_byte_count(count, bit_count);
+            uint64_t mask = (bit_count == bits_per_uint64) ? ~uint64_t(0) : (uint64_t(1) << bit_count) - 1;
+
+            // The accumulator holds acc_bits unread bits; input is read 64 bits at a time
+            uint64_t acc = 0;
+            int acc_bits = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                if (acc_bits >= bit_count)
+                {
+                    destination[i] = acc & mask;
+                    acc = (bit_count == bits_per_uint64) ? 0 : acc >> bit_count;
+                    acc_bits -= bit_count;
+                    continue;
+                }
+
+                uint64_t next = 0;
+                size_t byte_count = min(sizeof(uint64_t), static_cast<size_t>(in_end - in));
+                memcpy(&next, in, byte_count);
+                in += byte_count;
+
+                // acc_bits < bit_count <= 64, so the shifts are well-defined
+                int used_bits = bit_count - acc_bits;
+                destination[i] = (acc | (next << acc_bits)) & mask;
+                acc = (used_bits == bits_per_uint64) ? 0 : next >> used_bits;
+                acc_bits = bits_per_uint64 - used_bits;
+            }
+        }
+
+        size_t bitpacked_array_save_size(const uint64_t *values, size_t count, size_t chunk_size)
+        {
+            size_t size = 2 * sizeof(uint64_t);
+            for (size_t offset = 0; offset < count; offset += chunk_size)
+            {
+                size_t chunk_count = min(chunk_size, count - offset);
+                size = add_safe(
+                    size, size_t(1), bitpacked_byte_count(chunk_count, max_bit_count(values + offset, chunk_count)));
+            }
+            return size;
+        }
+
+        void save_bitpacked_array(const uint64_t *values, size_t count, size_t chunk_size, ostream &stream)
+        {
+            if (count && !chunk_size)
+            {
+                throw invalid_argument("chunk_size cannot be zero");
+            }
+
+            uint64_t count64 = safe_cast<uint64_t>(count);
+            uint64_t chunk_size64 = safe_cast<uint64_t>(chunk_size);
+            stream.write(reinterpret_cast<const char *>(&count64), sizeof(uint64_t));
+            stream.write(reinterpret_cast<const char *>(&chunk_size64), sizeof(uint64_t));
+            if (!count)
+            {
+                return;
+            }
+
+            // Write the bit counts of all chunks first
+            auto pool = MemoryManager::GetPool();
+            size_t chunk_total = (count + chunk_size - 1) / chunk_size;
+            auto bit_counts(allocate<unsigned char>(chunk_total, pool));
+            for (size_t k = 0; k < chunk_total; k++)
+            {
+                size_t offset = k * chunk_size;
+                bit_counts[k] =
+                    static_cast<unsigned char>(max_bit_count(values + offset, min(chunk_size, count - offset)));
+            }
+            stream.write(reinterpret_cast<const char *>(bit_counts.get()), safe_cast<streamsize>(chunk_total));
+
+            // Pack and write one chunk at a time
+            size_t buffer_size = bitpacked_byte_count(min(chunk_size, count), bits_per_uint64);
+            auto buffer(allocate<seal_byte>(buffer_size, pool));
+            for (size_t k = 0; k < chunk_total; k++)
+            {
+                size_t offset = k * chunk_size;
+                size_t chunk_count = min(chunk_size, count - offset);
+                bitpack_uint64(values + offset, chunk_count, bit_counts[k], buffer.get());
+                stream.write(
+                    reinterpret_cast<const char *>(buffer.get()),
+                    safe_cast<streamsize>(bitpacked_byte_count(chunk_count, bit_counts[k])));
+            }
+
+            // The data may be secret (e.g., a SecretKey), so do not leave a copy behind
+            seal_memzero(buffer.get(), buffer_size);
+        }
+
+        void load_bitpacked_array(istream &stream, size_t in_size_bound, DynArray<uint64_t> &destination)
+        {
+            uint64_t count64 = 0;
+            uint64_t chunk_size64 = 0;
+            stream.read(reinterpret_cast<char *>(&count64), sizeof(uint64_t));
+            stream.read(reinterpret_cast<char *>(&chunk_size64), sizeof(uint64_t));
+
+            // Check (optionally) that the size in the metadata does not exceed in_size_bound
+            if (in_size_bound && unsigned_gt(count64, in_size_bound))
+            {
+                throw logic_error("unexpected size");
+            }
+            size_t count = safe_cast<size_t>(count64);
+            if (!count)
+            {
+                destination.resize(0);
+                return;
+            }
+            if (!chunk_size64)
+            {
+                throw logic_error("invalid chunk size");
+            }
+            size_t chunk_size = static_cast<size_t>(min(chunk_size64, count64));
+
+            auto pool = MemoryManager::GetPool();
+            size_t chunk_total = (count + chunk_size - 1) / chunk_size;
+            auto bit_counts(allocate<unsigned char>(chunk_total, pool));
+            stream.read(reinterpret_cast<char *>(bit_counts.get()), safe_cast<streamsize>(chunk_total));
+            if (any_of(bit_counts.get(), bit_counts.get() + chunk_total, [](unsigned char b) {
+                    return b > bits_per_uint64;
+                }))
+            {
+                throw logic_error("invalid bit count");
+            }
+
+            destination.resize(count);
+            size_t buffer_size = bitpacked_byte_count(chunk_size, bits_per_uint64);
+            auto buffer(allocate<seal_byte>(buffer_size, pool));
+            for (size_t k = 0; k < chunk_total; k++)
+            {
+                size_t offset = k * chunk_size;
+                size_t chunk_count = min(chunk_size, count - offset);
+                stream.read(
+                    reinterpret_cast<char *>(buffer.get()),
+                    safe_cast<streamsize>(bitpacked_byte_count(chunk_count, bit_counts[k])));
+                bitunpack_uint64(buffer.get(), chunk_count, bit_counts[k], destination.begin() + offset);
+            }
+            seal_memzero(buffer.get(), buffer_size);
+        }
+    } // namespace util
+} // namespace seal
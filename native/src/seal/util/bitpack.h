@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/dynarray.h"
+#include "seal/util/common.h"
+#include "seal/util/defines.h"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Returns the number of bytes needed to store count values of bit_count bits each.
+        */
+        SEAL_NODISCARD inline std::size_t bitpacked_byte_count(std::size_t count, int bit_count)
+        {
+            std::size_t bits = mul_safe(count, static_cast<std::size_t>(bit_count));
+            return (bits >> 3) + static_cast<std::size_t>((bits & 7) != 0);
+        }
+
+        /**
+        Returns the number of significant bits of the largest of count values.
+        */
+        SEAL_NODISCARD int max_bit_count(const std::uint64_t *values, std::size_t count);
+
+        /**
+        Stores the low bit_count bits of each of count values contiguously in little-endian bit order, writing
+        bitpacked_byte_count(count, bit_count) bytes to destination. The values must be less than 2^bit_count.
+
+        @param[in] values The values to pack
+        @param[in] count The number of values
+        @param[in] bit_count The number of bits per value, between 0 and 64
+        @param[out] destination The output buffer
+        */
+        void bitpack_uint64(const std::uint64_t *values, std::size_t count, int bit_count, seal_byte *destination);
+
+        /**
+        Reverses bitpack_uint64, reading bitpacked_byte_count(count, bit_count) bytes from source.
+
+        @param[in] source The packed input
+        @param[in] count The number of values
+        @param[in] bit_count The number of bits per value, between 0 and 64
+        @param[out] destination The output buffer for count values
+        */
+        void bitunpack_uint64(const seal_byte *source, std::size_t count, int bit_count, std::uint64_t *destination);
+
+        /**
+        Returns the exact number of bytes save_bitpacked_array writes for the given array.
+        */
+        SEAL_NODISCARD std::size_t bitpacked_array_save_size(
+            const std::uint64_t *values, std::size_t count, std::size_t chunk_size);
+
+        /**
+        Writes an array of count values to a stream, splitting it into chunks of chunk_size values (the last chunk
+        may be shorter) that are each packed to the bit count of their largest value. This is the format used for
+        the data of Ciphertext and Plaintext with compr_mode_type::bitpack: the value count and chunk size as 64-bit
+        integers, one byte per chunk for its bit count, and then the packed chunks, each padded to a whole byte.
+
+        @param[in] values The values to save
+        @param[in] count The number of values
+        @param[in] chunk_size The number of values per chunk; typically the polynomial modulus degree
+        @param[out] stream The stream to save the array to
+        @throws std::invalid_argument if count is non-zero and chunk_size is zero
+        */
+        void save_bitpacked_array(
+            const std::uint64_t *values, std::size_t count, std::size_t chunk_size, std::ostream &stream);
+
+        /**
+        Loads an array written by save_bitpacked_array, resizing destination to the number of loaded values.
+
+        @param[in] stream The stream to load the array from
+        @param[in] in_size_bound If this is non-zero, specifies an upper bound on the number of loaded values
+        @param[out] destination The array to load into
+        @throws std::logic_error if the loaded data is invalid or if the loaded size exceeds in_size_bound
+        */
+        void load_bitpacked_array(
+            std::istream &stream, std::size_t in_size_bound, DynArray<std::uint64_t> &destination);
+    } // namespace util
+} // namespace seal
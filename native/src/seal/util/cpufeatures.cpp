@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/cpufeatures.h"
+#if (SEAL_COMPILER == SEAL_COMPILER_MSVC) && \
+    (defined(SEAL_USE_AVX2) || defined(SEAL_USE_AVX512) || defined(SEAL_USE_AESNI))
+#include <intrin.h>
+#endif
+
+namespace seal
+{
+    namespace util
+    {
+#if (SEAL_COMPILER == SEAL_COMPILER_MSVC) && (defined(SEAL_USE_AVX2) || defined(SEAL_USE_AVX512))
+        namespace
+        {
+            // Returns true if the OS saves the YMM (and optionally ZMM and opmask) registers on context switch
+            bool os_saves_registers(bool zmm)
+            {
+                int info[4];
+                __cpuid(info, 1);
+                bool osxsave = (info[2] & (1 << 27)) != 0;
+                if (!osxsave)
+                {
+                    return false;
+                }
+                unsigned long long xcr0 = _xgetbv(0);
+                unsigned long long mask = zmm ? 0xE6ULL : 0x06ULL;
+                return (xcr0 & mask) == mask;
+            }
+
+            bool cpuid_leaf7_ebx_bits(int bits)
+            {
+                int info[4];
+                __cpuid(info, 0);
+                if (info[0] < 7)
+                {
+                    return false;
+                }
+                __cpuidex(info, 7, 0);
+                return (info[1] & bits) == bits;
+            }
+        } // namespace
+#endif
+
+        bool cpu_has_avx2() noexcept
+        {
+#ifdef SEAL_USE_AVX2
+#if (SEAL_COMPILER == SEAL_COMPILER_MSVC)
+            static const bool result = os_saves_registers(false) && cpuid_leaf7_ebx_bits(1 << 5);
+#else
+            static const bool result = []() {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") != 0;
+            }();
+#endif
+            return result;
+#else
+            return false;
+#endif
+        }
+
+        bool cpu_has_avx512() noexcept
+        {
+#ifdef SEAL_USE_AVX512
+#if (SEAL_COMPILER == SEAL_COMPILER_MSVC)
+            // AVX-512F is bit 16 and AVX-512DQ is bit 17 of EBX
+            static const bool result = cpu_has_avx2() && os_saves_registers(true) &&
+                                       cpuid_leaf7_ebx_bits((1 << 16) | (1 << 17));
+#else
+            static const bool result = []() {
+                __builtin_cpu_init();
+                return cpu_has_avx2() && __builtin_cpu_supports("avx512f") != 0 &&
+                       __builtin_cpu_supports("avx512dq") != 0;
+            }();
+#endif
+            return result;
+#else
+            return false;
+#endif
+        }
+
+        bool cpu_has_avx512ifma() noexcept
+        {
+#ifdef SEAL_USE_AVX512IFMA
+#if (SEAL_COMPILER == SEAL_COMPILER_MSVC)
+            // AVX-512 IFMA is bit 21 of EBX
+            static const bool result = cpu_has_avx512() && cpuid_leaf7_ebx_bits(1 << 21);
+#else
+            static const bool result = []() {
+                __builtin_cpu_init();
+                return cpu_has_avx512() && __builtin_cpu_supports("avx512ifma") != 0;
+            }();
+#endif
+            return result;
+#else
+            return false;
+#endif
+        }
+
+        bool cpu_has_aesni() noexcept
+        {
+#ifdef SEAL_USE_AESNI
+#if (SEAL_COMPILER == SEAL_COMPILER_MSVC)
+            // AES-NI is bit 25 of ECX
+            static const bool result = []() {
+                int info[4];
+                __cpuid(info, 1);
+                return (info[2] & (1 << 25)) != 0;
+            }();
+#else
+            static const bool result = []() {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("aes") != 0;
+            }();
+#endif
+            return result;
+#else
+            return false;
+#endif
+        }
+    } // namespace util
+} // namespace seal
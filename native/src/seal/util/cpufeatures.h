@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/util/defines.h"
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Returns true if the library was compiled with AVX2 kernels and the CPU (and operating system) supports AVX2.
+        The CPU is queried only once; subsequent calls return a cached value.
+        */
+        SEAL_NODISCARD bool cpu_has_avx2() noexcept;
+
+        /**
+        Returns true if the library was compiled with AVX-512 kernels and the CPU (and operating system) supports
+        AVX-512F and AVX-512DQ. The CPU is queried only once; subsequent calls return a cached value.
+        */
+        SEAL_NODISCARD bool cpu_has_avx512() noexcept;
+
+        /**
+        Returns true if the library was compiled with AVX-512 IFMA kernels and cpu_has_avx512() returns true and the
+        CPU supports AVX-512 IFMA. The CPU is queried only once; subsequent calls return a cached value.
+        */
+        SEAL_NODISCARD bool cpu_has_avx512ifma() noexcept;
+
+        /**
+        Returns true if the library was compiled with the AES-NI implementation of AES256CTRPRNG and the CPU supports
+        AES-NI. The CPU is queried only once; subsequent calls return a cached value.
+        */
+        SEAL_NODISCARD bool cpu_has_aesni() noexcept;
+    } // namespace util
+} // namespace seal
@@ -136,6 +136,20 @@ namespace seal
 #define SEAL_FORCE_INLINE inline
 #endif
 
+// Function-level target attributes for AVX2, AVX-512, AVX-512 IFMA, and AES-NI kernels (no-op on MSVC)
+#ifndef SEAL_TARGET_AVX2
+#define SEAL_TARGET_AVX2
+#endif
+#ifndef SEAL_TARGET_AVX512
+#define SEAL_TARGET_AVX512
+#endif
+#ifndef SEAL_TARGET_AVX512IFMA
+#define SEAL_TARGET_AVX512IFMA
+#endif
+#ifndef SEAL_TARGET_AESNI
+#define SEAL_TARGET_AESNI
+#endif
+
 // Use `if constexpr' from C++17
 #ifdef SEAL_USE_IF_CONSTEXPR
 #define SEAL_IF_CONSTEXPR if constexpr
@@ -93,4 +93,18 @@ __extension__ typedef unsigned __int128 uint128_t;
 
 #endif // SEAL_USE_INTRIN
 
+// Compile individual functions for AVX2, AVX-512, AVX-512 IFMA, or AES-NI regardless of the global target
+#ifdef SEAL_USE_AVX2
+#define SEAL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#ifdef SEAL_USE_AVX512
+#define SEAL_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512dq")))
+#endif
+#ifdef SEAL_USE_AVX512IFMA
+#define SEAL_TARGET_AVX512IFMA __attribute__((target("avx2,avx512f,avx512dq,avx512ifma")))
+#endif
+#ifdef SEAL_USE_AESNI
+#define SEAL_TARGET_AESNI __attribute__((target("aes")))
+#endif
+
 #endif
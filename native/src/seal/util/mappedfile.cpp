@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/common.h"
+#include "seal/util/mappedfile.h"
+#include <stdexcept>
+#if (SEAL_SYSTEM == SEAL_SYSTEM_WINDOWS)
+#include <Windows.h>
+#elif (SEAL_SYSTEM == SEAL_SYSTEM_UNIX_LIKE)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+#if (SEAL_SYSTEM == SEAL_SYSTEM_UNIX_LIKE)
+        MappedFile::MappedFile(const string &path)
+        {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw runtime_error("failed to open file");
+            }
+
+            struct stat file_stat;
+            if (fstat(fd, &file_stat) != 0)
+            {
+                close(fd);
+                throw runtime_error("failed to read file size");
+            }
+            if (file_stat.st_size <= 0)
+            {
+                close(fd);
+                throw logic_error("file is empty");
+            }
+            size_t size = safe_cast<size_t>(file_stat.st_size);
+
+            // The mapping remains valid after the file descriptor is closed
+            void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED)
+            {
+                throw runtime_error("failed to map file");
+            }
+
+            data_ = reinterpret_cast<seal_byte *>(mapping);
+            size_ = size;
+        }
+
+        MappedFile::~MappedFile()
+        {
+            munmap(data_, size_);
+        }
+#elif (SEAL_SYSTEM == SEAL_SYSTEM_WINDOWS)
+        MappedFile::MappedFile(const string &path)
+        {
+            HANDLE file = CreateFileA(
+                path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                throw runtime_error("failed to open file");
+            }
+
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file, &file_size))
+            {
+                CloseHandle(file);
+                throw runtime_error("failed to read file size");
+            }
+            if (file_size.QuadPart <= 0)
+            {
+                CloseHandle(file);
+                throw logic_error("file is empty");
+            }
+            size_t size = safe_cast<size_t>(file_size.QuadPart);
+
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+            if (!mapping)
+            {
+                CloseHandle(file);
+                throw runtime_error("failed to map file");
+            }
+            void *view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            if (!view)
+            {
+                CloseHandle(mapping);
+                CloseHandle(file);
+                throw runtime_error("failed to map file");
+            }
+
+            file_handle_ = file;
+            mapping_handle_ = mapping;
+            data_ = reinterpret_cast<seal_byte *>(view);
+            size_ = size;
+        }
+
+        MappedFile::~MappedFile()
+        {
+            UnmapViewOfFile(data_);
+            CloseHandle(mapping_handle_);
+            CloseHandle(file_handle_);
+        }
+#else
+        MappedFile::MappedFile(SEAL_MAYBE_UNUSED const string &path)
+        {
+            throw logic_error("memory-mapped files are not supported on this platform");
+        }
+
+        MappedFile::~MappedFile()
+        {}
+#endif
+    } // namespace util
+} // namespace seal
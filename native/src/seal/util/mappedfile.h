@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/util/defines.h"
+#include <cstddef>
+#include <string>
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Maps an entire file into memory. The mapping is private and copy-on-write:
+        the file is never modified, and pages that are only read are shared with
+        the page cache, and hence with other processes mapping the same file.
+        */
+        class MappedFile
+        {
+        public:
+            /**
+            Maps the file at the given path.
+
+            @param[in] path The path of the file to map
+            @throws std::runtime_error if the file cannot be opened or mapped
+            @throws std::logic_error if the file is empty, or if memory-mapped files
+            are not supported on this platform
+            */
+            explicit MappedFile(const std::string &path);
+
+            ~MappedFile();
+
+            MappedFile(const MappedFile &copy) = delete;
+
+            MappedFile &operator=(const MappedFile &assign) = delete;
+
+            /**
+            Returns a pointer to the beginning of the mapping. The mapping is
+            aligned at least to a page boundary.
+            */
+            SEAL_NODISCARD inline seal_byte *data() const noexcept
+            {
+                return data_;
+            }
+
+            /**
+            Returns the size of the mapping in bytes.
+            */
+            SEAL_NODISCARD inline std::size_t size() const noexcept
+            {
+                return size_;
+            }
+
+        private:
+            seal_byte *data_ = nullptr;
+
+            std::size_t size_ = 0;
+
+#if (SEAL_SYSTEM == SEAL_SYSTEM_WINDOWS)
+            void *file_handle_ = nullptr;
+
+            void *mapping_handle_ = nullptr;
+#endif
+        };
+    } // namespace util
+} // namespace seal
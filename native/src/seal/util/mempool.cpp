@@ -7,6 +7,8 @@
 #include <cmath>
 #include <numeric>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 
@@ -26,6 +28,45 @@ namespace seal
         // ensure symbol is created.
         constexpr size_t MemoryPool::first_alloc_count;
 
+#ifndef _M_CEE
+        namespace
+        {
+            thread_local const char *trace_tag = nullptr;
+        } // namespace
+
+        MemoryPoolTraceScope::MemoryPoolTraceScope(const char *tag) noexcept : owner_(trace_tag == nullptr)
+        {
+            if (owner_)
+            {
+                trace_tag = tag;
+            }
+        }
+
+        MemoryPoolTraceScope::~MemoryPoolTraceScope() noexcept
+        {
+            if (owner_)
+            {
+                trace_tag = nullptr;
+            }
+        }
+
+        const char *MemoryPoolTraceScope::current_tag() noexcept
+        {
+            return trace_tag;
+        }
+#else
+        // Thread-local storage is not available; allocations are not tagged
+        MemoryPoolTraceScope::MemoryPoolTraceScope(const char *) noexcept : owner_(false)
+        {}
+
+        MemoryPoolTraceScope::~MemoryPoolTraceScope() noexcept
+        {}
+
+        const char *MemoryPoolTraceScope::current_tag() noexcept
+        {
+            return nullptr;
+        }
+#endif
         MemoryPoolHeadMT::MemoryPoolHeadMT(size_t item_byte_count, bool clear_on_destruction)
             : clear_on_destruction_(clear_on_destruction), locked_(false), item_byte_count_(item_byte_count),
               item_count_(MemoryPool::first_alloc_count), first_item_(nullptr)
@@ -38,6 +79,7 @@ namespace seal
 
             // Initial allocation
             allocation new_alloc;
+            auto malloc_start = chrono::steady_clock::now();
             try
             {
                 new_alloc.data_ptr = SEAL_MALLOC(mul_safe(MemoryPool::first_alloc_count, item_byte_count_));
@@ -47,6 +89,8 @@ namespace seal
                 // Allocation failed; rethrow
                 throw;
             }
+            malloc_time_ += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - malloc_start);
+            malloc_count_++;
 
             new_alloc.size = MemoryPool::first_alloc_count;
             new_alloc.free = MemoryPool::first_alloc_count;
@@ -135,15 +179,20 @@ namespace seal
                         new_alloc_byte_count = new_size * item_byte_count_;
                     }
 
+                    auto malloc_start = chrono::steady_clock::now();
                     try
                     {
                         new_alloc.data_ptr = SEAL_MALLOC(new_alloc_byte_count);
                     }
                     catch (const bad_alloc &)
                     {
-                        // Allocation failed; rethrow
+                        // Allocation failed; release the lock and rethrow
+                        locked_.store(false, memory_order_release);
                         throw;
                     }
+                    malloc_time_ +=
+                        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - malloc_start);
+                    malloc_count_++;
 
                     new_alloc.size = new_size;
                     new_alloc.free = new_size - 1;
@@ -153,6 +202,8 @@ namespace seal
                     new_item = new MemoryPoolItem(new_alloc.data_ptr);
                 }
 
+                alloc_count_++;
+                peak_live_item_count_ = max(peak_live_item_count_, ++live_item_count_);
                 locked_.store(false, memory_order_release);
                 return new_item;
             }
@@ -160,10 +211,31 @@ namespace seal
             // Pool is not empty
             first_item_ = old_first->next();
             old_first->next() = nullptr;
+            alloc_count_++;
+            peak_live_item_count_ = max(peak_live_item_count_, ++live_item_count_);
             locked_.store(false, memory_order_release);
             return old_first;
         }
 
+        MemoryPoolHeadStats MemoryPoolHeadMT::stats() const
+        {
+            bool expected = false;
+            while (!locked_.compare_exchange_strong(expected, true, memory_order_acquire))
+            {
+                expected = false;
+            }
+            MemoryPoolHeadStats result;
+            result.item_byte_count = item_byte_count_;
+            result.item_count = item_count_;
+            result.live_item_count = live_item_count_;
+            result.peak_live_item_count = peak_live_item_count_;
+            result.alloc_count = alloc_count_;
+            result.malloc_count = malloc_count_;
+            result.malloc_time = malloc_time_;
+            locked_.store(false, memory_order_release);
+            return result;
+        }
+
         MemoryPoolHeadST::MemoryPoolHeadST(size_t item_byte_count, bool clear_on_destruction)
             : clear_on_destruction_(clear_on_destruction), item_byte_count_(item_byte_count),
               item_count_(MemoryPool::first_alloc_count), first_item_(nullptr)
@@ -176,6 +248,7 @@ namespace seal
 
             // Initial allocation
             allocation new_alloc;
+            auto malloc_start = chrono::steady_clock::now();
             try
             {
                 new_alloc.data_ptr = SEAL_MALLOC(mul_safe(MemoryPool::first_alloc_count, item_byte_count_));
@@ -185,6 +258,8 @@ namespace seal
                 // Allocation failed; rethrow
                 throw;
             }
+            malloc_time_ += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - malloc_start);
+            malloc_count_++;
 
             new_alloc.size = MemoryPool::first_alloc_count;
             new_alloc.free = MemoryPool::first_alloc_count;
@@ -262,6 +337,7 @@ namespace seal
                         new_alloc_byte_count = new_size * item_byte_count_;
                     }
 
+                    auto malloc_start = chrono::steady_clock::now();
                     try
                     {
                         new_alloc.data_ptr = SEAL_MALLOC(new_alloc_byte_count);
@@ -271,6 +347,9 @@ namespace seal
                         // Allocation failed; rethrow
                         throw;
                     }
+                    malloc_time_ +=
+                        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - malloc_start);
+                    malloc_count_++;
 
                     new_alloc.size = new_size;
                     new_alloc.free = new_size - 1;
@@ -280,15 +359,32 @@ namespace seal
                     new_item = new MemoryPoolItem(new_alloc.data_ptr);
                 }
 
+                alloc_count_++;
+                peak_live_item_count_ = max(peak_live_item_count_, ++live_item_count_);
                 return new_item;
             }
 
             // Pool is not empty
             first_item_ = old_first->next();
             old_first->next() = nullptr;
+            alloc_count_++;
+            peak_live_item_count_ = max(peak_live_item_count_, ++live_item_count_);
             return old_first;
         }
 
+        MemoryPoolHeadStats MemoryPoolHeadST::stats() const
+        {
+            MemoryPoolHeadStats result;
+            result.item_byte_count = item_byte_count_;
+            result.item_count = item_count_;
+            result.live_item_count = live_item_count_;
+            result.peak_live_item_count = peak_live_item_count_;
+            result.alloc_count = alloc_count_;
+            result.malloc_count = malloc_count_;
+            result.malloc_time = malloc_time_;
+            return result;
+        }
+
         const size_t MemoryPool::max_single_alloc_byte_count = []() -> size_t {
             int bit_shift = static_cast<int>(ceil(log2(MemoryPool::alloc_size_multiplier)));
             if (bit_shift < 0 || unsigned_geq(bit_shift, sizeof(size_t) * static_cast<size_t>(bits_per_byte)))
@@ -307,6 +403,42 @@ namespace seal
             return numeric_limits<size_t>::max() >> bit_shift;
         }();
 
+        MemoryPoolStats MemoryPool::stats() const
+        {
+            MemoryPoolStats result;
+            result.age = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - created_);
+            result.size_classes = head_stats();
+            return result;
+        }
+
+        void MemoryPool::set_alloc_callback(MemoryPoolAllocCallback callback)
+        {
+            shared_ptr<const MemoryPoolAllocCallback> new_callback;
+            if (callback)
+            {
+                new_callback = make_shared<const MemoryPoolAllocCallback>(move(callback));
+            }
+
+            WriterLock lock(alloc_callback_locker_.acquire_write());
+            has_alloc_callback_.store(static_cast<bool>(new_callback), memory_order_release);
+            alloc_callback_ = move(new_callback);
+        }
+
+        void MemoryPool::invoke_alloc_callback(size_t byte_count) const
+        {
+            shared_ptr<const MemoryPoolAllocCallback> callback;
+            {
+                ReaderLock lock(alloc_callback_locker_.acquire_read());
+                callback = alloc_callback_;
+            }
+
+            // The callback is invoked without holding the lock so that it may allocate or replace itself
+            if (callback)
+            {
+                (*callback)(MemoryPoolAllocEvent{ byte_count, MemoryPoolTraceScope::current_tag() });
+            }
+        }
+
         MemoryPoolMT::~MemoryPoolMT() noexcept
         {
             WriterLock lock(pools_locker_.acquire_write());
@@ -328,6 +460,13 @@ namespace seal
                 return Pointer<seal_byte>();
             }
 
+            Pointer<seal_byte> result(find_or_create_head(byte_count));
+            trace_alloc(byte_count);
+            return result;
+        }
+
+        MemoryPoolHead *MemoryPoolMT::find_or_create_head(size_t byte_count)
+        {
             // Attempt to find size.
             ReaderLock reader_lock(pools_locker_.acquire_read());
             size_t start = 0;
@@ -347,7 +486,7 @@ namespace seal
                 }
                 else
                 {
-                    return Pointer<seal_byte>(mid_head);
+                    return mid_head;
                 }
             }
             reader_lock.unlock();
@@ -371,7 +510,7 @@ namespace seal
                 }
                 else
                 {
-                    return Pointer<seal_byte>(mid_head);
+                    return mid_head;
                 }
             }
 
@@ -382,7 +521,7 @@ namespace seal
                 throw runtime_error("maximum pool head count reached");
             }
 
-            MemoryPoolHead *new_head = new MemoryPoolHeadMT(byte_count, clear_on_destruction_);
+            MemoryPoolHead *new_head = create_head(byte_count);
             if (!pools_.empty())
             {
                 pools_.insert(pools_.begin() + static_cast<ptrdiff_t>(start), new_head);
@@ -392,7 +531,24 @@ namespace seal
                 pools_.emplace_back(new_head);
             }
 
-            return Pointer<seal_byte>(new_head);
+            return new_head;
+        }
+
+        MemoryPoolHead *MemoryPoolMT::create_head(size_t byte_count) const
+        {
+            return new MemoryPoolHeadMT(byte_count, clear_on_destruction_);
+        }
+
+        vector<MemoryPoolHeadStats> MemoryPoolMT::head_stats() const
+        {
+            ReaderLock lock(pools_locker_.acquire_read());
+            vector<MemoryPoolHeadStats> result;
+            result.reserve(pools_.size());
+            for (MemoryPoolHead *head : pools_)
+            {
+                result.push_back(head->stats());
+            }
+            return result;
         }
 
         size_t MemoryPoolMT::alloc_byte_count() const
@@ -404,6 +560,315 @@ namespace seal
             });
         }
 
+#ifndef _M_CEE
+        struct MemoryPoolMagazine
+        {
+            MemoryPoolMagazine(size_t capacity) : in_use(true), cached_count(0), hit_count(0)
+            {
+                items.reserve(capacity);
+            }
+
+            vector<MemoryPoolItem *> items;
+
+            // Set while a live thread owns the magazine
+            atomic<bool> in_use;
+
+            // Statistics; written only by the owning thread and read by MemoryPoolHeadTC::stats
+            atomic<size_t> cached_count;
+
+            atomic<uint64_t> hit_count;
+        };
+
+        namespace
+        {
+            // Heads and pools get unique identifiers so that stale entries in thread caches are never matched
+            atomic<uint64_t> next_cache_id(0);
+
+            // Identifiers of the MemoryPoolHeadTC objects that are alive. The registry is intentionally leaked so that
+            // it outlives any thread_local or static object that may still release memory during shutdown.
+            struct LiveHeadRegistry
+            {
+                mutex registry_mutex;
+
+                unordered_set<uint64_t> ids;
+            };
+
+            LiveHeadRegistry &live_heads()
+            {
+                static LiveHeadRegistry *registry = new LiveHeadRegistry;
+                return *registry;
+            }
+
+            struct PoolHeadKey
+            {
+                uint64_t pool_id;
+
+                size_t byte_count;
+
+                bool operator==(const PoolHeadKey &other) const noexcept
+                {
+                    return pool_id == other.pool_id && byte_count == other.byte_count;
+                }
+            };
+
+            struct PoolHeadKeyHash
+            {
+                size_t operator()(const PoolHeadKey &key) const noexcept
+                {
+                    return hash<uint64_t>()(key.pool_id) ^ (hash<size_t>()(key.byte_count) * 0x9E3779B97F4A7C15ULL);
+                }
+            };
+
+            // Per-thread state of all thread-caching memory pools
+            class ThreadCache
+            {
+            public:
+                // Maximum number of cached pool heads before the lookup table is flushed
+                static constexpr size_t max_head_count = 1024;
+
+                // Number of magazines after which entries of destroyed heads are pruned
+                static constexpr size_t magazine_prune_count = 256;
+
+                ThreadCache() = default;
+
+                ~ThreadCache() noexcept;
+
+                unordered_map<PoolHeadKey, MemoryPoolHead *, PoolHeadKeyHash> heads;
+
+                unordered_map<uint64_t, MemoryPoolMagazine *> magazines;
+
+                void prune_magazines();
+            };
+
+            // Trivially destructible, so it stays valid while and after the ThreadCache is destroyed
+            thread_local bool thread_cache_destroyed = false;
+
+            ThreadCache::~ThreadCache() noexcept
+            {
+                thread_cache_destroyed = true;
+
+                // Hand the magazines of live heads over to other threads
+                auto &registry = live_heads();
+                lock_guard<mutex> lock(registry.registry_mutex);
+                for (auto &magazine : magazines)
+                {
+                    if (registry.ids.count(magazine.first))
+                    {
+                        magazine.second->in_use.store(false, memory_order_release);
+                    }
+                }
+            }
+
+            void ThreadCache::prune_magazines()
+            {
+                auto &registry = live_heads();
+                lock_guard<mutex> lock(registry.registry_mutex);
+                for (auto it = magazines.begin(); it != magazines.end();)
+                {
+                    it = registry.ids.count(it->first) ? next(it) : magazines.erase(it);
+                }
+            }
+
+            // Returns the cache of the calling thread, or nullptr if the thread is exiting
+            ThreadCache *thread_cache()
+            {
+                if (thread_cache_destroyed)
+                {
+                    return nullptr;
+                }
+                thread_local ThreadCache cache;
+                return &cache;
+            }
+        } // namespace
+
+        MemoryPoolHeadTC::MemoryPoolHeadTC(size_t item_byte_count, bool clear_on_destruction)
+            : id_(next_cache_id.fetch_add(1, memory_order_relaxed)),
+              magazine_capacity_(min<size_t>(64, max<size_t>(4, (size_t(1) << 18) / max<size_t>(item_byte_count, 1)))),
+              shared_(item_byte_count, clear_on_destruction)
+        {
+            auto &registry = live_heads();
+            lock_guard<mutex> lock(registry.registry_mutex);
+            registry.ids.insert(id_);
+        }
+
+        MemoryPoolHeadTC::~MemoryPoolHeadTC() noexcept
+        {
+            // After this no exiting thread touches the magazines
+            {
+                auto &registry = live_heads();
+                lock_guard<mutex> lock(registry.registry_mutex);
+                registry.ids.erase(id_);
+            }
+
+            // Return all cached items to the shared head, which deletes them
+            for (auto &magazine : magazines_)
+            {
+                for (MemoryPoolItem *item : magazine->items)
+                {
+                    shared_.add(item);
+                }
+            }
+            magazines_.clear();
+        }
+
+        MemoryPoolMagazine *MemoryPoolHeadTC::thread_magazine()
+        {
+            ThreadCache *cache = thread_cache();
+            if (!cache)
+            {
+                return nullptr;
+            }
+
+            auto it = cache->magazines.find(id_);
+            if (it != cache->magazines.end())
+            {
+                return it->second;
+            }
+
+            if (cache->magazines.size() >= ThreadCache::magazine_prune_count)
+            {
+                cache->prune_magazines();
+            }
+
+            // Adopt a magazine left behind by an exited thread, or create a new one
+            MemoryPoolMagazine *magazine = nullptr;
+            {
+                lock_guard<mutex> lock(magazines_mutex_);
+                for (auto &candidate : magazines_)
+                {
+                    bool expected = false;
+                    if (candidate->in_use.compare_exchange_strong(expected, true, memory_order_acq_rel))
+                    {
+                        magazine = candidate.get();
+                        break;
+                    }
+                }
+                if (!magazine)
+                {
+                    magazines_.emplace_back(new MemoryPoolMagazine(magazine_capacity_));
+                    magazine = magazines_.back().get();
+                }
+            }
+            cache->magazines.emplace(id_, magazine);
+            return magazine;
+        }
+
+        MemoryPoolItem *MemoryPoolHeadTC::get()
+        {
+            MemoryPoolMagazine *magazine = thread_magazine();
+            if (magazine && !magazine->items.empty())
+            {
+                MemoryPoolItem *item = magazine->items.back();
+                magazine->items.pop_back();
+                magazine->cached_count.store(magazine->items.size(), memory_order_relaxed);
+                magazine->hit_count.store(magazine->hit_count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+                return item;
+            }
+            return shared_.get();
+        }
+
+        void MemoryPoolHeadTC::add(MemoryPoolItem *new_first) noexcept
+        {
+            MemoryPoolMagazine *magazine = nullptr;
+            try
+            {
+                magazine = thread_magazine();
+            }
+            catch (...)
+            {
+                // Could not create a magazine; fall back to the shared head
+            }
+            if (!magazine)
+            {
+                shared_.add(new_first);
+                return;
+            }
+
+            // When full, move the older half of the cached items to the shared head
+            if (magazine->items.size() == magazine_capacity_)
+            {
+                size_t flush_count = magazine_capacity_ / 2;
+                for (size_t i = 0; i < flush_count; i++)
+                {
+                    shared_.add(magazine->items[i]);
+                }
+                magazine->items.erase(
+                    magazine->items.begin(), magazine->items.begin() + static_cast<ptrdiff_t>(flush_count));
+            }
+            new_first->next() = nullptr;
+            magazine->items.push_back(new_first);
+            magazine->cached_count.store(magazine->items.size(), memory_order_relaxed);
+        }
+
+        MemoryPoolHeadStats MemoryPoolHeadTC::stats() const
+        {
+            MemoryPoolHeadStats result = shared_.stats();
+
+            // Items cached by threads are counted as live by the shared head
+            size_t cached_count = 0;
+            {
+                lock_guard<mutex> lock(magazines_mutex_);
+                for (auto &magazine : magazines_)
+                {
+                    cached_count += magazine->cached_count.load(memory_order_relaxed);
+                    result.alloc_count += magazine->hit_count.load(memory_order_relaxed);
+                }
+            }
+            result.live_item_count -= min(result.live_item_count, cached_count);
+            return result;
+        }
+
+        MemoryPoolTC::MemoryPoolTC(bool clear_on_destruction)
+            : MemoryPoolMT(clear_on_destruction), id_(next_cache_id.fetch_add(1, memory_order_relaxed))
+        {}
+
+        Pointer<seal_byte> MemoryPoolTC::get_for_byte_count(size_t byte_count)
+        {
+            if (byte_count > max_single_alloc_byte_count)
+            {
+                throw invalid_argument("invalid allocation size");
+            }
+            else if (byte_count == 0)
+            {
+                return Pointer<seal_byte>();
+            }
+
+            Pointer<seal_byte> result(find_head(byte_count));
+            trace_alloc(byte_count);
+            return result;
+        }
+
+        MemoryPoolHead *MemoryPoolTC::find_head(size_t byte_count)
+        {
+            ThreadCache *cache = thread_cache();
+            if (!cache)
+            {
+                return find_or_create_head(byte_count);
+            }
+
+            // Look up the head in the thread cache without taking the pool lock
+            PoolHeadKey key{ id_, byte_count };
+            auto it = cache->heads.find(key);
+            if (it != cache->heads.end())
+            {
+                return it->second;
+            }
+
+            MemoryPoolHead *head = find_or_create_head(byte_count);
+            if (cache->heads.size() >= ThreadCache::max_head_count)
+            {
+                cache->heads.clear();
+            }
+            cache->heads.emplace(key, head);
+            return head;
+        }
+
+        MemoryPoolHead *MemoryPoolTC::create_head(size_t byte_count) const
+        {
+            return new MemoryPoolHeadTC(byte_count, clear_on_destruction_);
+        }
+#endif
+
         MemoryPoolST::~MemoryPoolST() noexcept
         {
             for (MemoryPoolHead *head : pools_)
@@ -442,7 +907,9 @@ namespace seal
                 }
                 else
                 {
-                    return Pointer<seal_byte>(mid_head);
+                    Pointer<seal_byte> result(mid_head);
+                    trace_alloc(byte_count);
+                    return result;
                 }
             }
 
@@ -463,7 +930,20 @@ namespace seal
                 pools_.emplace_back(new_head);
             }
 
-            return Pointer<seal_byte>(new_head);
+            Pointer<seal_byte> result(new_head);
+            trace_alloc(byte_count);
+            return result;
+        }
+
+        vector<MemoryPoolHeadStats> MemoryPoolST::head_stats() const
+        {
+            vector<MemoryPoolHeadStats> result;
+            result.reserve(pools_.size());
+            for (MemoryPoolHead *head : pools_)
+            {
+                result.push_back(head->stats());
+            }
+            return result;
         }
 
         size_t MemoryPoolST::alloc_byte_count() const
@@ -9,14 +9,20 @@
 #include "seal/util/locks.h"
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <new>
+#include <numeric>
 #include <stdexcept>
 #include <type_traits>
 #include <vector>
+#ifndef _M_CEE
+#include <mutex>
+#endif
 
 namespace seal
 {
@@ -67,6 +73,127 @@ namespace seal
             MemoryPoolItem *next_ = nullptr;
         };
 
+        /**
+        Usage statistics of a single size class (pool head) of a memory pool.
+        */
+        struct MemoryPoolHeadStats
+        {
+            // Byte size of the allocations (items) in this size class
+            std::size_t item_byte_count = 0;
+
+            // Total number of items allocated from the system
+            std::size_t item_count = 0;
+
+            // Number of items currently handed out and not yet released
+            std::size_t live_item_count = 0;
+
+            // Largest number of items handed out at the same time
+            std::size_t peak_live_item_count = 0;
+
+            // Number of items handed out since the pool was created
+            std::uint64_t alloc_count = 0;
+
+            // Number of calls to SEAL_MALLOC
+            std::uint64_t malloc_count = 0;
+
+            // Total time spent in SEAL_MALLOC
+            std::chrono::nanoseconds malloc_time{ 0 };
+        };
+
+        /**
+        A snapshot of the usage statistics of a memory pool.
+        */
+        struct MemoryPoolStats
+        {
+            // Statistics of every size class, ordered by decreasing item byte count
+            std::vector<MemoryPoolHeadStats> size_classes;
+
+            // Time since the memory pool was created
+            std::chrono::nanoseconds age{ 0 };
+
+            // Total number of bytes allocated from the system
+            SEAL_NODISCARD inline std::size_t alloc_byte_count() const noexcept
+            {
+                return std::accumulate(
+                    size_classes.cbegin(), size_classes.cend(), std::size_t(0),
+                    [](std::size_t sum, const MemoryPoolHeadStats &head) {
+                        return sum + head.item_count * head.item_byte_count;
+                    });
+            }
+
+            // Number of bytes currently handed out; a non-zero value after all objects are destroyed indicates a leak
+            SEAL_NODISCARD inline std::size_t live_byte_count() const noexcept
+            {
+                return std::accumulate(
+                    size_classes.cbegin(), size_classes.cend(), std::size_t(0),
+                    [](std::size_t sum, const MemoryPoolHeadStats &head) {
+                        return sum + head.live_item_count * head.item_byte_count;
+                    });
+            }
+
+            // Number of items handed out since the pool was created
+            SEAL_NODISCARD inline std::uint64_t alloc_count() const noexcept
+            {
+                return std::accumulate(
+                    size_classes.cbegin(), size_classes.cend(), std::uint64_t(0),
+                    [](std::uint64_t sum, const MemoryPoolHeadStats &head) { return sum + head.alloc_count; });
+            }
+
+            // Total time spent in SEAL_MALLOC
+            SEAL_NODISCARD inline std::chrono::nanoseconds malloc_time() const noexcept
+            {
+                return std::accumulate(
+                    size_classes.cbegin(), size_classes.cend(), std::chrono::nanoseconds(0),
+                    [](std::chrono::nanoseconds sum, const MemoryPoolHeadStats &head) {
+                        return sum + head.malloc_time;
+                    });
+            }
+
+            // Average number of items handed out per second since the pool was created
+            SEAL_NODISCARD inline double alloc_rate() const noexcept
+            {
+                return age.count() ? static_cast<double>(alloc_count()) * 1e9 / static_cast<double>(age.count()) : 0.0;
+            }
+        };
+
+        /**
+        Describes a single allocation from a memory pool, as passed to a MemoryPoolAllocCallback.
+        */
+        struct MemoryPoolAllocEvent
+        {
+            // Number of bytes requested
+            std::size_t byte_count;
+
+            // Tag of the outermost MemoryPoolTraceScope of the allocating thread, or nullptr
+            const char *tag;
+        };
+
+        using MemoryPoolAllocCallback = std::function<void(const MemoryPoolAllocEvent &)>;
+
+        /**
+        Tags the allocations made by the current thread while the scope is alive. The Evaluator opens a scope named
+        after the operation in its public functions, so that allocation callbacks can attribute pool usage to
+        operations. Scopes nest, and the outermost tag is kept: a user can wrap a group of operations in a scope of
+        their own to attribute all of their allocations to it.
+        */
+        class MemoryPoolTraceScope
+        {
+        public:
+            MemoryPoolTraceScope(const char *tag) noexcept;
+
+            ~MemoryPoolTraceScope() noexcept;
+
+            // Returns the tag of the outermost scope of the current thread, or nullptr if there is none
+            SEAL_NODISCARD static const char *current_tag() noexcept;
+
+        private:
+            MemoryPoolTraceScope(const MemoryPoolTraceScope &copy) = delete;
+
+            MemoryPoolTraceScope &operator=(const MemoryPoolTraceScope &assign) = delete;
+
+            bool owner_;
+        };
+
         class MemoryPoolHead
         {
         public:
@@ -101,6 +228,9 @@ namespace seal
 
             // Return item back to this pool
             virtual void add(MemoryPoolItem *new_first) noexcept = 0;
+
+            // Usage statistics of this pool
+            virtual MemoryPoolHeadStats stats() const = 0;
         };
 
         class MemoryPoolHeadMT : public MemoryPoolHead
@@ -135,9 +265,12 @@ namespace seal
                 MemoryPoolItem *old_first = first_item_;
                 new_first->next() = old_first;
                 first_item_ = new_first;
+                live_item_count_--;
                 locked_.store(false, std::memory_order_release);
             }
 
+            SEAL_NODISCARD MemoryPoolHeadStats stats() const override;
+
         private:
             MemoryPoolHeadMT(const MemoryPoolHeadMT &copy) = delete;
 
@@ -154,6 +287,17 @@ namespace seal
             std::vector<allocation> allocs_;
 
             MemoryPoolItem *volatile first_item_;
+
+            // Statistics; protected by locked_
+            std::size_t live_item_count_ = 0;
+
+            std::size_t peak_live_item_count_ = 0;
+
+            std::uint64_t alloc_count_ = 0;
+
+            std::uint64_t malloc_count_ = 0;
+
+            std::chrono::nanoseconds malloc_time_{ 0 };
         };
 
         class MemoryPoolHeadST : public MemoryPoolHead
@@ -182,8 +326,11 @@ namespace seal
             {
                 new_first->next() = first_item_;
                 first_item_ = new_first;
+                live_item_count_--;
             }
 
+            SEAL_NODISCARD MemoryPoolHeadStats stats() const override;
+
         private:
             MemoryPoolHeadST(const MemoryPoolHeadST &copy) = delete;
 
@@ -198,8 +345,78 @@ namespace seal
             std::vector<allocation> allocs_;
 
             MemoryPoolItem *first_item_;
+
+            std::size_t live_item_count_ = 0;
+
+            std::size_t peak_live_item_count_ = 0;
+
+            std::uint64_t alloc_count_ = 0;
+
+            std::uint64_t malloc_count_ = 0;
+
+            std::chrono::nanoseconds malloc_time_{ 0 };
         };
+#ifndef _M_CEE
+        struct MemoryPoolMagazine;
+
+        /**
+        A thread-safe pool head with a per-thread cache of free items (a magazine) in front of a shared
+        MemoryPoolHeadMT. Items are taken from and returned to the calling thread's magazine without any
+        synchronization; only when a magazine runs empty or overflows is the shared head locked. A magazine is owned
+        by the head and is handed over to another thread once its thread exits.
+        */
+        class MemoryPoolHeadTC : public MemoryPoolHead
+        {
+        public:
+            // Creates a new MemoryPoolHeadTC with allocation for one single item.
+            MemoryPoolHeadTC(std::size_t item_byte_count, bool clear_on_destruction = false);
+
+            ~MemoryPoolHeadTC() noexcept override;
 
+            // Byte size of the allocations (items) owned by this pool
+            SEAL_NODISCARD inline std::size_t item_byte_count() const noexcept override
+            {
+                return shared_.item_byte_count();
+            }
+
+            // Returns the total number of items allocated
+            SEAL_NODISCARD inline std::size_t item_count() const noexcept override
+            {
+                return shared_.item_count();
+            }
+
+            // Maximum number of items cached by a single thread
+            SEAL_NODISCARD inline std::size_t magazine_capacity() const noexcept
+            {
+                return magazine_capacity_;
+            }
+
+            SEAL_NODISCARD MemoryPoolItem *get() override;
+
+            void add(MemoryPoolItem *new_first) noexcept override;
+
+            // Peak live item count includes the items cached by threads at the time
+            SEAL_NODISCARD MemoryPoolHeadStats stats() const override;
+
+        private:
+            MemoryPoolHeadTC(const MemoryPoolHeadTC &copy) = delete;
+
+            MemoryPoolHeadTC &operator=(const MemoryPoolHeadTC &assign) = delete;
+
+            // Returns the magazine of the calling thread, or nullptr if the thread is exiting
+            SEAL_NODISCARD MemoryPoolMagazine *thread_magazine();
+
+            const std::uint64_t id_;
+
+            const std::size_t magazine_capacity_;
+
+            MemoryPoolHeadMT shared_;
+
+            mutable std::mutex magazines_mutex_;
+
+            std::vector<std::unique_ptr<MemoryPoolMagazine>> magazines_;
+        };
+#endif
         class MemoryPool
         {
         public:
@@ -216,6 +433,9 @@ namespace seal
 
             static constexpr std::size_t first_alloc_count = 1;
 
+            MemoryPool() : created_(std::chrono::steady_clock::now())
+            {}
+
             virtual ~MemoryPool() = default;
 
             virtual Pointer<seal_byte> get_for_byte_count(std::size_t byte_count) = 0;
@@ -223,6 +443,36 @@ namespace seal
             virtual std::size_t pool_count() const = 0;
 
             virtual std::size_t alloc_byte_count() const = 0;
+
+            // Returns a snapshot of the usage statistics
+            SEAL_NODISCARD MemoryPoolStats stats() const;
+
+            // Sets a function to be called on every allocation; an empty function disables the callback
+            void set_alloc_callback(MemoryPoolAllocCallback callback);
+
+        protected:
+            // Statistics of all pool heads, ordered by decreasing item byte count
+            virtual std::vector<MemoryPoolHeadStats> head_stats() const = 0;
+
+            // Reports an allocation to the callback, if one is set
+            inline void trace_alloc(std::size_t byte_count) const
+            {
+                if (has_alloc_callback_.load(std::memory_order_acquire))
+                {
+                    invoke_alloc_callback(byte_count);
+                }
+            }
+
+        private:
+            void invoke_alloc_callback(std::size_t byte_count) const;
+
+            const std::chrono::steady_clock::time_point created_;
+
+            std::atomic<bool> has_alloc_callback_{ false };
+
+            mutable ReaderWriterLocker alloc_callback_locker_;
+
+            std::shared_ptr<const MemoryPoolAllocCallback> alloc_callback_;
         };
 
         class MemoryPoolMT : public MemoryPool
@@ -243,10 +493,18 @@ namespace seal
             SEAL_NODISCARD std::size_t alloc_byte_count() const override;
 
         protected:
+            SEAL_NODISCARD std::vector<MemoryPoolHeadStats> head_stats() const override;
+
             MemoryPoolMT(const MemoryPoolMT &copy) = delete;
 
             MemoryPoolMT &operator=(const MemoryPoolMT &assign) = delete;
 
+            // Returns the pool head for the given byte count, creating it if it does not exist yet
+            SEAL_NODISCARD MemoryPoolHead *find_or_create_head(std::size_t byte_count);
+
+            // Creates a pool head of the type used by this memory pool
+            SEAL_NODISCARD virtual MemoryPoolHead *create_head(std::size_t byte_count) const;
+
             const bool clear_on_destruction_;
 
             mutable ReaderWriterLocker pools_locker_;
@@ -254,6 +512,37 @@ namespace seal
             std::vector<MemoryPoolHead *> pools_;
         };
 
+#ifndef _M_CEE
+        /**
+        A thread-safe memory pool that caches free items per thread, similar to tcmalloc. Each thread keeps a lookup
+        table from byte counts to pool heads and a magazine of free items for every pool head it uses, so that
+        allocations and deallocations that hit the cache take no locks and touch no shared atomics. This removes the
+        contention of MemoryPoolMT when many threads allocate from the same pool at a high rate, at the price of each
+        thread holding on to up to MemoryPoolHeadTC::magazine_capacity() free items of each size.
+        */
+        class MemoryPoolTC : public MemoryPoolMT
+        {
+        public:
+            MemoryPoolTC(bool clear_on_destruction = false);
+
+            ~MemoryPoolTC() noexcept override = default;
+
+            SEAL_NODISCARD Pointer<seal_byte> get_for_byte_count(std::size_t byte_count) override;
+
+        protected:
+            SEAL_NODISCARD MemoryPoolHead *create_head(std::size_t byte_count) const override;
+
+        private:
+            // Returns the pool head for the given byte count, using the lookup table of the calling thread
+            SEAL_NODISCARD MemoryPoolHead *find_head(std::size_t byte_count);
+
+            MemoryPoolTC(const MemoryPoolTC &copy) = delete;
+
+            MemoryPoolTC &operator=(const MemoryPoolTC &assign) = delete;
+
+            const std::uint64_t id_;
+        };
+#endif
         class MemoryPoolST : public MemoryPool
         {
         public:
@@ -271,6 +560,8 @@ namespace seal
             std::size_t alloc_byte_count() const override;
 
         protected:
+            SEAL_NODISCARD std::vector<MemoryPoolHeadStats> head_stats() const override;
+
             MemoryPoolST(const MemoryPoolST &copy) = delete;
 
             MemoryPoolST &operator=(const MemoryPoolST &assign) = delete;
@@ -88,6 +88,10 @@
 #endif
 #else
 #undef SEAL_USE_INTRIN
+#undef SEAL_USE_AVX2
+#undef SEAL_USE_AVX512
+#undef SEAL_USE_AVX512IFMA
+#undef SEAL_USE_AESNI
 
 #endif //_M_X64
 
@@ -2,6 +2,8 @@
 // Licensed under the MIT license.
 
 #include "seal/util/ntt.h"
+#include "seal/util/cpufeatures.h"
+#include "seal/util/nttavx.h"
 #include "seal/util/uintarith.h"
 #include "seal/util/uintarithsmallmod.h"
 #include <algorithm>
@@ -399,6 +401,20 @@ namespace seal
 
             intel::seal_ext::compute_forward_ntt(operand, N, p, root, 4, 4);
 #else
+#ifdef SEAL_USE_AVX512
+            if (cpu_has_avx512())
+            {
+                ntt_negacyclic_harvey_lazy_avx512(operand, tables);
+                return;
+            }
+#endif
+#ifdef SEAL_USE_AVX2
+            if (cpu_has_avx2())
+            {
+                ntt_negacyclic_harvey_lazy_avx2(operand, tables);
+                return;
+            }
+#endif
             tables.ntt_handler().transform_to_rev(
                 operand.ptr(), tables.coeff_count_power(), tables.get_from_root_powers());
 #endif
@@ -443,6 +459,20 @@ namespace seal
             uint64_t root = tables.get_root();
             intel::seal_ext::compute_inverse_ntt(operand, N, p, root, 2, 2);
 #else
+#ifdef SEAL_USE_AVX512
+            if (cpu_has_avx512())
+            {
+                inverse_ntt_negacyclic_harvey_lazy_avx512(operand, tables);
+                return;
+            }
+#endif
+#ifdef SEAL_USE_AVX2
+            if (cpu_has_avx2())
+            {
+                inverse_ntt_negacyclic_harvey_lazy_avx2(operand, tables);
+                return;
+            }
+#endif
             MultiplyUIntModOperand inv_degree_modulo = tables.inv_degree_modulo();
             tables.ntt_handler().transform_from_rev(
                 operand.ptr(), tables.coeff_count_power(), tables.get_from_inv_root_powers(), &inv_degree_modulo);
@@ -0,0 +1,443 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/nttavx.h"
+#include "seal/util/uintarithsmallmod.h"
+#if defined(SEAL_USE_AVX2) || defined(SEAL_USE_AVX512)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+#ifdef SEAL_USE_AVX2
+        namespace
+        {
+            /*
+            The butterflies below mirror Arithmetic<uint64_t, MultiplyUIntModOperand, MultiplyUIntModOperand> exactly:
+            guard(a) subtracts 2q from a in [2q, 4q), and mul_root computes Shoup's lazy product in [0, 2q). Since all
+            values are below 4q < 2^63, signed 64-bit comparisons are sufficient in AVX2 code.
+            */
+
+            inline void forward_butterfly(
+                uint64_t *x, uint64_t *y, const MultiplyUIntModOperand &r, const Modulus &modulus, uint64_t two_q)
+            {
+                uint64_t u = SEAL_COND_SELECT(*x >= two_q, *x - two_q, *x);
+                uint64_t v = multiply_uint_mod_lazy(*y, r, modulus);
+                *x = u + v;
+                *y = u + two_q - v;
+            }
+
+            inline void inverse_butterfly(
+                uint64_t *x, uint64_t *y, const MultiplyUIntModOperand &r, const Modulus &modulus, uint64_t two_q)
+            {
+                uint64_t u = *x;
+                uint64_t v = *y;
+                uint64_t w = u + v;
+                *x = SEAL_COND_SELECT(w >= two_q, w - two_q, w);
+                *y = multiply_uint_mod_lazy(u + two_q - v, r, modulus);
+            }
+
+            SEAL_TARGET_AVX2 inline __m256i mulhi64_avx2(__m256i a, __m256i b)
+            {
+                const __m256i lo_mask = _mm256_set1_epi64x(0xFFFFFFFF);
+                __m256i a_hi = _mm256_srli_epi64(a, 32);
+                __m256i b_hi = _mm256_srli_epi64(b, 32);
+                __m256i p00 = _mm256_mul_epu32(a, b);
+                __m256i p01 = _mm256_mul_epu32(a, b_hi);
+                __m256i p10 = _mm256_mul_epu32(a_hi, b);
+                __m256i p11 = _mm256_mul_epu32(a_hi, b_hi);
+                __m256i mid = _mm256_add_epi64(_mm256_srli_epi64(p00, 32), _mm256_and_si256(p01, lo_mask));
+                mid = _mm256_add_epi64(mid, _mm256_and_si256(p10, lo_mask));
+                __m256i hi = _mm256_add_epi64(p11, _mm256_srli_epi64(p01, 32));
+                hi = _mm256_add_epi64(hi, _mm256_srli_epi64(p10, 32));
+                return _mm256_add_epi64(hi, _mm256_srli_epi64(mid, 32));
+            }
+
+            SEAL_TARGET_AVX2 inline __m256i mullo64_avx2(__m256i a, __m256i b)
+            {
+                __m256i p00 = _mm256_mul_epu32(a, b);
+                __m256i cross = _mm256_add_epi64(
+                    _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)), _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b));
+                return _mm256_add_epi64(p00, _mm256_slli_epi64(cross, 32));
+            }
+
+            SEAL_TARGET_AVX2 inline __m256i guard_avx2(__m256i a, __m256i two_q)
+            {
+                __m256i lt = _mm256_cmpgt_epi64(two_q, a);
+                return _mm256_sub_epi64(a, _mm256_andnot_si256(lt, two_q));
+            }
+
+            SEAL_TARGET_AVX2 inline __m256i mul_root_avx2(__m256i a, __m256i operand, __m256i quotient, __m256i q)
+            {
+                __m256i hi = mulhi64_avx2(a, quotient);
+                return _mm256_sub_epi64(mullo64_avx2(a, operand), mullo64_avx2(hi, q));
+            }
+
+            SEAL_TARGET_AVX2 inline void forward_butterfly_avx2(
+                __m256i &x, __m256i &y, __m256i operand, __m256i quotient, __m256i q, __m256i two_q)
+            {
+                __m256i u = guard_avx2(x, two_q);
+                __m256i v = mul_root_avx2(y, operand, quotient, q);
+                x = _mm256_add_epi64(u, v);
+                y = _mm256_sub_epi64(_mm256_add_epi64(u, two_q), v);
+            }
+
+            SEAL_TARGET_AVX2 inline void inverse_butterfly_avx2(
+                __m256i &x, __m256i &y, __m256i operand, __m256i quotient, __m256i q, __m256i two_q)
+            {
+                __m256i u = x;
+                __m256i v = y;
+                x = guard_avx2(_mm256_add_epi64(u, v), two_q);
+                y = mul_root_avx2(_mm256_sub_epi64(_mm256_add_epi64(u, two_q), v), operand, quotient, q);
+            }
+
+            /*
+            Processes one layer of m butterfly groups of width gap; roots[i] is the root of the i-th group. Groups
+            of width 1 and 2 are shuffled so that four butterflies with (possibly) different roots fill one vector.
+            */
+            template <bool Forward>
+            SEAL_TARGET_AVX2 void layer_avx2(
+                uint64_t *values, size_t m, size_t gap, const MultiplyUIntModOperand *roots, const Modulus &modulus)
+            {
+                const uint64_t two_q_scalar = modulus.value() << 1;
+                const __m256i q = _mm256_set1_epi64x(static_cast<long long>(modulus.value()));
+                const __m256i two_q = _mm256_set1_epi64x(static_cast<long long>(two_q_scalar));
+
+                if (gap >= 4)
+                {
+                    for (size_t i = 0; i < m; i++)
+                    {
+                        const __m256i operand = _mm256_set1_epi64x(static_cast<long long>(roots[i].operand));
+                        const __m256i quotient = _mm256_set1_epi64x(static_cast<long long>(roots[i].quotient));
+                        uint64_t *x = values + 2 * gap * i;
+                        uint64_t *y = x + gap;
+                        for (size_t j = 0; j < gap; j += 4)
+                        {
+                            __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + j));
+                            __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + j));
+                            SEAL_IF_CONSTEXPR(Forward)
+                            {
+                                forward_butterfly_avx2(vx, vy, operand, quotient, q, two_q);
+                            }
+                            else
+                            {
+                                inverse_butterfly_avx2(vx, vy, operand, quotient, q, two_q);
+                            }
+                            _mm256_storeu_si256(reinterpret_cast<__m256i *>(x + j), vx);
+                            _mm256_storeu_si256(reinterpret_cast<__m256i *>(y + j), vy);
+                        }
+                    }
+                }
+                else if (gap == 2 && m >= 2)
+                {
+                    for (size_t i = 0; i < m; i += 2)
+                    {
+                        // a = [x0 x1 y0 y1], b = [x2 x3 y2 y3]
+                        uint64_t *ptr = values + 4 * i;
+                        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+                        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr + 4));
+                        __m256i vx = _mm256_permute2x128_si256(a, b, 0x20);
+                        __m256i vy = _mm256_permute2x128_si256(a, b, 0x31);
+
+                        // r = [op0 quot0 op1 quot1]
+                        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(roots + i));
+                        __m256i operand = _mm256_permute4x64_epi64(r, 0xA0);
+                        __m256i quotient = _mm256_permute4x64_epi64(r, 0xF5);
+                        SEAL_IF_CONSTEXPR(Forward)
+                        {
+                            forward_butterfly_avx2(vx, vy, operand, quotient, q, two_q);
+                        }
+                        else
+                        {
+                            inverse_butterfly_avx2(vx, vy, operand, quotient, q, two_q);
+                        }
+                        _mm256_storeu_si256(
+                            reinterpret_cast<__m256i *>(ptr), _mm256_permute2x128_si256(vx, vy, 0x20));
+                        _mm256_storeu_si256(
+                            reinterpret_cast<__m256i *>(ptr + 4), _mm256_permute2x128_si256(vx, vy, 0x31));
+                    }
+                }
+                else if (gap == 1 && m >= 4)
+                {
+                    for (size_t i = 0; i < m; i += 4)
+                    {
+                        // a = [x0 y0 x1 y1], b = [x2 y2 x3 y3]
+                        uint64_t *ptr = values + 2 * i;
+                        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+                        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr + 4));
+
+                        // vx = [x0 x2 x1 x3], vy = [y0 y2 y1 y3]
+                        __m256i vx = _mm256_unpacklo_epi64(a, b);
+                        __m256i vy = _mm256_unpackhi_epi64(a, b);
+
+                        // Roots are permuted in the same way
+                        __m256i r0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(roots + i));
+                        __m256i r1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(roots + i + 2));
+                        __m256i operand = _mm256_unpacklo_epi64(r0, r1);
+                        __m256i quotient = _mm256_unpackhi_epi64(r0, r1);
+                        SEAL_IF_CONSTEXPR(Forward)
+                        {
+                            forward_butterfly_avx2(vx, vy, operand, quotient, q, two_q);
+                        }
+                        else
+                        {
+                            inverse_butterfly_avx2(vx, vy, operand, quotient, q, two_q);
+                        }
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(ptr), _mm256_unpacklo_epi64(vx, vy));
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(ptr + 4), _mm256_unpackhi_epi64(vx, vy));
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < m; i++)
+                    {
+                        uint64_t *x = values + 2 * gap * i;
+                        uint64_t *y = x + gap;
+                        for (size_t j = 0; j < gap; j++)
+                        {
+                            SEAL_IF_CONSTEXPR(Forward)
+                            {
+                                forward_butterfly(x + j, y + j, roots[i], modulus, two_q_scalar);
+                            }
+                            else
+                            {
+                                inverse_butterfly(x + j, y + j, roots[i], modulus, two_q_scalar);
+                            }
+                        }
+                    }
+                }
+            }
+
+            /*
+            The last layer of the inverse transform also multiplies by n^{-1}, exactly as DWTHandler does.
+            */
+            SEAL_TARGET_AVX2 void inverse_last_layer_avx2(
+                uint64_t *values, size_t gap, const MultiplyUIntModOperand &scaled_root,
+                const MultiplyUIntModOperand &scalar, const Modulus &modulus)
+            {
+                const uint64_t two_q_scalar = modulus.value() << 1;
+                uint64_t *x = values;
+                uint64_t *y = values + gap;
+                size_t j = 0;
+                if (gap >= 4)
+                {
+                    const __m256i q = _mm256_set1_epi64x(static_cast<long long>(modulus.value()));
+                    const __m256i two_q = _mm256_set1_epi64x(static_cast<long long>(two_q_scalar));
+                    const __m256i r_operand = _mm256_set1_epi64x(static_cast<long long>(scaled_root.operand));
+                    const __m256i r_quotient = _mm256_set1_epi64x(static_cast<long long>(scaled_root.quotient));
+                    const __m256i s_operand = _mm256_set1_epi64x(static_cast<long long>(scalar.operand));
+                    const __m256i s_quotient = _mm256_set1_epi64x(static_cast<long long>(scalar.quotient));
+                    for (; j < gap; j += 4)
+                    {
+                        __m256i u = guard_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + j)), two_q);
+                        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + j));
+                        __m256i vx = mul_root_avx2(guard_avx2(_mm256_add_epi64(u, v), two_q), s_operand, s_quotient, q);
+                        __m256i vy =
+                            mul_root_avx2(_mm256_sub_epi64(_mm256_add_epi64(u, two_q), v), r_operand, r_quotient, q);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(x + j), vx);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(y + j), vy);
+                    }
+                }
+                for (; j < gap; j++)
+                {
+                    uint64_t u = SEAL_COND_SELECT(x[j] >= two_q_scalar, x[j] - two_q_scalar, x[j]);
+                    uint64_t v = y[j];
+                    uint64_t w = u + v;
+                    w = SEAL_COND_SELECT(w >= two_q_scalar, w - two_q_scalar, w);
+                    x[j] = multiply_uint_mod_lazy(w, scalar, modulus);
+                    y[j] = multiply_uint_mod_lazy(u + two_q_scalar - v, scaled_root, modulus);
+                }
+            }
+
+#ifdef SEAL_USE_AVX512
+            /*
+            GCC implements the unmasked _mm512_srli_epi64 and _mm512_mul_epu32 with an undefined pass-through operand,
+            which -Wmaybe-uninitialized reports once they are inlined. The zero-masked forms with a full mask have no
+            such operand and compile to the same unmasked instructions.
+            */
+            SEAL_TARGET_AVX512 inline __m512i srli32_avx512(__m512i a)
+            {
+                return _mm512_maskz_srli_epi64(0xFF, a, 32);
+            }
+
+            SEAL_TARGET_AVX512 inline __m512i mul_epu32_avx512(__m512i a, __m512i b)
+            {
+                return _mm512_maskz_mul_epu32(0xFF, a, b);
+            }
+
+            SEAL_TARGET_AVX512 inline __m512i mulhi64_avx512(__m512i a, __m512i b)
+            {
+                const __m512i lo_mask = _mm512_set1_epi64(0xFFFFFFFF);
+                __m512i a_hi = srli32_avx512(a);
+                __m512i b_hi = srli32_avx512(b);
+                __m512i p00 = mul_epu32_avx512(a, b);
+                __m512i p01 = mul_epu32_avx512(a, b_hi);
+                __m512i p10 = mul_epu32_avx512(a_hi, b);
+                __m512i p11 = mul_epu32_avx512(a_hi, b_hi);
+                __m512i mid = _mm512_add_epi64(srli32_avx512(p00), _mm512_and_si512(p01, lo_mask));
+                mid = _mm512_add_epi64(mid, _mm512_and_si512(p10, lo_mask));
+                __m512i hi = _mm512_add_epi64(p11, srli32_avx512(p01));
+                hi = _mm512_add_epi64(hi, srli32_avx512(p10));
+                return _mm512_add_epi64(hi, srli32_avx512(mid));
+            }
+
+            SEAL_TARGET_AVX512 inline __m512i guard_avx512(__m512i a, __m512i two_q)
+            {
+                return _mm512_mask_sub_epi64(a, _mm512_cmpge_epu64_mask(a, two_q), a, two_q);
+            }
+
+            SEAL_TARGET_AVX512 inline __m512i mul_root_avx512(__m512i a, __m512i operand, __m512i quotient, __m512i q)
+            {
+                __m512i hi = mulhi64_avx512(a, quotient);
+                return _mm512_sub_epi64(_mm512_mullo_epi64(a, operand), _mm512_mullo_epi64(hi, q));
+            }
+
+            /*
+            Layers of width at least 8 use 512-bit vectors; narrower layers reuse the AVX2 code.
+            */
+            template <bool Forward>
+            SEAL_TARGET_AVX512 void layer_avx512(
+                uint64_t *values, size_t m, size_t gap, const MultiplyUIntModOperand *roots, const Modulus &modulus)
+            {
+                if (gap < 8)
+                {
+                    layer_avx2<Forward>(values, m, gap, roots, modulus);
+                    return;
+                }
+
+                const __m512i q = _mm512_set1_epi64(static_cast<long long>(modulus.value()));
+                const __m512i two_q = _mm512_set1_epi64(static_cast<long long>(modulus.value() << 1));
+                for (size_t i = 0; i < m; i++)
+                {
+                    const __m512i operand = _mm512_set1_epi64(static_cast<long long>(roots[i].operand));
+                    const __m512i quotient = _mm512_set1_epi64(static_cast<long long>(roots[i].quotient));
+                    uint64_t *x = values + 2 * gap * i;
+                    uint64_t *y = x + gap;
+                    for (size_t j = 0; j < gap; j += 8)
+                    {
+                        __m512i u = _mm512_loadu_si512(x + j);
+                        __m512i v = _mm512_loadu_si512(y + j);
+                        SEAL_IF_CONSTEXPR(Forward)
+                        {
+                            u = guard_avx512(u, two_q);
+                            v = mul_root_avx512(v, operand, quotient, q);
+                            _mm512_storeu_si512(x + j, _mm512_add_epi64(u, v));
+                            _mm512_storeu_si512(y + j, _mm512_sub_epi64(_mm512_add_epi64(u, two_q), v));
+                        }
+                        else
+                        {
+                            _mm512_storeu_si512(x + j, guard_avx512(_mm512_add_epi64(u, v), two_q));
+                            _mm512_storeu_si512(
+                                y + j,
+                                mul_root_avx512(_mm512_sub_epi64(_mm512_add_epi64(u, two_q), v), operand, quotient, q));
+                        }
+                    }
+                }
+            }
+
+            SEAL_TARGET_AVX512 void inverse_last_layer_avx512(
+                uint64_t *values, size_t gap, const MultiplyUIntModOperand &scaled_root,
+                const MultiplyUIntModOperand &scalar, const Modulus &modulus)
+            {
+                if (gap < 8)
+                {
+                    inverse_last_layer_avx2(values, gap, scaled_root, scalar, modulus);
+                    return;
+                }
+
+                const __m512i q = _mm512_set1_epi64(static_cast<long long>(modulus.value()));
+                const __m512i two_q = _mm512_set1_epi64(static_cast<long long>(modulus.value() << 1));
+                const __m512i r_operand = _mm512_set1_epi64(static_cast<long long>(scaled_root.operand));
+                const __m512i r_quotient = _mm512_set1_epi64(static_cast<long long>(scaled_root.quotient));
+                const __m512i s_operand = _mm512_set1_epi64(static_cast<long long>(scalar.operand));
+                const __m512i s_quotient = _mm512_set1_epi64(static_cast<long long>(scalar.quotient));
+                uint64_t *x = values;
+                uint64_t *y = values + gap;
+                for (size_t j = 0; j < gap; j += 8)
+                {
+                    __m512i u = guard_avx512(_mm512_loadu_si512(x + j), two_q);
+                    __m512i v = _mm512_loadu_si512(y + j);
+                    _mm512_storeu_si512(
+                        x + j, mul_root_avx512(guard_avx512(_mm512_add_epi64(u, v), two_q), s_operand, s_quotient, q));
+                    _mm512_storeu_si512(
+                        y + j,
+                        mul_root_avx512(_mm512_sub_epi64(_mm512_add_epi64(u, two_q), v), r_operand, r_quotient, q));
+                }
+            }
+#endif
+        } // namespace
+
+        void ntt_negacyclic_harvey_lazy_avx2(CoeffIter operand, const NTTTables &tables)
+        {
+            const Modulus &modulus = tables.modulus();
+            size_t n = tables.coeff_count();
+            const MultiplyUIntModOperand *roots = tables.get_from_root_powers() + 1;
+            size_t gap = n >> 1;
+            for (size_t m = 1; m < n; m <<= 1)
+            {
+                layer_avx2<true>(operand.ptr(), m, gap, roots, modulus);
+                roots += m;
+                gap >>= 1;
+            }
+        }
+
+        void inverse_ntt_negacyclic_harvey_lazy_avx2(CoeffIter operand, const NTTTables &tables)
+        {
+            const Modulus &modulus = tables.modulus();
+            size_t n = tables.coeff_count();
+            const MultiplyUIntModOperand *roots = tables.get_from_inv_root_powers() + 1;
+            size_t gap = 1;
+            for (size_t m = n >> 1; m > 1; m >>= 1)
+            {
+                layer_avx2<false>(operand.ptr(), m, gap, roots, modulus);
+                roots += m;
+                gap <<= 1;
+            }
+
+            const MultiplyUIntModOperand &scalar = tables.inv_degree_modulo();
+            MultiplyUIntModOperand scaled_root;
+            scaled_root.set(multiply_uint_mod(roots->operand, scalar, modulus), modulus);
+            inverse_last_layer_avx2(operand.ptr(), gap, scaled_root, scalar, modulus);
+        }
+
+#ifdef SEAL_USE_AVX512
+        void ntt_negacyclic_harvey_lazy_avx512(CoeffIter operand, const NTTTables &tables)
+        {
+            const Modulus &modulus = tables.modulus();
+            size_t n = tables.coeff_count();
+            const MultiplyUIntModOperand *roots = tables.get_from_root_powers() + 1;
+            size_t gap = n >> 1;
+            for (size_t m = 1; m < n; m <<= 1)
+            {
+                layer_avx512<true>(operand.ptr(), m, gap, roots, modulus);
+                roots += m;
+                gap >>= 1;
+            }
+        }
+
+        void inverse_ntt_negacyclic_harvey_lazy_avx512(CoeffIter operand, const NTTTables &tables)
+        {
+            const Modulus &modulus = tables.modulus();
+            size_t n = tables.coeff_count();
+            const MultiplyUIntModOperand *roots = tables.get_from_inv_root_powers() + 1;
+            size_t gap = 1;
+            for (size_t m = n >> 1; m > 1; m >>= 1)
+            {
+                layer_avx512<false>(operand.ptr(), m, gap, roots, modulus);
+                roots += m;
+                gap <<= 1;
+            }
+
+            const MultiplyUIntModOperand &scalar = tables.inv_degree_modulo();
+            MultiplyUIntModOperand scaled_root;
+            scaled_root.set(multiply_uint_mod(roots->operand, scalar, modulus), modulus);
+            inverse_last_layer_avx512(operand.ptr(), gap, scaled_root, scalar, modulus);
+        }
+#endif
+#endif
+    } // namespace util
+} // namespace seal
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/util/defines.h"
+#include "seal/util/iterator.h"
+#include "seal/util/ntt.h"
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        The functions in this file are AVX2 and AVX-512 implementations of the lazy forward and inverse negacyclic
+        NTTs in ntt.h. They perform exactly the same Harvey butterflies as DWTHandler, so their outputs are identical
+        to the scalar implementation for every input, including the lazy output ranges ([0, 4q) for the forward
+        transform and [0, 2q) for the inverse transform).
+
+        These functions must only be called if the corresponding cpu_has_avx2() or cpu_has_avx512() returns true.
+        The generic functions in ntt.h select the fastest available implementation automatically; these are exposed
+        only for testing and benchmarking.
+        */
+#ifdef SEAL_USE_AVX2
+        void ntt_negacyclic_harvey_lazy_avx2(CoeffIter operand, const NTTTables &tables);
+
+        void inverse_ntt_negacyclic_harvey_lazy_avx2(CoeffIter operand, const NTTTables &tables);
+#endif
+#ifdef SEAL_USE_AVX512
+        void ntt_negacyclic_harvey_lazy_avx512(CoeffIter operand, const NTTTables &tables);
+
+        void inverse_ntt_negacyclic_harvey_lazy_avx512(CoeffIter operand, const NTTTables &tables);
+#endif
+    } // namespace util
+} // namespace seal
@@ -21,6 +21,7 @@ namespace seal
         {
             friend class MemoryPoolST;
             friend class MemoryPoolMT;
+            friend class MemoryPoolTC;
 
         public:
             template <typename, typename>
@@ -192,6 +193,7 @@ namespace seal
         {
             friend class MemoryPoolST;
             friend class MemoryPoolMT;
+            friend class MemoryPoolTC;
 
         public:
             friend class Pointer<seal_byte>;
@@ -531,6 +533,7 @@ namespace seal
         {
             friend class MemoryPoolST;
             friend class MemoryPoolMT;
+            friend class MemoryPoolTC;
 
         public:
             template <typename, typename>
@@ -731,6 +734,7 @@ namespace seal
         {
             friend class MemoryPoolST;
             friend class MemoryPoolMT;
+            friend class MemoryPoolTC;
 
         public:
             ConstPointer() = default;
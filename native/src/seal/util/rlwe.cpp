@@ -11,6 +11,9 @@
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/polycore.h"
 #include "seal/util/rlwe.h"
+#include <algorithm>
+#include <limits>
+#include <random>
 
 using namespace std;
 
@@ -18,29 +21,104 @@ namespace seal
 {
     namespace util
     {
+        namespace
+        {
+            // Number of coefficients sampled per block; the randomness and the signed noise for one block are
+            // kept on the stack so that the sampling loops and the per-limb writes can be vectorized.
+            constexpr size_t sample_block_size = 512;
+
+            // Serves 32-bit words from a block of randomness drawn in bulk and falls back to the generator once
+            // the block is exhausted. Only as many words are drawn in bulk as there are coefficients left in the
+            // block, so the generator state afterwards is exactly what word-by-word sampling would leave.
+            class BlockRandomAdapter
+            {
+            public:
+                using result_type = uint32_t;
+
+                BlockRandomAdapter(UniformRandomGenerator &prng, const uint32_t *begin, const uint32_t *end)
+                    : prng_(prng), head_(begin), end_(end)
+                {}
+
+                SEAL_NODISCARD static constexpr result_type min() noexcept
+                {
+                    return numeric_limits<result_type>::min();
+                }
+
+                SEAL_NODISCARD static constexpr result_type max() noexcept
+                {
+                    return numeric_limits<result_type>::max();
+                }
+
+                SEAL_NODISCARD inline result_type operator()()
+                {
+                    return (head_ != end_) ? *head_++ : prng_.generate();
+                }
+
+            private:
+                UniformRandomGenerator &prng_;
+
+                const uint32_t *head_;
+
+                const uint32_t *end_;
+            };
+
+            SEAL_NODISCARD inline int hamming_weight_uint64(uint64_t value)
+            {
+                value -= (value >> 1) & 0x5555555555555555ULL;
+                value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+                value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+                return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+            }
+
+            // Writes small signed values into every RNS component of destination, starting at coefficient
+            // offset; negative values are represented as q - |value|.
+            inline void set_poly_signed(
+                const int64_t *values, size_t count, size_t offset, const vector<Modulus> &coeff_modulus,
+                size_t coeff_count, uint64_t *destination)
+            {
+                for (size_t j = 0; j < coeff_modulus.size(); j++)
+                {
+                    uint64_t modulus = coeff_modulus[j].value();
+                    uint64_t *dest = destination + j * coeff_count + offset;
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        uint64_t flag = static_cast<uint64_t>(-static_cast<int64_t>(values[i] < 0));
+                        dest[i] = static_cast<uint64_t>(values[i]) + (flag & modulus);
+                    }
+                }
+            }
+        } // namespace
+
         void sample_poly_ternary(
             shared_ptr<UniformRandomGenerator> prng, const EncryptionParameters &parms, uint64_t *destination)
         {
-            auto coeff_modulus = parms.coeff_modulus();
-            size_t coeff_modulus_size = coeff_modulus.size();
+            auto &coeff_modulus = parms.coeff_modulus();
             size_t coeff_count = parms.poly_modulus_degree();
 
-            RandomToStandardAdapter engine(prng);
             uniform_int_distribution<uint64_t> dist(0, 2);
 
-            SEAL_ITERATE(iter(destination), coeff_count, [&](auto &I) {
-                uint64_t rand = dist(engine);
-                uint64_t flag = static_cast<uint64_t>(-static_cast<int64_t>(rand == 0));
-                SEAL_ITERATE(
-                    iter(StrideIter<uint64_t *>(&I, coeff_count), coeff_modulus), coeff_modulus_size,
-                    [&](auto J) { *get<0>(J) = rand + (flag & get<1>(J).value()) - 1; });
-            });
+            uint32_t rand[sample_block_size];
+            int64_t noise[sample_block_size];
+            for (size_t offset = 0; offset < coeff_count; offset += sample_block_size)
+            {
+                size_t count = min(sample_block_size, coeff_count - offset);
+                prng->generate(count * sizeof(uint32_t), reinterpret_cast<seal_byte *>(rand));
+
+                BlockRandomAdapter engine(*prng, rand, rand + count);
+                for (size_t i = 0; i < count; i++)
+                {
+                    noise[i] = static_cast<int64_t>(dist(engine)) - 1;
+                }
+                set_poly_signed(noise, count, offset, coeff_modulus, coeff_count, destination);
+            }
+            seal_memzero(rand, sizeof(rand));
+            seal_memzero(noise, sizeof(noise));
         }
 
         void sample_poly_normal(
             shared_ptr<UniformRandomGenerator> prng, const EncryptionParameters &parms, uint64_t *destination)
         {
-            auto coeff_modulus = parms.coeff_modulus();
+            auto &coeff_modulus = parms.coeff_modulus();
             size_t coeff_modulus_size = coeff_modulus.size();
             size_t coeff_count = parms.poly_modulus_degree();
 
@@ -54,19 +132,23 @@ namespace seal
             ClippedNormalDistribution dist(
                 0, global_variables::noise_standard_deviation, global_variables::noise_max_deviation);
 
-            SEAL_ITERATE(iter(destination), coeff_count, [&](auto &I) {
-                int64_t noise = static_cast<int64_t>(dist(engine));
-                uint64_t flag = static_cast<uint64_t>(-static_cast<int64_t>(noise < 0));
-                SEAL_ITERATE(
-                    iter(StrideIter<uint64_t *>(&I, coeff_count), coeff_modulus), coeff_modulus_size,
-                    [&](auto J) { *get<0>(J) = static_cast<uint64_t>(noise) + (flag & get<1>(J).value()); });
-            });
+            int64_t noise[sample_block_size];
+            for (size_t offset = 0; offset < coeff_count; offset += sample_block_size)
+            {
+                size_t count = min(sample_block_size, coeff_count - offset);
+                for (size_t i = 0; i < count; i++)
+                {
+                    noise[i] = static_cast<int64_t>(dist(engine));
+                }
+                set_poly_signed(noise, count, offset, coeff_modulus, coeff_count, destination);
+            }
+            seal_memzero(noise, sizeof(noise));
         }
 
         void sample_poly_cbd(
             shared_ptr<UniformRandomGenerator> prng, const EncryptionParameters &parms, uint64_t *destination)
         {
-            auto coeff_modulus = parms.coeff_modulus();
+            auto &coeff_modulus = parms.coeff_modulus();
             size_t coeff_modulus_size = coeff_modulus.size();
             size_t coeff_count = parms.poly_modulus_degree();
 
@@ -82,29 +164,38 @@ namespace seal
                                   "Gaussian instead");
             }
 
-            auto cbd = [&]() {
-                unsigned char x[6];
-                prng->generate(6, reinterpret_cast<seal_byte *>(x));
-                x[2] &= 0x1F;
-                x[5] &= 0x1F;
-                return hamming_weight(x[0]) + hamming_weight(x[1]) + hamming_weight(x[2]) - hamming_weight(x[3]) -
-                       hamming_weight(x[4]) - hamming_weight(x[5]);
-            };
+            // Each coefficient consumes 6 bytes of randomness: the hamming weight of the low 21 bits of the first
+            // three bytes minus that of the low 21 bits of the last three bytes.
+            constexpr size_t bytes_per_sample = 6;
+            constexpr uint64_t half_mask = 0x1FFFFF;
 
-            SEAL_ITERATE(iter(destination), coeff_count, [&](auto &I) {
-                int32_t noise = cbd();
-                uint64_t flag = static_cast<uint64_t>(-static_cast<int64_t>(noise < 0));
-                SEAL_ITERATE(
-                    iter(StrideIter<uint64_t *>(&I, coeff_count), coeff_modulus), coeff_modulus_size,
-                    [&](auto J) { *get<0>(J) = static_cast<uint64_t>(noise) + (flag & get<1>(J).value()); });
-            });
+            unsigned char rand[sample_block_size * bytes_per_sample];
+            int64_t noise[sample_block_size];
+            for (size_t offset = 0; offset < coeff_count; offset += sample_block_size)
+            {
+                size_t count = min(sample_block_size, coeff_count - offset);
+                prng->generate(count * bytes_per_sample, reinterpret_cast<seal_byte *>(rand));
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    const unsigned char *x = rand + i * bytes_per_sample;
+                    uint64_t word = static_cast<uint64_t>(x[0]) | (static_cast<uint64_t>(x[1]) << 8) |
+                                    (static_cast<uint64_t>(x[2]) << 16) | (static_cast<uint64_t>(x[3]) << 24) |
+                                    (static_cast<uint64_t>(x[4]) << 32) | (static_cast<uint64_t>(x[5]) << 40);
+                    noise[i] = static_cast<int64_t>(hamming_weight_uint64(word & half_mask)) -
+                               static_cast<int64_t>(hamming_weight_uint64((word >> 24) & half_mask));
+                }
+                set_poly_signed(noise, count, offset, coeff_modulus, coeff_count, destination);
+            }
+            seal_memzero(rand, sizeof(rand));
+            seal_memzero(noise, sizeof(noise));
         }
 
         void sample_poly_uniform(
             shared_ptr<UniformRandomGenerator> prng, const EncryptionParameters &parms, uint64_t *destination)
         {
             // Extract encryption parameters
-            auto coeff_modulus = parms.coeff_modulus();
+            auto &coeff_modulus = parms.coeff_modulus();
             size_t coeff_modulus_size = coeff_modulus.size();
             size_t coeff_count = parms.poly_modulus_degree();
             size_t dest_byte_count = mul_safe(coeff_modulus_size, coeff_count, sizeof(uint64_t));
@@ -118,14 +209,17 @@ namespace seal
             {
                 auto &modulus = coeff_modulus[j];
                 uint64_t max_multiple = max_random - barrett_reduce_64(max_random, modulus) - 1;
-                transform(destination, destination + coeff_count, destination, [&](uint64_t rand) {
-                    // This ensures uniform distribution
-                    while (rand >= max_multiple)
+
+                // This ensures uniform distribution; rejected values are replaced in order, so the output matches
+                // rejecting and reducing in a single pass
+                for (size_t i = 0; i < coeff_count; i++)
+                {
+                    while (destination[i] >= max_multiple)
                     {
-                        prng->generate(sizeof(uint64_t), reinterpret_cast<seal_byte *>(&rand));
+                        prng->generate(sizeof(uint64_t), reinterpret_cast<seal_byte *>(destination + i));
                     }
-                    return barrett_reduce_64(rand, modulus);
-                });
+                }
+                modulo_poly_coeffs(ConstCoeffIter(destination), coeff_count, modulus, CoeffIter(destination));
                 destination += coeff_count;
             }
         }
@@ -190,15 +284,24 @@ namespace seal
             const PublicKey &public_key, const SEALContext &context, parms_id_type parms_id, bool is_ntt_form,
             Ciphertext &destination)
         {
+            // Create a PRNG; u and the noise/error share the same PRNG. We use a fresh memory pool with
+            // `clear_on_destruction' enabled
+            encrypt_zero_asymmetric(
+                public_key, context, parms_id, is_ntt_form,
+                context.get_context_data(parms_id)->parms().random_generator()->create(), destination,
+                MemoryManager::GetPool(mm_prof_opt::mm_force_new, true));
+        }
+
+        void encrypt_zero_asymmetric(
+            const PublicKey &public_key, const SEALContext &context, parms_id_type parms_id, bool is_ntt_form,
+            shared_ptr<UniformRandomGenerator> prng, Ciphertext &destination, MemoryPoolHandle pool)
+        {
 #ifdef SEAL_DEBUG
             if (!is_valid_for(public_key, context))
             {
                 throw invalid_argument("public key is not valid for the encryption parameters");
             }
 #endif
-            // We use a fresh memory pool with `clear_on_destruction' enabled
-            MemoryPoolHandle pool = MemoryManager::GetPool(mm_prof_opt::mm_force_new, true);
-
             auto &context_data = *context.get_context_data(parms_id);
             auto &parms = context_data.parms();
             auto &coeff_modulus = parms.coeff_modulus();
@@ -215,9 +318,6 @@ namespace seal
 
             // c[j] = public_key[j] * u + e[j] where e[j] <-- chi, u <-- R_3
 
-            // Create a PRNG; u and the noise/error share the same PRNG
-            auto prng = parms.random_generator()->create();
-
             // Generate u <-- R_3
             auto u(allocate_poly(coeff_count, coeff_modulus_size, pool));
             sample_poly_ternary(prng, parms, u.get());
@@ -96,6 +96,22 @@ namespace seal
             const PublicKey &public_key, const SEALContext &context, parms_id_type parms_id, bool is_ntt_form,
             Ciphertext &destination);
 
+        /**
+        Create an encryption of zero with a public key and store in a ciphertext, drawing the randomness from a given
+        PRNG. Encrypting many ciphertexts with one PRNG and one memory pool avoids creating them for each ciphertext.
+
+        @param[in] public_key The public key used for encryption
+        @param[in] context The SEALContext containing a chain of ContextData
+        @param[in] parms_id Indicates the level of encryption
+        @param[in] is_ntt_form If true, store ciphertext in NTT form
+        @param[in] prng The uniform random generator for u and the errors
+        @param[out] destination The output ciphertext - an encryption of zero
+        @param[in] pool The memory pool for the secret polynomial u; it should clear memory on destruction
+        */
+        void encrypt_zero_asymmetric(
+            const PublicKey &public_key, const SEALContext &context, parms_id_type parms_id, bool is_ntt_form,
+            std::shared_ptr<UniformRandomGenerator> prng, Ciphertext &destination, MemoryPoolHandle pool);
+
         /**
         Create an encryption of zero with a secret key and store in a ciphertext.
 
@@ -2,9 +2,11 @@
 // Licensed under the MIT license.
 
 #include "seal/util/common.h"
+#include "seal/util/cpufeatures.h"
 #include "seal/util/numth.h"
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/rns.h"
+#include "seal/util/rnsavx.h"
 #include "seal/util/uintarithmod.h"
 #include "seal/util/uintarithsmallmod.h"
 #include <algorithm>
@@ -422,44 +424,125 @@ namespace seal
             {
                 throw invalid_argument("in and out are incompatible");
             }
+#endif
+#ifdef SEAL_USE_AVX512IFMA
+            if (use_avx512ifma_)
+            {
+                fast_convert_array_avx512ifma(in, out, ibase_, obase_, base_change_matrix_.get(), pool);
+                return;
+            }
+#endif
+#ifdef SEAL_USE_AVX512
+            if (use_avx512_)
+            {
+                fast_convert_array_avx512(in, out, ibase_, obase_, base_change_matrix_.get(), pool);
+                return;
+            }
 #endif
             size_t ibase_size = ibase_.size();
             size_t obase_size = obase_.size();
             size_t count = in.poly_modulus_degree();
 
+            // The conversion is done in blocks of coefficients so that the temporary values of a block (16 KB) stay
+            // in the L1 cache while they are multiplied with every row of the base-change matrix
+            constexpr size_t block_byte_count = 16384;
+            size_t block_size = min(count, max(block_byte_count / (ibase_size * sizeof(uint64_t)), size_t(1)));
+
             // Note that the stride size is ibase_size
-            SEAL_ALLOCATE_GET_STRIDE_ITER(temp, uint64_t, count, ibase_size, pool);
+            SEAL_ALLOCATE_GET_STRIDE_ITER(temp, uint64_t, block_size, ibase_size, pool);
 
-            SEAL_ITERATE(
-                iter(in, ibase_.inv_punctured_prod_mod_base_array(), ibase_.base(), size_t(0)), ibase_size,
-                [&](auto I) {
-                    // The current ibase index
-                    size_t ibase_index = get<3>(I);
+            for (size_t offset = 0; offset < count; offset += block_size)
+            {
+                size_t block_count = min(block_size, count - offset);
 
-                    if (get<1>(I).operand == 1)
-                    {
-                        // No multiplication needed
-                        SEAL_ITERATE(iter(get<0>(I), temp), count, [&](auto J) {
-                            // Reduce modulo ibase element
-                            get<1>(J)[ibase_index] = barrett_reduce_64(get<0>(J), get<2>(I));
-                        });
-                    }
-                    else
-                    {
-                        // Multiplication needed
-                        SEAL_ITERATE(iter(get<0>(I), temp), count, [&](auto J) {
-                            // Multiply coefficient of in with ibase_.inv_punctured_prod_mod_base_array_ element
+                SEAL_ITERATE(
+                    iter(in, ibase_.inv_punctured_prod_mod_base_array(), ibase_.base(), size_t(0)), ibase_size,
+                    [&](auto I) {
+                        // The current ibase index
+                        size_t ibase_index = get<3>(I);
+
+                        if (get<1>(I).operand == 1)
+                        {
+                            // No multiplication needed
+                            SEAL_ITERATE(iter(get<0>(I) + offset, temp), block_count, [&](auto J) {
+                                // Reduce modulo ibase element
+                                get<1>(J)[ibase_index] = barrett_reduce_64(get<0>(J), get<2>(I));
+                            });
+                        }
+                        else
+                        {
+                            // Multiplication needed
+                            SEAL_ITERATE(iter(get<0>(I) + offset, temp), block_count, [&](auto J) {
+                                // Multiply coefficient of in with ibase_.inv_punctured_prod_mod_base_array_ element
+                                get<1>(J)[ibase_index] = multiply_uint_mod(get<0>(J), get<1>(I), get<2>(I));
+                            });
+                        }
+                    });
+
+                SEAL_ITERATE(iter(out, base_change_matrix_, obase_.base()), obase_size, [&](auto I) {
+                    SEAL_ITERATE(iter(get<0>(I) + offset, temp), block_count, [&](auto J) {
+                        // Compute the base conversion sum modulo obase element
+                        get<0>(J) = dot_product_mod(get<1>(J), get<1>(I).get(), ibase_size, get<2>(I));
+                    });
+                });
+            }
+        }
+
+        void BaseConverter::exact_convert_array(ConstRNSIter in, RNSIter out, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (in.poly_modulus_degree() != out.poly_modulus_degree())
+            {
+                throw invalid_argument("in and out are incompatible");
+            }
+#endif
+            size_t ibase_size = ibase_.size();
+            size_t obase_size = obase_.size();
+            size_t count = in.poly_modulus_degree();
+
+            // The conversion is blocked as in fast_convert_array
+            constexpr size_t block_byte_count = 16384;
+            size_t block_size = min(count, max(block_byte_count / (ibase_size * sizeof(uint64_t)), size_t(1)));
+
+            // Note that the stride size is ibase_size
+            SEAL_ALLOCATE_GET_STRIDE_ITER(temp, uint64_t, block_size, ibase_size, pool);
+            SEAL_ALLOCATE_GET_COEFF_ITER(v, block_size, pool);
+
+            for (size_t offset = 0; offset < count; offset += block_size)
+            {
+                size_t block_count = min(block_size, count - offset);
+
+                SEAL_ITERATE(
+                    iter(in, ibase_.inv_punctured_prod_mod_base_array(), ibase_.base(), size_t(0)), ibase_size,
+                    [&](auto I) {
+                        // The current ibase index
+                        size_t ibase_index = get<3>(I);
+                        SEAL_ITERATE(iter(get<0>(I) + offset, temp), block_count, [&](auto J) {
                             get<1>(J)[ibase_index] = multiply_uint_mod(get<0>(J), get<1>(I), get<2>(I));
                         });
+                    });
+
+                // The fast conversion sum_i temp[i] * (prod(ibase)/ibase[i]) exceeds the centered representative of the
+                // input by v * prod(ibase), where v = round(sum_i temp[i] / ibase[i]) is small enough to be computed in
+                // floating-point arithmetic.
+                SEAL_ITERATE(iter(temp, v), block_count, [&](auto I) {
+                    double v_sum = 0.0;
+                    for (size_t i = 0; i < ibase_size; i++)
+                    {
+                        v_sum += static_cast<double>(get<0>(I)[i]) * inv_ibase_[i];
                     }
+                    get<1>(I) = static_cast<uint64_t>(v_sum + 0.5);
                 });
 
-            SEAL_ITERATE(iter(out, base_change_matrix_, obase_.base()), obase_size, [&](auto I) {
-                SEAL_ITERATE(iter(get<0>(I), temp), count, [&](auto J) {
-                    // Compute the base conversion sum modulo obase element
-                    get<0>(J) = dot_product_mod(get<1>(J), get<1>(I).get(), ibase_size, get<2>(I));
-                });
-            });
+                SEAL_ITERATE(
+                    iter(out, base_change_matrix_, ibase_prod_mod_obase_, obase_.base()), obase_size, [&](auto I) {
+                        SEAL_ITERATE(iter(get<0>(I) + offset, temp, v), block_count, [&](auto J) {
+                            get<0>(J) = sub_uint_mod(
+                                dot_product_mod(get<1>(J), get<1>(I).get(), ibase_size, get<3>(I)),
+                                multiply_uint_mod(get<2>(J), get<2>(I), get<3>(I)), get<3>(I));
+                        });
+                    });
+            }
         }
 
         void BaseConverter::initialize()
@@ -483,6 +566,23 @@ namespace seal
                     get<0>(J) = modulo_uint(get<1>(J), ibase_.size(), get<1>(I));
                 });
             });
+
+            // Precompute for exact_convert_array
+            inv_ibase_ = allocate<double>(ibase_.size(), pool_);
+            SEAL_ITERATE(iter(inv_ibase_.get(), ibase_.base()), ibase_.size(), [&](auto I) {
+                get<0>(I) = 1.0 / static_cast<double>(get<1>(I).value());
+            });
+
+            ibase_prod_mod_obase_ = allocate<MultiplyUIntModOperand>(obase_.size(), pool_);
+            SEAL_ITERATE(iter(ibase_prod_mod_obase_, obase_.base()), obase_.size(), [&](auto I) {
+                get<0>(I).set(modulo_uint(ibase_.base_prod(), ibase_.size(), get<1>(I)), get<1>(I));
+            });
+#ifdef SEAL_USE_AVX512IFMA
+            use_avx512ifma_ = cpu_has_avx512ifma() && fast_convert_array_fits_avx512ifma(ibase_, obase_);
+#endif
+#ifdef SEAL_USE_AVX512
+            use_avx512_ = !use_avx512ifma_ && cpu_has_avx512() && fast_convert_array_fits_avx512(ibase_, obase_);
+#endif
         }
 
         RNSTool::RNSTool(
@@ -681,6 +781,63 @@ namespace seal
                 });
             }
 
+            // HPS multiplication reuses Bsk as the auxiliary base. It is supported when prod(Bsk) exceeds the scaled
+            // ciphertext product by a margin; this holds whenever B was sized for BEHZ with a few bits to spare.
+            if (base_t_gamma_ && get_significant_bit_count_uint(base_Bsk_->base_prod(), base_Bsk_size) - 1 >=
+                                     16 + coeff_count_power + t_.bit_count() + total_coeff_bit_count)
+            {
+                hps_supported_ = true;
+
+                // Set up BaseConverter for Bsk --> q
+                base_Bsk_to_q_conv_ = allocate<BaseConverter>(pool_, *base_Bsk_, *base_q_, pool_);
+
+                // Compute a[i] = |t * (q/q[i])^(-1)|_q[i], the fraction a[i] / q[i] with 128 bits of precision, and
+                // -a[i] * q[i]^(-1) mod Bsk, the integer part of t * prod(Bsk) * |(q/q[i] * prod(Bsk))^(-1)|_q[i] / q[i]
+                hps_frac_q_ = allocate_uint(mul_safe(base_q_size, size_t(2)), pool_);
+                hps_int_q_mod_Bsk_ = allocate<Pointer<uint64_t>>(base_Bsk_size, pool_);
+                for (size_t j = 0; j < base_Bsk_size; j++)
+                {
+                    // The last two entries multiply the two words of the rounded sum of the fractional parts
+                    hps_int_q_mod_Bsk_[j] = allocate_uint(base_q_size + 2, pool_);
+                    hps_int_q_mod_Bsk_[j][base_q_size] = 1;
+                    uint64_t two_pow_64[2]{ 0, 1 };
+                    hps_int_q_mod_Bsk_[j][base_q_size + 1] = barrett_reduce_128(two_pow_64, (*base_Bsk_)[j]);
+                }
+                for (size_t i = 0; i < base_q_size; i++)
+                {
+                    const Modulus &qi = (*base_q_)[i];
+                    uint64_t a = multiply_uint_mod(
+                        barrett_reduce_64(t_.value(), qi), base_q_->inv_punctured_prod_mod_base_array()[i], qi);
+
+                    uint64_t numerator[3]{ 0, 0, a };
+                    uint64_t quotient[3]{ 0, 0, 0 };
+                    divide_uint192_inplace(numerator, qi.value(), quotient);
+                    hps_frac_q_[2 * i] = quotient[0];
+                    hps_frac_q_[2 * i + 1] = quotient[1];
+
+                    for (size_t j = 0; j < base_Bsk_size; j++)
+                    {
+                        const Modulus &pj = (*base_Bsk_)[j];
+                        if (!try_invert_uint_mod(barrett_reduce_64(qi.value(), pj), pj, temp))
+                        {
+                            throw logic_error("invalid rns bases");
+                        }
+                        hps_int_q_mod_Bsk_[j][i] =
+                            negate_uint_mod(multiply_uint_mod(barrett_reduce_64(a, pj), temp, pj), pj);
+                    }
+                }
+
+                // Compute t * prod(q)^(-1) mod Bsk
+                hps_t_inv_prod_q_mod_Bsk_ = allocate<MultiplyUIntModOperand>(base_Bsk_size, pool_);
+                SEAL_ITERATE(
+                    iter(hps_t_inv_prod_q_mod_Bsk_, inv_prod_q_mod_Bsk_, base_Bsk_->base()), base_Bsk_size,
+                    [&](auto I) {
+                        get<0>(I).set(
+                            multiply_uint_mod(barrett_reduce_64(t_.value(), get<2>(I)), get<1>(I), get<2>(I)),
+                            get<2>(I));
+                    });
+            }
+
             // Compute q[last]^(-1) mod q[i] for i = 0..last-1
             // This is used by modulus switching and rescaling
             inv_q_last_mod_q_ = allocate<MultiplyUIntModOperand>(base_q_size - 1, pool_);
@@ -1106,5 +1263,370 @@ namespace seal
                 }
             });
         }
+
+        void RNSTool::hps_lift_q_to_Bsk(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (!hps_supported_)
+            {
+                throw logic_error("HPS multiplication is not supported");
+            }
+#endif
+            base_q_to_Bsk_conv_->exact_convert_array(input, destination, pool);
+        }
+
+        void RNSTool::hps_scale_and_round(
+            ConstRNSIter input_q, ConstRNSIter input_Bsk, RNSIter destination, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (!hps_supported_)
+            {
+                throw logic_error("HPS multiplication is not supported");
+            }
+            if (!input_q || !input_Bsk)
+            {
+                throw invalid_argument("input cannot be null");
+            }
+            if (!destination)
+            {
+                throw invalid_argument("destination cannot be null");
+            }
+            if (!pool)
+            {
+                throw invalid_argument("pool is uninitialized");
+            }
+#endif
+            size_t base_q_size = base_q_->size();
+            size_t base_Bsk_size = base_Bsk_->size();
+
+            // Writing x in q U Bsk with the CRT, t/q * x mod prod(Bsk) is a sum of integer terms and the terms
+            // x_q[i] * a[i] / q[i], where a[i] / q[i] are the precomputed fractions. Hence round(t/q * x) mod Bsk[j] is
+            //
+            //     sum_i x_q[i] * (integer part)[i] + x_Bsk[j] * t * prod(q)^(-1) + round(sum_i x_q[i] * a[i] / q[i]),
+            //
+            // where the last sum is computed in 128-bit fixed point arithmetic. Its two words are appended to the
+            // coefficients in base q, so that a single dot product per Bsk prime includes them.
+            size_t temp_stride = base_q_size + 2;
+
+            // The computation is done in blocks of coefficients as in BaseConverter::fast_convert_array
+            constexpr size_t block_byte_count = 16384;
+            size_t block_size =
+                min(coeff_count_, max(block_byte_count / (temp_stride * sizeof(uint64_t)), size_t(1)));
+
+            // Note that the stride size is temp_stride
+            SEAL_ALLOCATE_GET_STRIDE_ITER(temp, uint64_t, block_size, temp_stride, pool);
+
+            for (size_t offset = 0; offset < coeff_count_; offset += block_size)
+            {
+                size_t block_count = min(block_size, coeff_count_ - offset);
+
+                SEAL_ITERATE(iter(input_q, size_t(0)), base_q_size, [&](auto I) {
+                    size_t q_index = get<1>(I);
+                    SEAL_ITERATE(iter(get<0>(I) + offset, temp), block_count, [&](auto J) {
+                        get<1>(J)[q_index] = get<0>(J);
+                    });
+                });
+
+                SEAL_ITERATE(temp, block_count, [&](auto I) {
+                    unsigned long long frac_sum[4]{ 0, 0, 0, 0 };
+                    for (size_t i = 0; i < base_q_size; i++)
+                    {
+                        unsigned long long prod_lo[2];
+                        unsigned long long prod_hi[2];
+                        multiply_uint64(I[i], hps_frac_q_[2 * i], prod_lo);
+                        multiply_uint64(I[i], hps_frac_q_[2 * i + 1], prod_hi);
+
+                        unsigned char carry = add_uint64(frac_sum[0], prod_lo[0], frac_sum);
+                        carry = add_uint64(frac_sum[1], prod_lo[1], carry, frac_sum + 1);
+                        carry = add_uint64(frac_sum[2], prod_hi[1], carry, frac_sum + 2);
+                        frac_sum[3] += carry;
+                        carry = add_uint64(frac_sum[1], prod_hi[0], frac_sum + 1);
+                        carry = add_uint64(frac_sum[2], uint64_t(0), carry, frac_sum + 2);
+                        frac_sum[3] += carry;
+                    }
+
+                    // Round: add 1/2 and keep the integer part
+                    unsigned char carry = add_uint64(frac_sum[1], uint64_t(1) << 63, frac_sum + 1);
+                    carry = add_uint64(frac_sum[2], uint64_t(0), carry, frac_sum + 2);
+                    I[base_q_size] = frac_sum[2];
+                    I[base_q_size + 1] = frac_sum[3] + carry;
+                });
+
+                SEAL_ITERATE(
+                    iter(destination, input_Bsk, hps_int_q_mod_Bsk_, hps_t_inv_prod_q_mod_Bsk_, base_Bsk_->base()),
+                    base_Bsk_size, [&](auto I) {
+                        const Modulus &modulus = get<4>(I);
+                        SEAL_ITERATE(iter(get<0>(I) + offset, get<1>(I) + offset, temp), block_count, [&](auto J) {
+                            get<0>(J) = add_uint_mod(
+                                dot_product_mod(get<2>(J), get<2>(I).get(), temp_stride, modulus),
+                                multiply_uint_mod(get<1>(J), get<3>(I), modulus), modulus);
+                        });
+                    });
+            }
+        }
+
+        void RNSTool::hps_convert_Bsk_to_q(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (!hps_supported_)
+            {
+                throw logic_error("HPS multiplication is not supported");
+            }
+#endif
+            base_Bsk_to_q_conv_->exact_convert_array(input, destination, pool);
+        }
+
+        HybridKSwitchTool::HybridKSwitchTool(
+            const RNSBase &data_base, const RNSBase &special_base, MemoryPoolHandle pool)
+            : pool_(move(pool)), data_base_size_(data_base.size()), special_base_size_(special_base.size())
+        {
+            if (!pool_)
+            {
+                throw invalid_argument("pool is uninitialized");
+            }
+            if (!data_base_size_ || !special_base_size_)
+            {
+                throw invalid_argument("rnsbase is invalid");
+            }
+
+            digit_count_ = (data_base_size_ + special_base_size_ - 1) / special_base_size_;
+
+            // Set up BaseConverter for each digit --> remaining data primes and special primes
+            mod_up_conv_ = allocate<Pointer<BaseConverter>>(digit_count_, pool_);
+            for (size_t j = 0; j < digit_count_; j++)
+            {
+                size_t begin = digit_begin(j);
+                size_t end = begin + digit_size(j);
+
+                vector<Modulus> digit_primes;
+                vector<Modulus> other_primes;
+                for (size_t i = 0; i < data_base_size_; i++)
+                {
+                    if (i >= begin && i < end)
+                    {
+                        digit_primes.push_back(data_base[i]);
+                    }
+                    else
+                    {
+                        other_primes.push_back(data_base[i]);
+                    }
+                }
+                for (size_t i = 0; i < special_base_size_; i++)
+                {
+                    other_primes.push_back(special_base[i]);
+                }
+
+                mod_up_conv_[j] = allocate<BaseConverter>(
+                    pool_, RNSBase(digit_primes, pool_), RNSBase(other_primes, pool_), pool_);
+            }
+
+            // Set up BaseConverter for special primes --> data primes
+            mod_down_conv_ = allocate<BaseConverter>(pool_, special_base, data_base, pool_);
+
+            // Compute (product of special primes)^(-1) mod q[i]
+            inv_special_prod_mod_data_ = allocate<MultiplyUIntModOperand>(data_base_size_, pool_);
+            for (size_t i = 0; i < data_base_size_; i++)
+            {
+                const Modulus &qi = data_base[i];
+                uint64_t prod = 1;
+                for (size_t k = 0; k < special_base_size_; k++)
+                {
+                    prod = multiply_uint_mod(prod, barrett_reduce_64(special_base[k].value(), qi), qi);
+                }
+
+                uint64_t temp;
+                if (!try_invert_uint_mod(prod, qi, temp))
+                {
+                    throw logic_error("invalid rns bases");
+                }
+                inv_special_prod_mod_data_[i].set(temp, qi);
+            }
+
+            // Compute floor((product of special primes) / 2) mod p[k] and mod q[i]
+            auto half_special_prod(allocate_uint(special_base_size_, pool_));
+            right_shift_uint(special_base.base_prod(), 1, special_base_size_, half_special_prod.get());
+            half_special_prod_mod_special_ = allocate_uint(special_base_size_, pool_);
+            for (size_t k = 0; k < special_base_size_; k++)
+            {
+                half_special_prod_mod_special_[k] =
+                    modulo_uint(half_special_prod.get(), special_base_size_, special_base[k]);
+            }
+            half_special_prod_mod_data_ = allocate_uint(data_base_size_, pool_);
+            for (size_t i = 0; i < data_base_size_; i++)
+            {
+                half_special_prod_mod_data_[i] = modulo_uint(half_special_prod.get(), special_base_size_, data_base[i]);
+            }
+        }
+
+        void HybridKSwitchTool::mod_up(
+            size_t digit_index, ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (digit_index >= digit_count_)
+            {
+                throw out_of_range("digit_index");
+            }
+            if (!input || !destination)
+            {
+                throw invalid_argument("input or destination");
+            }
+            if (input.poly_modulus_degree() != destination.poly_modulus_degree())
+            {
+                throw invalid_argument("input and destination are incompatible");
+            }
+#endif
+            size_t coeff_count = input.poly_modulus_degree();
+            size_t begin = digit_begin(digit_index);
+            size_t size = digit_size(digit_index);
+            const BaseConverter &conv = *mod_up_conv_[digit_index];
+
+            // Convert to the remaining primes in a temporary buffer
+            SEAL_ALLOCATE_GET_RNS_ITER(temp, coeff_count, conv.obase_size(), pool);
+            conv.fast_convert_array(input, temp, pool);
+
+            // The digit itself is already correct; copy the converted limbs around it
+            set_poly(input, coeff_count, size, destination + begin);
+            set_poly(temp, coeff_count, begin, destination);
+            set_poly(temp + begin, coeff_count, conv.obase_size() - begin, destination + begin + size);
+        }
+
+        void HybridKSwitchTool::mod_down_convert(RNSIter input, RNSIter destination, MemoryPoolHandle pool) const
+        {
+            size_t coeff_count = input.poly_modulus_degree();
+
+            // Add floor(P/2) before the conversion and subtract it afterwards
+            auto &special_base = mod_down_conv_->ibase();
+            for (size_t k = 0; k < special_base_size_; k++)
+            {
+                add_poly_scalar_coeffmod(
+                    input[k], coeff_count, half_special_prod_mod_special_[k], special_base[k], input[k]);
+            }
+            mod_down_conv_->fast_convert_array(input, destination, move(pool));
+            auto &data_base = mod_down_conv_->obase();
+            for (size_t i = 0; i < data_base_size_; i++)
+            {
+                sub_poly_scalar_coeffmod(
+                    destination[i], coeff_count, half_special_prod_mod_data_[i], data_base[i], destination[i]);
+            }
+        }
+
+        KSwitchRescaleTool::KSwitchRescaleTool(
+            const RNSBase &data_base, const RNSBase &special_base, MemoryPoolHandle pool)
+            : pool_(move(pool)), special_base_size_(special_base.size())
+        {
+            if (!pool_)
+            {
+                throw invalid_argument("pool is uninitialized");
+            }
+            if (data_base.size() < 2 || !special_base_size_)
+            {
+                throw invalid_argument("rnsbase is invalid");
+            }
+
+            next_base_size_ = data_base.size() - 1;
+            const Modulus &q_last = data_base[next_base_size_];
+
+            if (special_base_size_ == 1)
+            {
+                const Modulus &special = special_base[0];
+                q_last_ = q_last;
+                special_modulus_ = special;
+                next_modulus_ = allocate<Modulus>(next_base_size_, pool_);
+                copy_n(data_base.base(), next_base_size_, next_modulus_.get());
+
+                uint64_t temp;
+                if (!try_invert_uint_mod(barrett_reduce_64(special.value(), q_last), q_last, temp))
+                {
+                    throw logic_error("invalid rns bases");
+                }
+                inv_special_mod_last_.set(temp, q_last);
+
+                // H = floor(p * q_last / 2) modulo every prime
+                unsigned long long prod[2];
+                multiply_uint64(special.value(), q_last.value(), prod);
+                uint64_t half[2]{ static_cast<uint64_t>(prod[0]), static_cast<uint64_t>(prod[1]) };
+                right_shift_uint128(half, 1, half);
+                half_mod_special_ = barrett_reduce_128(half, special);
+                half_mod_last_ = barrett_reduce_128(half, q_last);
+                half_mod_next_ = allocate_uint(next_base_size_, pool_);
+                for (size_t i = 0; i < next_base_size_; i++)
+                {
+                    half_mod_next_[i] = barrett_reduce_128(half, data_base[i]);
+                }
+            }
+            else
+            {
+                // Set up BaseConverter for q_last and special primes --> remaining data primes
+                vector<Modulus> divisor_primes{ q_last };
+                vector<Modulus> next_primes;
+                for (size_t i = 0; i < special_base_size_; i++)
+                {
+                    divisor_primes.push_back(special_base[i]);
+                }
+                for (size_t i = 0; i < next_base_size_; i++)
+                {
+                    next_primes.push_back(data_base[i]);
+                }
+                conv_ = allocate<BaseConverter>(
+                    pool_, RNSBase(divisor_primes, pool_), RNSBase(next_primes, pool_), pool_);
+            }
+
+            // Compute P mod q[i] and (P * q_last)^(-1) mod q[i]
+            special_prod_mod_data_ = allocate<MultiplyUIntModOperand>(data_base.size(), pool_);
+            inv_divisor_mod_next_ = allocate<MultiplyUIntModOperand>(next_base_size_, pool_);
+            for (size_t i = 0; i < data_base.size(); i++)
+            {
+                const Modulus &qi = data_base[i];
+                uint64_t prod = 1;
+                for (size_t k = 0; k < special_base_size_; k++)
+                {
+                    prod = multiply_uint_mod(prod, barrett_reduce_64(special_base[k].value(), qi), qi);
+                }
+                special_prod_mod_data_[i].set(prod, qi);
+                if (i == next_base_size_)
+                {
+                    break;
+                }
+
+                uint64_t temp;
+                prod = multiply_uint_mod(prod, barrett_reduce_64(q_last.value(), qi), qi);
+                if (!try_invert_uint_mod(prod, qi, temp))
+                {
+                    throw logic_error("invalid rns bases");
+                }
+                inv_divisor_mod_next_[i].set(temp, qi);
+            }
+        }
+
+        void KSwitchRescaleTool::convert(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const
+        {
+            if (conv_)
+            {
+                conv_->exact_convert_array(input, destination, move(pool));
+                return;
+            }
+
+            size_t coeff_count = input.poly_modulus_degree();
+            SEAL_ALLOCATE_GET_COEFF_ITER(a, coeff_count, pool);
+            SEAL_ALLOCATE_GET_COEFF_ITER(y, coeff_count, pool);
+
+            // Write x + H = a + p * y with a in [0, p) and y in [0, q_last)
+            SEAL_ITERATE(iter(input[0], input[1], a, y), coeff_count, [&](auto I) {
+                get<2>(I) = add_uint_mod(get<1>(I), half_mod_special_, special_modulus_);
+                uint64_t b = add_uint_mod(get<0>(I), half_mod_last_, q_last_);
+                get<3>(I) = multiply_uint_mod(
+                    sub_uint_mod(b, barrett_reduce_64(get<2>(I), q_last_), q_last_), inv_special_mod_last_, q_last_);
+            });
+
+            // The centered representative of x is a + p * y - H
+            SEAL_ITERATE(
+                iter(destination, next_modulus_.get(), special_prod_mod_data_.get(), half_mod_next_.get()),
+                next_base_size_, [&](auto I) {
+                    SEAL_ITERATE(iter(a, y, get<0>(I)), coeff_count, [&](auto J) {
+                        get<2>(J) = sub_uint_mod(
+                            multiply_add_uint_mod(get<1>(J), get<2>(I), get<0>(J), get<1>(I)), get<3>(I), get<1>(I));
+                    });
+                });
+        }
     } // namespace util
 } // namespace seal
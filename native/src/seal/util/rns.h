@@ -9,6 +9,7 @@
 #include "seal/util/ntt.h"
 #include "seal/util/pointer.h"
 #include "seal/util/uintarithsmallmod.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -164,6 +165,14 @@ namespace seal
 
             void fast_convert_array(ConstRNSIter in, RNSIter out, MemoryPoolHandle pool) const;
 
+            /**
+            Converts the centered representative of the input, i.e. the representative in [-prod(ibase)/2,
+            prod(ibase)/2], to obase. The multiple of prod(ibase) that fast_convert_array leaves in its result is
+            estimated in floating-point arithmetic and subtracted, as in the Halevi-Polyakov-Shoup (HPS) RNS variant.
+            Inputs very close to +-prod(ibase)/2 may be converted to the other representative.
+            */
+            void exact_convert_array(ConstRNSIter in, RNSIter out, MemoryPoolHandle pool) const;
+
         private:
             BaseConverter(const BaseConverter &copy) = delete;
 
@@ -182,6 +191,18 @@ namespace seal
             RNSBase obase_;
 
             Pointer<Pointer<std::uint64_t>> base_change_matrix_;
+
+            // 1 / ibase[i] in floating-point
+            Pointer<double> inv_ibase_;
+
+            // prod(ibase) mod obase
+            Pointer<MultiplyUIntModOperand> ibase_prod_mod_obase_;
+
+            // Whether fast_convert_array uses the AVX-512 IFMA kernel
+            bool use_avx512ifma_ = false;
+
+            // Whether fast_convert_array uses the AVX-512F/DQ kernel
+            bool use_avx512_ = false;
         };
 
         class RNSTool
@@ -229,6 +250,30 @@ namespace seal
             */
             void decrypt_scale_and_round(ConstRNSIter phase, CoeffIter destination, MemoryPoolHandle pool) const;
 
+            /**
+            HPS exact base conversion of the centered representative from q to Bsk
+            */
+            void hps_lift_q_to_Bsk(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const;
+
+            /**
+            HPS scaling: compute round(t/q * input) mod Bsk from the q and Bsk components of input
+            */
+            void hps_scale_and_round(
+                ConstRNSIter input_q, ConstRNSIter input_Bsk, RNSIter destination, MemoryPoolHandle pool) const;
+
+            /**
+            HPS exact base conversion of the centered representative from Bsk to q
+            */
+            void hps_convert_Bsk_to_q(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const;
+
+            /**
+            Returns whether prod(Bsk) is large enough to hold the scaled ciphertext product of HPS multiplication.
+            */
+            SEAL_NODISCARD inline bool hps_supported() const noexcept
+            {
+                return hps_supported_;
+            }
+
             SEAL_NODISCARD inline auto inv_q_last_mod_q() const noexcept
             {
                 return inv_q_last_mod_q_.get();
@@ -360,6 +405,20 @@ namespace seal
             // NTTTables for Bsk
             Pointer<NTTTables> base_Bsk_ntt_tables_;
 
+            // Base converter: Bsk --> q
+            Pointer<BaseConverter> base_Bsk_to_q_conv_;
+
+            // floor(2^128 * |t * (q/q[i])^(-1)|_q[i] / q[i]) as 128-bit fixed point fractions
+            Pointer<std::uint64_t> hps_frac_q_;
+
+            // -|t * (q/q[i])^(-1)|_q[i] * q[i]^(-1) mod Bsk followed by 1 and 2^64 mod Bsk; row j is for Bsk[j]
+            Pointer<Pointer<std::uint64_t>> hps_int_q_mod_Bsk_;
+
+            // t * prod(q)^(-1) mod Bsk
+            Pointer<MultiplyUIntModOperand> hps_t_inv_prod_q_mod_Bsk_;
+
+            bool hps_supported_ = false;
+
             Modulus m_tilde_;
 
             Modulus m_sk_;
@@ -368,5 +427,194 @@ namespace seal
 
             Modulus gamma_;
         };
+
+        /**
+        Pre-computations for hybrid key switching at one level of the modulus chain. The data primes are split into
+        digits of digit_size() consecutive primes, where digit_size() equals the number of special primes. ModUp
+        extends a digit to all data primes and special primes, and ModDown divides by the product of the special
+        primes, both using fast base conversion.
+        */
+        class HybridKSwitchTool
+        {
+        public:
+            /**
+            @throws std::invalid_argument if data_base or special_base is empty, or if pool is invalid.
+            @throws std::logic_error if the data and special primes are not coprime.
+            */
+            HybridKSwitchTool(const RNSBase &data_base, const RNSBase &special_base, MemoryPoolHandle pool);
+
+            /**
+            Extends a digit to all data primes and special primes. The output has data_base_size() limbs for the data
+            primes followed by special_base_size() limbs for the special primes; the limbs of the digit itself are
+            copied unchanged.
+
+            @param[in] digit_index The index of the digit
+            @param[in] input The digit_size(digit_index) limbs of the digit in coefficient form
+            @param[out] destination The data_base_size() + special_base_size() output limbs
+            */
+            void mod_up(
+                std::size_t digit_index, ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const;
+
+            /**
+            Converts the special_base_size() limbs of input, given in coefficient form, to the data primes, offset so
+            that ModDown rounds instead of flooring. With P the product of the special primes and h = floor(P/2),
+            destination is ((input + h) mod P) - h up to a small multiple of P, so that (c - destination) / P equals
+            c / P rounded to the nearest integer, up to the same small error as without rounding, for any c congruent
+            to input modulo P. The contents of input are destroyed.
+            */
+            void mod_down_convert(RNSIter input, RNSIter destination, MemoryPoolHandle pool) const;
+
+            SEAL_NODISCARD inline std::size_t data_base_size() const noexcept
+            {
+                return data_base_size_;
+            }
+
+            SEAL_NODISCARD inline std::size_t special_base_size() const noexcept
+            {
+                return special_base_size_;
+            }
+
+            SEAL_NODISCARD inline std::size_t digit_count() const noexcept
+            {
+                return digit_count_;
+            }
+
+            SEAL_NODISCARD inline std::size_t digit_begin(std::size_t digit_index) const noexcept
+            {
+                return digit_index * special_base_size_;
+            }
+
+            SEAL_NODISCARD inline std::size_t digit_size(std::size_t digit_index) const noexcept
+            {
+                return std::min(special_base_size_, data_base_size_ - digit_begin(digit_index));
+            }
+
+            SEAL_NODISCARD inline auto inv_special_prod_mod_data() const noexcept
+            {
+                return inv_special_prod_mod_data_.get();
+            }
+
+        private:
+            HybridKSwitchTool(const HybridKSwitchTool &copy) = delete;
+
+            HybridKSwitchTool(HybridKSwitchTool &&source) = delete;
+
+            HybridKSwitchTool &operator=(const HybridKSwitchTool &assign) = delete;
+
+            HybridKSwitchTool &operator=(HybridKSwitchTool &&assign) = delete;
+
+            MemoryPoolHandle pool_;
+
+            std::size_t data_base_size_ = 0;
+
+            std::size_t special_base_size_ = 0;
+
+            std::size_t digit_count_ = 0;
+
+            // BaseConverter from each digit to the remaining data primes and the special primes
+            Pointer<Pointer<BaseConverter>> mod_up_conv_;
+
+            // BaseConverter from the special primes to the data primes
+            Pointer<BaseConverter> mod_down_conv_;
+
+            // (product of special primes)^(-1) mod q[i]
+            Pointer<MultiplyUIntModOperand> inv_special_prod_mod_data_;
+
+            // floor((product of special primes) / 2) mod p[k]
+            Pointer<std::uint64_t> half_special_prod_mod_special_;
+
+            // floor((product of special primes) / 2) mod q[i]
+            Pointer<std::uint64_t> half_special_prod_mod_data_;
+        };
+
+        /**
+        Pre-computations for dividing the output of key switching at one level of the modulus chain by the product P
+        of the special primes and the last data prime q_last in a single pass. This fuses the ModDown of key switching
+        with the modulus switch (or CKKS rescale) to the next level: a ciphertext c and a key switching output d
+        modulo the data and special primes are combined into P*c + d, whose residues modulo q_last and the special
+        primes are converted exactly to the remaining data primes so that the division rounds to the nearest integer.
+        */
+        class KSwitchRescaleTool
+        {
+        public:
+            /**
+            @throws std::invalid_argument if data_base has fewer than two primes, if special_base is empty, or if
+            pool is invalid.
+            @throws std::logic_error if the data and special primes are not coprime.
+            */
+            KSwitchRescaleTool(const RNSBase &data_base, const RNSBase &special_base, MemoryPoolHandle pool);
+
+            /**
+            Converts the limb for q_last followed by the special_base_size() limbs for the special primes, given in
+            coefficient form, to the next_base_size() remaining data primes. The centered representative modulo
+            P*q_last is converted; see BaseConverter::exact_convert_array.
+            */
+            void convert(ConstRNSIter input, RNSIter destination, MemoryPoolHandle pool) const;
+
+            SEAL_NODISCARD inline std::size_t next_base_size() const noexcept
+            {
+                return next_base_size_;
+            }
+
+            SEAL_NODISCARD inline std::size_t special_base_size() const noexcept
+            {
+                return special_base_size_;
+            }
+
+            /**
+            Returns P mod q[i] for every data prime, including q_last.
+            */
+            SEAL_NODISCARD inline auto special_prod_mod_data() const noexcept
+            {
+                return special_prod_mod_data_.get();
+            }
+
+            /**
+            Returns (P*q_last)^(-1) mod q[i] for the remaining data primes.
+            */
+            SEAL_NODISCARD inline auto inv_divisor_mod_next() const noexcept
+            {
+                return inv_divisor_mod_next_.get();
+            }
+
+        private:
+            KSwitchRescaleTool(const KSwitchRescaleTool &copy) = delete;
+
+            KSwitchRescaleTool(KSwitchRescaleTool &&source) = delete;
+
+            KSwitchRescaleTool &operator=(const KSwitchRescaleTool &assign) = delete;
+
+            KSwitchRescaleTool &operator=(KSwitchRescaleTool &&assign) = delete;
+
+            MemoryPoolHandle pool_;
+
+            std::size_t next_base_size_ = 0;
+
+            std::size_t special_base_size_ = 0;
+
+            // BaseConverter from q_last and the special primes to the remaining data primes; used only with more than
+            // one special prime
+            Pointer<BaseConverter> conv_;
+
+            // With a single special prime p the conversion uses the mixed-radix form x = a + p*y, where H is
+            // floor(p*q_last/2) and the input is shifted by H to obtain the centered representative
+            Modulus q_last_;
+
+            Modulus special_modulus_;
+
+            Pointer<Modulus> next_modulus_;
+
+            MultiplyUIntModOperand inv_special_mod_last_;
+
+            std::uint64_t half_mod_special_ = 0;
+
+            std::uint64_t half_mod_last_ = 0;
+
+            Pointer<std::uint64_t> half_mod_next_;
+
+            Pointer<MultiplyUIntModOperand> special_prod_mod_data_;
+
+            Pointer<MultiplyUIntModOperand> inv_divisor_mod_next_;
+        };
     } // namespace util
 } // namespace seal
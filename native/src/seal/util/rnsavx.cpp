@@ -0,0 +1,414 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/rnsavx.h"
+#include "seal/util/uintarith.h"
+#include "seal/util/uintarithsmallmod.h"
+#include <algorithm>
+#include <limits>
+#ifdef SEAL_USE_AVX512
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            int max_bit_count(const RNSBase &base) noexcept
+            {
+                int result = 0;
+                for (size_t i = 0; i < base.size(); i++)
+                {
+                    result = max(result, base[i].bit_count());
+                }
+                return result;
+            }
+        } // namespace
+
+        bool fast_convert_array_fits_avx512(const RNSBase &ibase, const RNSBase &obase) noexcept
+        {
+            // The final reduction sums lazily reduced values in [0, 4q)
+            int ibase_bit_count = max_bit_count(ibase);
+            int obase_bit_count = max_bit_count(obase);
+            if (ibase_bit_count > 61 || obase_bit_count > 61)
+            {
+                return false;
+            }
+
+            // Products are split into 32-bit limbs accumulated in three 64-bit sums. Each product adds less than
+            // 3 * 2^32 to the middle sum; the high sum receives the product of the high halves of the factors and the
+            // high halves of the two cross products.
+            uint64_t count = static_cast<uint64_t>(ibase.size());
+            int ibase_high_bit_count = max(ibase_bit_count - 32, 0);
+            int obase_high_bit_count = max(obase_bit_count - 32, 0);
+            uint64_t high_bound = (uint64_t(1) << (ibase_high_bit_count + obase_high_bit_count)) +
+                                  (uint64_t(1) << ibase_high_bit_count) + (uint64_t(1) << obase_high_bit_count);
+            return count < (uint64_t(1) << 30) && count <= numeric_limits<uint64_t>::max() / high_bound;
+        }
+
+        bool fast_convert_array_fits_avx512ifma(const RNSBase &ibase, const RNSBase &obase) noexcept
+        {
+            // Both factors of every product must fit in 52 bits, and lazily reduced values in [0, 2q) as well
+            int ibase_bit_count = max_bit_count(ibase);
+            int obase_bit_count = max_bit_count(obase);
+            if (ibase_bit_count > 50 || obase_bit_count > 50)
+            {
+                return false;
+            }
+
+            // The low 52-bit halves of the products are accumulated in 64 bits, and the high halves together with
+            // the carries from the low halves must stay below 2^52
+            uint64_t count = static_cast<uint64_t>(ibase.size());
+            int high_bit_count = max(ibase_bit_count + obase_bit_count - 52, 0);
+            return count < (uint64_t(1) << 12) && count * ((uint64_t(1) << high_bit_count) + 1) < (uint64_t(1) << 52);
+        }
+
+#ifdef SEAL_USE_AVX512
+        namespace
+        {
+            // Number of 64-bit lanes in a vector
+            constexpr size_t lane_count = 8;
+
+            // Returns the number of coefficients converted per block, a multiple of lane_count unless count is
+            // smaller, such that the temporary values of a block fill 16 KB
+            size_t get_block_size(size_t ibase_size, size_t count) noexcept
+            {
+                constexpr size_t block_byte_count = 16384;
+                size_t block_size = max(block_byte_count / (ibase_size * sizeof(uint64_t)) / lane_count, size_t(1));
+                return min(block_size * lane_count, count);
+            }
+
+            // Multiplies the input with the inverse punctured products, as in the scalar implementation; temp holds
+            // one row of block_size values per ibase element
+            void multiply_inv_punctured_prod(
+                ConstRNSIter in, size_t offset, size_t block_count, const RNSBase &ibase, uint64_t *temp,
+                size_t block_size)
+            {
+                SEAL_ITERATE(
+                    iter(in, ibase.inv_punctured_prod_mod_base_array(), ibase.base(), size_t(0)), ibase.size(),
+                    [&](auto I) {
+                        uint64_t *temp_row = temp + get<3>(I) * block_size;
+                        if (get<1>(I).operand == 1)
+                        {
+                            SEAL_ITERATE(iter(get<0>(I) + offset, temp_row), block_count, [&](auto J) {
+                                get<1>(J) = barrett_reduce_64(get<0>(J), get<2>(I));
+                            });
+                        }
+                        else
+                        {
+                            SEAL_ITERATE(iter(get<0>(I) + offset, temp_row), block_count, [&](auto J) {
+                                get<1>(J) = multiply_uint_mod(get<0>(J), get<1>(I), get<2>(I));
+                            });
+                        }
+                    });
+            }
+
+            // Computes the base conversion sum of coefficient c of a block in scalar arithmetic
+            uint64_t convert_coeff(
+                const uint64_t *temp, size_t block_size, size_t c, const uint64_t *matrix_row, uint64_t *column,
+                const RNSBase &ibase, const Modulus &modulus)
+            {
+                for (size_t i = 0; i < ibase.size(); i++)
+                {
+                    column[i] = temp[i * block_size + c];
+                }
+                return dot_product_mod(column, matrix_row, ibase.size(), modulus);
+            }
+
+            /*
+            GCC implements the unmasked _mm512_srli_epi64, _mm512_mul_epu32, and _mm512_min_epu64 with an undefined
+            pass-through operand, which -Wmaybe-uninitialized reports once they are inlined. The zero-masked forms
+            with a full mask have no such operand and compile to the same unmasked instructions.
+            */
+            template <unsigned int Shift>
+            SEAL_TARGET_AVX512 inline __m512i srli_avx512(__m512i a)
+            {
+                return _mm512_maskz_srli_epi64(0xFF, a, Shift);
+            }
+
+            SEAL_TARGET_AVX512 inline __m512i mul_epu32_avx512(__m512i a, __m512i b)
+            {
+                return _mm512_maskz_mul_epu32(0xFF, a, b);
+            }
+
+            SEAL_TARGET_AVX512 inline __m512i min_epu64_avx512(__m512i a, __m512i b)
+            {
+                return _mm512_maskz_min_epu64(0xFF, a, b);
+            }
+
+            // Reduces a in [0, 2q) to [0, q), or a in [0, 4q) to [0, 2q) when q is replaced with 2q; the unsigned
+            // minimum selects the difference unless it wraps around
+            SEAL_TARGET_AVX512 inline __m512i reduce_once_avx512(__m512i a, __m512i q)
+            {
+                return min_epu64_avx512(a, _mm512_sub_epi64(a, q));
+            }
+
+            SEAL_TARGET_AVX512 inline __m512i mulhi64_avx512(__m512i a, __m512i b)
+            {
+                const __m512i lo_mask = _mm512_set1_epi64(0xFFFFFFFF);
+                __m512i a_hi = srli_avx512<32>(a);
+                __m512i b_hi = srli_avx512<32>(b);
+                __m512i p00 = mul_epu32_avx512(a, b);
+                __m512i p01 = mul_epu32_avx512(a, b_hi);
+                __m512i p10 = mul_epu32_avx512(a_hi, b);
+                __m512i p11 = mul_epu32_avx512(a_hi, b_hi);
+                __m512i mid = _mm512_add_epi64(srli_avx512<32>(p00), _mm512_and_si512(p01, lo_mask));
+                mid = _mm512_add_epi64(mid, _mm512_and_si512(p10, lo_mask));
+                __m512i hi = _mm512_add_epi64(p11, srli_avx512<32>(p01));
+                hi = _mm512_add_epi64(hi, srli_avx512<32>(p10));
+                return _mm512_add_epi64(hi, srli_avx512<32>(mid));
+            }
+
+            // Computes a * operand mod q in [0, 2q) for any 64-bit a with Shoup's method, as multiply_uint_mod_lazy
+            SEAL_TARGET_AVX512 inline __m512i multiply_uint_mod_lazy_avx512(
+                __m512i a, const MultiplyUIntModOperand &operand, __m512i q)
+            {
+                __m512i hi = mulhi64_avx512(a, _mm512_set1_epi64(static_cast<long long>(operand.quotient)));
+                return _mm512_sub_epi64(
+                    _mm512_mullo_epi64(a, _mm512_set1_epi64(static_cast<long long>(operand.operand))),
+                    _mm512_mullo_epi64(hi, q));
+            }
+
+            // Constants for reducing a value hi * 2^64 + mid * 2^32 + lo modulo an obase element
+            struct AVX512ReductionConstants
+            {
+                // 2^64 mod q, 2^32 mod q, and 1 with their Shoup quotients
+                MultiplyUIntModOperand pow64;
+
+                MultiplyUIntModOperand pow32;
+
+                MultiplyUIntModOperand one;
+            };
+
+            AVX512ReductionConstants make_avx512_reduction_constants(const Modulus &modulus)
+            {
+                AVX512ReductionConstants result;
+                uint64_t pow32 = (uint64_t(1) << 32) % modulus.value();
+                result.pow64.set(multiply_uint_mod(pow32, pow32, modulus), modulus);
+                result.pow32.set(pow32, modulus);
+                result.one.set(1, modulus);
+                return result;
+            }
+
+            /*
+            Reduces hi * 2^64 + mid * 2^32 + lo modulo q. Each of the three terms is reduced lazily to [0, 2q) with
+            Shoup's method, which is exact for any 64-bit input, and the sums are corrected to [0, 2q) and finally to
+            [0, q). All intermediate values are below 4q < 2^64.
+            */
+            SEAL_TARGET_AVX512 inline __m512i reduce_avx512(
+                __m512i lo, __m512i mid, __m512i hi, const AVX512ReductionConstants &constants, __m512i q)
+            {
+                const __m512i two_q = _mm512_add_epi64(q, q);
+                __m512i r = _mm512_add_epi64(
+                    multiply_uint_mod_lazy_avx512(hi, constants.pow64, q),
+                    multiply_uint_mod_lazy_avx512(mid, constants.pow32, q));
+                r = reduce_once_avx512(r, two_q);
+                r = _mm512_add_epi64(r, multiply_uint_mod_lazy_avx512(lo, constants.one, q));
+                r = reduce_once_avx512(r, two_q);
+                return reduce_once_avx512(r, q);
+            }
+        } // namespace
+
+        SEAL_TARGET_AVX512 void fast_convert_array_avx512(
+            ConstRNSIter in, RNSIter out, const RNSBase &ibase, const RNSBase &obase,
+            const Pointer<uint64_t> *base_change_matrix, MemoryPool &pool)
+        {
+            size_t ibase_size = ibase.size();
+            size_t obase_size = obase.size();
+            size_t count = in.poly_modulus_degree();
+            size_t block_size = get_block_size(ibase_size, count);
+
+            // Rows of temporary values, one per ibase element
+            auto temp(allocate_uint(mul_safe(block_size, ibase_size), pool));
+            auto column(allocate_uint(ibase_size, pool));
+
+            // The high 32-bit halves of the base-change matrix rows
+            auto matrix_row_hi(allocate_uint(ibase_size, pool));
+
+            vector<AVX512ReductionConstants> constants(obase_size);
+            for (size_t j = 0; j < obase_size; j++)
+            {
+                constants[j] = make_avx512_reduction_constants(obase[j]);
+            }
+
+            const __m512i lo_mask = _mm512_set1_epi64(0xFFFFFFFF);
+            for (size_t offset = 0; offset < count; offset += block_size)
+            {
+                size_t block_count = min(block_size, count - offset);
+                multiply_inv_punctured_prod(in, offset, block_count, ibase, temp.get(), block_size);
+
+                for (size_t j = 0; j < obase_size; j++)
+                {
+                    const uint64_t *matrix_row = base_change_matrix[j].get();
+                    for (size_t i = 0; i < ibase_size; i++)
+                    {
+                        matrix_row_hi[i] = matrix_row[i] >> 32;
+                    }
+                    const __m512i q = _mm512_set1_epi64(static_cast<long long>(obase[j].value()));
+                    uint64_t *out_row = out[j] + offset;
+
+                    size_t c = 0;
+                    for (; c + lane_count <= block_count; c += lane_count)
+                    {
+                        // The products are accumulated as lo + mid * 2^32 + hi * 2^64 from their 32-bit limbs
+                        __m512i lo = _mm512_setzero_si512();
+                        __m512i mid = _mm512_setzero_si512();
+                        __m512i hi = _mm512_setzero_si512();
+                        for (size_t i = 0; i < ibase_size; i++)
+                        {
+                            __m512i t = _mm512_loadu_si512(temp.get() + i * block_size + c);
+                            __m512i t_hi = srli_avx512<32>(t);
+                            __m512i m = _mm512_set1_epi64(static_cast<long long>(matrix_row[i]));
+                            __m512i m_hi = _mm512_set1_epi64(static_cast<long long>(matrix_row_hi[i]));
+                            __m512i p00 = mul_epu32_avx512(t, m);
+                            __m512i p01 = mul_epu32_avx512(t, m_hi);
+                            __m512i p10 = mul_epu32_avx512(t_hi, m);
+                            __m512i p11 = mul_epu32_avx512(t_hi, m_hi);
+                            lo = _mm512_add_epi64(lo, _mm512_and_si512(p00, lo_mask));
+                            mid = _mm512_add_epi64(mid, srli_avx512<32>(p00));
+                            mid = _mm512_add_epi64(mid, _mm512_and_si512(p01, lo_mask));
+                            mid = _mm512_add_epi64(mid, _mm512_and_si512(p10, lo_mask));
+                            hi = _mm512_add_epi64(hi, p11);
+                            hi = _mm512_add_epi64(hi, srli_avx512<32>(p01));
+                            hi = _mm512_add_epi64(hi, srli_avx512<32>(p10));
+                        }
+                        _mm512_storeu_si512(out_row + c, reduce_avx512(lo, mid, hi, constants[j], q));
+                    }
+
+                    // Remaining coefficients
+                    for (; c < block_count; c++)
+                    {
+                        out_row[c] =
+                            convert_coeff(temp.get(), block_size, c, matrix_row, column.get(), ibase, obase[j]);
+                    }
+                }
+            }
+        }
+#endif
+#ifdef SEAL_USE_AVX512IFMA
+        namespace
+        {
+            // Constants for reducing a value hi * 2^52 + lo, with hi and lo below 2^52, modulo an obase element
+            struct IFMAReductionConstants
+            {
+                // The modulus q
+                uint64_t modulus;
+
+                // 2^52 mod q and its Shoup quotient floor((2^52 mod q) * 2^52 / q)
+                uint64_t pow52;
+
+                uint64_t pow52_quotient;
+
+                // Barrett factor floor(2^52 / q)
+                uint64_t barrett;
+            };
+
+            IFMAReductionConstants make_reduction_constants(const Modulus &modulus)
+            {
+                IFMAReductionConstants result;
+                uint64_t q = modulus.value();
+                result.modulus = q;
+                result.pow52 = (uint64_t(1) << 52) % q;
+                uint64_t numerator[2]{ result.pow52 << 52, result.pow52 >> 12 };
+                uint64_t quotient[2]{ 0, 0 };
+                divide_uint128_inplace(numerator, q, quotient);
+                result.pow52_quotient = quotient[0];
+                result.barrett = (uint64_t(1) << 52) / q;
+                return result;
+            }
+
+            /*
+            Reduces hi * 2^52 + lo modulo q, where the accumulators hold sums of the low and high 52-bit halves of
+            products. After moving the carries of lo into hi, both are below 2^52. Then hi * (2^52 mod q) is reduced
+            lazily with Shoup's method and lo with Barrett's method; each result is in [0, 2q) and is computed exactly
+            in 52-bit arithmetic because 2q < 2^52. Their sum in [0, 4q) is finally corrected to [0, q).
+            */
+            SEAL_TARGET_AVX512IFMA inline __m512i reduce_ifma(
+                __m512i lo, __m512i hi, const IFMAReductionConstants &constants)
+            {
+                const __m512i zero = _mm512_setzero_si512();
+                const __m512i mask52 = _mm512_set1_epi64((int64_t(1) << 52) - 1);
+                const __m512i q = _mm512_set1_epi64(static_cast<int64_t>(constants.modulus));
+                const __m512i two_q = _mm512_add_epi64(q, q);
+
+                hi = _mm512_add_epi64(hi, srli_avx512<52>(lo));
+                lo = _mm512_and_si512(lo, mask52);
+
+                // hi * 2^52 mod q in [0, 2q)
+                __m512i est = _mm512_madd52hi_epu64(
+                    zero, hi, _mm512_set1_epi64(static_cast<int64_t>(constants.pow52_quotient)));
+                __m512i r_hi = _mm512_sub_epi64(
+                    _mm512_madd52lo_epu64(zero, hi, _mm512_set1_epi64(static_cast<int64_t>(constants.pow52))),
+                    _mm512_madd52lo_epu64(zero, est, q));
+                r_hi = _mm512_and_si512(r_hi, mask52);
+
+                // lo mod q in [0, 2q)
+                est = _mm512_madd52hi_epu64(zero, lo, _mm512_set1_epi64(static_cast<int64_t>(constants.barrett)));
+                __m512i r_lo = _mm512_and_si512(_mm512_sub_epi64(lo, _mm512_madd52lo_epu64(zero, est, q)), mask52);
+
+                // Sum in [0, 4q) reduced to [0, q)
+                __m512i r = reduce_once_avx512(_mm512_add_epi64(r_hi, r_lo), two_q);
+                return reduce_once_avx512(r, q);
+            }
+        } // namespace
+
+        SEAL_TARGET_AVX512IFMA void fast_convert_array_avx512ifma(
+            ConstRNSIter in, RNSIter out, const RNSBase &ibase, const RNSBase &obase,
+            const Pointer<uint64_t> *base_change_matrix, MemoryPool &pool)
+        {
+            size_t ibase_size = ibase.size();
+            size_t obase_size = obase.size();
+            size_t count = in.poly_modulus_degree();
+            size_t block_size = get_block_size(ibase_size, count);
+
+            // Rows of temporary values, one per ibase element
+            auto temp(allocate_uint(mul_safe(block_size, ibase_size), pool));
+            auto column(allocate_uint(ibase_size, pool));
+
+            vector<IFMAReductionConstants> constants(obase_size);
+            for (size_t j = 0; j < obase_size; j++)
+            {
+                constants[j] = make_reduction_constants(obase[j]);
+            }
+
+            for (size_t offset = 0; offset < count; offset += block_size)
+            {
+                size_t block_count = min(block_size, count - offset);
+                multiply_inv_punctured_prod(in, offset, block_count, ibase, temp.get(), block_size);
+
+                for (size_t j = 0; j < obase_size; j++)
+                {
+                    const uint64_t *matrix_row = base_change_matrix[j].get();
+                    uint64_t *out_row = out[j] + offset;
+
+                    size_t c = 0;
+                    for (; c + lane_count <= block_count; c += lane_count)
+                    {
+                        __m512i lo = _mm512_setzero_si512();
+                        __m512i hi = _mm512_setzero_si512();
+                        for (size_t i = 0; i < ibase_size; i++)
+                        {
+                            __m512i t = _mm512_loadu_si512(temp.get() + i * block_size + c);
+                            __m512i m = _mm512_set1_epi64(static_cast<int64_t>(matrix_row[i]));
+                            lo = _mm512_madd52lo_epu64(lo, t, m);
+                            hi = _mm512_madd52hi_epu64(hi, t, m);
+                        }
+                        _mm512_storeu_si512(out_row + c, reduce_ifma(lo, hi, constants[j]));
+                    }
+
+                    // Remaining coefficients
+                    for (; c < block_count; c++)
+                    {
+                        out_row[c] =
+                            convert_coeff(temp.get(), block_size, c, matrix_row, column.get(), ibase, obase[j]);
+                    }
+                }
+            }
+        }
+#endif
+    } // namespace util
+} // namespace seal
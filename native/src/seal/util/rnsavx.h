@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/util/defines.h"
+#include "seal/util/iterator.h"
+#include "seal/util/mempool.h"
+#include "seal/util/pointer.h"
+#include "seal/util/rns.h"
+#include <cstdint>
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        The functions in this file are AVX-512 implementations of BaseConverter::fast_convert_array. The conversion is
+        computed as the product of the (small) base-change matrix with the (large) matrix of input coefficients: eight
+        coefficients are processed at a time, the products are accumulated lazily and reduced only once per output
+        coefficient, and the input is processed in cache-sized blocks. The outputs are fully reduced and identical to
+        those of the scalar implementation.
+
+        The AVX-512 IFMA kernel uses 52-bit multiply-accumulate instructions and requires all moduli to be at most 50
+        bits. The AVX-512F/DQ kernel handles moduli of up to 61 bits, such as the auxiliary bases of BFV
+        multiplication, by accumulating the 32-bit limbs of the 64-bit products. Both kernels require the input base
+        to be small enough for the lazy accumulation not to overflow; fast_convert_array_fits_avx512ifma and
+        fast_convert_array_fits_avx512 check these conditions. BaseConverter selects a kernel automatically when the
+        conditions hold and cpu_has_avx512ifma() or cpu_has_avx512() returns true, preferring the IFMA kernel; the
+        functions are exposed only for testing and benchmarking.
+        */
+        SEAL_NODISCARD bool fast_convert_array_fits_avx512(const RNSBase &ibase, const RNSBase &obase) noexcept;
+
+        SEAL_NODISCARD bool fast_convert_array_fits_avx512ifma(const RNSBase &ibase, const RNSBase &obase) noexcept;
+#ifdef SEAL_USE_AVX512
+        void fast_convert_array_avx512(
+            ConstRNSIter in, RNSIter out, const RNSBase &ibase, const RNSBase &obase,
+            const Pointer<std::uint64_t> *base_change_matrix, MemoryPool &pool);
+#endif
+#ifdef SEAL_USE_AVX512IFMA
+        void fast_convert_array_avx512ifma(
+            ConstRNSIter in, RNSIter out, const RNSBase &ibase, const RNSBase &obase,
+            const Pointer<std::uint64_t> *base_change_matrix, MemoryPool &pool);
+#endif
+    } // namespace util
+} // namespace seal
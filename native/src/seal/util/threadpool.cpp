@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/threadpool.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            thread_local bool tls_in_parallel_region = false;
+        } // namespace
+
+        ThreadPool::ThreadPool(size_t thread_count)
+        {
+            if (!thread_count)
+            {
+                throw invalid_argument("thread_count must be positive");
+            }
+
+            workers_.reserve(thread_count - 1);
+            for (size_t i = 1; i < thread_count; i++)
+            {
+                workers_.emplace_back(&ThreadPool::worker_loop, this);
+            }
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                lock_guard<mutex> lock(mutex_);
+                stop_ = true;
+            }
+            work_cv_.notify_all();
+            for (auto &worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        bool ThreadPool::in_parallel_region() noexcept
+        {
+            return tls_in_parallel_region;
+        }
+
+        void ThreadPool::parallel_for(size_t count, const function<void(size_t)> &func)
+        {
+            // Run serially if there is nothing to distribute or if this is a nested call
+            if (workers_.empty() || count < 2 || tls_in_parallel_region)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    func(i);
+                }
+                return;
+            }
+
+            lock_guard<mutex> call_lock(call_mutex_);
+            {
+                lock_guard<mutex> lock(mutex_);
+                func_ = &func;
+                count_ = count;
+                next_.store(0);
+                exception_ = nullptr;
+                active_workers_ = workers_.size();
+                generation_++;
+            }
+            work_cv_.notify_all();
+
+            // The calling thread takes part in the work
+            run_iterations();
+
+            unique_lock<mutex> lock(mutex_);
+            done_cv_.wait(lock, [this] { return !active_workers_; });
+            func_ = nullptr;
+            if (exception_)
+            {
+                rethrow_exception(exception_);
+            }
+        }
+
+        void ThreadPool::worker_loop()
+        {
+            uint64_t generation = 0;
+            while (true)
+            {
+                {
+                    unique_lock<mutex> lock(mutex_);
+                    work_cv_.wait(lock, [&] { return stop_ || generation != generation_; });
+                    if (stop_)
+                    {
+                        return;
+                    }
+                    generation = generation_;
+                }
+
+                run_iterations();
+
+                {
+                    lock_guard<mutex> lock(mutex_);
+                    if (!--active_workers_)
+                    {
+                        done_cv_.notify_one();
+                    }
+                }
+            }
+        }
+
+        void ThreadPool::run_iterations()
+        {
+            tls_in_parallel_region = true;
+            size_t i;
+            while ((i = next_.fetch_add(1)) < count_)
+            {
+                try
+                {
+                    (*func_)(i);
+                }
+                catch (...)
+                {
+                    lock_guard<mutex> lock(mutex_);
+                    if (!exception_)
+                    {
+                        exception_ = current_exception();
+                    }
+
+                    // Skip the remaining iterations
+                    next_.store(count_);
+                }
+            }
+            tls_in_parallel_region = false;
+        }
+    } // namespace util
+} // namespace seal
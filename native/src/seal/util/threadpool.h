@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/util/defines.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        A fixed-size pool of threads for running independent loop iterations in parallel. The thread calling
+        parallel_for takes part in the work, so a ThreadPool with thread_count threads starts thread_count - 1
+        worker threads.
+        */
+        class ThreadPool
+        {
+        public:
+            /**
+            Creates a ThreadPool with the given total number of threads.
+
+            @param[in] thread_count The number of threads, including the calling thread
+            @throws std::invalid_argument if thread_count is zero
+            */
+            explicit ThreadPool(std::size_t thread_count);
+
+            ~ThreadPool();
+
+            /**
+            Returns the number of threads, including the calling thread.
+            */
+            SEAL_NODISCARD inline std::size_t thread_count() const noexcept
+            {
+                return workers_.size() + 1;
+            }
+
+            /**
+            Calls func(i) for every i in [0, count) and returns when all calls have completed. The iterations are
+            distributed dynamically over the threads, so func must not depend on which thread runs it. If any call
+            throws, the remaining iterations are skipped and the first exception is rethrown. Concurrent calls from
+            different threads are serialized, and calls made from within func run on the calling thread.
+            */
+            void parallel_for(std::size_t count, const std::function<void(std::size_t)> &func);
+
+            /**
+            Returns true if the current thread is running an iteration of parallel_for on any ThreadPool.
+            */
+            SEAL_NODISCARD static bool in_parallel_region() noexcept;
+
+        private:
+            ThreadPool(const ThreadPool &copy) = delete;
+
+            ThreadPool &operator=(const ThreadPool &assign) = delete;
+
+            void worker_loop();
+
+            void run_iterations();
+
+            std::vector<std::thread> workers_;
+
+            std::mutex call_mutex_;
+
+            std::mutex mutex_;
+
+            std::condition_variable work_cv_;
+
+            std::condition_variable done_cv_;
+
+            const std::function<void(std::size_t)> *func_ = nullptr;
+
+            std::size_t count_ = 0;
+
+            std::atomic<std::size_t> next_{ 0 };
+
+            std::size_t active_workers_ = 0;
+
+            std::uint64_t generation_ = 0;
+
+            bool stop_ = false;
+
+            std::exception_ptr exception_;
+        };
+    } // namespace util
+} // namespace seal
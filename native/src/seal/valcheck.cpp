@@ -138,7 +138,11 @@ namespace seal
             return false;
         }
 
-        size_t decomp_mod_count = context.first_context_data()->parms().coeff_modulus().size();
+        // With hybrid key switching each key has one component per digit instead of one per data prime
+        auto &first_context_data = *context.first_context_data();
+        size_t decomp_mod_count = first_context_data.hybrid_kswitch_tool()
+                                      ? first_context_data.hybrid_kswitch_tool()->digit_count()
+                                      : first_context_data.parms().coeff_modulus().size();
         for (auto &a : in.data())
         {
             // Check that each highest level component has right size
@@ -126,4 +126,52 @@ namespace sealtest
             is_equal_uint(ctxt.data(), ctxt2.data(), parms.poly_modulus_degree() * parms.coeff_modulus().size() * 2));
         ASSERT_TRUE(ctxt.data() != ctxt2.data());
     }
+
+    TEST(CiphertextTest, SaveLoadCiphertextBitpack)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(1024);
+        parms.set_coeff_modulus(CoeffModulus::Create(1024, { 30, 40 }));
+        parms.set_plain_modulus(0xF0F0);
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        Encryptor encryptor(context, pk, keygen.secret_key());
+        Plaintext plain("Ax^10 + 9x^9 + 8x^8 + 7x^7 + 6x^6 + 5x^5 + 4x^4 + 3x^3 + 2x^2 + 1");
+
+        Ciphertext ctxt;
+        Ciphertext ctxt2;
+        encryptor.encrypt(plain, ctxt);
+        {
+            stringstream stream;
+            auto out_size = ctxt.save(stream, compr_mode_type::bitpack);
+            ASSERT_EQ(ctxt.save_size(compr_mode_type::bitpack), out_size);
+            ASSERT_LT(out_size, ctxt.save_size(compr_mode_type::none));
+            ASSERT_EQ(out_size, ctxt2.load(context, stream));
+            ASSERT_TRUE(ctxt.parms_id() == ctxt2.parms_id());
+            ASSERT_EQ(ctxt.size(), ctxt2.size());
+            ASSERT_TRUE(is_equal_uint(ctxt.data(), ctxt2.data(), ctxt.dyn_array().size()));
+        }
+        {
+            // Also to a buffer
+            vector<seal_byte> buffer(static_cast<size_t>(ctxt.save_size(compr_mode_type::bitpack)));
+            auto out_size = ctxt.save(buffer.data(), buffer.size(), compr_mode_type::bitpack);
+            ASSERT_EQ(static_cast<streamoff>(buffer.size()), out_size);
+            ASSERT_EQ(out_size, ctxt2.load(context, buffer.data(), buffer.size()));
+            ASSERT_TRUE(is_equal_uint(ctxt.data(), ctxt2.data(), ctxt.dyn_array().size()));
+        }
+        {
+            // Seeded ciphertexts pack only the first polynomial and expand as before
+            stringstream stream;
+            stringstream stream_none;
+            auto seeded = encryptor.encrypt_symmetric(plain);
+            auto out_size = seeded.save(stream, compr_mode_type::bitpack);
+            ASSERT_EQ(seeded.save_size(compr_mode_type::bitpack), out_size);
+            ASSERT_LT(out_size, seeded.save(stream_none, compr_mode_type::none));
+            ctxt.load(context, stream_none);
+            ctxt2.load(context, stream);
+            ASSERT_TRUE(is_equal_uint(ctxt.data(), ctxt2.data(), ctxt.dyn_array().size()));
+        }
+    }
 } // namespace sealtest
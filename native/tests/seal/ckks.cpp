@@ -246,6 +246,64 @@ namespace sealtest
         }
     }
 
+    TEST(CKKSEncoderTest, CKKSEncoderEncodeRealVectorDecodeTest)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        srand(static_cast<unsigned>(time(NULL)));
+        for (size_t slots : { size_t(1), size_t(2), size_t(4), size_t(32), size_t(1024) })
+        {
+            parms.set_poly_modulus_degree(slots << 1);
+            parms.set_coeff_modulus(CoeffModulus::Create(slots << 1, { 60, 60, 60 }));
+            SEALContext context(parms, false, sec_level_type::none);
+            CKKSEncoder encoder(context);
+            double delta = (1ULL << 40);
+
+            int data_bound = (1 << 20);
+            vector<double> values(slots);
+            vector<complex<double>> complex_values(slots);
+            for (size_t i = 0; i < slots; i++)
+            {
+                values[i] = static_cast<double>(rand() % data_bound - data_bound / 2) / 16.0;
+                complex_values[i] = values[i];
+            }
+
+            // Real and complex encoding must agree in both directions
+            Plaintext plain;
+            Plaintext complex_plain;
+            encoder.encode(values, context.first_parms_id(), delta, plain);
+            encoder.encode(complex_values, context.first_parms_id(), delta, complex_plain);
+
+            vector<double> result;
+            vector<complex<double>> complex_result;
+            encoder.decode(plain, complex_result);
+            for (size_t i = 0; i < slots; i++)
+            {
+                ASSERT_TRUE(abs(values[i] - complex_result[i].real()) < 0.001);
+                ASSERT_TRUE(abs(complex_result[i].imag()) < 0.001);
+            }
+            encoder.decode(complex_plain, result);
+            for (size_t i = 0; i < slots; i++)
+            {
+                ASSERT_TRUE(abs(values[i] - result[i]) < 0.001);
+            }
+            encoder.decode(plain, result);
+            for (size_t i = 0; i < slots; i++)
+            {
+                ASSERT_TRUE(abs(values[i] - result[i]) < 0.001);
+            }
+
+            // Fewer values than slots
+            values.resize(slots / 2 + 1);
+            encoder.encode(values, context.first_parms_id(), delta, plain);
+            encoder.decode(plain, result);
+            for (size_t i = 0; i < slots; i++)
+            {
+                double expected = i < values.size() ? values[i] : 0.0;
+                ASSERT_TRUE(abs(expected - result[i]) < 0.001);
+            }
+        }
+    }
+
     TEST(CKKSEncoderTest, CKKSEncoderEncodeSingleDecodeTest)
     {
         EncryptionParameters parms(scheme_type::ckks);
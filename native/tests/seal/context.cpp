@@ -382,6 +382,38 @@ namespace sealtest
         }
     }
 
+    TEST(ContextTest, ModulusChainSpecialModulusSize)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        parms.set_poly_modulus_degree(4);
+        parms.set_coeff_modulus({ 41, 137, 193, 65537 });
+        parms.set_special_modulus_size(2);
+        SEALContext context(parms, true, sec_level_type::none);
+        ASSERT_TRUE(context.using_keyswitching());
+
+        // Both special primes are dropped from the key level
+        auto context_data = context.key_context_data();
+        ASSERT_EQ(size_t(2), context_data->chain_index());
+        ASSERT_FALSE(!!context_data->hybrid_kswitch_tool());
+        context_data = context_data->next_context_data();
+        ASSERT_EQ(context_data->parms_id(), context.first_parms_id());
+        ASSERT_EQ(size_t(1), context_data->chain_index());
+        ASSERT_EQ(5617ULL, *context_data->total_coeff_modulus());
+        ASSERT_EQ(size_t(2), context_data->parms().special_modulus_size());
+        ASSERT_EQ(size_t(1), context_data->hybrid_kswitch_tool()->digit_count());
+        context_data = context_data->next_context_data();
+        ASSERT_EQ(size_t(0), context_data->chain_index());
+        ASSERT_EQ(41ULL, *context_data->total_coeff_modulus());
+        ASSERT_EQ(size_t(1), context_data->hybrid_kswitch_tool()->digit_count());
+        ASSERT_FALSE(!!context_data->next_context_data());
+
+        // Not enough primes for key switching
+        parms.set_coeff_modulus({ 41, 137 });
+        context = SEALContext(parms, true, sec_level_type::none);
+        ASSERT_FALSE(context.using_keyswitching());
+        ASSERT_EQ(context.key_parms_id(), context.first_parms_id());
+    }
+
     TEST(EncryptionParameterQualifiersTest, ParameterError)
     {
         auto scheme = scheme_type::bfv;
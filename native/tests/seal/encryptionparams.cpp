@@ -144,5 +144,58 @@ namespace sealtest
         ASSERT_TRUE(parms.plain_modulus() == parms2.plain_modulus());
         ASSERT_TRUE(parms.poly_modulus_degree() == parms2.poly_modulus_degree());
         ASSERT_TRUE(parms == parms2);
+
+        // The default number of special primes keeps the format unchanged
+        stringstream default_stream;
+        Serialization::SEALHeader header;
+        parms.save(default_stream);
+        Serialization::LoadHeader(default_stream, header);
+        ASSERT_EQ(0, header.reserved);
+        ASSERT_EQ(parms.save_size(compr_mode_type::none), parms.save(default_stream, compr_mode_type::none));
+
+        // Otherwise it is saved after coeff_modulus and flagged in the header
+        parms.set_special_modulus_size(2);
+        auto special_pos = stream.tellp();
+        parms.save(stream);
+        parms2.load(stream);
+        ASSERT_EQ(size_t(2), parms2.special_modulus_size());
+        ASSERT_TRUE(parms.coeff_modulus() == parms2.coeff_modulus());
+        ASSERT_TRUE(parms == parms2);
+        stream.seekg(special_pos);
+        Serialization::LoadHeader(stream, header);
+        ASSERT_EQ(Serialization::header_flag_special_modulus_size, header.reserved);
+        ASSERT_EQ(parms.save_size(compr_mode_type::none), parms.save(stream, compr_mode_type::none));
+
+        // Readers must not accept the field without the flag
+        stringstream unflagged_stream;
+        parms.save(unflagged_stream, compr_mode_type::none);
+        Serialization::LoadHeader(unflagged_stream, header);
+        unflagged_stream.seekp(0);
+        header.reserved = 0;
+        Serialization::SaveHeader(header, unflagged_stream);
+        unflagged_stream.seekg(0);
+        ASSERT_THROW(parms2.load(unflagged_stream), logic_error);
+    }
+
+    TEST(EncryptionParametersTest, EncryptionParametersSpecialModulusSize)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 30, 30, 30, 30 }));
+        ASSERT_EQ(size_t(1), parms.special_modulus_size());
+
+        // The default value does not change the parms_id
+        EncryptionParameters parms2 = parms;
+        parms2.set_special_modulus_size(1);
+        ASSERT_TRUE(parms == parms2);
+
+        parms2.set_special_modulus_size(2);
+        ASSERT_EQ(size_t(2), parms2.special_modulus_size());
+        ASSERT_FALSE(parms == parms2);
+
+        ASSERT_THROW(parms.set_special_modulus_size(0), invalid_argument);
+
+        EncryptionParameters parms_none(scheme_type::none);
+        ASSERT_THROW(parms_none.set_special_modulus_size(2), logic_error);
     }
 } // namespace sealtest
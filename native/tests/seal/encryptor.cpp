@@ -8,6 +8,7 @@
 #include "seal/encryptor.h"
 #include "seal/keygenerator.h"
 #include "seal/modulus.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <ctime>
@@ -850,4 +851,115 @@ namespace sealtest
             }
         }
     }
+
+    TEST(EncryptorTest, BFVEncryptBatchDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        Modulus plain_modulus(1 << 6);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40 }));
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Decryptor decryptor(context, keygen.secret_key());
+        ASSERT_EQ(size_t(1), encryptor.thread_count());
+
+        vector<Plaintext> plains;
+        for (size_t i = 0; i < 11; i++)
+        {
+            plains.emplace_back(i + 1);
+            plains.back()[i] = i + 1;
+            plains.back()[0] += 1;
+        }
+
+        for (size_t thread_count : { 1, 4 })
+        {
+            encryptor.set_thread_count(thread_count);
+            ASSERT_EQ(thread_count, encryptor.thread_count());
+
+            // Existing ciphertexts are reused and missing ones are created
+            vector<Ciphertext> encrypteds(3);
+            encryptor.encrypt_batch(plains, encrypteds);
+            ASSERT_EQ(plains.size(), encrypteds.size());
+            for (size_t i = 0; i < plains.size(); i++)
+            {
+                ASSERT_TRUE(encrypteds[i].parms_id() == context.first_parms_id());
+                Plaintext plain;
+                decryptor.decrypt(encrypteds[i], plain);
+                ASSERT_TRUE(plains[i] == plain);
+            }
+
+            // Fresh randomness for every ciphertext
+            ASSERT_FALSE(equal(encrypteds[0].data(1), encrypteds[0].data(1) + 64, encrypteds[1].data(1)));
+
+            encryptor.encrypt_batch({}, encrypteds);
+            ASSERT_TRUE(encrypteds.empty());
+        }
+        ASSERT_THROW(encryptor.set_thread_count(0), invalid_argument);
+
+        // Invalid plaintexts are detected before encrypting
+        vector<Ciphertext> encrypteds;
+        plains.emplace_back();
+        plains.back().resize(65);
+        ASSERT_THROW(encryptor.encrypt_batch(plains, encrypteds), invalid_argument);
+
+        Encryptor symmetric_encryptor(context, keygen.secret_key());
+        ASSERT_THROW(symmetric_encryptor.encrypt_batch({ Plaintext("1") }, encrypteds), logic_error);
+    }
+
+    TEST(EncryptorTest, CKKSEncryptBatchDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(slot_size * 2);
+        parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, { 40, 40, 40 }));
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        CKKSEncoder encoder(context);
+        Encryptor encryptor(context, pk);
+        Decryptor decryptor(context, keygen.secret_key());
+        encryptor.set_thread_count(3);
+        const double delta = static_cast<double>(1 << 16);
+
+        // Plaintexts at different levels
+        vector<Plaintext> plains(7);
+        for (size_t i = 0; i < plains.size(); i++)
+        {
+            vector<double> input(slot_size, static_cast<double>(i));
+            auto parms_id = (i % 2) ? context.first_context_data()->next_context_data()->parms_id()
+                                    : context.first_parms_id();
+            encoder.encode(input, parms_id, delta, plains[i]);
+        }
+
+        vector<Ciphertext> encrypteds;
+        encryptor.encrypt_batch(plains, encrypteds);
+        ASSERT_EQ(plains.size(), encrypteds.size());
+        for (size_t i = 0; i < plains.size(); i++)
+        {
+            ASSERT_TRUE(encrypteds[i].parms_id() == plains[i].parms_id());
+            ASSERT_EQ(delta, encrypteds[i].scale());
+
+            Plaintext plain;
+            vector<double> output;
+            decryptor.decrypt(encrypteds[i], plain);
+            encoder.decode(plain, output);
+            for (size_t j = 0; j < slot_size; j++)
+            {
+                ASSERT_NEAR(static_cast<double>(i), output[j], 0.5);
+            }
+        }
+
+        // Plaintexts must be in NTT form
+        Plaintext plain_coeff;
+        plain_coeff.resize(slot_size * 2);
+        plains.push_back(plain_coeff);
+        ASSERT_THROW(encryptor.encrypt_batch(plains, encrypteds), invalid_argument);
+    }
 } // namespace sealtest
@@ -9,9 +9,13 @@
 #include "seal/evaluator.h"
 #include "seal/keygenerator.h"
 #include "seal/modulus.h"
+#include "seal/valcheck.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <ctime>
+#include <functional>
+#include <random>
 #include <string>
 #include "gtest/gtest.h"
 
@@ -1463,6 +1467,93 @@ namespace sealtest
         }
     }
 
+    TEST(EvaluatorTest, BFVEncryptMultiplyDecryptHPS)
+    {
+        auto hps_test = [](size_t poly_modulus_degree, const Modulus &plain_modulus, const vector<int> &bit_sizes) {
+            EncryptionParameters parms(scheme_type::bfv);
+            parms.set_poly_modulus_degree(poly_modulus_degree);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus(CoeffModulus::Create(poly_modulus_degree, bit_sizes));
+
+            SEALContext context(parms, true, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Evaluator evaluator_hps(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            ASSERT_TRUE(context.first_context_data()->rns_tool()->hps_supported());
+            ASSERT_EQ(bfv_mul_type::behz, evaluator_hps.bfv_mul());
+            evaluator_hps.set_bfv_mul(bfv_mul_type::hps);
+            ASSERT_EQ(bfv_mul_type::hps, evaluator_hps.bfv_mul());
+
+            mt19937_64 engine(poly_modulus_degree);
+            auto random_plain = [&]() {
+                Plaintext plain(poly_modulus_degree);
+                for (size_t i = 0; i < poly_modulus_degree; i++)
+                {
+                    plain[i] = engine() % plain_modulus.value();
+                }
+                return plain;
+            };
+
+            // HPS and BEHZ decrypt to the same result with similar noise budgets
+            auto compare = [&](const Ciphertext &encrypted, const Ciphertext &encrypted_hps) {
+                ASSERT_EQ(encrypted.size(), encrypted_hps.size());
+                ASSERT_TRUE(encrypted.parms_id() == encrypted_hps.parms_id());
+                ASSERT_GT(decryptor.invariant_noise_budget(encrypted_hps), 0);
+                ASSERT_GE(
+                    decryptor.invariant_noise_budget(encrypted_hps), decryptor.invariant_noise_budget(encrypted) - 1);
+
+                Plaintext plain, plain_hps;
+                decryptor.decrypt(encrypted, plain);
+                decryptor.decrypt(encrypted_hps, plain_hps);
+                ASSERT_TRUE(plain == plain_hps);
+            };
+
+            Ciphertext encrypted1, encrypted2;
+            encryptor.encrypt(random_plain(), encrypted1);
+            encryptor.encrypt(random_plain(), encrypted2);
+
+            Ciphertext product, product_hps;
+            evaluator.multiply(encrypted1, encrypted2, product);
+            evaluator_hps.multiply(encrypted1, encrypted2, product_hps);
+            compare(product, product_hps);
+
+            Ciphertext square, square_hps;
+            evaluator.square(encrypted1, square);
+            evaluator_hps.square(encrypted1, square_hps);
+            compare(square, square_hps);
+
+            // Larger ciphertexts
+            evaluator.multiply_inplace(product, encrypted2);
+            evaluator_hps.multiply_inplace(product_hps, encrypted2);
+            compare(product, product_hps);
+
+            // Lower levels
+            evaluator.mod_switch_to_next_inplace(encrypted1);
+            evaluator.mod_switch_to_next_inplace(encrypted2);
+            evaluator.multiply(encrypted1, encrypted2, product);
+            evaluator_hps.multiply(encrypted1, encrypted2, product_hps);
+            compare(product, product_hps);
+        };
+
+        hps_test(64, 1 << 6, { 40, 40, 40 });
+        hps_test(128, PlainModulus::Batching(128, 20), { 60, 60, 60 });
+        hps_test(1024, PlainModulus::Batching(1024, 40), { 50, 50, 50, 50, 50 });
+        hps_test(4096, PlainModulus::Batching(4096, 50), { 60, 60, 60, 60, 60 });
+
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(1 << 6);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40 }));
+        SEALContext context(parms, false, sec_level_type::none);
+        Evaluator evaluator(context);
+        ASSERT_THROW(evaluator.set_bfv_mul(static_cast<bfv_mul_type>(2)), invalid_argument);
+    }
+
 #include "seal/randomgen.h"
     TEST(EvaluatorTest, BFVRelinearize)
     {
@@ -1539,6 +1630,134 @@ namespace sealtest
         ASSERT_TRUE(plain2.to_string() == "1x^40 + 8x^30 + 18x^20 + 20x^10 + 10");
     }
 
+    TEST(EvaluatorTest, BFVHybridKeySwitching)
+    {
+        auto hybrid_test = [](size_t special_modulus_size) {
+            EncryptionParameters parms(scheme_type::bfv);
+            Modulus plain_modulus(257);
+            parms.set_poly_modulus_degree(64);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus(CoeffModulus::Create(64, vector<int>(4 + special_modulus_size, 40)));
+            parms.set_special_modulus_size(special_modulus_size);
+
+            SEALContext context(parms, true, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+            RelinKeys rlk;
+            keygen.create_relin_keys(rlk);
+            GaloisKeys glk;
+            keygen.create_galois_keys(glk);
+
+            // One key per digit of special_modulus_size data primes
+            size_t digit_count = (4 + special_modulus_size - 1) / special_modulus_size;
+            ASSERT_EQ(digit_count, rlk.key(2).size());
+            ASSERT_TRUE(is_metadata_valid_for(rlk, context));
+            ASSERT_TRUE(is_valid_for(rlk, context));
+            ASSERT_TRUE(is_metadata_valid_for(glk, context));
+            ASSERT_TRUE(is_valid_for(glk, context));
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            BatchEncoder batch_encoder(context);
+
+            Plaintext plain;
+            vector<uint64_t> plain_vec(64);
+            for (size_t i = 0; i < plain_vec.size(); i++)
+            {
+                plain_vec[i] = i;
+            }
+            batch_encoder.encode(plain_vec, plain);
+            Ciphertext encrypted;
+            encryptor.encrypt(plain, encrypted);
+
+            evaluator.square_inplace(encrypted);
+            evaluator.relinearize_inplace(encrypted, rlk);
+            ASSERT_EQ(size_t(2), encrypted.size());
+            decryptor.decrypt(encrypted, plain);
+            vector<uint64_t> result;
+            batch_encoder.decode(plain, result);
+            for (size_t i = 0; i < plain_vec.size(); i++)
+            {
+                ASSERT_EQ((plain_vec[i] * plain_vec[i]) % 257, result[i]);
+            }
+
+            // Key switching at lower levels uses fewer digits
+            evaluator.mod_switch_to_next_inplace(encrypted);
+            evaluator.rotate_columns_inplace(encrypted, glk);
+            evaluator.rotate_rows_inplace(encrypted, 1, glk);
+            decryptor.decrypt(encrypted, plain);
+            batch_encoder.decode(plain, result);
+            for (size_t i = 0; i < plain_vec.size(); i++)
+            {
+                size_t row = (i < 32) ? 32 : 0;
+                size_t j = row + (i + 1) % 32;
+                ASSERT_EQ((plain_vec[j] * plain_vec[j]) % 257, result[i]);
+            }
+        };
+        hybrid_test(2);
+        hybrid_test(3);
+    }
+
+    TEST(EvaluatorTest, CKKSHybridKeySwitching)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        size_t slot_size = 16;
+        parms.set_poly_modulus_degree(slot_size * 2);
+        parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, { 60, 40, 40, 40, 60, 60 }));
+        parms.set_special_modulus_size(2);
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+        GaloisKeys glk;
+        keygen.create_galois_keys(glk);
+        ASSERT_EQ(size_t(2), rlk.key(2).size());
+        ASSERT_TRUE(is_metadata_valid_for(rlk, context));
+        ASSERT_TRUE(is_valid_for(rlk, context));
+        ASSERT_TRUE(is_metadata_valid_for(glk, context));
+        ASSERT_TRUE(is_valid_for(glk, context));
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        CKKSEncoder encoder(context);
+        const double delta = pow(2.0, 40);
+
+        vector<complex<double>> input(slot_size);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            input[i] = complex<double>(static_cast<double>(i % 7), -static_cast<double>(i % 5));
+        }
+
+        Plaintext plain;
+        Ciphertext encrypted;
+        encoder.encode(input, context.first_parms_id(), delta, plain);
+        encryptor.encrypt(plain, encrypted);
+        evaluator.square_inplace(encrypted);
+        evaluator.relinearize_inplace(encrypted, rlk);
+        evaluator.rescale_to_next_inplace(encrypted);
+
+        int shift = 3;
+        evaluator.rotate_vector_inplace(encrypted, shift, glk);
+        evaluator.complex_conjugate_inplace(encrypted, glk);
+        decryptor.decrypt(encrypted, plain);
+
+        vector<complex<double>> output;
+        encoder.decode(plain, output);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            complex<double> expected = conj(input[(i + static_cast<size_t>(shift)) % slot_size] *
+                                            input[(i + static_cast<size_t>(shift)) % slot_size]);
+            ASSERT_EQ(expected.real(), round(output[i].real()));
+            ASSERT_EQ(expected.imag(), round(output[i].imag()));
+        }
+    }
+
     TEST(EvaluatorTest, CKKSEncryptNaiveMultiplyDecrypt)
     {
         EncryptionParameters parms(scheme_type::ckks);
@@ -1932,6 +2151,136 @@ namespace sealtest
         }
     }
 
+    TEST(EvaluatorTest, CKKSEncryptMultiplyAddConstDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(slot_size * 2);
+        parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, { 60, 40, 40, 60 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        CKKSEncoder encoder(context);
+        const double delta = pow(2.0, 40);
+
+        vector<complex<double>> input(slot_size);
+        for (size_t j = 0; j < slot_size; j++)
+        {
+            input[j] = complex<double>(static_cast<double>(j % 7) - 3.0, static_cast<double>(j % 5) / 2.0 - 1.0);
+        }
+        Plaintext plain;
+        Ciphertext encrypted;
+        encoder.encode(input, delta, plain);
+        encryptor.encrypt(plain, encrypted);
+
+        auto check = [&](const Ciphertext &result, function<complex<double>(complex<double>)> expected) {
+            vector<complex<double>> output;
+            decryptor.decrypt(result, plain);
+            encoder.decode(plain, output);
+            for (size_t j = 0; j < slot_size; j++)
+            {
+                ASSERT_NEAR(expected(input[j]).real(), output[j].real(), 0.001);
+                ASSERT_NEAR(expected(input[j]).imag(), output[j].imag(), 0.001);
+            }
+        };
+
+        Ciphertext result;
+        evaluator.multiply_const(encrypted, -1.5, delta, result);
+        ASSERT_EQ(delta * delta, result.scale());
+        check(result, [](complex<double> x) { return -1.5 * x; });
+
+        complex<double> value(0.75, -2.25);
+        evaluator.multiply_const(encrypted, value, delta, result);
+        check(result, [&](complex<double> x) { return value * x; });
+
+        // The imaginary unit matches the encoder
+        Ciphertext expected;
+        encoder.encode(complex<double>(0.0, 1.0), delta, plain);
+        evaluator.multiply_plain(encrypted, plain, expected);
+        evaluator.multiply_const(encrypted, complex<double>(0.0, 1.0), delta, result);
+        check(result, [](complex<double> x) { return complex<double>(0.0, 1.0) * x; });
+        ASSERT_EQ(expected.scale(), result.scale());
+
+        evaluator.add_const(encrypted, 2.5, result);
+        ASSERT_EQ(delta, result.scale());
+        check(result, [](complex<double> x) { return x + 2.5; });
+
+        evaluator.mod_switch_to_next_inplace(result);
+        evaluator.add_const_inplace(result, value);
+        check(result, [&](complex<double> x) { return x + 2.5 + value; });
+
+        // Scale too large and wrong scheme
+        ASSERT_THROW(evaluator.multiply_const(encrypted, 1.0, pow(2.0, 200), result), invalid_argument);
+        ASSERT_THROW(evaluator.multiply_const(encrypted, uint64_t(1), result), logic_error);
+        ASSERT_THROW(evaluator.add_const(encrypted, uint64_t(1), result), logic_error);
+    }
+
+    TEST(EvaluatorTest, BFVEncryptMultiplyAddConstDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        Modulus plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40 }));
+
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder batch_encoder(context);
+        uint64_t t = plain_modulus.value();
+
+        vector<uint64_t> input(batch_encoder.slot_count());
+        for (size_t j = 0; j < input.size(); j++)
+        {
+            input[j] = (j * 7919) % t;
+        }
+        Plaintext plain;
+        Ciphertext encrypted;
+        batch_encoder.encode(input, plain);
+        encryptor.encrypt(plain, encrypted);
+
+        auto check = [&](const Ciphertext &result, function<uint64_t(uint64_t)> expected) {
+            vector<uint64_t> output;
+            decryptor.decrypt(result, plain);
+            batch_encoder.decode(plain, output);
+            for (size_t j = 0; j < input.size(); j++)
+            {
+                ASSERT_EQ(expected(input[j]), output[j]);
+            }
+        };
+
+        Ciphertext result;
+        evaluator.multiply_const(encrypted, 12345, result);
+        check(result, [&](uint64_t x) { return (x * 12345) % t; });
+
+        // Large constants are multiplied by their negative representative
+        evaluator.multiply_const(encrypted, t - 3, result);
+        check(result, [&](uint64_t x) { return (x * (t - 3)) % t; });
+
+        evaluator.add_const(encrypted, t + 17, result);
+        check(result, [&](uint64_t x) { return (x + 17) % t; });
+
+        evaluator.transform_to_ntt_inplace(encrypted);
+        evaluator.multiply_const_inplace(encrypted, 2);
+        evaluator.transform_from_ntt_inplace(encrypted);
+        check(encrypted, [&](uint64_t x) { return (x * 2) % t; });
+
+        evaluator.transform_to_ntt_inplace(encrypted);
+        ASSERT_THROW(evaluator.add_const_inplace(encrypted, uint64_t(1)), invalid_argument);
+        ASSERT_THROW(evaluator.add_const_inplace(encrypted, 1.0), logic_error);
+    }
+
     TEST(EvaluatorTest, CKKSEncryptMultiplyRelinDecrypt)
     {
         EncryptionParameters parms(scheme_type::ckks);
@@ -3097,107 +3446,412 @@ namespace sealtest
             }
         }
     }
-    TEST(EvaluatorTest, CKKSEncryptRotateDecrypt)
+
+    TEST(EvaluatorTest, BFVEncryptMultiplyRelinRescaleDecrypt)
     {
-        EncryptionParameters parms(scheme_type::ckks);
-        {
-            // Maximal number of slots
-            size_t slot_size = 4;
-            parms.set_poly_modulus_degree(slot_size * 2);
-            parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, { 40, 40, 40, 40 }));
+        auto fused_test = [](size_t special_modulus_size) {
+            EncryptionParameters parms(scheme_type::bfv);
+            Modulus plain_modulus(257);
+            parms.set_poly_modulus_degree(64);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus(CoeffModulus::Create(64, vector<int>(4 + special_modulus_size, 40)));
+            parms.set_special_modulus_size(special_modulus_size);
 
-            SEALContext context(parms, false, sec_level_type::none);
+            SEALContext context(parms, true, sec_level_type::none);
             KeyGenerator keygen(context);
             PublicKey pk;
             keygen.create_public_key(pk);
-            GaloisKeys glk;
-            keygen.create_galois_keys(glk);
+            RelinKeys rlk;
+            keygen.create_relin_keys(rlk);
 
             Encryptor encryptor(context, pk);
             Evaluator evaluator(context);
             Decryptor decryptor(context, keygen.secret_key());
-            CKKSEncoder encoder(context);
-            const double delta = static_cast<double>(1ULL << 30);
+            BatchEncoder batch_encoder(context);
 
-            Ciphertext encrypted;
-            Plaintext plain;
+            vector<uint64_t> plain_vec1(64);
+            vector<uint64_t> plain_vec2(64);
+            for (size_t i = 0; i < plain_vec1.size(); i++)
+            {
+                plain_vec1[i] = i;
+                plain_vec2[i] = (3 * i + 1) % 257;
+            }
+            Plaintext plain1;
+            Plaintext plain2;
+            batch_encoder.encode(plain_vec1, plain1);
+            batch_encoder.encode(plain_vec2, plain2);
+            Ciphertext encrypted1;
+            Ciphertext encrypted2;
+            encryptor.encrypt(plain1, encrypted1);
+            encryptor.encrypt(plain2, encrypted2);
 
-            vector<complex<double>> input{ complex<double>(1, 1), complex<double>(2, 2), complex<double>(3, 3),
-                                           complex<double>(4, 4) };
-            input.resize(slot_size);
+            // Same level and plaintext as the sequential operations
+            Ciphertext expected;
+            evaluator.multiply(encrypted1, encrypted2, expected);
+            evaluator.relinearize_inplace(expected, rlk);
+            evaluator.mod_switch_to_next_inplace(expected);
 
-            vector<complex<double>> output(slot_size, 0);
+            Ciphertext product;
+            evaluator.multiply_relin_rescale(encrypted1, encrypted2, rlk, product);
+            ASSERT_EQ(size_t(2), product.size());
+            ASSERT_TRUE(product.parms_id() == expected.parms_id());
+            ASSERT_FALSE(product.is_ntt_form());
 
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            int shift = 1;
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rotate_vector_inplace(encrypted, shift, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
+            Plaintext plain;
+            vector<uint64_t> result;
+            decryptor.decrypt(product, plain);
+            batch_encoder.decode(plain, result);
+            for (size_t i = 0; i < plain_vec1.size(); i++)
             {
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
+                ASSERT_EQ((plain_vec1[i] * plain_vec2[i]) % 257, result[i]);
             }
+            ASSERT_GE(decryptor.invariant_noise_budget(product) + 1, decryptor.invariant_noise_budget(expected));
 
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            shift = 2;
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rotate_vector_inplace(encrypted, shift, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
+            // Square at the lower level
+            evaluator.multiply_relin_rescale_inplace(product, product, rlk);
+            decryptor.decrypt(product, plain);
+            batch_encoder.decode(plain, result);
+            for (size_t i = 0; i < plain_vec1.size(); i++)
             {
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
+                uint64_t value = (plain_vec1[i] * plain_vec2[i]) % 257;
+                ASSERT_EQ((value * value) % 257, result[i]);
             }
 
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            shift = 3;
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rotate_vector_inplace(encrypted, shift, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
-            {
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
-            }
+            evaluator.mod_switch_to_inplace(product, context.last_parms_id());
+            ASSERT_THROW(evaluator.multiply_relin_rescale_inplace(product, product, rlk), invalid_argument);
+        };
+        fused_test(1);
+        fused_test(2);
+    }
 
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            encryptor.encrypt(plain, encrypted);
-            evaluator.complex_conjugate_inplace(encrypted, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
-            {
-                ASSERT_EQ(input[i].real(), round(output[i].real()));
-                ASSERT_EQ(-input[i].imag(), round(output[i].imag()));
-            }
-        }
-        {
+    TEST(EvaluatorTest, CKKSEncryptMultiplyRelinRescaleFusedDecrypt)
+    {
+        auto fused_test = [](size_t special_modulus_size) {
+            EncryptionParameters parms(scheme_type::ckks);
             size_t slot_size = 32;
-            parms.set_poly_modulus_degree(64);
-            parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+            parms.set_poly_modulus_degree(slot_size * 2);
+            vector<int> bit_sizes{ 60, 40, 40 };
+            bit_sizes.insert(bit_sizes.end(), special_modulus_size, 60);
+            parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, bit_sizes));
+            parms.set_special_modulus_size(special_modulus_size);
 
-            SEALContext context(parms, false, sec_level_type::none);
+            SEALContext context(parms, true, sec_level_type::none);
             KeyGenerator keygen(context);
             PublicKey pk;
             keygen.create_public_key(pk);
-            GaloisKeys glk;
-            keygen.create_galois_keys(glk);
+            RelinKeys rlk;
+            keygen.create_relin_keys(rlk);
 
             Encryptor encryptor(context, pk);
             Evaluator evaluator(context);
             Decryptor decryptor(context, keygen.secret_key());
             CKKSEncoder encoder(context);
-            const double delta = static_cast<double>(1ULL << 30);
+            const double delta = pow(2.0, 40);
 
-            Ciphertext encrypted;
-            Plaintext plain;
+            vector<complex<double>> input1(slot_size);
+            vector<complex<double>> input2(slot_size);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                input1[i] = complex<double>(static_cast<double>(i % 7), -static_cast<double>(i % 5));
+                input2[i] = complex<double>(static_cast<double>(i % 3) - 1.0, static_cast<double>(i % 4));
+            }
+            Plaintext plain1;
+            Plaintext plain2;
+            encoder.encode(input1, delta, plain1);
+            encoder.encode(input2, delta, plain2);
+            Ciphertext encrypted1;
+            Ciphertext encrypted2;
+            encryptor.encrypt(plain1, encrypted1);
+            encryptor.encrypt(plain2, encrypted2);
 
-            vector<complex<double>> input{ complex<double>(1, 1), complex<double>(2, 2), complex<double>(3, 3),
-                                           complex<double>(4, 4) };
+            // Same level and scale as the sequential operations
+            Ciphertext expected;
+            evaluator.multiply(encrypted1, encrypted2, expected);
+            evaluator.relinearize_inplace(expected, rlk);
+            evaluator.rescale_to_next_inplace(expected);
+
+            Ciphertext product;
+            evaluator.multiply_relin_rescale(encrypted1, encrypted2, rlk, product);
+            ASSERT_EQ(size_t(2), product.size());
+            ASSERT_TRUE(product.parms_id() == expected.parms_id());
+            ASSERT_TRUE(product.is_ntt_form());
+            ASSERT_EQ(expected.scale(), product.scale());
+
+            Plaintext plain;
+            vector<complex<double>> output;
+            vector<complex<double>> expected_output;
+            decryptor.decrypt(product, plain);
+            encoder.decode(plain, output);
+            decryptor.decrypt(expected, plain);
+            encoder.decode(plain, expected_output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                complex<double> value = input1[i] * input2[i];
+                ASSERT_NEAR(value.real(), output[i].real(), 0.001);
+                ASSERT_NEAR(value.imag(), output[i].imag(), 0.001);
+                ASSERT_NEAR(expected_output[i].real(), output[i].real(), 0.001);
+                ASSERT_NEAR(expected_output[i].imag(), output[i].imag(), 0.001);
+            }
+
+            // Square at the lower level
+            evaluator.multiply_relin_rescale_inplace(product, product, rlk);
+            decryptor.decrypt(product, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                complex<double> value = input1[i] * input2[i] * input1[i] * input2[i];
+                ASSERT_NEAR(value.real(), output[i].real(), 0.01);
+                ASSERT_NEAR(value.imag(), output[i].imag(), 0.01);
+            }
+            ASSERT_TRUE(product.parms_id() == context.last_parms_id());
+            ASSERT_THROW(evaluator.multiply_relin_rescale_inplace(product, product, rlk), invalid_argument);
+        };
+        fused_test(1);
+        fused_test(2);
+    }
+
+    TEST(EvaluatorTest, BFVEncryptInnerProductDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        Modulus plain_modulus(257);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder batch_encoder(context);
+
+        size_t term_count = 5;
+        vector<Ciphertext> encrypteds1(term_count);
+        vector<Ciphertext> encrypteds2(term_count);
+        vector<uint64_t> expected(64, 0);
+        for (size_t i = 0; i < term_count; i++)
+        {
+            vector<uint64_t> plain_vec1(64);
+            vector<uint64_t> plain_vec2(64);
+            for (size_t j = 0; j < 64; j++)
+            {
+                plain_vec1[j] = (i * 64 + j) % 257;
+                plain_vec2[j] = (5 * i + 3 * j + 1) % 257;
+                expected[j] = (expected[j] + plain_vec1[j] * plain_vec2[j]) % 257;
+            }
+            Plaintext plain;
+            batch_encoder.encode(plain_vec1, plain);
+            encryptor.encrypt(plain, encrypteds1[i]);
+            batch_encoder.encode(plain_vec2, plain);
+            encryptor.encrypt(plain, encrypteds2[i]);
+        }
+
+        Ciphertext encrypted;
+        evaluator.inner_product(encrypteds1, encrypteds2, rlk, encrypted);
+        ASSERT_EQ(size_t(2), encrypted.size());
+        ASSERT_TRUE(encrypted.parms_id() == encrypteds1[0].parms_id());
+
+        Plaintext plain;
+        vector<uint64_t> result;
+        decryptor.decrypt(encrypted, plain);
+        batch_encoder.decode(plain, result);
+        ASSERT_TRUE(expected == result);
+
+        // A single term is a relinearized product
+        evaluator.inner_product({ encrypteds1[0] }, { encrypteds2[0] }, rlk, encrypted);
+        Ciphertext product;
+        evaluator.multiply(encrypteds1[0], encrypteds2[0], product);
+        evaluator.relinearize_inplace(product, rlk);
+        decryptor.decrypt(encrypted, plain);
+        batch_encoder.decode(plain, result);
+        vector<uint64_t> product_result;
+        decryptor.decrypt(product, plain);
+        batch_encoder.decode(plain, product_result);
+        ASSERT_TRUE(product_result == result);
+
+        ASSERT_THROW(evaluator.inner_product({}, {}, rlk, encrypted), invalid_argument);
+        ASSERT_THROW(evaluator.inner_product(encrypteds1, { encrypteds2[0] }, rlk, encrypted), invalid_argument);
+        ASSERT_THROW(evaluator.inner_product(encrypteds1, encrypteds2, rlk, encrypteds1[1]), invalid_argument);
+    }
+
+    TEST(EvaluatorTest, CKKSEncryptInnerProductDecrypt)
+    {
+        auto inner_product_test = [](size_t special_modulus_size) {
+            EncryptionParameters parms(scheme_type::ckks);
+            size_t slot_size = 32;
+            parms.set_poly_modulus_degree(slot_size * 2);
+            vector<int> bit_sizes{ 60, 40, 40 };
+            bit_sizes.insert(bit_sizes.end(), special_modulus_size, 60);
+            parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, bit_sizes));
+            parms.set_special_modulus_size(special_modulus_size);
+
+            SEALContext context(parms, true, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+            RelinKeys rlk;
+            keygen.create_relin_keys(rlk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            CKKSEncoder encoder(context);
+            const double delta = pow(2.0, 40);
+
+            size_t term_count = 6;
+            vector<Ciphertext> encrypteds1(term_count);
+            vector<Ciphertext> encrypteds2(term_count);
+            vector<complex<double>> expected(slot_size, 0.0);
+            for (size_t i = 0; i < term_count; i++)
+            {
+                vector<complex<double>> input1(slot_size);
+                vector<complex<double>> input2(slot_size);
+                for (size_t j = 0; j < slot_size; j++)
+                {
+                    input1[j] = complex<double>(static_cast<double>((i + j) % 7) - 3.0, static_cast<double>(j % 3));
+                    input2[j] = complex<double>(static_cast<double>((i * j) % 5) / 2.0, -static_cast<double>(i % 2));
+                    expected[j] += input1[j] * input2[j];
+                }
+                Plaintext plain;
+                encoder.encode(input1, delta, plain);
+                encryptor.encrypt(plain, encrypteds1[i]);
+                encoder.encode(input2, delta, plain);
+                encryptor.encrypt(plain, encrypteds2[i]);
+            }
+
+            Ciphertext encrypted;
+            evaluator.inner_product(encrypteds1, encrypteds2, rlk, encrypted);
+            ASSERT_EQ(size_t(2), encrypted.size());
+            ASSERT_TRUE(encrypted.parms_id() == context.first_context_data()->next_context_data()->parms_id());
+            double q_last = static_cast<double>(context.first_context_data()->parms().coeff_modulus().back().value());
+            ASSERT_EQ(delta * delta / q_last, encrypted.scale());
+
+            Plaintext plain;
+            vector<complex<double>> output;
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t j = 0; j < slot_size; j++)
+            {
+                ASSERT_NEAR(expected[j].real(), output[j].real(), 0.001);
+                ASSERT_NEAR(expected[j].imag(), output[j].imag(), 0.001);
+            }
+
+            // No level is left for the rescale
+            evaluator.mod_switch_to_inplace(encrypteds1[0], context.last_parms_id());
+            evaluator.mod_switch_to_inplace(encrypteds2[0], context.last_parms_id());
+            ASSERT_THROW(
+                evaluator.inner_product({ encrypteds1[0] }, { encrypteds2[0] }, rlk, encrypted), invalid_argument);
+        };
+        inner_product_test(1);
+        inner_product_test(2);
+    }
+
+    TEST(EvaluatorTest, CKKSEncryptRotateDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        {
+            // Maximal number of slots
+            size_t slot_size = 4;
+            parms.set_poly_modulus_degree(slot_size * 2);
+            parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, { 40, 40, 40, 40 }));
+
+            SEALContext context(parms, false, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+            GaloisKeys glk;
+            keygen.create_galois_keys(glk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            CKKSEncoder encoder(context);
+            const double delta = static_cast<double>(1ULL << 30);
+
+            Ciphertext encrypted;
+            Plaintext plain;
+
+            vector<complex<double>> input{ complex<double>(1, 1), complex<double>(2, 2), complex<double>(3, 3),
+                                           complex<double>(4, 4) };
+            input.resize(slot_size);
+
+            vector<complex<double>> output(slot_size, 0);
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            int shift = 1;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rotate_vector_inplace(encrypted, shift, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
+            }
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            shift = 2;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rotate_vector_inplace(encrypted, shift, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
+            }
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            shift = 3;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rotate_vector_inplace(encrypted, shift, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
+            }
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            encryptor.encrypt(plain, encrypted);
+            evaluator.complex_conjugate_inplace(encrypted, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(input[i].real(), round(output[i].real()));
+                ASSERT_EQ(-input[i].imag(), round(output[i].imag()));
+            }
+        }
+        {
+            size_t slot_size = 32;
+            parms.set_poly_modulus_degree(64);
+            parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+
+            SEALContext context(parms, false, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+            GaloisKeys glk;
+            keygen.create_galois_keys(glk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            CKKSEncoder encoder(context);
+            const double delta = static_cast<double>(1ULL << 30);
+
+            Ciphertext encrypted;
+            Plaintext plain;
+
+            vector<complex<double>> input{ complex<double>(1, 1), complex<double>(2, 2), complex<double>(3, 3),
+                                           complex<double>(4, 4) };
             input.resize(slot_size);
 
             vector<complex<double>> output(slot_size, 0);
@@ -3280,137 +3934,615 @@ namespace sealtest
                                            complex<double>(4, 4) };
             input.resize(slot_size);
 
-            vector<complex<double>> output(slot_size, 0);
+            vector<complex<double>> output(slot_size, 0);
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            int shift = 1;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rescale_to_next_inplace(encrypted);
+            evaluator.rotate_vector_inplace(encrypted, shift, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
+            }
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            shift = 2;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rescale_to_next_inplace(encrypted);
+            evaluator.rotate_vector_inplace(encrypted, shift, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
+            }
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            shift = 3;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rescale_to_next_inplace(encrypted);
+            evaluator.rotate_vector_inplace(encrypted, shift, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
+                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
+            }
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rescale_to_next_inplace(encrypted);
+            evaluator.complex_conjugate_inplace(encrypted, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(input[i].real(), round(output[i].real()));
+                ASSERT_EQ(-input[i].imag(), round(output[i].imag()));
+            }
+        }
+        {
+            size_t slot_size = 32;
+            parms.set_poly_modulus_degree(64);
+            parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+
+            SEALContext context(parms, true, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+            GaloisKeys glk;
+            keygen.create_galois_keys(glk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            CKKSEncoder encoder(context);
+            const double delta = pow(2, 70);
+
+            Ciphertext encrypted;
+            Plaintext plain;
+
+            vector<complex<double>> input{ complex<double>(1, 1), complex<double>(2, 2), complex<double>(3, 3),
+                                           complex<double>(4, 4) };
+            input.resize(slot_size);
+
+            vector<complex<double>> output(slot_size, 0);
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            int shift = 1;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rescale_to_next_inplace(encrypted);
+            evaluator.rotate_vector_inplace(encrypted, shift, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].real()), round(output[i].real()));
+                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].imag()), round(output[i].imag()));
+            }
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            shift = 2;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rescale_to_next_inplace(encrypted);
+            evaluator.rotate_vector_inplace(encrypted, shift, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].real()), round(output[i].real()));
+                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].imag()), round(output[i].imag()));
+            }
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            shift = 3;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rescale_to_next_inplace(encrypted);
+            evaluator.rotate_vector_inplace(encrypted, shift, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].real()), round(output[i].real()));
+                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].imag()), round(output[i].imag()));
+            }
+
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            encryptor.encrypt(plain, encrypted);
+            evaluator.rescale_to_next_inplace(encrypted);
+            evaluator.complex_conjugate_inplace(encrypted, glk);
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(round(input[i].real()), round(output[i].real()));
+                ASSERT_EQ(round(-input[i].imag()), round(output[i].imag()));
+            }
+        }
+    }
+
+    TEST(EvaluatorTest, CKKSEncryptRotateManyDecrypt)
+    {
+        auto rotate_many_test = [](size_t special_modulus_size) {
+            EncryptionParameters parms(scheme_type::ckks);
+            size_t slot_size = 16;
+            parms.set_poly_modulus_degree(slot_size * 2);
+            parms.set_coeff_modulus(
+                CoeffModulus::Create(slot_size * 2, vector<int>(3 + special_modulus_size, 50)));
+            parms.set_special_modulus_size(special_modulus_size);
+
+            SEALContext context(parms, true, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+
+            // Step 3 has no Galois key and falls back to rotations by 4 and -1
+            vector<int> steps{ 1, 0, -1, 2, 4, 3 };
+            GaloisKeys glk;
+            keygen.create_galois_keys(vector<int>{ 1, -1, 2, 4 }, glk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            CKKSEncoder encoder(context);
+            const double delta = pow(2.0, 30);
+
+            vector<complex<double>> input(slot_size);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                input[i] = complex<double>(static_cast<double>(i), static_cast<double>(slot_size - i));
+            }
+
+            Plaintext plain;
+            Ciphertext encrypted;
+            encoder.encode(input, context.first_parms_id(), delta, plain);
+            encryptor.encrypt(plain, encrypted);
+
+            // Also rotate at a lower level
+            for (size_t level = 0; level < 2; level++)
+            {
+                vector<Ciphertext> rotated;
+                evaluator.rotate_vector_many(encrypted, steps, glk, rotated);
+                ASSERT_EQ(steps.size(), rotated.size());
+
+                vector<complex<double>> output;
+                for (size_t j = 0; j < steps.size(); j++)
+                {
+                    ASSERT_TRUE(rotated[j].parms_id() == encrypted.parms_id());
+                    decryptor.decrypt(rotated[j], plain);
+                    encoder.decode(plain, output);
+                    size_t shift = static_cast<size_t>(steps[j] + static_cast<int>(slot_size));
+                    for (size_t i = 0; i < slot_size; i++)
+                    {
+                        ASSERT_EQ(input[(i + shift) % slot_size].real(), round(output[i].real()));
+                        ASSERT_EQ(input[(i + shift) % slot_size].imag(), round(output[i].imag()));
+                    }
+                }
+                evaluator.mod_switch_to_next_inplace(encrypted);
+            }
+        };
+        rotate_many_test(1);
+        rotate_many_test(2);
+    }
+
+    TEST(EvaluatorTest, BFVMultiplyPlainMatrix)
+    {
+        auto matrix_test = [](size_t special_modulus_size) {
+            EncryptionParameters parms(scheme_type::bfv);
+            Modulus plain_modulus(257);
+            parms.set_poly_modulus_degree(64);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus(CoeffModulus::Create(64, vector<int>(3 + special_modulus_size, 40)));
+            parms.set_special_modulus_size(special_modulus_size);
+
+            SEALContext context(parms, true, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            BatchEncoder encoder(context);
+            size_t row_size = encoder.slot_count() / 2;
+
+            vector<uint64_t> input(encoder.slot_count());
+            for (size_t i = 0; i < input.size(); i++)
+            {
+                input[i] = (i * 7 + 3) % plain_modulus.value();
+            }
+            Plaintext plain;
+            Ciphertext encrypted;
+            encoder.encode(input, plain);
+            encryptor.encrypt(plain, encrypted);
+
+            for (size_t diagonal_count : { size_t(1), size_t(7), row_size })
+            {
+                GaloisKeys glk;
+                keygen.create_galois_keys(evaluator.multiply_plain_matrix_galois_elts(diagonal_count), glk);
+
+                vector<vector<uint64_t>> diagonal_values(diagonal_count);
+                vector<Plaintext> diagonals(diagonal_count);
+                for (size_t d = 0; d < diagonal_count; d++)
+                {
+                    diagonal_values[d].resize(encoder.slot_count());
+                    for (size_t j = 0; j < encoder.slot_count(); j++)
+                    {
+                        diagonal_values[d][j] = (d * 31 + j * 5 + 1) % plain_modulus.value();
+                    }
+                    encoder.encode(diagonal_values[d], diagonals[d]);
+                    evaluator.transform_to_ntt_inplace(diagonals[d], encrypted.parms_id());
+                }
+
+                Ciphertext product;
+                evaluator.multiply_plain_matrix(encrypted, diagonals, glk, product);
+                ASSERT_TRUE(product.parms_id() == encrypted.parms_id());
+                ASSERT_FALSE(product.is_ntt_form());
+
+                vector<uint64_t> output;
+                decryptor.decrypt(product, plain);
+                encoder.decode(plain, output);
+                for (size_t j = 0; j < encoder.slot_count(); j++)
+                {
+                    size_t row_begin = j - j % row_size;
+                    uint64_t expected = 0;
+                    for (size_t d = 0; d < diagonal_count; d++)
+                    {
+                        uint64_t value = input[row_begin + (j + d) % row_size];
+                        expected = (expected + diagonal_values[d][j] * value) % plain_modulus.value();
+                    }
+                    ASSERT_EQ(expected, output[j]);
+                }
+            }
+
+            // Missing Galois keys
+            GaloisKeys glk;
+            keygen.create_galois_keys(vector<int>{ 1 }, glk);
+            vector<Plaintext> diagonals(16, plain);
+            for (auto &diagonal : diagonals)
+            {
+                evaluator.transform_to_ntt_inplace(diagonal, encrypted.parms_id());
+            }
+            Ciphertext product;
+            ASSERT_THROW(evaluator.multiply_plain_matrix(encrypted, diagonals, glk, product), invalid_argument);
+            ASSERT_THROW(evaluator.multiply_plain_matrix(encrypted, {}, glk, product), invalid_argument);
+            ASSERT_THROW(evaluator.multiply_plain_matrix(encrypted, { plain }, glk, product), invalid_argument);
+        };
+        matrix_test(1);
+        matrix_test(2);
+    }
+
+    TEST(EvaluatorTest, CKKSMultiplyPlainMatrix)
+    {
+        auto matrix_test = [](size_t special_modulus_size) {
+            EncryptionParameters parms(scheme_type::ckks);
+            size_t slot_size = 32;
+            parms.set_poly_modulus_degree(slot_size * 2);
+            parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, vector<int>(3 + special_modulus_size, 50)));
+            parms.set_special_modulus_size(special_modulus_size);
+
+            SEALContext context(parms, true, sec_level_type::none);
+            KeyGenerator keygen(context);
+            PublicKey pk;
+            keygen.create_public_key(pk);
+
+            Encryptor encryptor(context, pk);
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            CKKSEncoder encoder(context);
+
+            vector<double> input(slot_size);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                input[i] = static_cast<double>(i % 5);
+            }
+            Plaintext plain;
+            Ciphertext encrypted;
+            encoder.encode(input, context.first_parms_id(), pow(2.0, 30), plain);
+            encryptor.encrypt(plain, encrypted);
+
+            // Also multiply at a lower level
+            for (size_t level = 0; level < 2; level++)
+            {
+                for (size_t diagonal_count : { size_t(1), size_t(6), slot_size })
+                {
+                    GaloisKeys glk;
+                    keygen.create_galois_keys(evaluator.multiply_plain_matrix_galois_elts(diagonal_count), glk);
+
+                    vector<vector<double>> diagonal_values(diagonal_count);
+                    vector<Plaintext> diagonals(diagonal_count);
+                    for (size_t d = 0; d < diagonal_count; d++)
+                    {
+                        diagonal_values[d].resize(slot_size);
+                        for (size_t j = 0; j < slot_size; j++)
+                        {
+                            diagonal_values[d][j] = static_cast<double>((d + 2 * j) % 7) - 3.0;
+                        }
+                        encoder.encode(diagonal_values[d], encrypted.parms_id(), pow(2.0, 20), diagonals[d]);
+                    }
+
+                    Ciphertext product;
+                    evaluator.multiply_plain_matrix(encrypted, diagonals, glk, product);
+                    ASSERT_TRUE(product.parms_id() == encrypted.parms_id());
+
+                    vector<double> output;
+                    decryptor.decrypt(product, plain);
+                    encoder.decode(plain, output);
+                    for (size_t j = 0; j < slot_size; j++)
+                    {
+                        double expected = 0.0;
+                        for (size_t d = 0; d < diagonal_count; d++)
+                        {
+                            expected += diagonal_values[d][j] * input[(j + d) % slot_size];
+                        }
+                        ASSERT_EQ(expected, round(output[j]));
+                    }
+                }
+                evaluator.mod_switch_to_next_inplace(encrypted);
+            }
+        };
+        matrix_test(1);
+        matrix_test(2);
+    }
+
+    TEST(EvaluatorTest, BFVSumSlots)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        Modulus plain_modulus(257);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40 }));
+
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder encoder(context);
+        size_t slot_count = encoder.slot_count();
+
+        // Powers of two only use the rotate-and-add ladder; sum_slots_galois_elts adds the steps 3s for hoisting
+        GaloisKeys glk_ladder;
+        keygen.create_galois_keys(glk_ladder);
+        GaloisKeys glk_hoisted;
+        keygen.create_galois_keys(evaluator.sum_slots_galois_elts(slot_count), glk_hoisted);
+        size_t row_size = slot_count / 2;
+
+        vector<uint64_t> input(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            input[i] = (i * 11 + 5) % plain_modulus.value();
+        }
+        Plaintext plain;
+        Ciphertext encrypted;
+        encoder.encode(input, plain);
+        encryptor.encrypt(plain, encrypted);
+
+        for (auto glk : { &glk_ladder, &glk_hoisted })
+        {
+            for (size_t block_width = 1; block_width <= slot_count; block_width <<= 1)
+            {
+                Ciphertext summed;
+                evaluator.sum_slots(encrypted, block_width, *glk, summed);
+
+                vector<uint64_t> output;
+                decryptor.decrypt(summed, plain);
+                encoder.decode(plain, output);
+                for (size_t j = 0; j < slot_count; j++)
+                {
+                    uint64_t expected = 0;
+                    if (block_width == slot_count)
+                    {
+                        for (auto value : input)
+                        {
+                            expected += value;
+                        }
+                    }
+                    else
+                    {
+                        size_t row_begin = j - j % row_size;
+                        for (size_t i = 0; i < block_width; i++)
+                        {
+                            expected += input[row_begin + (j + i) % row_size];
+                        }
+                    }
+                    ASSERT_EQ(expected % plain_modulus.value(), output[j]);
+                }
+            }
+        }
+
+        ASSERT_THROW(evaluator.sum_slots_inplace(encrypted, 3, glk_ladder), invalid_argument);
+        ASSERT_THROW(evaluator.sum_slots_inplace(encrypted, 2 * slot_count, glk_ladder), invalid_argument);
+    }
+
+    TEST(EvaluatorTest, BFVSumSlotsHoisting)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        Modulus plain_modulus(257);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40 }));
+
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder encoder(context);
+        size_t slot_count = encoder.slot_count();
+        auto galois_tool = context.key_context_data()->galois_tool();
+
+        // Steps 1, 2, 3, 4, 8, 12, 16 for a row of 32 slots, and the row swap
+        auto galois_elts = evaluator.sum_slots_galois_elts(slot_count);
+        ASSERT_EQ(galois_tool->get_elts_from_steps({ 1, 2, 3, 4, 8, 12, 16, 0 }), galois_elts);
+        ASSERT_EQ(galois_tool->get_elts_from_steps({ 1 }), evaluator.sum_slots_galois_elts(2));
+        ASSERT_THROW(auto elts = evaluator.sum_slots_galois_elts(3), invalid_argument);
+        ASSERT_THROW(auto elts = evaluator.sum_slots_galois_elts(2 * slot_count), invalid_argument);
+
+        // The same keys without the steps 3s only run the ladder
+        GaloisKeys glk_hoisted;
+        keygen.create_galois_keys(galois_elts, glk_hoisted);
+        GaloisKeys glk_ladder = glk_hoisted;
+        for (auto galois_elt : galois_tool->get_elts_from_steps({ 3, 12 }))
+        {
+            glk_ladder.data()[GaloisKeys::get_index(galois_elt)].clear();
+        }
+        ASSERT_FALSE(glk_ladder.has_key(galois_tool->get_elt_from_step(3)));
+
+        vector<uint64_t> input(slot_count);
+        for (size_t i = 0; i < slot_count; i++)
+        {
+            input[i] = (i * 7 + 3) % plain_modulus.value();
+        }
+        Plaintext plain;
+        Ciphertext encrypted;
+        encoder.encode(input, plain);
+        encryptor.encrypt(plain, encrypted);
+
+        for (size_t block_width = 1; block_width <= slot_count; block_width <<= 1)
+        {
+            Ciphertext hoisted;
+            Ciphertext ladder;
+            evaluator.sum_slots(encrypted, block_width, glk_hoisted, hoisted);
+            evaluator.sum_slots(encrypted, block_width, glk_ladder, ladder);
+
+            // Hoisted steps switch keys differently, so the ciphertexts differ exactly when a step was hoisted
+            bool identical = equal(hoisted.data(), hoisted.data() + hoisted.dyn_array().size(), ladder.data());
+            ASSERT_EQ(block_width < 4, identical);
+
+            vector<uint64_t> hoisted_output;
+            vector<uint64_t> ladder_output;
+            decryptor.decrypt(hoisted, plain);
+            encoder.decode(plain, hoisted_output);
+            decryptor.decrypt(ladder, plain);
+            encoder.decode(plain, ladder_output);
+            ASSERT_EQ(ladder_output, hoisted_output);
+        }
+    }
+
+    TEST(EvaluatorTest, CKKSSumSlots)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(slot_size * 2);
+        parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, { 50, 50, 50, 50 }));
+        parms.set_special_modulus_size(2);
+
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        GaloisKeys glk_ladder;
+        keygen.create_galois_keys(glk_ladder);
+        GaloisKeys glk_hoisted;
+        keygen.create_galois_keys(vector<int>{ 1, 2, 3, 4, 8, 12, 16 }, glk_hoisted);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        CKKSEncoder encoder(context);
 
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            int shift = 1;
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rescale_to_next_inplace(encrypted);
-            evaluator.rotate_vector_inplace(encrypted, shift, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
-            {
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
-            }
+        vector<double> input(slot_size);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            input[i] = static_cast<double>(i % 9);
+        }
+        Plaintext plain;
+        Ciphertext encrypted;
+        encoder.encode(input, context.first_parms_id(), pow(2.0, 30), plain);
+        encryptor.encrypt(plain, encrypted);
 
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            shift = 2;
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rescale_to_next_inplace(encrypted);
-            evaluator.rotate_vector_inplace(encrypted, shift, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
+        for (auto glk : { &glk_ladder, &glk_hoisted })
+        {
+            for (size_t block_width = 1; block_width <= slot_size; block_width <<= 1)
             {
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
-            }
+                Ciphertext summed = encrypted;
+                evaluator.sum_slots_inplace(summed, block_width, *glk);
 
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            shift = 3;
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rescale_to_next_inplace(encrypted);
-            evaluator.rotate_vector_inplace(encrypted, shift, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
-            {
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].real(), round(output[i].real()));
-                ASSERT_EQ(input[(i + static_cast<size_t>(shift)) % slot_size].imag(), round(output[i].imag()));
+                vector<double> output;
+                decryptor.decrypt(summed, plain);
+                encoder.decode(plain, output);
+                for (size_t j = 0; j < slot_size; j++)
+                {
+                    double expected = 0.0;
+                    for (size_t i = 0; i < block_width; i++)
+                    {
+                        expected += input[(j + i) % slot_size];
+                    }
+                    ASSERT_EQ(expected, round(output[j]));
+                }
             }
+        }
 
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rescale_to_next_inplace(encrypted);
-            evaluator.complex_conjugate_inplace(encrypted, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
+        ASSERT_THROW(evaluator.sum_slots_inplace(encrypted, 2 * slot_size, glk_ladder), invalid_argument);
+    }
+
+    TEST(EvaluatorTest, MultithreadedKeySwitching)
+    {
+        auto threads_test = [](scheme_type scheme, size_t special_modulus_size) {
+            EncryptionParameters parms(scheme);
+            parms.set_poly_modulus_degree(64);
+            if (scheme == scheme_type::bfv)
             {
-                ASSERT_EQ(input[i].real(), round(output[i].real()));
-                ASSERT_EQ(-input[i].imag(), round(output[i].imag()));
+                parms.set_plain_modulus(257);
             }
-        }
-        {
-            size_t slot_size = 32;
-            parms.set_poly_modulus_degree(64);
-            parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+            parms.set_coeff_modulus(CoeffModulus::Create(64, vector<int>(4 + special_modulus_size, 40)));
+            parms.set_special_modulus_size(special_modulus_size);
 
             SEALContext context(parms, true, sec_level_type::none);
             KeyGenerator keygen(context);
             PublicKey pk;
             keygen.create_public_key(pk);
+            RelinKeys rlk;
+            keygen.create_relin_keys(rlk);
             GaloisKeys glk;
-            keygen.create_galois_keys(glk);
+            keygen.create_galois_keys(vector<int>{ 1 }, glk);
 
             Encryptor encryptor(context, pk);
             Evaluator evaluator(context);
-            Decryptor decryptor(context, keygen.secret_key());
-            CKKSEncoder encoder(context);
-            const double delta = pow(2, 70);
-
-            Ciphertext encrypted;
-            Plaintext plain;
-
-            vector<complex<double>> input{ complex<double>(1, 1), complex<double>(2, 2), complex<double>(3, 3),
-                                           complex<double>(4, 4) };
-            input.resize(slot_size);
-
-            vector<complex<double>> output(slot_size, 0);
-
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            int shift = 1;
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rescale_to_next_inplace(encrypted);
-            evaluator.rotate_vector_inplace(encrypted, shift, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
-            {
-                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].real()), round(output[i].real()));
-                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].imag()), round(output[i].imag()));
-            }
-
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            shift = 2;
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rescale_to_next_inplace(encrypted);
-            evaluator.rotate_vector_inplace(encrypted, shift, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
-            {
-                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].real()), round(output[i].real()));
-                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].imag()), round(output[i].imag()));
-            }
+            Evaluator evaluator_mt(context);
+            ASSERT_THROW(evaluator_mt.set_thread_count(0), invalid_argument);
+            evaluator_mt.set_thread_count(4);
+            ASSERT_EQ(size_t(4), evaluator_mt.thread_count());
 
-            encoder.encode(input, context.first_parms_id(), delta, plain);
-            shift = 3;
-            encryptor.encrypt(plain, encrypted);
-            evaluator.rescale_to_next_inplace(encrypted);
-            evaluator.rotate_vector_inplace(encrypted, shift, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
+            Plaintext plain("1x^10 + 2x^3 + 3");
+            if (scheme == scheme_type::ckks)
             {
-                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].real()), round(output[i].real()));
-                ASSERT_EQ(round(input[(i + static_cast<size_t>(shift)) % slot_size].imag()), round(output[i].imag()));
+                CKKSEncoder encoder(context);
+                encoder.encode(1.5, pow(2.0, 20), plain);
             }
-
-            encoder.encode(input, context.first_parms_id(), delta, plain);
+            Ciphertext encrypted;
             encryptor.encrypt(plain, encrypted);
-            evaluator.rescale_to_next_inplace(encrypted);
-            evaluator.complex_conjugate_inplace(encrypted, glk);
-            decryptor.decrypt(encrypted, plain);
-            encoder.decode(plain, output);
-            for (size_t i = 0; i < slot_size; i++)
-            {
-                ASSERT_EQ(round(input[i].real()), round(output[i].real()));
-                ASSERT_EQ(round(-input[i].imag()), round(output[i].imag()));
-            }
-        }
+            evaluator.square_inplace(encrypted);
+
+            // Results must be bit-identical to single-threaded execution
+            Ciphertext result;
+            Ciphertext result_mt;
+            evaluator.relinearize(encrypted, rlk, result);
+            evaluator_mt.relinearize(encrypted, rlk, result_mt);
+            ASSERT_TRUE(equal(result.data(), result.data() + result.dyn_array().size(), result_mt.data()));
+
+            evaluator.apply_galois(result, 3, glk, encrypted);
+            evaluator_mt.apply_galois(result, 3, glk, result_mt);
+            ASSERT_TRUE(equal(encrypted.data(), encrypted.data() + encrypted.dyn_array().size(), result_mt.data()));
+        };
+        threads_test(scheme_type::bfv, 1);
+        threads_test(scheme_type::bfv, 2);
+        threads_test(scheme_type::ckks, 1);
+        threads_test(scheme_type::ckks, 3);
     }
 
     TEST(EvaluatorTest, BFVEncryptSquareDecrypt)
@@ -3646,6 +4778,263 @@ namespace sealtest
         ASSERT_TRUE(encrypted.parms_id() == context.first_parms_id());
     }
 
+    TEST(EvaluatorTest, BFVEncryptMultiplyManyThreadsDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        Modulus plain_modulus(1 << 6);
+        parms.set_poly_modulus_degree(128);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus(CoeffModulus::Create(128, { 50, 50, 50, 50 }));
+
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Evaluator evaluator_mt(context);
+        evaluator_mt.set_thread_count(4);
+        Decryptor decryptor(context, keygen.secret_key());
+
+        vector<Ciphertext> encrypteds(7);
+        for (size_t i = 0; i < encrypteds.size(); i++)
+        {
+            Plaintext plain("1x^1 + " + to_string(i + 1));
+            encryptor.encrypt(plain, encrypteds[i]);
+        }
+
+        // The parallel product tree gives the same result as the sequential one
+        Ciphertext product;
+        Ciphertext product_mt;
+        evaluator.multiply_many(encrypteds, rlk, product);
+        evaluator_mt.multiply_many(encrypteds, rlk, product_mt);
+        ASSERT_EQ(product.size(), product_mt.size());
+        ASSERT_TRUE(equal(product.data(), product.data() + product.dyn_array().size(), product_mt.data()));
+
+        Plaintext plain;
+        decryptor.decrypt(product_mt, plain);
+        ASSERT_EQ(plain.to_string(), "1x^7 + 1Cx^6 + 2x^5 + 28x^4 + 31x^3 + Cx^2 + Cx^1 + 30");
+
+        evaluator_mt.exponentiate(encrypteds[0], 5, rlk, product_mt);
+        decryptor.decrypt(product_mt, plain);
+        ASSERT_EQ(plain.to_string(), "1x^5 + 5x^4 + Ax^3 + Ax^2 + 5x^1 + 1");
+    }
+
+    TEST(EvaluatorTest, CKKSEncryptMultiplyManyDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(slot_size * 2);
+        parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, { 60, 40, 40, 40, 60 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Evaluator evaluator_mt(context);
+        evaluator_mt.set_thread_count(3);
+        Decryptor decryptor(context, keygen.secret_key());
+        CKKSEncoder encoder(context);
+        const double delta = pow(2.0, 40);
+
+        vector<vector<complex<double>>> inputs(5, vector<complex<double>>(slot_size));
+        vector<complex<double>> expected(slot_size, 1.0);
+        vector<Ciphertext> encrypteds(inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            for (size_t j = 0; j < slot_size; j++)
+            {
+                inputs[i][j] = complex<double>(
+                    1.0 + static_cast<double>((i + j) % 4) / 4.0, static_cast<double>((i * j) % 3) / 4.0 - 0.25);
+                expected[j] *= inputs[i][j];
+            }
+            Plaintext plain;
+            encoder.encode(inputs[i], delta, plain);
+            encryptor.encrypt(plain, encrypteds[i]);
+        }
+
+        // The odd ciphertext out is at a higher level than the product it is multiplied with
+        for (auto &each_evaluator : { &evaluator, &evaluator_mt })
+        {
+            Ciphertext product;
+            each_evaluator->multiply_many(encrypteds, rlk, product);
+            ASSERT_EQ(size_t(2), product.size());
+            ASSERT_TRUE(product.parms_id() == context.last_parms_id());
+
+            Plaintext plain;
+            vector<complex<double>> output;
+            decryptor.decrypt(product, plain);
+            encoder.decode(plain, output);
+            for (size_t j = 0; j < slot_size; j++)
+            {
+                ASSERT_NEAR(expected[j].real(), output[j].real(), 0.01);
+                ASSERT_NEAR(expected[j].imag(), output[j].imag(), 0.01);
+            }
+        }
+
+        // Four factors need two levels
+        Ciphertext power;
+        evaluator_mt.exponentiate(encrypteds[0], 4, rlk, power);
+        Plaintext plain;
+        vector<complex<double>> output;
+        decryptor.decrypt(power, plain);
+        encoder.decode(plain, output);
+        for (size_t j = 0; j < slot_size; j++)
+        {
+            complex<double> value = pow(inputs[0][j], 4);
+            ASSERT_NEAR(value.real(), output[j].real(), 0.01);
+            ASSERT_NEAR(value.imag(), output[j].imag(), 0.01);
+        }
+
+        // Nine factors need four levels
+        encrypteds.resize(9, encrypteds[0]);
+        ASSERT_THROW(evaluator.multiply_many(encrypteds, rlk, power), invalid_argument);
+    }
+
+    TEST(EvaluatorTest, CKKSEncryptEvaluatePolynomialDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(slot_size * 2);
+        parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, { 60, 40, 40, 40, 40, 40, 40, 60 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        CKKSEncoder encoder(context);
+        const double delta = pow(2.0, 40);
+
+        vector<double> input(slot_size);
+        for (size_t j = 0; j < slot_size; j++)
+        {
+            input[j] = -1.0 + 2.0 * static_cast<double>(j) / static_cast<double>(slot_size - 1);
+        }
+        Plaintext plain;
+        Ciphertext encrypted;
+        encoder.encode(input, delta, plain);
+        encryptor.encrypt(plain, encrypted);
+
+        auto test = [&](const vector<double> &coeffs, size_t depth) {
+            Ciphertext result;
+            evaluator.evaluate_polynomial(encrypted, coeffs, rlk, result);
+            ASSERT_EQ(size_t(2), result.size());
+            ASSERT_EQ(encrypted.scale(), result.scale());
+            ASSERT_EQ(
+                context.get_context_data(encrypted.parms_id())->chain_index() - depth,
+                context.get_context_data(result.parms_id())->chain_index());
+
+            vector<double> output;
+            decryptor.decrypt(result, plain);
+            encoder.decode(plain, output);
+            for (size_t j = 0; j < slot_size; j++)
+            {
+                double expected = 0;
+                for (size_t i = coeffs.size(); i-- > 0;)
+                {
+                    expected = expected * input[j] + coeffs[i];
+                }
+                ASSERT_NEAR(expected, output[j], 0.001);
+            }
+        };
+
+        // Dense polynomial of degree 15 uses one level more than the minimal depth
+        vector<double> coeffs(16);
+        for (size_t i = 0; i < coeffs.size(); i++)
+        {
+            coeffs[i] = (i % 2 ? -1.0 : 1.0) / static_cast<double>(i + 1);
+        }
+        test(coeffs, 5);
+
+        // Sparse and low-degree polynomials
+        test({ 0.0, 1.0 }, 1);
+        test({ 0.5, 0.0, -2.0 }, 2);
+        test({ 0.25, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0 }, 4);
+
+        // Constant polynomials and too many levels
+        Ciphertext result;
+        ASSERT_THROW(evaluator.evaluate_polynomial(encrypted, vector<double>{ 1.0 }, rlk, result), invalid_argument);
+        ASSERT_THROW(
+            evaluator.evaluate_polynomial(encrypted, vector<double>{ 1.0, 0.0 }, rlk, result), invalid_argument);
+        coeffs.resize(128, 1.0);
+        ASSERT_THROW(evaluator.evaluate_polynomial(encrypted, coeffs, rlk, result), invalid_argument);
+        ASSERT_THROW(evaluator.evaluate_polynomial(encrypted, vector<uint64_t>{ 1, 1 }, rlk, result), logic_error);
+    }
+
+    TEST(EvaluatorTest, BFVEncryptEvaluatePolynomialDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        Modulus plain_modulus(PlainModulus::Batching(64, 20));
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 60, 60, 60, 60, 60 }));
+
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        RelinKeys rlk;
+        keygen.create_relin_keys(rlk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder batch_encoder(context);
+        uint64_t t = plain_modulus.value();
+
+        vector<uint64_t> input(batch_encoder.slot_count());
+        for (size_t j = 0; j < input.size(); j++)
+        {
+            input[j] = (j * 7919) % t;
+        }
+        Plaintext plain;
+        Ciphertext encrypted;
+        batch_encoder.encode(input, plain);
+        encryptor.encrypt(plain, encrypted);
+
+        auto test = [&](const vector<uint64_t> &coeffs) {
+            Ciphertext result;
+            evaluator.evaluate_polynomial(encrypted, coeffs, rlk, result);
+            ASSERT_EQ(size_t(2), result.size());
+
+            vector<uint64_t> output;
+            decryptor.decrypt(result, plain);
+            batch_encoder.decode(plain, output);
+            for (size_t j = 0; j < input.size(); j++)
+            {
+                uint64_t expected = 0;
+                for (size_t i = coeffs.size(); i-- > 0;)
+                {
+                    expected = (expected * input[j] + coeffs[i] % t) % t;
+                }
+                ASSERT_EQ(expected, output[j]);
+            }
+        };
+
+        test({ 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5 });
+        test({ 0, t - 1 });
+        test({ 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, t + 2 });
+        test({ t - 5, 0, 0, 0, 0, 0, 1 });
+
+        Ciphertext result;
+        ASSERT_THROW(evaluator.evaluate_polynomial(encrypted, vector<uint64_t>{ 1, t }, rlk, result), invalid_argument);
+        ASSERT_THROW(evaluator.evaluate_polynomial(encrypted, vector<double>{ 1.0, 1.0 }, rlk, result), logic_error);
+    }
+
     TEST(EvaluatorTest, BFVEncryptAddManyDecrypt)
     {
         EncryptionParameters parms(scheme_type::bfv);
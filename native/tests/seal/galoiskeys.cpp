@@ -1,12 +1,20 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+#include "seal/batchencoder.h"
+#include "seal/ckks.h"
 #include "seal/context.h"
+#include "seal/decryptor.h"
+#include "seal/encryptor.h"
+#include "seal/evaluator.h"
 #include "seal/galoiskeys.h"
 #include "seal/keygenerator.h"
 #include "seal/modulus.h"
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/uintcore.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <vector>
 #include "gtest/gtest.h"
 
@@ -203,4 +211,319 @@ namespace sealtest
             compare_kswitchkeys(keys, test_keys, secret_key, context);
         }
     }
+
+    TEST(GaloisKeysTest, GaloisKeysMappedSaveLoad)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(256);
+        parms.set_plain_modulus(PlainModulus::Batching(256, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(256, { 40, 40, 40 }));
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+
+        GaloisKeys keys;
+        keygen.create_galois_keys(vector<int>{ 1, -3 }, keys);
+        const string path = "galoiskeys_mapped_test.bin";
+        {
+            ofstream file(path, ios::binary);
+            auto out_size = keys.save_mapped(file);
+            ASSERT_EQ(0, out_size % static_cast<streamoff>(KSwitchKeys::mapped_alignment));
+        }
+
+        GaloisKeys test_keys;
+        test_keys.load_mapped(context, path);
+        ASSERT_TRUE(test_keys.is_mapped());
+        ASSERT_TRUE(keys.parms_id() == test_keys.parms_id());
+        ASSERT_EQ(keys.data().size(), test_keys.data().size());
+        for (size_t j = 0; j < test_keys.data().size(); j++)
+        {
+            ASSERT_EQ(keys.data()[j].size(), test_keys.data()[j].size());
+            for (size_t i = 0; i < test_keys.data()[j].size(); i++)
+            {
+                auto &key_data = test_keys.data()[j][i].data();
+                ASSERT_EQ(0ULL, reinterpret_cast<uintptr_t>(key_data.data()) % KSwitchKeys::mapped_alignment);
+                ASSERT_TRUE(keys.data()[j][i].data().parms_id() == key_data.parms_id());
+                ASSERT_TRUE(key_data.is_ntt_form());
+                ASSERT_EQ(keys.data()[j][i].data().dyn_array().size(), key_data.dyn_array().size());
+                ASSERT_TRUE(is_equal_uint(
+                    keys.data()[j][i].data().data(), key_data.data(), key_data.dyn_array().size()));
+            }
+        }
+
+        // Rotations with the mapped keys give the same result
+        Encryptor encryptor(context, keygen.secret_key());
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        BatchEncoder encoder(context);
+        vector<uint64_t> values(encoder.slot_count());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = i;
+        }
+        Plaintext plain;
+        encoder.encode(values, plain);
+        Ciphertext encrypted;
+        encryptor.encrypt_symmetric(plain, encrypted);
+        Ciphertext expected;
+        evaluator.rotate_rows(encrypted, -3, keys, expected);
+        evaluator.rotate_rows_inplace(encrypted, -3, test_keys);
+        ASSERT_TRUE(is_equal_uint(encrypted.data(), expected.data(), encrypted.dyn_array().size()));
+        decryptor.decrypt(encrypted, plain);
+        vector<uint64_t> result;
+        encoder.decode(plain, result);
+        ASSERT_EQ(values[encoder.slot_count() / 2 - 3], result[0]);
+
+        // Copies own their data
+        GaloisKeys copied_keys(test_keys);
+        ASSERT_FALSE(copied_keys.is_mapped());
+        for (size_t j = 0; j < copied_keys.data().size(); j++)
+        {
+            for (size_t i = 0; i < copied_keys.data()[j].size(); i++)
+            {
+                ASSERT_NE(test_keys.data()[j][i].data().data(), copied_keys.data()[j][i].data().data());
+            }
+        }
+
+        // Anything else fails to load
+        ASSERT_THROW(test_keys.unsafe_load_mapped(context, path + ".missing"), runtime_error);
+        {
+            ofstream file(path, ios::binary);
+            keys.save(file);
+        }
+        ASSERT_THROW(test_keys.unsafe_load_mapped(context, path), logic_error);
+        ASSERT_TRUE(test_keys.is_mapped());
+        remove(path.c_str());
+    }
+
+    TEST(GaloisKeysTest, GaloisKeysArchive)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(256);
+        parms.set_plain_modulus(PlainModulus::Batching(256, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(256, { 40, 40, 40 }));
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+
+        // Save the same seeded keys both normally and as an archive
+        vector<int> steps{ 1, 2, -3, 5 };
+        auto serializable_keys = keygen.create_galois_keys(steps);
+        GaloisKeys keys;
+        {
+            stringstream stream;
+            serializable_keys.save(stream);
+            keys.load(context, stream);
+        }
+        const string path = "galoiskeys_archive_test.bin";
+        {
+            ofstream file(path, ios::binary);
+            serializable_keys.save_archive(file);
+        }
+
+        GaloisKeys archived_keys;
+        archived_keys.load_archive(context, path, 2);
+        ASSERT_TRUE(archived_keys.is_archived());
+        ASSERT_TRUE(keys.parms_id() == archived_keys.parms_id());
+        ASSERT_EQ(keys.size(), archived_keys.size());
+        ASSERT_EQ(0ULL, archived_keys.resident_key_count());
+        auto galois_tool = context.key_context_data()->galois_tool();
+        for (int step : steps)
+        {
+            ASSERT_TRUE(archived_keys.has_key(galois_tool->get_elt_from_step(step)));
+        }
+        ASSERT_FALSE(archived_keys.has_key(galois_tool->get_elt_from_step(7)));
+        ASSERT_THROW(auto key = archived_keys.acquire_key(galois_tool->get_elt_from_step(7)), invalid_argument);
+
+        // Loaded keys match the expanded keys
+        auto key_ptr = archived_keys.acquire_key(galois_tool->get_elt_from_step(-3));
+        auto &expected_key = keys.key(galois_tool->get_elt_from_step(-3));
+        ASSERT_EQ(expected_key.size(), key_ptr->size());
+        for (size_t i = 0; i < expected_key.size(); i++)
+        {
+            ASSERT_TRUE(is_equal_uint(
+                expected_key[i].data().data(), (*key_ptr)[i].data().data(), expected_key[i].data().dyn_array().size()));
+        }
+        ASSERT_EQ(1ULL, archived_keys.resident_key_count());
+
+        // Rotations give the same results while at most two keys stay resident
+        Encryptor encryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        Plaintext plain("1x^3 + 2x^2 + 3");
+        Ciphertext encrypted;
+        encryptor.encrypt_symmetric(plain, encrypted);
+        for (int step : { 1, 2, -3, 5, 1, -3 })
+        {
+            Ciphertext expected;
+            Ciphertext rotated;
+            evaluator.rotate_rows(encrypted, step, keys, expected);
+            evaluator.rotate_rows(encrypted, step, archived_keys, rotated);
+            ASSERT_TRUE(is_equal_uint(expected.data(), rotated.data(), expected.dyn_array().size()));
+            ASSERT_GE(2ULL, archived_keys.resident_key_count());
+        }
+
+        // The evicted key stays usable through the pointer acquired earlier
+        ASSERT_TRUE(is_equal_uint(
+            expected_key[0].data().data(), (*key_ptr)[0].data().data(), expected_key[0].data().dyn_array().size()));
+
+        // Copies share the archive; saving archived keys is not supported
+        GaloisKeys copied_keys(archived_keys);
+        ASSERT_TRUE(copied_keys.is_archived());
+        stringstream stream;
+        ASSERT_THROW(archived_keys.save(stream), logic_error);
+
+        // Loading other data resets the archive
+        keys.save(stream);
+        copied_keys.load(context, stream);
+        ASSERT_FALSE(copied_keys.is_archived());
+        ASSERT_TRUE(archived_keys.is_archived());
+
+        {
+            ofstream file(path, ios::binary);
+            keys.save(file);
+        }
+        ASSERT_THROW(archived_keys.load_archive(context, path, 2), logic_error);
+        ASSERT_THROW(archived_keys.load_archive(context, path, 0), invalid_argument);
+        ASSERT_THROW(archived_keys.load_archive(context, path + ".missing", 2), runtime_error);
+        remove(path.c_str());
+    }
+
+    TEST(GaloisKeysTest, GaloisKeysSeeded)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(256);
+        parms.set_plain_modulus(PlainModulus::Batching(256, 20));
+        parms.set_coeff_modulus(CoeffModulus::Create(256, { 40, 40, 40 }));
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+
+        // Load the same seeded keys both expanded and in seeded form
+        vector<int> steps{ 1, 2, -3 };
+        auto serializable_keys = keygen.create_galois_keys(steps);
+        stringstream stream;
+        serializable_keys.save(stream);
+        GaloisKeys keys;
+        keys.load(context, stream);
+        stream.seekg(0);
+        GaloisKeys seeded_keys;
+        seeded_keys.load_seeded(context, stream);
+        ASSERT_TRUE(seeded_keys.is_seeded());
+        ASSERT_FALSE(keys.is_seeded());
+        ASSERT_TRUE(keys.parms_id() == seeded_keys.parms_id());
+        ASSERT_EQ(keys.size(), seeded_keys.size());
+        ASSERT_TRUE(seeded_keys.data().empty());
+        auto galois_tool = context.key_context_data()->galois_tool();
+        for (int step : steps)
+        {
+            ASSERT_TRUE(seeded_keys.has_key(galois_tool->get_elt_from_step(step)));
+        }
+        ASSERT_FALSE(seeded_keys.has_key(galois_tool->get_elt_from_step(5)));
+        ASSERT_THROW(auto key = seeded_keys.acquire_key(galois_tool->get_elt_from_step(5)), invalid_argument);
+
+        // Expanded keys match the keys expanded on load
+        auto key_ptr = seeded_keys.acquire_key(galois_tool->get_elt_from_step(2));
+        auto &expected_key = keys.key(galois_tool->get_elt_from_step(2));
+        ASSERT_EQ(expected_key.size(), key_ptr->size());
+        for (size_t i = 0; i < expected_key.size(); i++)
+        {
+            ASSERT_TRUE(is_equal_uint(
+                expected_key[i].data().data(), (*key_ptr)[i].data().data(), expected_key[i].data().dyn_array().size()));
+        }
+
+        // Rotations give the same results
+        Encryptor encryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        Plaintext plain("1x^3 + 2x^2 + 3");
+        Ciphertext encrypted;
+        encryptor.encrypt_symmetric(plain, encrypted);
+        for (int step : steps)
+        {
+            Ciphertext expected;
+            Ciphertext rotated;
+            evaluator.rotate_rows(encrypted, step, keys, expected);
+            evaluator.rotate_rows(encrypted, step, seeded_keys, rotated);
+            ASSERT_TRUE(is_equal_uint(expected.data(), rotated.data(), expected.dyn_array().size()));
+        }
+
+        // Copies share the seeded keys; saving seeded keys is not supported
+        GaloisKeys copied_keys(seeded_keys);
+        ASSERT_TRUE(copied_keys.is_seeded());
+        stringstream out_stream;
+        ASSERT_THROW(seeded_keys.save(out_stream), logic_error);
+
+        // Keys that are not seeded are kept in full; loading other data resets the seeded keys
+        keys.save(out_stream);
+        copied_keys.load_seeded(context, out_stream);
+        ASSERT_TRUE(copied_keys.is_seeded());
+        ASSERT_EQ(keys.size(), copied_keys.size());
+        Ciphertext rotated;
+        evaluator.rotate_rows(encrypted, -3, copied_keys, rotated);
+        out_stream.seekg(0);
+        copied_keys.load(context, out_stream);
+        ASSERT_FALSE(copied_keys.is_seeded());
+        ASSERT_TRUE(seeded_keys.is_seeded());
+        {
+            // With hybrid key switching there is one key per digit
+            parms.set_poly_modulus_degree(64);
+            parms.set_plain_modulus(PlainModulus::Batching(64, 20));
+            parms.set_coeff_modulus(CoeffModulus::Create(64, vector<int>(6, 40)));
+            parms.set_special_modulus_size(2);
+            SEALContext hybrid_context(parms, false, sec_level_type::none);
+            KeyGenerator hybrid_keygen(hybrid_context);
+
+            stringstream hybrid_stream;
+            hybrid_keygen.create_galois_keys(steps).save(hybrid_stream);
+            GaloisKeys hybrid_keys;
+            hybrid_keys.load(hybrid_context, hybrid_stream);
+            hybrid_stream.seekg(0);
+            GaloisKeys hybrid_seeded_keys;
+            hybrid_seeded_keys.load_seeded(hybrid_context, hybrid_stream);
+            ASSERT_TRUE(hybrid_seeded_keys.is_seeded());
+            auto hybrid_galois_tool = hybrid_context.key_context_data()->galois_tool();
+            ASSERT_EQ(size_t(2), hybrid_keys.key(hybrid_galois_tool->get_elt_from_step(1)).size());
+
+            Encryptor hybrid_encryptor(hybrid_context, hybrid_keygen.secret_key());
+            Evaluator hybrid_evaluator(hybrid_context);
+            hybrid_encryptor.encrypt_symmetric(plain, encrypted);
+            for (int step : steps)
+            {
+                Ciphertext expected;
+                hybrid_evaluator.rotate_rows(encrypted, step, hybrid_keys, expected);
+                hybrid_evaluator.rotate_rows(encrypted, step, hybrid_seeded_keys, rotated);
+                ASSERT_TRUE(is_equal_uint(expected.data(), rotated.data(), expected.dyn_array().size()));
+            }
+        }
+        {
+            // Hoisted rotations use the seeded keys as well
+            EncryptionParameters ckks_parms(scheme_type::ckks);
+            ckks_parms.set_poly_modulus_degree(64);
+            ckks_parms.set_coeff_modulus(CoeffModulus::Create(64, vector<int>(6, 40)));
+            ckks_parms.set_special_modulus_size(2);
+            SEALContext ckks_context(ckks_parms, false, sec_level_type::none);
+            KeyGenerator ckks_keygen(ckks_context);
+
+            stringstream ckks_stream;
+            ckks_keygen.create_galois_keys(steps).save(ckks_stream);
+            GaloisKeys ckks_keys;
+            ckks_keys.load(ckks_context, ckks_stream);
+            ckks_stream.seekg(0);
+            GaloisKeys ckks_seeded_keys;
+            ckks_seeded_keys.load_seeded(ckks_context, ckks_stream);
+
+            CKKSEncoder encoder(ckks_context);
+            Encryptor ckks_encryptor(ckks_context, ckks_keygen.secret_key());
+            Evaluator ckks_evaluator(ckks_context);
+            Plaintext ckks_plain;
+            encoder.encode(vector<double>(encoder.slot_count(), 1.5), pow(2.0, 20), ckks_plain);
+            Ciphertext ckks_encrypted;
+            ckks_encryptor.encrypt_symmetric(ckks_plain, ckks_encrypted);
+            vector<Ciphertext> ckks_expected;
+            vector<Ciphertext> ckks_rotated;
+            ckks_evaluator.rotate_vector_many(ckks_encrypted, steps, ckks_keys, ckks_expected);
+            ckks_evaluator.rotate_vector_many(ckks_encrypted, steps, ckks_seeded_keys, ckks_rotated);
+            for (size_t i = 0; i < steps.size(); i++)
+            {
+                ASSERT_TRUE(is_equal_uint(
+                    ckks_expected[i].data(), ckks_rotated[i].data(), ckks_expected[i].dyn_array().size()));
+            }
+        }
+    }
 } // namespace sealtest
@@ -1,10 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+#include "seal/context.h"
 #include "seal/dynarray.h"
+#include "seal/encryptor.h"
+#include "seal/evaluator.h"
+#include "seal/keygenerator.h"
 #include "seal/memorymanager.h"
+#include "seal/modulus.h"
 #include "seal/util/pointer.h"
 #include "seal/util/uintcore.h"
+#include <string>
+#include <utility>
+#include <vector>
 #include "gtest/gtest.h"
 
 using namespace seal;
@@ -67,4 +75,124 @@ namespace sealtest
         }
         ASSERT_EQ(1L, pool.use_count());
     }
+
+    TEST(MemoryPoolHandleTest, ThreadCaching)
+    {
+        MemoryPoolHandle pool = MemoryPoolHandle::NewThreadCaching();
+        ASSERT_TRUE(pool);
+        ASSERT_FALSE(pool == MemoryPoolHandle::NewThreadCaching());
+        ASSERT_TRUE(0LL == pool.alloc_byte_count());
+        {
+            auto ptr(allocate_uint(5, pool));
+            ASSERT_TRUE(5LL * bytes_per_uint64 == pool.alloc_byte_count());
+        }
+        {
+            auto ptr(allocate_uint(5, pool));
+            ASSERT_TRUE(5LL * bytes_per_uint64 == pool.alloc_byte_count());
+            ASSERT_TRUE(1LL == pool.pool_count());
+        }
+
+        MMProfThreadCaching prof;
+        MemoryPoolHandle prof_pool = prof.get_pool(mm_prof_opt::mm_default);
+        ASSERT_TRUE(prof_pool == prof.get_pool(mm_prof_opt::mm_default));
+        ASSERT_FALSE(prof_pool == MemoryPoolHandle::Global());
+    }
+
+    TEST(MemoryPoolHandleTest, Stats)
+    {
+        // An uninitialized handle has no statistics
+        ASSERT_TRUE(MemoryPoolHandle().stats().size_classes.empty());
+
+        auto test_pool = [](MemoryPoolHandle pool) {
+            {
+                auto ptr1(allocate_uint(5, pool));
+                auto ptr2(allocate_uint(5, pool));
+                auto ptr3(allocate_uint(2, pool));
+                auto stats = pool.stats();
+                ASSERT_EQ(2ULL, stats.size_classes.size());
+                ASSERT_EQ(5ULL * bytes_per_uint64, stats.size_classes[0].item_byte_count);
+                ASSERT_EQ(2ULL, stats.size_classes[0].live_item_count);
+                ASSERT_EQ(2ULL, stats.size_classes[0].peak_live_item_count);
+                ASSERT_EQ(2ULL, stats.size_classes[0].alloc_count);
+                ASSERT_EQ(2ULL * bytes_per_uint64, stats.size_classes[1].item_byte_count);
+                ASSERT_EQ(1ULL, stats.size_classes[1].live_item_count);
+                ASSERT_EQ(12ULL * bytes_per_uint64, stats.live_byte_count());
+                ASSERT_EQ(pool.alloc_byte_count(), stats.alloc_byte_count());
+                ASSERT_EQ(3ULL, stats.alloc_count());
+                ASSERT_TRUE(stats.size_classes[0].malloc_count >= 1);
+            }
+            for (int i = 0; i < 10; i++)
+            {
+                auto ptr(allocate_uint(5, pool));
+            }
+
+            // Nothing is leaked and the high-water mark remains
+            auto stats = pool.stats();
+            ASSERT_EQ(0ULL, stats.live_byte_count());
+            ASSERT_EQ(2ULL, stats.size_classes[0].peak_live_item_count);
+            ASSERT_EQ(12ULL, stats.size_classes[0].alloc_count);
+            ASSERT_EQ(13ULL, stats.alloc_count());
+            ASSERT_TRUE(stats.age.count() > 0);
+            ASSERT_TRUE(stats.alloc_rate() > 0.0);
+        };
+        test_pool(MemoryPoolHandle::New());
+        test_pool(MemoryPoolHandle::NewThreadCaching());
+        test_pool(MemoryPoolHandle(make_shared<MemoryPoolST>()));
+    }
+
+    TEST(MemoryPoolHandleTest, AllocCallback)
+    {
+        MemoryPoolHandle pool = MemoryPoolHandle::New();
+        ASSERT_THROW(MemoryPoolHandle().set_alloc_callback(nullptr), logic_error);
+
+        vector<pair<size_t, string>> events;
+        pool.set_alloc_callback([&](const MemoryPoolAllocEvent &event) {
+            events.emplace_back(event.byte_count, event.tag ? event.tag : "");
+        });
+        {
+            auto ptr(allocate_uint(3, pool));
+        }
+        ASSERT_EQ(1ULL, events.size());
+        ASSERT_EQ(3ULL * bytes_per_uint64, events[0].first);
+        ASSERT_EQ("", events[0].second);
+
+        // The outermost scope names the allocations
+        {
+            MemoryPoolTraceScope outer("outer");
+            MemoryPoolTraceScope inner("inner");
+            ASSERT_EQ(string("outer"), MemoryPoolTraceScope::current_tag());
+            auto ptr(allocate_uint(3, pool));
+        }
+        ASSERT_TRUE(MemoryPoolTraceScope::current_tag() == nullptr);
+        ASSERT_EQ(2ULL, events.size());
+        ASSERT_EQ("outer", events[1].second);
+
+        // Evaluator operations tag their allocations
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(1 << 6);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40 }));
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Ciphertext encrypted;
+        encryptor.encrypt(Plaintext("1x^1"), encrypted);
+
+        events.clear();
+        evaluator.square_inplace(encrypted, pool);
+        ASSERT_FALSE(events.empty());
+        for (auto &event : events)
+        {
+            ASSERT_EQ("square", event.second);
+        }
+
+        // Removing the callback stops tracing
+        pool.set_alloc_callback(nullptr);
+        events.clear();
+        evaluator.square_inplace(encrypted, pool);
+        ASSERT_TRUE(events.empty());
+    }
 } // namespace sealtest
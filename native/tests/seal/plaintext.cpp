@@ -206,4 +206,32 @@ namespace sealtest
             ASSERT_TRUE(plain2.is_ntt_form());
         }
     }
+
+    TEST(PlaintextTest, SaveLoadPlaintextBitpack)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(2048);
+        parms.set_coeff_modulus(CoeffModulus::Create(2048, { 30, 40 }));
+        parms.set_plain_modulus(65537);
+        SEALContext context(parms, false, sec_level_type::none);
+
+        Plaintext plain("1x^63 + 2x^62 + Fx^32 + Ax^9 + 1x^1 + 1");
+        Plaintext plain2;
+        stringstream stream;
+        auto out_size = plain.save(stream, compr_mode_type::bitpack);
+        ASSERT_EQ(plain.save_size(compr_mode_type::bitpack), out_size);
+        ASSERT_LT(out_size, plain.save_size(compr_mode_type::none));
+        ASSERT_EQ(out_size, plain2.load(context, stream));
+        ASSERT_TRUE(plain == plain2);
+
+        // In NTT form each RNS component is packed separately
+        Evaluator evaluator(context);
+        evaluator.transform_to_ntt_inplace(plain, context.first_parms_id());
+        out_size = plain.save(stream, compr_mode_type::bitpack);
+        ASSERT_EQ(plain.save_size(compr_mode_type::bitpack), out_size);
+        ASSERT_EQ(out_size, plain2.load(context, stream));
+        ASSERT_TRUE(plain2.is_ntt_form());
+        ASSERT_TRUE(plain.parms_id() == plain2.parms_id());
+        ASSERT_TRUE(equal(plain.data(), plain.data() + plain.coeff_count(), plain2.data()));
+    }
 } // namespace sealtest
@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/batchencoder.h"
+#include "seal/ckks.h"
+#include "seal/context.h"
+#include "seal/decryptor.h"
+#include "seal/encryptor.h"
+#include "seal/evaluator.h"
+#include "seal/keygenerator.h"
+#include "seal/modulus.h"
+#include "seal/preparedplaintext.h"
+#include <cmath>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+namespace sealtest
+{
+    TEST(PreparedPlaintextTest, BFVMultiplyAddPlain)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        Modulus plain_modulus(257);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus(CoeffModulus::Create(64, { 40, 40, 40, 40 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        BatchEncoder encoder(context);
+
+        vector<uint64_t> input(encoder.slot_count());
+        vector<uint64_t> weights(encoder.slot_count());
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            input[i] = (i * 3 + 1) % plain_modulus.value();
+            weights[i] = (i * 17 + 200) % plain_modulus.value();
+        }
+        Plaintext plain;
+        Plaintext weights_plain;
+        Ciphertext encrypted;
+        encoder.encode(input, plain);
+        encoder.encode(weights, weights_plain);
+        encryptor.encrypt(plain, encrypted);
+
+        PreparedPlaintext prepared(context, weights_plain);
+        ASSERT_EQ(0ULL, prepared.cached_level_count());
+
+        for (size_t level = 0; level < 3; level++)
+        {
+            // Same result as multiplying with the original plaintext
+            Ciphertext expected;
+            Ciphertext product;
+            evaluator.multiply_plain(encrypted, weights_plain, expected);
+            evaluator.multiply_plain(encrypted, prepared, product);
+            ASSERT_FALSE(product.is_ntt_form());
+            ASSERT_TRUE(product.parms_id() == encrypted.parms_id());
+            ASSERT_TRUE(equal(product.data(), product.data() + product.dyn_array().size(), expected.data()));
+
+            evaluator.add_plain(encrypted, weights_plain, expected);
+            Ciphertext sum;
+            evaluator.add_plain(encrypted, prepared, sum);
+            ASSERT_TRUE(equal(sum.data(), sum.data() + sum.dyn_array().size(), expected.data()));
+
+            // NTT form ciphertexts are also supported
+            evaluator.transform_to_ntt_inplace(encrypted);
+            evaluator.multiply_plain_inplace(encrypted, prepared);
+            evaluator.transform_from_ntt_inplace(encrypted);
+
+            vector<uint64_t> output;
+            decryptor.decrypt(encrypted, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < input.size(); i++)
+            {
+                input[i] = (input[i] * weights[i]) % plain_modulus.value();
+                ASSERT_EQ(input[i], output[i]);
+            }
+            ASSERT_EQ(level + 1, prepared.cached_level_count());
+
+            // Reusing a level does not grow the cache
+            evaluator.multiply_plain(encrypted, prepared, product);
+            ASSERT_EQ(level + 1, prepared.cached_level_count());
+            if (level < 2)
+            {
+                evaluator.mod_switch_to_next_inplace(encrypted);
+            }
+        }
+
+        Plaintext ntt_plain = weights_plain;
+        evaluator.transform_to_ntt_inplace(ntt_plain, context.first_parms_id());
+        ASSERT_THROW(PreparedPlaintext(context, ntt_plain), invalid_argument);
+    }
+
+    TEST(PreparedPlaintextTest, CKKSMultiplyAddPlain)
+    {
+        EncryptionParameters parms(scheme_type::ckks);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(slot_size * 2);
+        parms.set_coeff_modulus(CoeffModulus::Create(slot_size * 2, { 60, 40, 40, 60 }));
+
+        SEALContext context(parms, true, sec_level_type::none);
+        KeyGenerator keygen(context);
+        PublicKey pk;
+        keygen.create_public_key(pk);
+
+        Encryptor encryptor(context, pk);
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        CKKSEncoder encoder(context);
+        double delta = pow(2.0, 20);
+
+        vector<double> input(slot_size);
+        vector<double> weights(slot_size);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            input[i] = static_cast<double>(i % 7);
+            weights[i] = static_cast<double>(i % 3) - 1.0;
+        }
+        Plaintext plain;
+        Plaintext weights_plain;
+        Ciphertext encrypted;
+        encoder.encode(input, delta, plain);
+        encoder.encode(weights, delta, weights_plain);
+        encryptor.encrypt(plain, encrypted);
+
+        PreparedPlaintext prepared(context, weights_plain);
+        ASSERT_TRUE(&prepared.at(context.first_parms_id()) == &prepared.plain());
+        ASSERT_EQ(0ULL, prepared.cached_level_count());
+
+        for (size_t level = 0; level < 3; level++)
+        {
+            // Same result as multiplying with a plaintext switched to the level manually
+            Plaintext switched = weights_plain;
+            evaluator.mod_switch_to_inplace(switched, encrypted.parms_id());
+            Ciphertext expected;
+            Ciphertext product;
+            evaluator.multiply_plain(encrypted, switched, expected);
+            evaluator.multiply_plain(encrypted, prepared, product);
+            ASSERT_TRUE(product.parms_id() == encrypted.parms_id());
+            ASSERT_TRUE(equal(product.data(), product.data() + product.dyn_array().size(), expected.data()));
+
+            Ciphertext sum;
+            evaluator.add_plain(encrypted, prepared, sum);
+            vector<double> output;
+            decryptor.decrypt(sum, plain);
+            encoder.decode(plain, output);
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_EQ(input[i] + weights[i], round(output[i]));
+            }
+            ASSERT_EQ(level, prepared.cached_level_count());
+            if (level < 2)
+            {
+                evaluator.mod_switch_to_next_inplace(encrypted);
+            }
+        }
+
+        // Plaintexts cannot be switched to a higher level
+        Plaintext lower = weights_plain;
+        evaluator.mod_switch_to_next_inplace(lower);
+        PreparedPlaintext prepared_lower(context, lower);
+        ASSERT_THROW(static_cast<void>(prepared_lower.at(context.first_parms_id())), invalid_argument);
+    }
+} // namespace sealtest
@@ -3,6 +3,7 @@
 
 #include "seal/keygenerator.h"
 #include "seal/randomgen.h"
+#include "seal/util/aes.h"
 #include <algorithm>
 #include <array>
 #include <cstdint>
@@ -11,6 +12,7 @@
 #include <set>
 #include <sstream>
 #include <thread>
+#include <vector>
 #include "gtest/gtest.h"
 
 using namespace seal;
@@ -265,6 +267,21 @@ namespace sealtest
                 ASSERT_EQ(rg->generate(), rg2->generate());
             }
         }
+        {
+            shared_ptr<UniformRandomGenerator> rg(make_unique<AES256CTRPRNG>(seed_arr));
+            info = rg->info();
+
+            ASSERT_EQ(prng_type::aes256ctr, info.type());
+            ASSERT_TRUE(info.has_valid_prng_type());
+            ASSERT_EQ(seed_arr, info.seed());
+
+            auto rg2 = info.make_prng();
+            ASSERT_TRUE(rg2);
+            for (int i = 0; i < 100; i++)
+            {
+                ASSERT_EQ(rg->generate(), rg2->generate());
+            }
+        }
         {
             shared_ptr<UniformRandomGenerator> rg(make_unique<SequentialRandomGenerator>(seed_arr));
             info = rg->info();
@@ -302,5 +319,46 @@ namespace sealtest
             info2.load(ss);
             ASSERT_TRUE(info == info2);
         }
+        {
+            shared_ptr<UniformRandomGenerator> rg(make_unique<AES256CTRPRNG>(seed_arr));
+            info = rg->info();
+            info.save(ss);
+            info2.load(ss);
+            ASSERT_TRUE(info == info2);
+        }
+    }
+
+    TEST(RandomGenerator, AES256CTRPRNG)
+    {
+        // The key is the first four seed words in little-endian byte order and the nonce is the fifth word
+        prng_seed_type seed_arr = { 0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL, 0x1716151413121110ULL,
+                                    0x1f1e1d1c1b1a1918ULL, 0x7766554433221100ULL, 1, 2, 3 };
+        array<uint8_t, util::aes256_key_byte_count> key;
+        iota(key.begin(), key.end(), uint8_t(0));
+        array<uint8_t, util::aes256_round_key_byte_count> round_keys;
+        util::aes256_expand_key(key.data(), round_keys.data());
+
+        // The output is the keystream for counters 0, 1, 2, ... across buffer refills
+        constexpr size_t block_count = 1000;
+        vector<uint8_t> expected(block_count * util::aes_block_byte_count);
+        util::aes256_ctr_keystream_portable(
+            round_keys.data(), seed_arr[4], 0, block_count, reinterpret_cast<seal_byte *>(expected.data()));
+
+        auto rg = AES256CTRPRNGFactory(seed_arr).create();
+        vector<uint8_t> values(expected.size());
+        rg->generate(values.size(), reinterpret_cast<seal_byte *>(values.data()));
+        ASSERT_EQ(expected, values);
+
+        // Seed words beyond the key and nonce do not affect the output
+        seed_arr[7] = 4;
+        auto rg2 = AES256CTRPRNGFactory(seed_arr).create();
+        rg2->generate(values.size(), reinterpret_cast<seal_byte *>(values.data()));
+        ASSERT_EQ(expected, values);
+
+        // A different nonce changes the output
+        seed_arr[4]++;
+        auto rg3 = AES256CTRPRNGFactory(seed_arr).create();
+        rg3->generate(values.size(), reinterpret_cast<seal_byte *>(values.data()));
+        ASSERT_NE(expected, values);
     }
 } // namespace sealtest
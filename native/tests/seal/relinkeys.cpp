@@ -1,12 +1,16 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+#include "seal/ckks.h"
 #include "seal/context.h"
+#include "seal/encryptor.h"
+#include "seal/evaluator.h"
 #include "seal/keygenerator.h"
 #include "seal/modulus.h"
 #include "seal/relinkeys.h"
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/uintcore.h"
+#include <cmath>
 #include "gtest/gtest.h"
 
 using namespace seal;
@@ -190,4 +194,133 @@ namespace sealtest
             compare_kswitchkeys(keys, test_keys, secret_key, context);
         }
     }
+
+    TEST(RelinKeysTest, RelinKeysBitpackSaveLoad)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(256);
+        parms.set_plain_modulus(1 << 6);
+        parms.set_coeff_modulus(CoeffModulus::Create(256, { 40, 50 }));
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+
+        RelinKeys keys;
+        RelinKeys test_keys;
+        keygen.create_relin_keys(keys);
+        stringstream stream;
+        auto out_size = keys.save(stream, compr_mode_type::bitpack);
+        ASSERT_EQ(keys.save_size(compr_mode_type::bitpack), out_size);
+        ASSERT_LT(out_size, keys.save_size(compr_mode_type::none));
+        ASSERT_EQ(out_size, test_keys.load(context, stream));
+        ASSERT_EQ(keys.size(), test_keys.size());
+        ASSERT_TRUE(keys.parms_id() == test_keys.parms_id());
+        for (size_t j = 0; j < test_keys.size(); j++)
+        {
+            for (size_t i = 0; i < test_keys.key(j + 2).size(); i++)
+            {
+                ASSERT_EQ(
+                    keys.key(j + 2)[i].data().dyn_array().size(), test_keys.key(j + 2)[i].data().dyn_array().size());
+                ASSERT_TRUE(is_equal_uint(
+                    keys.key(j + 2)[i].data().data(), test_keys.key(j + 2)[i].data().data(),
+                    keys.key(j + 2)[i].data().dyn_array().size()));
+            }
+        }
+
+        // Seeded keys are packed the same way
+        stringstream seeded_stream;
+        out_size = keygen.create_relin_keys().save(seeded_stream, compr_mode_type::bitpack);
+        ASSERT_EQ(out_size, test_keys.load(context, seeded_stream));
+        ASSERT_EQ(keys.size(), test_keys.size());
+    }
+
+    TEST(RelinKeysTest, RelinKeysSeeded)
+    {
+        EncryptionParameters parms(scheme_type::bfv);
+        parms.set_poly_modulus_degree(256);
+        parms.set_plain_modulus(1 << 6);
+        parms.set_coeff_modulus(CoeffModulus::Create(256, { 40, 40, 50 }));
+        SEALContext context(parms, false, sec_level_type::none);
+        KeyGenerator keygen(context);
+
+        stringstream stream;
+        keygen.create_relin_keys().save(stream);
+        RelinKeys keys;
+        keys.load(context, stream);
+        stream.seekg(0);
+        RelinKeys seeded_keys;
+        seeded_keys.load_seeded(context, stream);
+        ASSERT_TRUE(seeded_keys.is_seeded());
+        ASSERT_EQ(keys.size(), seeded_keys.size());
+        ASSERT_TRUE(seeded_keys.has_key(2));
+        ASSERT_FALSE(seeded_keys.has_key(3));
+
+        // Relinearization expands the seeded keys to the same keys
+        Encryptor encryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        Plaintext plain("1x^3 + 2x^2 + 3");
+        Ciphertext encrypted;
+        encryptor.encrypt_symmetric(plain, encrypted);
+        evaluator.square_inplace(encrypted);
+        Ciphertext expected;
+        Ciphertext relinearized;
+        evaluator.relinearize(encrypted, keys, expected);
+        evaluator.relinearize(encrypted, seeded_keys, relinearized);
+        ASSERT_TRUE(is_equal_uint(expected.data(), relinearized.data(), expected.dyn_array().size()));
+        {
+            // With hybrid key switching there is one key per digit
+            parms.set_poly_modulus_degree(64);
+            parms.set_coeff_modulus(CoeffModulus::Create(64, vector<int>(6, 40)));
+            parms.set_special_modulus_size(2);
+            SEALContext hybrid_context(parms, false, sec_level_type::none);
+            KeyGenerator hybrid_keygen(hybrid_context);
+
+            stringstream hybrid_stream;
+            hybrid_keygen.create_relin_keys().save(hybrid_stream);
+            RelinKeys hybrid_keys;
+            hybrid_keys.load(hybrid_context, hybrid_stream);
+            hybrid_stream.seekg(0);
+            RelinKeys hybrid_seeded_keys;
+            hybrid_seeded_keys.load_seeded(hybrid_context, hybrid_stream);
+            ASSERT_TRUE(hybrid_seeded_keys.is_seeded());
+            ASSERT_EQ(size_t(2), hybrid_keys.key(2).size());
+
+            Encryptor hybrid_encryptor(hybrid_context, hybrid_keygen.secret_key());
+            Evaluator hybrid_evaluator(hybrid_context);
+            hybrid_encryptor.encrypt_symmetric(plain, encrypted);
+            hybrid_evaluator.square_inplace(encrypted);
+            hybrid_evaluator.relinearize(encrypted, hybrid_keys, expected);
+            hybrid_evaluator.relinearize(encrypted, hybrid_seeded_keys, relinearized);
+            ASSERT_TRUE(is_equal_uint(expected.data(), relinearized.data(), expected.dyn_array().size()));
+        }
+        {
+            // Relinearization fused with rescaling uses the seeded keys as well
+            EncryptionParameters ckks_parms(scheme_type::ckks);
+            ckks_parms.set_poly_modulus_degree(64);
+            ckks_parms.set_coeff_modulus(CoeffModulus::Create(64, vector<int>(6, 40)));
+            ckks_parms.set_special_modulus_size(2);
+            SEALContext ckks_context(ckks_parms, true, sec_level_type::none);
+            KeyGenerator ckks_keygen(ckks_context);
+
+            stringstream ckks_stream;
+            ckks_keygen.create_relin_keys().save(ckks_stream);
+            RelinKeys ckks_keys;
+            ckks_keys.load(ckks_context, ckks_stream);
+            ckks_stream.seekg(0);
+            RelinKeys ckks_seeded_keys;
+            ckks_seeded_keys.load_seeded(ckks_context, ckks_stream);
+
+            CKKSEncoder encoder(ckks_context);
+            Encryptor ckks_encryptor(ckks_context, ckks_keygen.secret_key());
+            Evaluator ckks_evaluator(ckks_context);
+            Plaintext ckks_plain;
+            encoder.encode(vector<double>(encoder.slot_count(), 1.5), pow(2.0, 20), ckks_plain);
+            Ciphertext ckks_encrypted;
+            ckks_encryptor.encrypt_symmetric(ckks_plain, ckks_encrypted);
+            Ciphertext ckks_expected;
+            Ciphertext ckks_result;
+            ckks_evaluator.multiply_relin_rescale(ckks_encrypted, ckks_encrypted, ckks_keys, ckks_expected);
+            ckks_evaluator.multiply_relin_rescale(ckks_encrypted, ckks_encrypted, ckks_seeded_keys, ckks_result);
+            ASSERT_TRUE(is_equal_uint(ckks_expected.data(), ckks_result.data(), ckks_expected.dyn_array().size()));
+        }
+    }
 } // namespace sealtest
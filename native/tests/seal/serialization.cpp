@@ -7,6 +7,7 @@
 #include <functional>
 #include <sstream>
 #include <string>
+#include <vector>
 #include "gtest/gtest.h"
 
 using namespace seal;
@@ -62,6 +63,9 @@ namespace sealtest
         ASSERT_TRUE(Serialization::IsValidHeader(header));
 #endif
 
+        header.compr_mode = compr_mode_type::bitpack;
+        ASSERT_TRUE(Serialization::IsValidHeader(header));
+
         Serialization::SEALHeader invalid_header;
         invalid_header.magic = 0x1212;
         ASSERT_FALSE(Serialization::IsValidHeader(invalid_header));
@@ -70,7 +74,20 @@ namespace sealtest
         invalid_header.version_major = 0x02;
         ASSERT_FALSE(Serialization::IsValidHeader(invalid_header));
         invalid_header.version_major = SEAL_VERSION_MAJOR;
-        invalid_header.compr_mode = (compr_mode_type)0x03;
+        invalid_header.compr_mode = (compr_mode_type)0x04;
+        ASSERT_FALSE(Serialization::IsValidHeader(invalid_header));
+
+        // Framing is only valid with zlib and zstd; unknown flags are always invalid
+        invalid_header.compr_mode = compr_mode_type::none;
+        invalid_header.reserved = Serialization::header_flag_framed;
+        ASSERT_FALSE(Serialization::IsValidHeader(invalid_header));
+        invalid_header.compr_mode = compr_mode_type::bitpack;
+        ASSERT_FALSE(Serialization::IsValidHeader(invalid_header));
+#ifdef SEAL_USE_ZLIB
+        invalid_header.compr_mode = compr_mode_type::zlib;
+        ASSERT_TRUE(Serialization::IsValidHeader(invalid_header));
+#endif
+        invalid_header.reserved = 0x8000;
         ASSERT_FALSE(Serialization::IsValidHeader(invalid_header));
     }
 
@@ -260,4 +277,84 @@ namespace sealtest
         }
 #endif
     }
+
+#if defined(SEAL_USE_ZLIB) || defined(SEAL_USE_ZSTD)
+    TEST(SerializationTest, SaveLoadFramed)
+    {
+        ASSERT_THROW(Serialization::SetComprThreadCount(0), invalid_argument);
+        ASSERT_THROW(Serialization::SetComprThreadCount(2, 0), invalid_argument);
+        ASSERT_EQ(size_t(1), Serialization::ComprThreadCount());
+
+        constexpr size_t frame_size = 4096;
+        vector<uint64_t> data(12345);
+        size_t data_size = data.size() * sizeof(uint64_t);
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            data[i] = (i * 0x9E3779B97F4A7C15ULL) >> (i % 61);
+        }
+        auto save_data = [&](ostream &stream) {
+            stream.write(reinterpret_cast<const char *>(data.data()), static_cast<streamsize>(data_size));
+        };
+        auto load_data = [&](vector<uint64_t> &out) {
+            return [&out](istream &stream, SEALVersion) {
+                stream.read(
+                    reinterpret_cast<char *>(out.data()), static_cast<streamsize>(out.size() * sizeof(uint64_t)));
+            };
+        };
+
+        vector<compr_mode_type> compr_modes;
+#ifdef SEAL_USE_ZLIB
+        compr_modes.push_back(compr_mode_type::zlib);
+#endif
+#ifdef SEAL_USE_ZSTD
+        compr_modes.push_back(compr_mode_type::zstd);
+#endif
+        for (auto compr_mode : compr_modes)
+        {
+            Serialization::SetComprThreadCount(4, frame_size);
+            ASSERT_EQ(size_t(4), Serialization::ComprThreadCount());
+            ASSERT_EQ(frame_size, Serialization::ComprFrameSize());
+
+            auto raw_size = static_cast<streamoff>(
+                sizeof(Serialization::SEALHeader) + Serialization::ComprSizeEstimate(data_size, compr_mode));
+            stringstream stream;
+            auto out_size = Serialization::Save(save_data, raw_size, stream, compr_mode, false);
+            ASSERT_GE(raw_size, out_size);
+
+            Serialization::SEALHeader header;
+            stream.seekg(0);
+            Serialization::LoadHeader(stream, header);
+            ASSERT_EQ(compr_mode, header.compr_mode);
+            ASSERT_TRUE(header.reserved & Serialization::header_flag_framed);
+            ASSERT_EQ(static_cast<uint64_t>(out_size), header.size);
+
+            vector<uint64_t> data2(data.size());
+            stream.seekg(0);
+            auto in_size = Serialization::Load(load_data(data2), stream, false);
+            ASSERT_EQ(out_size, in_size);
+            ASSERT_EQ(data, data2);
+
+            // Framed data also loads with a single thread
+            Serialization::SetComprThreadCount(1);
+            vector<uint64_t> data3(data.size());
+            stream.seekg(0);
+            in_size = Serialization::Load(load_data(data3), stream, false);
+            ASSERT_EQ(out_size, in_size);
+            ASSERT_EQ(data, data3);
+
+            // A corrupted frame index is detected
+            string corrupted = stream.str();
+            corrupted[sizeof(Serialization::SEALHeader) + sizeof(uint64_t)] ^= 0x01;
+            stringstream corrupted_stream(corrupted);
+            ASSERT_THROW(Serialization::Load(load_data(data3), corrupted_stream, false), logic_error);
+
+            // A single thread writes unframed data
+            stream.str("");
+            out_size = Serialization::Save(save_data, raw_size, stream, compr_mode, false);
+            stream.seekg(0);
+            Serialization::LoadHeader(stream, header);
+            ASSERT_FALSE(header.reserved & Serialization::header_flag_framed);
+        }
+    }
+#endif
 } // namespace sealtest
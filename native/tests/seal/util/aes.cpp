@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/aes.h"
+#include "seal/util/cpufeatures.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace seal::util;
+using namespace seal;
+using namespace std;
+
+namespace sealtest
+{
+    namespace util
+    {
+        namespace
+        {
+            // FIPS-197, Appendix C.3
+            array<uint8_t, aes256_key_byte_count> fips_key()
+            {
+                array<uint8_t, aes256_key_byte_count> key;
+                for (size_t i = 0; i < key.size(); i++)
+                {
+                    key[i] = static_cast<uint8_t>(i);
+                }
+                return key;
+            }
+
+            const array<uint8_t, aes_block_byte_count> fips_plaintext = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55,
+                                                                          0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb,
+                                                                          0xcc, 0xdd, 0xee, 0xff };
+
+            const array<uint8_t, aes_block_byte_count> fips_ciphertext = { 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67,
+                                                                           0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90,
+                                                                           0x4b, 0x49, 0x60, 0x89 };
+
+            // The FIPS-197 plaintext is the counter block for this nonce and counter
+            constexpr uint64_t fips_nonce = 0x7766554433221100ULL;
+            constexpr uint64_t fips_counter = 0xffeeddccbbaa9988ULL;
+        } // namespace
+
+        TEST(AESTest, EncryptBlock)
+        {
+            auto key = fips_key();
+            array<uint8_t, aes256_round_key_byte_count> round_keys;
+            aes256_expand_key(key.data(), round_keys.data());
+
+            // The last round key in FIPS-197, Appendix C.3
+            const array<uint8_t, aes_block_byte_count> last_round_key = { 0x24, 0xfc, 0x79, 0xcc, 0xbf, 0x09,
+                                                                          0x79, 0xe9, 0x37, 0x1a, 0xc2, 0x3c,
+                                                                          0x6d, 0x68, 0xde, 0x36 };
+            ASSERT_TRUE(equal(last_round_key.begin(), last_round_key.end(), round_keys.end() - aes_block_byte_count));
+
+            array<uint8_t, aes_block_byte_count> out;
+            aes256_encrypt_block(round_keys.data(), fips_plaintext.data(), out.data());
+            ASSERT_EQ(fips_ciphertext, out);
+
+            // In-place
+            out = fips_plaintext;
+            aes256_encrypt_block(round_keys.data(), out.data(), out.data());
+            ASSERT_EQ(fips_ciphertext, out);
+        }
+
+        TEST(AESTest, CTRKeystream)
+        {
+            auto key = fips_key();
+            array<uint8_t, aes256_round_key_byte_count> round_keys;
+            aes256_expand_key(key.data(), round_keys.data());
+
+            array<uint8_t, aes_block_byte_count> out;
+            aes256_ctr_keystream_portable(
+                round_keys.data(), fips_nonce, fips_counter, 1, reinterpret_cast<seal_byte *>(out.data()));
+            ASSERT_EQ(fips_ciphertext, out);
+
+            out.fill(0);
+            aes256_ctr_keystream(
+                round_keys.data(), fips_nonce, fips_counter, 1, reinterpret_cast<seal_byte *>(out.data()));
+            ASSERT_EQ(fips_ciphertext, out);
+
+            // Block counts not divisible by the number of interleaved AES-NI lanes, including counter wrap-around
+            for (size_t block_count : { size_t(1), size_t(7), size_t(8), size_t(9), size_t(256) })
+            {
+                vector<uint8_t> expected(block_count * aes_block_byte_count);
+                vector<uint8_t> result(block_count * aes_block_byte_count);
+                uint64_t counter = ~uint64_t(0) - 3;
+                aes256_ctr_keystream_portable(
+                    round_keys.data(), fips_nonce, counter, block_count,
+                    reinterpret_cast<seal_byte *>(expected.data()));
+                aes256_ctr_keystream(
+                    round_keys.data(), fips_nonce, counter, block_count, reinterpret_cast<seal_byte *>(result.data()));
+                ASSERT_EQ(expected, result);
+#ifdef SEAL_USE_AESNI
+                if (cpu_has_aesni())
+                {
+                    fill(result.begin(), result.end(), uint8_t(0));
+                    aes256_ctr_keystream_aesni(
+                        round_keys.data(), fips_nonce, counter, block_count,
+                        reinterpret_cast<seal_byte *>(result.data()));
+                    ASSERT_EQ(expected, result);
+                }
+#endif
+                // Consecutive blocks use consecutive counters
+                array<uint8_t, aes_block_byte_count> block;
+                aes256_ctr_keystream_portable(
+                    round_keys.data(), fips_nonce, counter + block_count - 1, 1,
+                    reinterpret_cast<seal_byte *>(block.data()));
+                ASSERT_TRUE(equal(block.begin(), block.end(), expected.end() - aes_block_byte_count));
+            }
+        }
+    } // namespace util
+} // namespace sealtest
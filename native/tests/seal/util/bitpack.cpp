@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/dynarray.h"
+#include "seal/util/bitpack.h"
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace seal::util;
+using namespace seal;
+using namespace std;
+
+namespace sealtest
+{
+    namespace util
+    {
+        TEST(BitpackTest, PackUnpack)
+        {
+            mt19937_64 engine(0);
+            for (size_t count : { size_t(1), size_t(7), size_t(37), size_t(64) })
+            {
+                for (int bit_count = 0; bit_count <= 64; bit_count++)
+                {
+                    uint64_t mask = (bit_count == 64) ? ~uint64_t(0) : (uint64_t(1) << bit_count) - 1;
+                    vector<uint64_t> values(count);
+                    for (auto &value : values)
+                    {
+                        value = engine() & mask;
+                    }
+
+                    // One guard byte after the packed data
+                    size_t byte_count = bitpacked_byte_count(count, bit_count);
+                    ASSERT_EQ((count * static_cast<size_t>(bit_count) + 7) / 8, byte_count);
+                    vector<seal_byte> packed(byte_count + 1, static_cast<seal_byte>(0xA5));
+                    bitpack_uint64(values.data(), count, bit_count, packed.data());
+                    ASSERT_EQ(static_cast<seal_byte>(0xA5), packed[byte_count]);
+
+                    vector<uint64_t> unpacked(count, 1);
+                    bitunpack_uint64(packed.data(), count, bit_count, unpacked.data());
+                    ASSERT_EQ(values, unpacked);
+                }
+            }
+
+            uint64_t values[]{ 0, 1, 0x1F, 3 };
+            ASSERT_EQ(0, max_bit_count(values, 1));
+            ASSERT_EQ(1, max_bit_count(values, 2));
+            ASSERT_EQ(5, max_bit_count(values, 4));
+            ASSERT_EQ(0, max_bit_count(values, 0));
+        }
+
+        TEST(BitpackTest, SaveLoadArray)
+        {
+            // Three chunks of widths 10, 60, and 0; the last chunk is partial
+            vector<uint64_t> values(40, 0);
+            for (size_t i = 0; i < 16; i++)
+            {
+                values[i] = 1000 + i;
+                values[16 + i] = (uint64_t(1) << 59) + i;
+            }
+
+            stringstream stream;
+            save_bitpacked_array(values.data(), values.size(), 16, stream);
+            size_t expected_size = 2 * sizeof(uint64_t) + 3 + 20 + 120 + 0;
+            ASSERT_EQ(expected_size, bitpacked_array_save_size(values.data(), values.size(), 16));
+            ASSERT_EQ(expected_size, stream.str().size());
+
+            DynArray<uint64_t> loaded;
+            load_bitpacked_array(stream, values.size(), loaded);
+            ASSERT_EQ(values.size(), loaded.size());
+            ASSERT_TRUE(equal(values.begin(), values.end(), loaded.cbegin()));
+
+            // The loaded size must respect the bound
+            stream.seekg(0);
+            ASSERT_THROW(load_bitpacked_array(stream, values.size() - 1, loaded), logic_error);
+
+            // Empty arrays have no chunks
+            stringstream empty_stream;
+            save_bitpacked_array(nullptr, 0, 16, empty_stream);
+            ASSERT_EQ(2 * sizeof(uint64_t), empty_stream.str().size());
+            load_bitpacked_array(empty_stream, 0, loaded);
+            ASSERT_EQ(0ULL, loaded.size());
+        }
+    } // namespace util
+} // namespace sealtest
@@ -9,6 +9,7 @@
 #include "seal/util/uintcore.h"
 #include <algorithm>
 #include <memory>
+#include <thread>
 #include <vector>
 #include "gtest/gtest.h"
 
@@ -287,6 +288,102 @@ namespace sealtest
             }
         }
 
+        TEST(MemoryPoolTests, TestMemoryPoolTC)
+        {
+            {
+                MemoryPoolTC pool;
+                ASSERT_TRUE(0LL == pool.pool_count());
+
+                Pointer<uint64_t> pointer{ pool.get_for_byte_count(bytes_per_uint64 * 0) };
+                ASSERT_FALSE(pointer.is_set());
+                ASSERT_TRUE(0LL == pool.pool_count());
+
+                pointer = pool.get_for_byte_count(bytes_per_uint64 * 2);
+                uint64_t *allocation1 = pointer.get();
+                ASSERT_TRUE(pointer.is_set());
+                pointer.release();
+                ASSERT_TRUE(1LL == pool.pool_count());
+
+                // Released memory is reused by the same thread
+                pointer = pool.get_for_byte_count(bytes_per_uint64 * 2);
+                ASSERT_TRUE(allocation1 == pointer.get());
+                Pointer<uint64_t> pointer2 = pool.get_for_byte_count(bytes_per_uint64 * 2);
+                uint64_t *allocation2 = pointer2.get();
+                ASSERT_FALSE(allocation2 == pointer.get());
+                pointer.release();
+                pointer2.release();
+                ASSERT_TRUE(1LL == pool.pool_count());
+
+                pointer = pool.get_for_byte_count(bytes_per_uint64 * 2);
+                ASSERT_TRUE(allocation2 == pointer.get());
+                pointer2 = pool.get_for_byte_count(bytes_per_uint64 * 2);
+                ASSERT_TRUE(allocation1 == pointer2.get());
+                Pointer<uint64_t> pointer3 = pool.get_for_byte_count(bytes_per_uint64 * 1);
+                pointer.release();
+                pointer2.release();
+                pointer3.release();
+                ASSERT_TRUE(2LL == pool.pool_count());
+                ASSERT_TRUE(pool.alloc_byte_count() >= 3 * bytes_per_uint64);
+            }
+            {
+                // Memory is allocated and released by many threads, partly across threads
+                MemoryPoolTC pool;
+                size_t thread_count = 4;
+                size_t round_count = 200;
+                vector<Pointer<uint64_t>> handoff(thread_count * round_count);
+                vector<thread> threads;
+                for (size_t t = 0; t < thread_count; t++)
+                {
+                    threads.emplace_back([&, t]() {
+                        for (size_t r = 0; r < round_count; r++)
+                        {
+                            size_t count = 1 + (r % 3);
+                            auto local = allocate_uint(count, pool);
+                            fill_n(local.get(), count, static_cast<uint64_t>(t));
+                            handoff[t * round_count + r] = allocate_uint(count, pool);
+                            fill_n(handoff[t * round_count + r].get(), count, static_cast<uint64_t>(t + r));
+                            ASSERT_TRUE(all_of(
+                                local.get(), local.get() + count, [t](uint64_t value) { return value == t; }));
+                        }
+                    });
+                }
+                for (auto &th : threads)
+                {
+                    th.join();
+                }
+                ASSERT_TRUE(3LL == pool.pool_count());
+
+                // Release memory from a different thread than the one that allocated it
+                threads.clear();
+                for (size_t t = 0; t < thread_count; t++)
+                {
+                    threads.emplace_back([&, t]() {
+                        size_t other = (t + 1) % thread_count;
+                        for (size_t r = 0; r < round_count; r++)
+                        {
+                            ASSERT_EQ(other + r, handoff[other * round_count + r][0]);
+                            handoff[other * round_count + r].release();
+                        }
+                    });
+                }
+                for (auto &th : threads)
+                {
+                    th.join();
+                }
+
+                // Magazines of exited threads are reused
+                size_t alloc_byte_count = pool.alloc_byte_count();
+                thread([&]() {
+                    vector<Pointer<uint64_t>> pointers;
+                    for (size_t r = 0; r < round_count; r++)
+                    {
+                        pointers.push_back(allocate_uint(1 + (r % 3), pool));
+                    }
+                }).join();
+                ASSERT_EQ(alloc_byte_count, pool.alloc_byte_count());
+            }
+        }
+
         TEST(MemoryPoolTests, TestMemoryPoolST)
         {
             {
@@ -2,7 +2,9 @@
 // Licensed under the MIT license.
 
 #include "seal/modulus.h"
+#include "seal/util/cpufeatures.h"
 #include "seal/util/ntt.h"
+#include "seal/util/nttavx.h"
 #include "seal/util/numth.h"
 #include "seal/util/polycore.h"
 #include <cstddef>
@@ -131,5 +133,79 @@ namespace sealtest
                 ASSERT_EQ(temp[i], poly[i]);
             }
         }
+
+        namespace
+        {
+            // Compares a lazy forward and inverse NTT implementation to the scalar DWTHandler on random inputs in
+            // the full lazy input ranges; the outputs must be bit-identical.
+            template <typename Forward, typename Inverse>
+            void compare_to_scalar_ntt(Forward forward, Inverse inverse)
+            {
+                MemoryPoolHandle pool = MemoryPoolHandle::Global();
+                mt19937_64 engine(0);
+                for (int coeff_count_power = 1; coeff_count_power <= 12; coeff_count_power++)
+                {
+                    size_t n = size_t(1) << coeff_count_power;
+                    for (int bit_count : { 20, 40, 50, 60, 61 })
+                    {
+                        Modulus modulus(get_prime(uint64_t(2) << coeff_count_power, bit_count));
+                        NTTTables tables(coeff_count_power, modulus, pool);
+                        vector<uint64_t> expected(n);
+                        vector<uint64_t> actual(n);
+
+                        uniform_int_distribution<uint64_t> dist4(0, 4 * modulus.value() - 1);
+                        generate(expected.begin(), expected.end(), [&]() { return dist4(engine); });
+                        actual = expected;
+                        tables.ntt_handler().transform_to_rev(
+                            expected.data(), coeff_count_power, tables.get_from_root_powers());
+                        forward(actual.data(), tables);
+                        ASSERT_EQ(expected, actual);
+
+                        uniform_int_distribution<uint64_t> dist2(0, 2 * modulus.value() - 1);
+                        generate(expected.begin(), expected.end(), [&]() { return dist2(engine); });
+                        actual = expected;
+                        MultiplyUIntModOperand inv_degree_modulo = tables.inv_degree_modulo();
+                        tables.ntt_handler().transform_from_rev(
+                            expected.data(), coeff_count_power, tables.get_from_inv_root_powers(), &inv_degree_modulo);
+                        inverse(actual.data(), tables);
+                        ASSERT_EQ(expected, actual);
+                    }
+                }
+            }
+        } // namespace
+
+        TEST(NTTTablesTest, NegacyclicNTTAVX2Test)
+        {
+#ifdef SEAL_USE_AVX2
+            if (!cpu_has_avx2())
+            {
+                GTEST_SKIP() << "AVX2 is not supported by the CPU";
+            }
+            compare_to_scalar_ntt(
+                [](uint64_t *values, const NTTTables &tables) { ntt_negacyclic_harvey_lazy_avx2(values, tables); },
+                [](uint64_t *values, const NTTTables &tables) {
+                    inverse_ntt_negacyclic_harvey_lazy_avx2(values, tables);
+                });
+#else
+            GTEST_SKIP() << "AVX2 kernels are not compiled";
+#endif
+        }
+
+        TEST(NTTTablesTest, NegacyclicNTTAVX512Test)
+        {
+#ifdef SEAL_USE_AVX512
+            if (!cpu_has_avx512())
+            {
+                GTEST_SKIP() << "AVX-512 is not supported by the CPU";
+            }
+            compare_to_scalar_ntt(
+                [](uint64_t *values, const NTTTables &tables) { ntt_negacyclic_harvey_lazy_avx512(values, tables); },
+                [](uint64_t *values, const NTTTables &tables) {
+                    inverse_ntt_negacyclic_harvey_lazy_avx512(values, tables);
+                });
+#else
+            GTEST_SKIP() << "AVX-512 kernels are not compiled";
+#endif
+        }
     } // namespace util
 } // namespace sealtest
@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/encryptionparams.h"
+#include "seal/modulus.h"
+#include "seal/randomgen.h"
+#include "seal/randomtostd.h"
+#include "seal/util/common.h"
+#include "seal/util/rlwe.h"
+#include "seal/util/uintarithsmallmod.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace seal::util;
+using namespace seal;
+using namespace std;
+
+namespace sealtest
+{
+    namespace util
+    {
+        namespace
+        {
+            // Coefficient-by-coefficient reference samplers that consume randomness one sample at a time
+            void reference_sample_poly_ternary(
+                shared_ptr<UniformRandomGenerator> prng, const EncryptionParameters &parms, uint64_t *destination)
+            {
+                auto &coeff_modulus = parms.coeff_modulus();
+                size_t coeff_count = parms.poly_modulus_degree();
+                RandomToStandardAdapter engine(prng);
+                uniform_int_distribution<uint64_t> dist(0, 2);
+                for (size_t i = 0; i < coeff_count; i++)
+                {
+                    uint64_t rand = dist(engine);
+                    for (size_t j = 0; j < coeff_modulus.size(); j++)
+                    {
+                        destination[i + j * coeff_count] = rand == 0 ? coeff_modulus[j].value() - 1 : rand - 1;
+                    }
+                }
+            }
+
+            void reference_sample_poly_cbd(
+                shared_ptr<UniformRandomGenerator> prng, const EncryptionParameters &parms, uint64_t *destination)
+            {
+                auto &coeff_modulus = parms.coeff_modulus();
+                size_t coeff_count = parms.poly_modulus_degree();
+                for (size_t i = 0; i < coeff_count; i++)
+                {
+                    unsigned char x[6];
+                    prng->generate(6, reinterpret_cast<seal_byte *>(x));
+                    x[2] &= 0x1F;
+                    x[5] &= 0x1F;
+                    int noise = hamming_weight(x[0]) + hamming_weight(x[1]) + hamming_weight(x[2]) -
+                                hamming_weight(x[3]) - hamming_weight(x[4]) - hamming_weight(x[5]);
+                    for (size_t j = 0; j < coeff_modulus.size(); j++)
+                    {
+                        destination[i + j * coeff_count] =
+                            noise < 0 ? coeff_modulus[j].value() - static_cast<uint64_t>(-noise)
+                                      : static_cast<uint64_t>(noise);
+                    }
+                }
+            }
+
+            void reference_sample_poly_uniform(
+                shared_ptr<UniformRandomGenerator> prng, const EncryptionParameters &parms, uint64_t *destination)
+            {
+                auto &coeff_modulus = parms.coeff_modulus();
+                size_t coeff_count = parms.poly_modulus_degree();
+                prng->generate(
+                    coeff_modulus.size() * coeff_count * sizeof(uint64_t), reinterpret_cast<seal_byte *>(destination));
+                for (size_t j = 0; j < coeff_modulus.size(); j++)
+                {
+                    uint64_t max_multiple =
+                        0xFFFFFFFFFFFFFFFFULL - barrett_reduce_64(0xFFFFFFFFFFFFFFFFULL, coeff_modulus[j]) - 1;
+                    for (size_t i = 0; i < coeff_count; i++)
+                    {
+                        uint64_t &rand = destination[i + j * coeff_count];
+                        while (rand >= max_multiple)
+                        {
+                            prng->generate(sizeof(uint64_t), reinterpret_cast<seal_byte *>(&rand));
+                        }
+                        rand = barrett_reduce_64(rand, coeff_modulus[j]);
+                    }
+                }
+            }
+
+            using sampler_type =
+                function<void(shared_ptr<UniformRandomGenerator>, const EncryptionParameters &, uint64_t *)>;
+
+            void compare_samplers(sampler_type sampler, sampler_type reference)
+            {
+                EncryptionParameters parms(scheme_type::bfv);
+                for (size_t coeff_count : { size_t(1024), size_t(4096) })
+                {
+                    parms.set_poly_modulus_degree(coeff_count);
+                    parms.set_coeff_modulus(CoeffModulus::Create(coeff_count, { 30, 40, 50, 60 }));
+                    size_t size = coeff_count * parms.coeff_modulus().size();
+
+                    for (uint64_t s = 0; s < 4; s++)
+                    {
+                        prng_seed_type seed = { s, s + 1, s + 2, s + 3, s + 4, s + 5, s + 6, s + 7 };
+                        auto prng = Blake2xbPRNGFactory(seed).create();
+                        auto reference_prng = Blake2xbPRNGFactory(seed).create();
+
+                        vector<uint64_t> result(size), expected(size);
+                        sampler(prng, parms, result.data());
+                        reference(reference_prng, parms, expected.data());
+                        ASSERT_EQ(expected, result);
+
+                        // The generators must also be left in the same state
+                        ASSERT_EQ(reference_prng->generate(), prng->generate());
+                    }
+                }
+            }
+        } // namespace
+
+        TEST(RLWE, SamplePolyTernary)
+        {
+            compare_samplers(sample_poly_ternary, reference_sample_poly_ternary);
+        }
+
+        TEST(RLWE, SamplePolyCBD)
+        {
+            compare_samplers(sample_poly_cbd, reference_sample_poly_cbd);
+        }
+
+        TEST(RLWE, SamplePolyUniform)
+        {
+            compare_samplers(sample_poly_uniform, reference_sample_poly_uniform);
+        }
+    } // namespace util
+} // namespace sealtest
@@ -4,8 +4,10 @@
 #include "seal/memorymanager.h"
 #include "seal/util/numth.h"
 #include "seal/util/rns.h"
+#include "seal/util/rnsavx.h"
 #include "seal/util/uintarithmod.h"
 #include "seal/util/uintarithsmallmod.h"
+#include <random>
 #include <stdexcept>
 #include <vector>
 #include "gtest/gtest.h"
@@ -437,6 +439,140 @@ namespace sealtest
             }
         }
 
+        TEST(BaseConverterTest, ConvertArrayBlocked)
+        {
+            auto pool = MemoryManager::GetPool();
+
+            // Compare with fast_convert applied to each coefficient separately
+            auto bct_test = [&](const vector<Modulus> &ibase, const vector<Modulus> &obase, size_t count) {
+                BaseConverter bct(RNSBase(ibase, pool), RNSBase(obase, pool), pool);
+                mt19937_64 engine(static_cast<uint64_t>(count));
+                vector<uint64_t> in(ibase.size() * count);
+                for (size_t i = 0; i < ibase.size(); i++)
+                {
+                    for (size_t c = 0; c < count; c++)
+                    {
+                        in[i * count + c] = engine() % ibase[i].value();
+                    }
+                }
+                vector<uint64_t> out(obase.size() * count);
+                bct.fast_convert_array(ConstRNSIter(in.data(), count), RNSIter(out.data(), count), pool);
+
+                vector<uint64_t> in_coeff(ibase.size());
+                vector<uint64_t> out_coeff(obase.size());
+                for (size_t c = 0; c < count; c++)
+                {
+                    for (size_t i = 0; i < ibase.size(); i++)
+                    {
+                        in_coeff[i] = in[i * count + c];
+                    }
+                    bct.fast_convert(in_coeff.data(), out_coeff.data(), pool);
+                    for (size_t j = 0; j < obase.size(); j++)
+                    {
+                        ASSERT_EQ(out_coeff[j], out[j * count + c]);
+                    }
+                }
+            };
+
+            // Small moduli; eligible for the AVX-512 IFMA kernel
+            auto ibase = get_primes(1024, 40, 3);
+            auto obase = get_primes(1024, 45, 2);
+            ASSERT_TRUE(fast_convert_array_fits_avx512ifma(RNSBase(ibase, pool), RNSBase(obase, pool)));
+            bct_test(ibase, obase, 4);
+            bct_test(ibase, obase, 1000);
+            bct_test(ibase, obase, 8192);
+
+            // Largest moduli and input base for the AVX-512 IFMA kernel
+            auto primes = get_primes(1024, 50, 19);
+            obase.assign(primes.begin(), primes.begin() + 3);
+            ibase.assign(primes.begin() + 3, primes.begin() + 18);
+            ASSERT_TRUE(fast_convert_array_fits_avx512ifma(RNSBase(ibase, pool), RNSBase(obase, pool)));
+            bct_test(ibase, obase, 4096);
+            ibase.assign(primes.begin() + 3, primes.end());
+            ASSERT_FALSE(fast_convert_array_fits_avx512ifma(RNSBase(ibase, pool), RNSBase(obase, pool)));
+            bct_test(ibase, obase, 4096);
+
+            // Large moduli; eligible for the AVX-512F/DQ kernel only
+            ibase = get_primes(1024, 60, 5);
+            obase = get_primes(1024, 61, 6);
+            ASSERT_FALSE(fast_convert_array_fits_avx512ifma(RNSBase(ibase, pool), RNSBase(obase, pool)));
+            ASSERT_TRUE(fast_convert_array_fits_avx512(RNSBase(ibase, pool), RNSBase(obase, pool)));
+            bct_test(ibase, obase, 4);
+            bct_test(ibase, obase, 1000);
+            bct_test(ibase, obase, 8192);
+
+            // Largest input base for the AVX-512F/DQ kernel with 61-bit moduli
+            primes = get_primes(1024, 61, 66);
+            obase.assign(primes.begin(), primes.begin() + 2);
+            ibase.assign(primes.begin() + 2, primes.begin() + 65);
+            ASSERT_TRUE(fast_convert_array_fits_avx512(RNSBase(ibase, pool), RNSBase(obase, pool)));
+            bct_test(ibase, obase, 1000);
+            ibase.assign(primes.begin() + 2, primes.end());
+            ASSERT_FALSE(fast_convert_array_fits_avx512(RNSBase(ibase, pool), RNSBase(obase, pool)));
+            bct_test(ibase, obase, 1000);
+        }
+
+        TEST(BaseConverterTest, ExactConvertArray)
+        {
+            auto pool = MemoryManager::GetPool();
+
+            {
+                // Every value modulo 15 converts to its centered representative
+                BaseConverter bct(RNSBase({ 3, 5 }, pool), RNSBase({ 7, 11, 13 }, pool), pool);
+                vector<uint64_t> in(2 * 15);
+                for (uint64_t x = 0; x < 15; x++)
+                {
+                    in[x] = x % 3;
+                    in[15 + x] = x % 5;
+                }
+                vector<uint64_t> out(3 * 15);
+                bct.exact_convert_array(ConstRNSIter(in.data(), 15), RNSIter(out.data(), 15), pool);
+                for (uint64_t x = 0; x < 15; x++)
+                {
+                    ASSERT_EQ(x <= 7 ? x % 7 : (x + 7 - 15 % 7) % 7, out[x]);
+                    ASSERT_EQ(x <= 7 ? x % 11 : (x + 11 - 15 % 11) % 11, out[15 + x]);
+                    ASSERT_EQ(x <= 7 ? x % 13 : (x + 13 - 15 % 13) % 13, out[30 + x]);
+                }
+            }
+            {
+                // Converting to a larger base and back recovers the input
+                auto ibase = get_primes(1024, 60, 4);
+                auto obase = get_primes(1024, 61, 5);
+                BaseConverter bct(RNSBase(ibase, pool), RNSBase(obase, pool), pool);
+                BaseConverter bct_back(RNSBase(obase, pool), RNSBase(ibase, pool), pool);
+
+                size_t count = 1024;
+                mt19937_64 engine(count);
+                vector<uint64_t> in(ibase.size() * count);
+                for (size_t i = 0; i < ibase.size(); i++)
+                {
+                    for (size_t c = 0; c < count; c++)
+                    {
+                        in[i * count + c] = engine() % ibase[i].value();
+                    }
+                }
+
+                // Include zero and the largest values on both sides
+                for (size_t i = 0; i < ibase.size(); i++)
+                {
+                    in[i * count] = 0;
+                    in[i * count + 1] = ibase[i].value() - 1;
+                }
+
+                vector<uint64_t> out(obase.size() * count);
+                bct.exact_convert_array(ConstRNSIter(in.data(), count), RNSIter(out.data(), count), pool);
+                for (size_t j = 0; j < obase.size(); j++)
+                {
+                    ASSERT_EQ(0ULL, out[j * count]);
+                    ASSERT_EQ(obase[j].value() - 1, out[j * count + 1]);
+                }
+
+                vector<uint64_t> back(ibase.size() * count);
+                bct_back.exact_convert_array(ConstRNSIter(out.data(), count), RNSIter(back.data(), count), pool);
+                ASSERT_TRUE(in == back);
+            }
+        }
+
         TEST(RNSToolTest, Initialize)
         {
             auto pool = MemoryManager::GetPool();
@@ -1071,5 +1207,95 @@ namespace sealtest
             ASSERT_TRUE((53ULL + 2ULL - in[0]) % 53ULL <= 1);
             ASSERT_TRUE((53ULL + 3ULL - in[1]) % 53ULL <= 1);
         }
+
+        TEST(KSwitchRescaleToolTest, Convert)
+        {
+            auto pool = MemoryManager::GetPool();
+
+            auto convert_test = [&](const vector<Modulus> &special_primes) {
+                // The last data prime 13 and the special primes are converted to 7 and 11
+                KSwitchRescaleTool tool(RNSBase({ 7, 11, 13 }, pool), RNSBase(special_primes, pool), pool);
+                ASSERT_EQ(size_t(2), tool.next_base_size());
+                ASSERT_EQ(special_primes.size(), tool.special_base_size());
+
+                uint64_t divisor = 13;
+                for (auto &prime : special_primes)
+                {
+                    divisor *= prime.value();
+                }
+                size_t count = static_cast<size_t>(divisor);
+                size_t input_size = special_primes.size() + 1;
+                vector<uint64_t> in(input_size * count);
+                for (uint64_t x = 0; x < divisor; x++)
+                {
+                    in[x] = x % 13;
+                    for (size_t i = 0; i < special_primes.size(); i++)
+                    {
+                        in[(i + 1) * count + x] = x % special_primes[i].value();
+                    }
+                }
+                vector<uint64_t> out(2 * count);
+                tool.convert(ConstRNSIter(in.data(), count), RNSIter(out.data(), count), pool);
+
+                // Every value converts to its centered representative
+                for (uint64_t x = 0; x < divisor; x++)
+                {
+                    uint64_t neg = divisor - x;
+                    ASSERT_EQ(x <= divisor / 2 ? x % 7 : (7 - neg % 7) % 7, out[x]);
+                    ASSERT_EQ(x <= divisor / 2 ? x % 11 : (11 - neg % 11) % 11, out[count + x]);
+                }
+            };
+            convert_test({ 5 });
+            convert_test({ 3, 5 });
+        }
+
+        TEST(HybridKSwitchToolTest, ModDownConvert)
+        {
+            auto pool = MemoryManager::GetPool();
+
+            // Special primes 3 and 5 with P = 15 and floor(P/2) = 7; data primes 7, 11, 13
+            HybridKSwitchTool tool(RNSBase({ 7, 11, 13 }, pool), RNSBase({ 3, 5 }, pool), pool);
+            uint64_t special_prod = 15;
+            vector<uint64_t> data_primes{ 7, 11, 13 };
+
+            size_t count = static_cast<size_t>(special_prod);
+            vector<uint64_t> in(2 * count);
+            for (uint64_t x = 0; x < special_prod; x++)
+            {
+                in[x] = x % 3;
+                in[count + x] = x % 5;
+            }
+            vector<uint64_t> out(3 * count);
+            tool.mod_down_convert(RNSIter(in.data(), count), RNSIter(out.data(), count), pool);
+
+            // (x - out) / P is x / P rounded to the nearest integer, minus a conversion error e in [0, 2)
+            for (uint64_t x = 0; x < special_prod; x++)
+            {
+                uint64_t rounded = (2 * x >= special_prod) ? 1 : 0;
+                bool found = false;
+                for (uint64_t e = 0; e < 2 && !found; e++)
+                {
+                    found = true;
+                    for (size_t i = 0; i < data_primes.size(); i++)
+                    {
+                        uint64_t q = data_primes[i];
+                        uint64_t expected = (rounded + q - e) % q;
+                        uint64_t diff = (x % q + q - out[i * count + x]) % q;
+                        found = found && ((expected * special_prod) % q == diff);
+                    }
+                }
+                ASSERT_TRUE(found);
+
+                // Without a conversion error the result is exact; flooring would give 0 here
+                if (x == special_prod - 7)
+                {
+                    for (size_t i = 0; i < data_primes.size(); i++)
+                    {
+                        uint64_t q = data_primes[i];
+                        ASSERT_EQ(special_prod % q, (x % q + q - out[i * count + x]) % q);
+                    }
+                }
+            }
+        }
     } // namespace util
 } // namespace sealtest
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "seal/util/threadpool.h"
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace seal::util;
+using namespace std;
+
+namespace sealtest
+{
+    namespace util
+    {
+        TEST(ThreadPoolTest, ParallelFor)
+        {
+            ASSERT_THROW(ThreadPool(0), invalid_argument);
+
+            for (size_t thread_count = 1; thread_count <= 4; thread_count++)
+            {
+                ThreadPool pool(thread_count);
+                ASSERT_EQ(thread_count, pool.thread_count());
+
+                // Every index is visited exactly once
+                for (size_t count : { size_t(0), size_t(1), size_t(3), size_t(100) })
+                {
+                    vector<atomic<int>> visited(count);
+                    for (auto &v : visited)
+                    {
+                        v = 0;
+                    }
+                    pool.parallel_for(count, [&](size_t i) { visited[i]++; });
+                    for (auto &v : visited)
+                    {
+                        ASSERT_EQ(1, v.load());
+                    }
+                }
+            }
+        }
+
+        TEST(ThreadPoolTest, NestedAndExceptions)
+        {
+            ThreadPool pool(4);
+            ASSERT_FALSE(ThreadPool::in_parallel_region());
+
+            // Nested calls run on the calling thread
+            atomic<size_t> sum{ 0 };
+            pool.parallel_for(8, [&](size_t i) {
+                ASSERT_TRUE(ThreadPool::in_parallel_region());
+                pool.parallel_for(8, [&](size_t j) { sum += i * 8 + j; });
+            });
+            ASSERT_EQ(size_t(64 * 63 / 2), sum.load());
+            ASSERT_FALSE(ThreadPool::in_parallel_region());
+
+            // The first exception is rethrown and the pool remains usable
+            ASSERT_THROW(
+                pool.parallel_for(
+                    100,
+                    [](size_t i) {
+                        if (i == 42)
+                        {
+                            throw logic_error("test");
+                        }
+                    }),
+                logic_error);
+            sum = 0;
+            pool.parallel_for(10, [&](size_t i) { sum += i; });
+            ASSERT_EQ(size_t(45), sum.load());
+        }
+    } // namespace util
+} // namespace sealtest